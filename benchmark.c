@@ -0,0 +1,919 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "pberr.h"
+#include "gtree.h"
+
+#define RANDOMSEED 0
+
+// Number of nodes of the benchmarked trees
+#define NB_SIZE 5
+int benchmarkSize[NB_SIZE] = {1000, 5000, 25000, 100000, 200000};
+
+// Largest tree for which the reference quadratic builders are run
+#define REFERENCE_MAX_SIZE 25000
+
+// Create a random tree with 'nbNode' nodes (root included), each node
+// being appended to a randomly chosen previous node, with random sort
+// values
+// If 'data' is not null the 'iNode'-th node holds 'data + iNode', else
+// the nodes hold no data
+GenTree* BenchmarkCreateTree(const int nbNode, int* const data) {
+  GenTree** nodes = PBErrMalloc(GenTreeErr, sizeof(GenTree*) * nbNode);
+  nodes[0] = GenTreeCreateData(data);
+  for (int iNode = 1; iNode < nbNode; ++iNode) {
+    GenTree* parent = nodes[rand() % iNode];
+    GenTreeAddSortData(parent, (data != NULL ? data + iNode : NULL),
+      (float)(rand() % 1000));
+    nodes[iNode] =
+      (GenTree*)(((const GSet*)GenTreeSubtrees(parent))->_tail->_data);
+  }
+  GenTree* tree = nodes[0];
+  free(nodes);
+  return tree;
+}
+
+// Modify the tree 'tree' to make stale the iterators attached to it
+// The grafting is not memorized in the edit log of the tree, thus the 
+// depth first sequences are recreated instead of patched
+void BenchmarkTouchTree(GenTree* const tree) {
+  GenTreeAppendData(tree, NULL);
+  GenTree* subtree = GenTreeLastSubtree(tree);
+  GenTreeAppendData(subtree, NULL);
+  GenTreeGraftChildren(subtree, tree);
+  GenTreeFree(&subtree);
+  subtree = GenTreeLastSubtree(tree);
+  GenTreeFree(&subtree);
+}
+
+// Return the time in milliseconds elapsed since 'start'
+double BenchmarkElapsed(const clock_t start) {
+  return (double)(clock() - start) * 1000.0 / (double)CLOCKS_PER_SEC;
+}
+
+// Return the wall clock time in milliseconds, for the benchmarks of
+// the parallel functions (clock() sums the time of all the threads)
+double BenchmarkWallClock() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (double)(t.tv_sec) * 1000.0 + (double)(t.tv_nsec) / 1000000.0;
+}
+
+// Reference breadth first builder inserting each node with GSetAddSort
+// (former implementation, quadratic in the number of nodes)
+void BenchmarkReferenceBreadthFirst(GSetGenTree* seq, GenTree* tree,
+  int lvl) {
+  if (!GenTreeIsRoot(tree)) GSetAddSort(seq, tree, lvl);
+  GSetElem* subtree = ((const GSet*)GenTreeSubtrees(tree))->_head;
+  while (subtree != NULL) {
+    BenchmarkReferenceBreadthFirst(seq, subtree->_data, lvl + 1);
+    subtree = subtree->_next;
+  }
+}
+
+void BenchmarkGenTreeIterBreadth() {
+  printf("BenchmarkGenTreeIterBreadth\n");
+  printf("nbNode,create(ms),update(ms),update(ns/node),reference(ms)\n");
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    GenTree* tree = BenchmarkCreateTree(nbNode, NULL);
+    clock_t start = clock();
+    GenTreeIterBreadth iter = GenTreeIterBreadthCreateStatic(tree);
+    double timeCreate = BenchmarkElapsed(start);
+    BenchmarkTouchTree(tree);
+    start = clock();
+    GenTreeIterBreadthUpdate(&iter);
+    double timeUpdate = BenchmarkElapsed(start);
+    printf("%d,%.3f,%.3f,%.1f,", nbNode, timeCreate, timeUpdate,
+      timeUpdate * 1e6 / (double)nbNode);
+    if (nbNode <= REFERENCE_MAX_SIZE) {
+      GSetGenTree seq = GSetGenTreeCreateStatic();
+      start = clock();
+      BenchmarkReferenceBreadthFirst(&seq, tree, 0);
+      printf("%.3f\n", BenchmarkElapsed(start));
+      GSetFlush(&seq);
+    } else {
+      printf("-\n");
+    }
+    GenTreeIterFreeStatic(&iter);
+    GenTreeFree(&tree);
+  }
+}
+
+// Reference value first builder inserting each node with GSetAddSort
+// (former implementation, quadratic in the number of nodes)
+void BenchmarkReferenceValueFirst(GSetGenTree* seq, GenTree* tree,
+  float val) {
+  if (!GenTreeIsRoot(tree)) GSetAddSort(seq, tree, val);
+  GSetElem* subtree = ((const GSet*)GenTreeSubtrees(tree))->_head;
+  while (subtree != NULL) {
+    BenchmarkReferenceValueFirst(seq, subtree->_data, subtree->_sortVal);
+    subtree = subtree->_next;
+  }
+}
+
+// Number of nodes taken with GenTreeIterValueUpdateFirst
+#define BENCHMARK_NB_FIRST 100
+
+void BenchmarkGenTreeIterValue() {
+  printf("BenchmarkGenTreeIterValue\n");
+  printf("nbNode,update(ms),update(ns/node),first%d(ms),reference(ms)\n",
+    BENCHMARK_NB_FIRST);
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    GenTree* tree = BenchmarkCreateTree(nbNode, NULL);
+    GenTreeIterValue iter = GenTreeIterValueCreateStatic(tree);
+    BenchmarkTouchTree(tree);
+    clock_t start = clock();
+    GenTreeIterValueUpdate(&iter);
+    double timeUpdate = BenchmarkElapsed(start);
+    start = clock();
+    GenTreeIterValueUpdateFirst(&iter, BENCHMARK_NB_FIRST);
+    double timeFirst = BenchmarkElapsed(start);
+    printf("%d,%.3f,%.1f,%.3f,", nbNode, timeUpdate,
+      timeUpdate * 1e6 / (double)nbNode, timeFirst);
+    if (nbNode <= REFERENCE_MAX_SIZE) {
+      GSetGenTree seq = GSetGenTreeCreateStatic();
+      start = clock();
+      BenchmarkReferenceValueFirst(&seq, tree, 0.0);
+      printf("%.3f\n", BenchmarkElapsed(start));
+      GSetFlush(&seq);
+    } else {
+      printf("-\n");
+    }
+    GenTreeIterFreeStatic(&iter);
+    GenTreeFree(&tree);
+  }
+}
+
+// Number of searched data per tree
+#define BENCHMARK_NB_SEARCH 1000
+
+void BenchmarkGenTreeIndex() {
+  printf("BenchmarkGenTreeIndex\n");
+  printf("nbNode,create(ms),search(ns/search),iterSearch(ns/search)\n");
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    int* data = PBErrMalloc(GenTreeErr, sizeof(int) * nbNode);
+    GenTree* tree = BenchmarkCreateTree(nbNode, data);
+    int* searched = PBErrMalloc(GenTreeErr, 
+      sizeof(int) * BENCHMARK_NB_SEARCH);
+    for (int iSearch = 0; iSearch < BENCHMARK_NB_SEARCH; ++iSearch)
+      searched[iSearch] = 1 + rand() % (nbNode - 1);
+    // Search through the iterator, before the tree is indexed (only on
+    // small trees as it's linear in the number of nodes)
+    GenTreeIterDepthLazy iter = GenTreeIterDepthLazyCreateStatic(tree);
+    int nbFound = 0;
+    clock_t start = clock();
+    if (nbNode <= REFERENCE_MAX_SIZE) {
+      for (int iSearch = 0; iSearch < BENCHMARK_NB_SEARCH; ++iSearch) {
+        GenTreeIterReset(&iter);
+        if (GenTreeSearch(tree, data + searched[iSearch], &iter) != NULL)
+          ++nbFound;
+      }
+    } else {
+      nbFound = BENCHMARK_NB_SEARCH;
+    }
+    double timeIter = BenchmarkElapsed(start);
+    // Search through the index
+    start = clock();
+    GenTreeIndexCreate(tree, NULL);
+    double timeCreate = BenchmarkElapsed(start);
+    start = clock();
+    for (int iSearch = 0; iSearch < BENCHMARK_NB_SEARCH; ++iSearch)
+      if (GenTreeIndexSearch(tree, data + searched[iSearch], NULL) != NULL)
+        ++nbFound;
+    double timeSearch = BenchmarkElapsed(start);
+    if (nbFound != 2 * BENCHMARK_NB_SEARCH)
+      printf("search failed\n");
+    printf("%d,%.3f,%.1f,", nbNode, timeCreate, 
+      timeSearch * 1e6 / (double)BENCHMARK_NB_SEARCH);
+    if (nbNode <= REFERENCE_MAX_SIZE)
+      printf("%.1f\n", timeIter * 1e6 / (double)BENCHMARK_NB_SEARCH);
+    else
+      printf("-\n");
+    GenTreeIterFreeStatic(&iter);
+    GenTreeFree(&tree);
+    free(searched);
+    free(data);
+  }
+}
+
+// Loop on the subtrees of the GenTree 'tree' by position and return 
+// the number of subtrees with data
+int BenchmarkLoopSubtrees(const GenTree* const tree) {
+  int nb = 0;
+  int nbSubtree = GSetNbElem(GenTreeSubtrees(tree));
+  for (int iSubtree = 0; iSubtree < nbSubtree; ++iSubtree)
+    if (GenTreeData(GenTreeSubtree(tree, iSubtree)) != NULL)
+      ++nb;
+  return nb;
+}
+
+void BenchmarkGenTreeSubtreeArray() {
+  printf("BenchmarkGenTreeSubtreeArray\n");
+  printf("nbSubtree,loopArray(ms),insertArray(ms),loopList(ms)\n");
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbSubtree = benchmarkSize[iSize];
+    int data = 0;
+    GenTree* tree = GenTreeCreate();
+    for (int iSubtree = 0; iSubtree < nbSubtree; ++iSubtree)
+      GenTreeAppendData(tree, &data);
+    // Loop by position, without the array only on small trees as 
+    // it's quadratic in the number of subtrees
+    clock_t start = clock();
+    int nbList = nbSubtree;
+    if (nbSubtree <= REFERENCE_MAX_SIZE)
+      nbList = BenchmarkLoopSubtrees(tree);
+    double timeList = BenchmarkElapsed(start);
+    GenTreeSubtreeArrayCreate(tree);
+    start = clock();
+    int nbArray = BenchmarkLoopSubtrees(tree);
+    double timeArray = BenchmarkElapsed(start);
+    // Insert 1000 subtrees at random positions
+    start = clock();
+    for (int iInsert = 0; iInsert < 1000; ++iInsert)
+      GenTreeInsertData(tree, &data, rand() % nbSubtree);
+    double timeInsert = BenchmarkElapsed(start);
+    if (nbList != nbSubtree || nbArray != nbSubtree)
+      printf("loop failed\n");
+    printf("%d,%.3f,%.3f,", nbSubtree, timeArray, timeInsert);
+    if (nbSubtree <= REFERENCE_MAX_SIZE)
+      printf("%.3f\n", timeList);
+    else
+      printf("-\n");
+    GenTreeFree(&tree);
+  }
+}
+
+void BenchmarkGenTreeSubtreeSkipList() {
+  printf("BenchmarkGenTreeSubtreeSkipList\n");
+  printf("nbSubtree,addSortSkipList(ms),inRange(ns/query),bulk(ms),"
+    "addSortList(ms)\n");
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbSubtree = benchmarkSize[iSize];
+    int data = 0;
+    float* sortVals = PBErrMalloc(GenTreeErr, sizeof(float) * nbSubtree);
+    for (int iSubtree = 0; iSubtree < nbSubtree; ++iSubtree)
+      sortVals[iSubtree] = (float)(rand() % 1000000);
+    // Sorted insertion with the skip list
+    GenTree* tree = GenTreeCreate();
+    GenTreeSubtreeSkipListCreate(tree);
+    clock_t start = clock();
+    for (int iSubtree = 0; iSubtree < nbSubtree; ++iSubtree)
+      GenTreeAddSortData(tree, &data, sortVals[iSubtree]);
+    double timeSkipList = BenchmarkElapsed(start);
+    // Range queries
+    int nbFound = 0;
+    start = clock();
+    for (int iQuery = 0; iQuery < 1000; ++iQuery) {
+      GenTree* first = NULL;
+      float lo = (float)(rand() % 1000000);
+      nbFound += GenTreeSubtreesInRange(tree, lo, lo + 10.0, &first);
+    }
+    double timeRange = BenchmarkElapsed(start);
+    GenTreeFree(&tree);
+    // Bulk loading, sorting once
+    tree = GenTreeCreate();
+    start = clock();
+    for (int iSubtree = 0; iSubtree < nbSubtree; ++iSubtree)
+      GenTreeAppendSortData(tree, &data, sortVals[iSubtree]);
+    GenTreeSortSubtrees(tree);
+    double timeBulk = BenchmarkElapsed(start);
+    GenTreeFree(&tree);
+    printf("%d,%.3f,%.1f,%.3f,", nbSubtree, timeSkipList, timeRange * 1e3,
+      timeBulk);
+    // Sorted insertion without the skip list, only on small trees as 
+    // it's quadratic in the number of subtrees
+    if (nbSubtree <= REFERENCE_MAX_SIZE) {
+      tree = GenTreeCreate();
+      start = clock();
+      for (int iSubtree = 0; iSubtree < nbSubtree; ++iSubtree)
+        GenTreeAddSortData(tree, &data, sortVals[iSubtree]);
+      printf("%.3f\n", BenchmarkElapsed(start));
+      GenTreeFree(&tree);
+    } else {
+      printf("-\n");
+    }
+    if (nbFound < 0)
+      printf("range failed\n");
+    free(sortVals);
+  }
+}
+
+// Number of subtrees created at once in BenchmarkGenTreeBatch
+#define BENCHMARK_BATCH_SIZE 100
+
+// Create a tree with 'nbNode' nodes (root excluded) by expanding 
+// BENCHMARK_BATCH_SIZE subtrees at once for each node in breadth first
+// order, with the batch functions if 'isBatch' is true
+GenTree* BenchmarkExpandTree(const int nbNode, const bool isBatch) {
+  void* data[BENCHMARK_BATCH_SIZE] = {NULL};
+  GenTree* tree = GenTreeCreate();
+  // Queue of the nodes in breadth first order
+  GenTree** queue = PBErrMalloc(GenTreeErr, sizeof(GenTree*) * (nbNode + 1));
+  queue[0] = tree;
+  int nb = 0;
+  for (int iNode = 0; nb < nbNode; ++iNode) {
+    GenTree* node = queue[iNode];
+    int nbSubtree = nbNode - nb;
+    if (nbSubtree > BENCHMARK_BATCH_SIZE)
+      nbSubtree = BENCHMARK_BATCH_SIZE;
+    if (isBatch) {
+      GenTreeAppendDataBatch(node, data, nbSubtree);
+    } else {
+      for (int iSubtree = 0; iSubtree < nbSubtree; ++iSubtree)
+        GenTreeAppendData(node, NULL);
+    }
+    for (GSetElem* elem = ((const GSet*)GenTreeSubtrees(node))->_head;
+      elem != NULL; elem = elem->_next)
+      queue[++nb] = elem->_data;
+  }
+  free(queue);
+  return tree;
+}
+
+// Sum of the sizes of the subtrees, to run through the tree
+long BenchmarkSumSize(const GenTree* const tree) {
+  long sum = 0;
+  for (GSetElem* elem = ((const GSet*)GenTreeSubtrees(tree))->_head;
+    elem != NULL; elem = elem->_next)
+    sum += 1 + BenchmarkSumSize(elem->_data);
+  return sum;
+}
+
+void BenchmarkGenTreeBatch() {
+  printf("BenchmarkGenTreeBatch\n");
+  printf("nbNode,create(ms),createBatch(ms),runThrough(ms),"
+    "runThroughBatch(ms)\n");
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    clock_t start = clock();
+    GenTree* tree = BenchmarkExpandTree(nbNode, false);
+    double timeCreate = BenchmarkElapsed(start);
+    start = clock();
+    GenTree* treeBatch = BenchmarkExpandTree(nbNode, true);
+    double timeCreateBatch = BenchmarkElapsed(start);
+    start = clock();
+    long sum = BenchmarkSumSize(tree);
+    double timeRun = BenchmarkElapsed(start);
+    start = clock();
+    long sumBatch = BenchmarkSumSize(treeBatch);
+    double timeRunBatch = BenchmarkElapsed(start);
+    if (sum != sumBatch)
+      printf("batch failed\n");
+    printf("%d,%.3f,%.3f,%.3f,%.3f\n", nbNode, timeCreate, 
+      timeCreateBatch, timeRun, timeRunBatch);
+    GenTreeFree(&tree);
+    GenTreeFree(&treeBatch);
+  }
+}
+
+void BenchmarkGenTreeFromParents() {
+  printf("BenchmarkGenTreeFromParents\n");
+  printf("nbNode,create(ms),createFromParents(ms),export(ms)\n");
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    // Random tree, each node's parent has a lower index
+    int* parents = PBErrMalloc(GenTreeErr, sizeof(int) * nbNode);
+    parents[0] = -1;
+    for (int iNode = 1; iNode < nbNode; ++iNode)
+      parents[iNode] = rand() % iNode;
+    GenTree** nodes = PBErrMalloc(GenTreeErr, sizeof(GenTree*) * nbNode);
+    clock_t start = clock();
+    nodes[0] = GenTreeCreate();
+    for (int iNode = 1; iNode < nbNode; ++iNode) {
+      GenTreeAppendData(nodes[parents[iNode]], NULL);
+      nodes[iNode] = GenTreeLastSubtree(nodes[parents[iNode]]);
+    }
+    double timeCreate = BenchmarkElapsed(start);
+    start = clock();
+    GenTree* tree = GenTreeCreateFromParents(NULL, parents, NULL, nbNode);
+    double timeCreateFromParents = BenchmarkElapsed(start);
+    start = clock();
+    int nb = GenTreeExportParents(tree, NULL, parents, NULL);
+    double timeExport = BenchmarkElapsed(start);
+    if (nb != nbNode || GenTreeGetSize(tree) != GenTreeGetSize(nodes[0]))
+      printf("fromParents failed\n");
+    printf("%d,%.3f,%.3f,%.3f\n", nbNode, timeCreate, 
+      timeCreateFromParents, timeExport);
+    GenTreeFree(nodes);
+    GenTreeFree(&tree);
+    free(nodes);
+    free(parents);
+  }
+}
+
+// Number of iterations of the function applied on each node in 
+// BenchmarkGenTreeParallelApply, to simulate an expensive function
+#define BENCHMARK_APPLY_NBITER 200
+
+// Expensive function applied on each node
+void BenchmarkApplyFun(void* const data, void* const param) {
+  (void)data;
+  (void)param;
+  volatile double v = 1.0;
+  for (int iIter = 0; iIter < BENCHMARK_APPLY_NBITER; ++iIter)
+    v = sqrt(v + (double)iIter);
+}
+
+void BenchmarkGenTreeParallelApply() {
+  printf("BenchmarkGenTreeParallelApply\n");
+  printf("nbNode,nbThread,iterApply(ms),parallelApply(ms),speedup\n");
+  int nbProc = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    GenTree* tree = BenchmarkCreateTree(nbNode, NULL);
+    GenTreeIterDepth iter = GenTreeIterDepthCreateStatic(tree);
+    double start = BenchmarkWallClock();
+    GenTreeIterApply(&iter, BenchmarkApplyFun, NULL);
+    double timeIter = BenchmarkWallClock() - start;
+    GenTreeIterFreeStatic(&iter);
+    for (int nbThread = 1; nbThread <= nbProc; nbThread *= 2) {
+      GenTreeThreadPool* pool = GenTreeThreadPoolCreate(nbThread);
+      start = BenchmarkWallClock();
+      GenTreeParallelApply(tree, BenchmarkApplyFun, NULL, pool, 
+        GenTreeApplyOrderTopDown);
+      double timeParallel = BenchmarkWallClock() - start;
+      printf("%d,%d,%.3f,%.3f,%.2f\n", nbNode, nbThread, timeIter, 
+        timeParallel, timeIter / timeParallel);
+      GenTreeThreadPoolFree(&pool);
+    }
+    GenTreeFree(&tree);
+  }
+}
+
+// Functions of BenchmarkGenTreeReduce, counting the nodes
+void BenchmarkReduceSum(void* const data, void* const param) {
+  (void)data;
+  *(double*)param += 1.0;
+}
+
+void BenchmarkReduceMap(void* const data, void* const value, 
+  void* const param) {
+  (void)data;
+  (void)param;
+  *(double*)value = 1.0;
+}
+
+void BenchmarkReduceCombine(void* const acc, const void* const value, 
+  void* const param) {
+  (void)param;
+  *(double*)acc += *(const double*)value;
+}
+
+void BenchmarkGenTreeReduce() {
+  printf("BenchmarkGenTreeReduce\n");
+  printf("nbNode,nbThread,iterApply(ms),reduce(ms),reduceBottomUp(ms)\n");
+  int nbProc = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    GenTree* tree = BenchmarkCreateTree(nbNode, NULL);
+    double sumIter = 0.0;
+    double start = BenchmarkWallClock();
+    GenTreeIterDepth iter = GenTreeIterDepthCreateStatic(tree);
+    GenTreeIterApply(&iter, BenchmarkReduceSum, &sumIter);
+    GenTreeIterFreeStatic(&iter);
+    double timeIter = BenchmarkWallClock() - start;
+    for (int nbThread = 1; nbThread <= nbProc; nbThread *= 2) {
+      GenTreeThreadPool* pool = GenTreeThreadPoolCreate(nbThread);
+      double zero = 0.0;
+      double sum = 0.0;
+      start = BenchmarkWallClock();
+      GenTreeReduce(tree, &sum, &zero, sizeof(double), 
+        BenchmarkReduceMap, BenchmarkReduceCombine, NULL, pool);
+      double timeReduce = BenchmarkWallClock() - start;
+      double sumBottomUp = 0.0;
+      start = BenchmarkWallClock();
+      GenTreeReduceBottomUp(tree, &sumBottomUp, &zero, sizeof(double), 
+        BenchmarkReduceMap, BenchmarkReduceCombine, NULL, NULL, pool);
+      double timeBottomUp = BenchmarkWallClock() - start;
+      if (sum != sumIter || sumBottomUp != sumIter)
+        printf("reduce failed\n");
+      printf("%d,%d,%.3f,%.3f,%.3f\n", nbNode, nbThread, timeIter, 
+        timeReduce, timeBottomUp);
+      GenTreeThreadPoolFree(&pool);
+    }
+    GenTreeFree(&tree);
+  }
+}
+
+void BenchmarkGenTreeIterUpdateParallel() {
+  printf("BenchmarkGenTreeIterUpdateParallel\n");
+  printf("nbNode,nbThread,depth(ms),depthParallel(ms),breadth(ms),"
+    "breadthParallel(ms),value(ms),valueParallel(ms)\n");
+  int nbProc = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    GenTree* tree = BenchmarkCreateTree(nbNode, NULL);
+    GenTreeIterDepth depth = GenTreeIterDepthCreateStatic(tree);
+    GenTreeIterBreadth breadth = GenTreeIterBreadthCreateStatic(tree);
+    GenTreeIterValue value = GenTreeIterValueCreateStatic(tree);
+    for (int nbThread = 1; nbThread <= nbProc; nbThread *= 2) {
+      GenTreeThreadPool* pool = GenTreeThreadPoolCreate(nbThread);
+      double times[6];
+      for (int iUpdate = 0; iUpdate < 6; ++iUpdate) {
+        BenchmarkTouchTree(tree);
+        double start = BenchmarkWallClock();
+        switch (iUpdate) {
+          case 0: GenTreeIterUpdate(&depth); break;
+          case 1: GenTreeIterUpdateParallel(&depth, pool); break;
+          case 2: GenTreeIterUpdate(&breadth); break;
+          case 3: GenTreeIterUpdateParallel(&breadth, pool); break;
+          case 4: GenTreeIterUpdate(&value); break;
+          default: GenTreeIterUpdateParallel(&value, pool); break;
+        }
+        times[iUpdate] = BenchmarkWallClock() - start;
+      }
+      printf("%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", nbNode, nbThread, 
+        times[0], times[1], times[2], times[3], times[4], times[5]);
+      GenTreeThreadPoolFree(&pool);
+    }
+    GenTreeIterFreeStatic(&depth);
+    GenTreeIterFreeStatic(&breadth);
+    GenTreeIterFreeStatic(&value);
+    GenTreeFree(&tree);
+  }
+}
+
+// Number of rounds of edits and updates of BenchmarkGenTreeIterPatch
+#define BENCHMARK_NBPATCHROUND 100
+
+// Number of edits per round of BenchmarkGenTreeIterPatch
+#define BENCHMARK_NBPATCHEDIT 5
+
+void BenchmarkGenTreeIterPatch() {
+  printf("BenchmarkGenTreeIterPatch\n");
+  printf("nbNode,patch(ms),rebuild(ms)\n");
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    GenTree* tree = BenchmarkCreateTree(nbNode, NULL);
+    GenTreeIterDepth patched = GenTreeIterDepthCreateStatic(tree);
+    GenTreeIterDepth rebuilt = GenTreeIterDepthCreateStatic(tree);
+    double timePatch = 0.0;
+    double timeRebuild = 0.0;
+    for (int iRound = 0; iRound < BENCHMARK_NBPATCHROUND; ++iRound) {
+      // A few appends and cuts between two traversals
+      for (int iEdit = 0; iEdit < BENCHMARK_NBPATCHEDIT; ++iEdit) {
+        GenTree* node = GenTreeSelect(tree, rand() % GenTreeGetSize(tree));
+        GenTreeAppendData(node, NULL);
+        node = GenTreeSelect(tree, rand() % GenTreeGetSize(tree));
+        if (GenTreeIsLeaf(node))
+          GenTreeFree(&node);
+      }
+      double start = BenchmarkWallClock();
+      GenTreeIterUpdate(&patched);
+      timePatch += BenchmarkWallClock() - start;
+      // Attaching the iterator again drops its sequence
+      start = BenchmarkWallClock();
+      GenTreeIterSetGenTree(&rebuilt, tree);
+      timeRebuild += BenchmarkWallClock() - start;
+    }
+    printf("%d,%.3f,%.3f\n", nbNode, timePatch / BENCHMARK_NBPATCHROUND, 
+      timeRebuild / BENCHMARK_NBPATCHROUND);
+    GenTreeIterFreeStatic(&patched);
+    GenTreeIterFreeStatic(&rebuilt);
+    GenTreeFree(&tree);
+  }
+}
+
+#define BENCHMARK_NBREADLOCK 1000000
+
+// Copy the GenTree 'tree' node by node into the GenTree 'copy'
+void BenchmarkCloneNodeByNode(const GenTree* const tree, 
+  GenTree* const copy) {
+  GSetElem* elem = ((const GSet*)GenTreeSubtrees(tree))->_head;
+  while (elem != NULL) {
+    GenTreeAddSortData(copy, GenTreeData((GenTree*)(elem->_data)), 
+      elem->_sortVal);
+    BenchmarkCloneNodeByNode(elem->_data, 
+      ((const GSet*)GenTreeSubtrees(copy))->_tail->_data);
+    elem = elem->_next;
+  }
+}
+
+void BenchmarkGenTreeMoveGraft() {
+  printf("BenchmarkGenTreeMoveGraft\n");
+  printf("nbNode,popAppend(ms),graft(ms),cutPush(ms),move(ms)\n");
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    // The nodes are the subtrees of the first subtree of a tree, each 
+    // with one subtree
+    GenTree* tree = GenTreeCreate();
+    GenTreeAppendData(tree, NULL);
+    GenTreeAppendData(tree, NULL);
+    GenTree* from = GenTreeSubtree(tree, 0);
+    GenTree* to = GenTreeSubtree(tree, 1);
+    for (int iNode = 0; iNode < nbNode; ++iNode) {
+      GenTreeAppendData(from, NULL);
+      GenTreeAppendData(GenTreeLastSubtree(from), NULL);
+    }
+    // Move all the subtrees one by one, then at once
+    double start = BenchmarkWallClock();
+    while (GenTreeFirstSubtree(from) != NULL)
+      GenTreeAppendSubtree(to, GenTreePopSubtree(from));
+    double timePopAppend = BenchmarkWallClock() - start;
+    start = BenchmarkWallClock();
+    GenTreeGraftChildren(to, from);
+    double timeGraft = BenchmarkWallClock() - start;
+    // Move the subtrees one by one to the other node and back
+    start = BenchmarkWallClock();
+    while (GenTreeFirstSubtree(from) != NULL) {
+      GenTree* node = GenTreeFirstSubtree(from);
+      GenTreeCut(node);
+      GenTreePushSubtree(to, node);
+    }
+    double timeCutPush = BenchmarkWallClock() - start;
+    start = BenchmarkWallClock();
+    for (int iNode = 0; iNode < nbNode; ++iNode)
+      GenTreeMoveSubtree(GenTreeFirstSubtree(to), from, 0);
+    double timeMove = BenchmarkWallClock() - start;
+    if (GenTreeGetSize(from) != 2 * nbNode ||
+      GenTreeGetSize(to) != 0)
+      printf("move failed\n");
+    printf("%d,%.3f,%.3f,%.3f,%.3f\n", nbNode, timePopAppend, timeGraft,
+      timeCutPush, timeMove);
+    GenTreeFree(&tree);
+  }
+}
+
+void BenchmarkGenTreeClone() {
+  printf("BenchmarkGenTreeClone\n");
+  printf("nbNode,nbThread,nodeByNode(ms),clone(ms),cloneParallel(ms)\n");
+  int nbProc = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    GenTree* tree = BenchmarkCreateTree(nbNode, NULL);
+    double start = BenchmarkWallClock();
+    GenTree* copy = GenTreeCreate();
+    BenchmarkCloneNodeByNode(tree, copy);
+    double timeNodeByNode = BenchmarkWallClock() - start;
+    GenTreeFree(&copy);
+    start = BenchmarkWallClock();
+    GenTree* clone = GenTreeClone(tree, NULL);
+    double timeClone = BenchmarkWallClock() - start;
+    GenTreeFree(&clone);
+    for (int nbThread = 1; nbThread <= nbProc; nbThread *= 2) {
+      GenTreeThreadPool* pool = GenTreeThreadPoolCreate(nbThread);
+      start = BenchmarkWallClock();
+      clone = GenTreeCloneParallel(tree, NULL, pool);
+      double timeParallel = BenchmarkWallClock() - start;
+      if (GenTreeGetSize(clone) != GenTreeGetSize(tree))
+        printf("clone failed\n");
+      GenTreeFree(&clone);
+      printf("%d,%d,%.3f,%.3f,%.3f\n", nbNode, nbThread, timeNodeByNode,
+        timeClone, timeParallel);
+      GenTreeThreadPoolFree(&pool);
+    }
+    GenTreeFree(&tree);
+  }
+}
+
+void BenchmarkGenTreeRcu() {
+  printf("BenchmarkGenTreeRcu\n");
+  printf("nbNode,publish(ms),readLock(ns),readDepth(ms),iterDepth(ms)\n");
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    int* data = PBErrMalloc(GenTreeErr, sizeof(int) * nbNode);
+    for (int iNode = 0; iNode < nbNode; ++iNode)
+      data[iNode] = iNode;
+    GenTree* tree = BenchmarkCreateTree(nbNode, data);
+    GenTreeRcu* rcu = GenTreeRcuCreate(tree);
+    GenTreeRcuReader* reader = GenTreeRcuReaderCreate(rcu);
+    BenchmarkTouchTree(tree);
+    // Publish the modification of one node, the unmodified subtrees 
+    // are shared with the previous snapshot
+    GenTreeSetData(GenTreeSubtree(tree, 0), data);
+    double start = BenchmarkWallClock();
+    GenTreeRcuPublish(rcu);
+    double timePublish = BenchmarkWallClock() - start;
+    // Cost of entering and leaving a read section
+    long nbRead = 0;
+    start = BenchmarkWallClock();
+    for (int iLock = 0; iLock < BENCHMARK_NBREADLOCK; ++iLock) {
+      const GenTreePersist* root = GenTreeRcuReadLock(reader);
+      nbRead += GenTreePersistGetSize(root) + 1;
+      GenTreeRcuReadUnlock(reader);
+    }
+    double timeLock = (BenchmarkWallClock() - start) * 1e6 / 
+      (double)BENCHMARK_NBREADLOCK;
+    // Run through a snapshot compared to an iterator on the tree
+    long sum = 0;
+    start = BenchmarkWallClock();
+    const GenTreePersist* root = GenTreeRcuReadLock(reader);
+    // Depth first run with a stack, the root isn't in the steps of the
+    // iterator
+    const GenTreePersist** stack = 
+      PBErrMalloc(GenTreeErr, sizeof(GenTreePersist*) * nbNode);
+    int nbStack = 0;
+    for (int iSubtree = GenTreePersistNbSubtree(root); iSubtree--;)
+      stack[nbStack++] = GenTreePersistSubtree(root, iSubtree);
+    while (nbStack > 0) {
+      const GenTreePersist* node = stack[--nbStack];
+      sum += *(int*)GenTreePersistData(node);
+      for (int iSubtree = GenTreePersistNbSubtree(node); iSubtree--;)
+        stack[nbStack++] = GenTreePersistSubtree(node, iSubtree);
+    }
+    free(stack);
+    GenTreeRcuReadUnlock(reader);
+    double timeRead = BenchmarkWallClock() - start;
+    long sumIter = 0;
+    start = BenchmarkWallClock();
+    GenTreeIterDepth iter = GenTreeIterDepthCreateStatic(tree);
+    do {
+      sumIter += *(int*)GenTreeIterGetData(&iter);
+    } while (GenTreeIterStep(&iter));
+    GenTreeIterFreeStatic(&iter);
+    double timeIter = BenchmarkWallClock() - start;
+    if (nbRead != (long)BENCHMARK_NBREADLOCK * nbNode || 
+      sum != sumIter)
+      printf("rcu failed\n");
+    printf("%d,%.3f,%.1f,%.3f,%.3f\n", nbNode, timePublish, timeLock, 
+      timeRead, timeIter);
+    GenTreeRcuReaderFree(&reader);
+    GenTreeRcuFree(&rcu);
+    GenTreeFree(&tree);
+    free(data);
+  }
+}
+
+#define BENCHMARK_CONCURRENT_NBNODE 200000
+#define BENCHMARK_CONCURRENT_MAXTHREAD 32
+
+// Parameters of the threads of BenchmarkGenTreeConcurrent
+typedef struct BenchmarkConcurrentParam {
+  GenTreeConcurrent* _conc;
+  pthread_mutex_t* _mutex;
+  GenTree* _node;
+  int _nbNode;
+} BenchmarkConcurrentParam;
+
+// Append nodes with the GenTreeConcurrent on two levels below the 
+// thread's node: one node in 16 to the thread's node, the others to the
+// last of them
+void* BenchmarkConcurrentAppend(void* arg) {
+  BenchmarkConcurrentParam* param = arg;
+  GenTree* node = NULL;
+  for (int iNode = 0; iNode < param->_nbNode; ++iNode) {
+    if (iNode % 16 == 0)
+      node = GenTreeConcurrentAppendData(param->_conc, param->_node, 
+        NULL);
+    else
+      GenTreeConcurrentAppendData(param->_conc, node, NULL);
+  }
+  return NULL;
+}
+
+// Append the same nodes under a global lock
+void* BenchmarkConcurrentAppendGlobal(void* arg) {
+  BenchmarkConcurrentParam* param = arg;
+  GenTree* node = NULL;
+  for (int iNode = 0; iNode < param->_nbNode; ++iNode) {
+    pthread_mutex_lock(param->_mutex);
+    if (iNode % 16 == 0) {
+      GenTreeAppendData(param->_node, NULL);
+      node = ((const GSet*)GenTreeSubtrees(param->_node))->_tail->_data;
+    } else
+      GenTreeAppendData(node, NULL);
+    pthread_mutex_unlock(param->_mutex);
+  }
+  return NULL;
+}
+
+// Run 'nbThread' threads appending nodes, to the root if 'isShared' is
+// true, else to a node per thread, with the GenTreeConcurrent if 
+// 'isGlobal' is false, else under a global lock
+// Return the time in ms
+double BenchmarkConcurrentRun(const int nbThread, const bool isShared, 
+  const bool isGlobal) {
+  GenTree* tree = GenTreeCreate();
+  GenTreeConcurrent* conc = GenTreeConcurrentCreate(tree);
+  pthread_mutex_t mutex;
+  pthread_mutex_init(&mutex, NULL);
+  pthread_t threads[BENCHMARK_CONCURRENT_MAXTHREAD];
+  BenchmarkConcurrentParam params[BENCHMARK_CONCURRENT_MAXTHREAD];
+  for (int iThread = 0; iThread < nbThread; ++iThread) {
+    params[iThread]._conc = conc;
+    params[iThread]._mutex = &mutex;
+    params[iThread]._nbNode = BENCHMARK_CONCURRENT_NBNODE / nbThread;
+    if (isShared)
+      params[iThread]._node = tree;
+    else {
+      GenTreeAppendData(tree, NULL);
+      params[iThread]._node = GenTreeSubtree(tree, iThread);
+    }
+  }
+  double start = BenchmarkWallClock();
+  for (int iThread = 0; iThread < nbThread; ++iThread)
+    pthread_create(threads + iThread, NULL, (isGlobal ? 
+      BenchmarkConcurrentAppendGlobal : BenchmarkConcurrentAppend), 
+      params + iThread);
+  for (int iThread = 0; iThread < nbThread; ++iThread)
+    pthread_join(threads[iThread], NULL);
+  double time = BenchmarkWallClock() - start;
+  if (GenTreeGetSize(tree) != (isShared ? 0 : nbThread) + 
+    nbThread * (BENCHMARK_CONCURRENT_NBNODE / nbThread))
+    printf("concurrent failed\n");
+  pthread_mutex_destroy(&mutex);
+  GenTreeConcurrentFree(&conc);
+  GenTreeFree(&tree);
+  return time;
+}
+
+void BenchmarkGenTreeConcurrent() {
+  printf("BenchmarkGenTreeConcurrent\n");
+  printf("nbNode,nbThread,distinctGlobal(ms),distinct(ms),"
+    "sharedGlobal(ms),shared(ms)\n");
+  for (int nbThread = 1; nbThread <= BENCHMARK_CONCURRENT_MAXTHREAD; 
+    nbThread *= 2) {
+    double times[4];
+    for (int iRun = 0; iRun < 4; ++iRun)
+      times[iRun] = BenchmarkConcurrentRun(nbThread, iRun >= 2, 
+        iRun % 2 == 0);
+    printf("%d,%d,%.3f,%.3f,%.3f,%.3f\n", BENCHMARK_CONCURRENT_NBNODE, 
+      nbThread, times[0], times[1], times[2], times[3]);
+  }
+}
+
+// Number of edits of the benchmarked persistent trees
+#define BENCHMARK_NBPERSISTEDIT 100
+
+void BenchmarkGenTreePersist() {
+  printf("BenchmarkGenTreePersist\n");
+  printf("nbNode,create(ms),cloneEdit(us),persistEdit(us)\n");
+  for (int iSize = 0; iSize < NB_SIZE; ++iSize) {
+    int nbNode = benchmarkSize[iSize];
+    int* data = PBErrMalloc(GenTreeErr, sizeof(int) * nbNode);
+    // Create a random persistent tree, each node being added to a 
+    // randomly chosen previous node
+    double start = BenchmarkWallClock();
+    GenTreePersist* persist = GenTreePersistCreate(data);
+    for (int iNode = 1; iNode < nbNode; ++iNode) {
+      GenTreePersist* next = GenTreePersistAddSortData(persist, 
+        rand() % iNode, data + iNode, (float)(rand() % 1000));
+      GenTreePersistFree(&persist);
+      persist = next;
+    }
+    double timeCreate = BenchmarkWallClock() - start;
+    GenTree* tree = BenchmarkCreateTree(nbNode, data);
+    // Snapshot then edit, keeping all the versions: a copy of the whole
+    // tree for the GenTree, the path to the edited node for the 
+    // persistent tree
+    GenTree* clones[BENCHMARK_NBPERSISTEDIT];
+    start = BenchmarkWallClock();
+    for (int iEdit = 0; iEdit < BENCHMARK_NBPERSISTEDIT; ++iEdit) {
+      clones[iEdit] = GenTreeClone(tree, NULL);
+      GenTreeSetData(GenTreeSelect(tree, rand() % (nbNode - 1)), data);
+    }
+    double timeClone = (BenchmarkWallClock() - start) * 1e3 / 
+      (double)BENCHMARK_NBPERSISTEDIT;
+    GenTreePersist* versions[BENCHMARK_NBPERSISTEDIT];
+    start = BenchmarkWallClock();
+    for (int iEdit = 0; iEdit < BENCHMARK_NBPERSISTEDIT; ++iEdit) {
+      versions[iEdit] = GenTreePersistRetain(persist);
+      GenTreePersist* next = 
+        GenTreePersistSetData(persist, rand() % nbNode, data);
+      GenTreePersistFree(&persist);
+      persist = next;
+    }
+    double timePersist = (BenchmarkWallClock() - start) * 1e3 / 
+      (double)BENCHMARK_NBPERSISTEDIT;
+    if (GenTreePersistGetSize(persist) != GenTreeGetSize(tree))
+      printf("persist failed\n");
+    printf("%d,%.3f,%.3f,%.3f\n", nbNode, timeCreate, timeClone, 
+      timePersist);
+    for (int iEdit = 0; iEdit < BENCHMARK_NBPERSISTEDIT; ++iEdit) {
+      GenTreeFree(clones + iEdit);
+      GenTreePersistFree(versions + iEdit);
+    }
+    GenTreePersistFree(&persist);
+    GenTreeFree(&tree);
+    free(data);
+  }
+}
+
+void BenchmarkAll() {
+  BenchmarkGenTreeIterBreadth();
+  BenchmarkGenTreeIterValue();
+  BenchmarkGenTreeIndex();
+  BenchmarkGenTreeSubtreeArray();
+  BenchmarkGenTreeSubtreeSkipList();
+  BenchmarkGenTreeBatch();
+  BenchmarkGenTreeFromParents();
+  BenchmarkGenTreeParallelApply();
+  BenchmarkGenTreeReduce();
+  BenchmarkGenTreeIterUpdateParallel();
+  BenchmarkGenTreeIterPatch();
+  BenchmarkGenTreeClone();
+  BenchmarkGenTreeMoveGraft();
+  BenchmarkGenTreeRcu();
+  BenchmarkGenTreeConcurrent();
+  BenchmarkGenTreePersist();
+}
+
+int main() {
+  srand(RANDOMSEED);
+  BenchmarkAll();
+  // Return success code
+  return 0;
+}
@@ -34,6 +34,38 @@ GenTree* _GenTreeParent(const GenTree* const that) {
   return that->_parent;
 }
 
+// Return the next brother of the GenTree 'that', null if it is the last
+// of its brotherhood or a root
+#if BUILDMODE != 0
+static inline
+#endif
+GenTree* _GenTreeNextSibling(const GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return (that->_link._next != NULL ? that->_link._next->_data : NULL);
+}
+
+// Return the previous brother of the GenTree 'that', null if it is the
+// first of its brotherhood or a root
+#if BUILDMODE != 0
+static inline
+#endif
+GenTree* _GenTreePrevSibling(const GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return (that->_link._prev != NULL ? that->_link._prev->_data : NULL);
+}
+
 // Set the user data of the GenTree 'that' to 'data'
 #if BUILDMODE != 0
 static inline
@@ -46,14 +78,37 @@ void _GenTreeSetData(GenTree* const that, void* const data) {
     PBErrCatch(GSetErr);
   }
 #endif
-  that->_data = data;
+  // If the node is in an index, move it to the bucket of its new data
+  if (GenTreeGetIndex(that) != NULL && that->_parent != NULL) {
+    GenTreeIndex* index = GenTreeGetIndex(that);
+    GenTreeIndexRemove(index, that);
+    that->_data = data;
+    GenTreeIndexAdd(index, that);
+  } else {
+    that->_data = data;
+  }
 }
 
 // Get the set of subtrees of the GenTree 'that'
 #if BUILDMODE != 0
 static inline
 #endif
-GSetGenTree* _GenTreeSubtrees(const GenTree* const that) {
+const GSetGenTree* _GenTreeSubtrees(const GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GSetErr->_msg, "'that' is null");
+    PBErrCatch(GSetErr);
+  }
+#endif
+  return &(that->_subtrees);
+}
+
+// Get the pool of the GenTree 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+GenTreePool* _GenTreeGetPool(const GenTree* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
@@ -61,7 +116,118 @@ GSetGenTree* _GenTreeSubtrees(const GenTree* const that) {
     PBErrCatch(GSetErr);
   }
 #endif
-  return (GSetGenTree*)&(that->_subtrees);
+  return that->_pool;
+}
+
+// Get the sort value of the GenTree 'that' in the subtrees of its 
+// parent
+#if BUILDMODE != 0
+static inline
+#endif
+float _GenTreeSortVal(const GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_link._sortVal;
+}
+
+// Get the generation of the GenTree 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned long _GenTreeGen(const GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_gen;
+}
+
+// Return the number of subtrees of the GenTree 'that' and their subtrees 
+// recursively
+#if BUILDMODE != 0
+static inline
+#endif
+int _GenTreeGetSize(const GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_size;
+}
+
+// Return the array of subtrees of the GenTree 'that', null if it has 
+// none
+#if BUILDMODE != 0
+static inline
+#endif
+GenTree** GenTreeGetSubtreeArr(const GenTree* const that) {
+  return (that->_extra != NULL ? that->_extra->_subtreeArr : NULL);
+}
+
+// Return the skip list over the subtrees of the GenTree 'that', null 
+// if it has none
+#if BUILDMODE != 0
+static inline
+#endif
+GenTreeSkipList* GenTreeGetSkipList(const GenTree* const that) {
+  return (that->_extra != NULL ? that->_extra->_skipList : NULL);
+}
+
+// Return the index of the tree the GenTree 'that' belongs to, null if
+// it's not indexed
+// The index is owned by the root of the tree, this function climbs up
+// to it
+#if BUILDMODE != 0
+static inline
+#endif
+GenTreeIndex* GenTreeGetIndex(const GenTree* const that) {
+  const GenTree* root = that;
+  while (root->_parent != NULL)
+    root = root->_parent;
+  return (root->_extra != NULL ? root->_extra->_index : NULL);
+}
+
+// Return true if the GenTree 'that' has an array of subtrees
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif
+bool GenTreeHasSubtreeArray(const GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return (GenTreeGetSubtreeArr(that) != NULL);
+}
+
+// Return true if the GenTree 'that' has a skip list over its subtrees
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif
+bool GenTreeHasSubtreeSkipList(const GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return (GenTreeGetSkipList(that) != NULL);
 }
 
 // Return true if the GenTree 'that' is a root
@@ -109,11 +275,60 @@ bool _GenTreeIsLastBrother(const GenTree* const that) {
     PBErrCatch(GSetErr);
   }
 #endif
-  if (that->_parent == NULL)
-    return true;
-  else {
-    return (GSetTail(&(that->_parent->_subtrees)) == that);
+  return (that->_link._next == NULL);
+}
+
+// ----------- GenTreePool
+
+// ================ Functions declaration ====================
+
+// ================ Functions implementation ====================
+
+// Return true if the GenTreePool 'that' is in arena mode
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif
+bool GenTreePoolIsArena(const GenTreePool* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_isArena;
+}
+
+// Return the number of nodes currently in use in the GenTreePool 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+long GenTreePoolGetNbLive(const GenTreePool* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_nbLive;
+}
+
+// Return the number of nodes served from the freelist of the 
+// GenTreePool 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+long GenTreePoolGetNbRecycled(const GenTreePool* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
   }
+#endif
+  return that->_nbRecycled;
 }
 
 // ----------- GenTreeIter
@@ -134,7 +349,7 @@ void _GenTreeIterReset(GenTreeIter* const that) {
     PBErrCatch(GSetErr);
   }
 #endif
-  that->_curPos = ((GSet*)&(that->_seq))->_head;
+  that->_curPos = 0;
 }
 
 // Reset the iterator 'that' to its end position
@@ -149,7 +364,7 @@ void _GenTreeIterToEnd(GenTreeIter* const that) {
     PBErrCatch(GSetErr);
   }
 #endif
-  that->_curPos = ((GSet*)&(that->_seq))->_tail;
+  that->_curPos = (that->_nbNode > 0 ? that->_nbNode - 1 : 0);
 }
 
 // Step the iterator 'that' at its next position
@@ -165,14 +380,14 @@ bool _GenTreeIterStep(GenTreeIter* const that) {
     sprintf(GSetErr->_msg, "'that' is null");
     PBErrCatch(GSetErr);
   }
-  if (that->_curPos == NULL) {
+  if (that->_nbNode == 0) {
     GenTreeErr->_type = PBErrTypeInvalidArg;
-    sprintf(GSetErr->_msg, "'that->_curPos' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "the sequence is empty");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  if (that->_curPos->_next != NULL) {
-    that->_curPos = that->_curPos->_next;
+  if (that->_curPos < that->_nbNode - 1) {
+    ++(that->_curPos);
     return true;
   }
   return false;
@@ -191,14 +406,14 @@ bool _GenTreeIterStepBack(GenTreeIter* const that) {
     sprintf(GSetErr->_msg, "'that' is null");
     PBErrCatch(GSetErr);
   }
-  if (that->_curPos == NULL) {
+  if (that->_nbNode == 0) {
     GenTreeErr->_type = PBErrTypeInvalidArg;
-    sprintf(GSetErr->_msg, "'that->_curPos' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "the sequence is empty");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  if (that->_curPos->_prev != NULL) {
-    that->_curPos = that->_curPos->_prev;
+  if (that->_curPos > 0) {
+    --(that->_curPos);
     return true;
   }
   return false;
@@ -229,14 +444,12 @@ void _GenTreeIterApply(GenTreeIter* const that,
 #endif
   // Reset the iterator;
   GenTreeIterReset(that);
-  // If the associated tree is not empty
-  if (GSetNbElem(&(that->_seq)) > 0) {
-    // For each node of the tree
-    do {
-      // Apply the user function
-      fun(GenTreeIterGetData(that), param);
-    } while (GenTreeIterStep(that));
-  }
+  // For each node of the tree
+  for (; that->_curPos < that->_nbNode; ++(that->_curPos))
+    // Apply the user function
+    fun(that->_seq[that->_curPos]->_data, param);
+  // Stay on the last node
+  GenTreeIterToEnd(that);
 }
 
 // Return true if the iterator is at the start of the elements (from
@@ -253,7 +466,7 @@ bool _GenTreeIterIsFirst(const GenTreeIter* const that) {
     PBErrCatch(GSetErr);
   }
 #endif
-  return (that->_curPos == ((GSet*)&(that->_seq))->_head);
+  return (that->_curPos == 0);
 }
 
 // Return true if the iterator is at the end of the elements (from
@@ -270,7 +483,7 @@ bool _GenTreeIterIsLast(const GenTreeIter* const that) {
     PBErrCatch(GSetErr);
   }
 #endif
-  return (that->_curPos == ((GSet*)&(that->_seq))->_tail);
+  return (that->_curPos + 1 >= that->_nbNode);
 }
 
 // Change the attached tree of the iterator, and reset it
@@ -291,9 +504,14 @@ void _GenTreeIterDepthSetGenTree(GenTreeIterDepth* const that,
     PBErrCatch(GSetErr);
   }
 #endif
-  // Set the tree
+  // Set the tree and drop the sequence of the previous one, which 
+  // can't be patched
   ((GenTreeIter*)that)->_tree = tree;
-  // Update the sequence
+  ((GenTreeIter*)that)->_nbNode = 0;
+  ((GenTreeIter*)that)->_root = NULL;
+  // Update the sequence, the generation of the tree only increases 
+  // hence the iterator is stale until the update
+  ((GenTreeIter*)that)->_gen = tree->_gen - 1;
   GenTreeIterDepthUpdate(that);
   // Reset the iterator
   GenTreeIterReset(that);
@@ -315,9 +533,12 @@ void _GenTreeIterBreadthSetGenTree(GenTreeIterBreadth* const that,
     PBErrCatch(GSetErr);
   }
 #endif
-  // Set the tree
+  // Set the tree, the sequence of the previous one can't be patched
   ((GenTreeIter*)that)->_tree = tree;
-  // Update the sequence
+  ((GenTreeIter*)that)->_root = NULL;
+  // Update the sequence, the generation of the tree only increases 
+  // hence the iterator is stale until the update
+  ((GenTreeIter*)that)->_gen = tree->_gen - 1;
   GenTreeIterBreadthUpdate(that);
   // Reset the iterator
   GenTreeIterReset(that);
@@ -339,9 +560,12 @@ void _GenTreeIterValueSetGenTree(GenTreeIterValue* const that,
     PBErrCatch(GSetErr);
   }
 #endif
-  // Set the tree
+  // Set the tree, the sequence of the previous one can't be patched
   ((GenTreeIter*)that)->_tree = tree;
-  // Update the sequence
+  ((GenTreeIter*)that)->_root = NULL;
+  // Update the sequence, the generation of the tree only increases 
+  // hence the iterator is stale until the update
+  ((GenTreeIter*)that)->_gen = tree->_gen - 1;
   GenTreeIterValueUpdate(that);
   // Reset the iterator
   GenTreeIterReset(that);
@@ -358,13 +582,13 @@ void* _GenTreeIterGetData(const GenTreeIter* const that) {
     sprintf(GSetErr->_msg, "'that' is null");
     PBErrCatch(GSetErr);
   }
-  if (that->_curPos == NULL) {
+  if (that->_curPos >= that->_nbNode) {
     GenTreeErr->_type = PBErrTypeInvalidArg;
-    sprintf(GSetErr->_msg, "'that->_curPos' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "the sequence is empty");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  return ((GenTree*)(that->_curPos->_data))->_data;
+  return that->_seq[that->_curPos]->_data;
 }
 
 // Return the tree currently pointed to by the iterator
@@ -378,13 +602,13 @@ GenTree* _GenTreeIterGetGenTree(const GenTreeIter* const that) {
     sprintf(GSetErr->_msg, "'that' is null");
     PBErrCatch(GSetErr);
   }
-  if (that->_curPos == NULL) {
+  if (that->_curPos >= that->_nbNode) {
     GenTreeErr->_type = PBErrTypeInvalidArg;
-    sprintf(GSetErr->_msg, "'that->_curPos' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "the sequence is empty");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  return (GenTree*)(that->_curPos->_data);
+  return that->_seq[that->_curPos];
 }
 
 // Return the tree associated to the iterator 'that'
@@ -402,18 +626,848 @@ GenTree* _GenTreeIterGenTree(const GenTreeIter* const that) {
   return that->_tree;
 }
 
-// Return the sequaence of the iterator 'that'
+// Return the sequence of nodes of the iterator 'that'
 #if BUILDMODE != 0
 static inline
 #endif 
-GSetGenTree* _GenTreeIterSeq(const GenTreeIter* const that) {
+GenTree** _GenTreeIterSeq(const GenTreeIter* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'that' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_seq;
+}
+
+// Return the number of nodes in the sequence of the iterator 'that'
+#if BUILDMODE != 0
+static inline
+#endif 
+int _GenTreeIterGetNbNode(const GenTreeIter* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_nbNode;
+}
+
+// Return the index in the sequence of the current position of the 
+// iterator 'that'
+#if BUILDMODE != 0
+static inline
+#endif 
+int _GenTreeIterGetPos(const GenTreeIter* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_curPos;
+}
+
+// Move the iterator 'that' to the 'iPos'-th node of its sequence
+#if BUILDMODE != 0
+static inline
+#endif 
+void _GenTreeIterSeek(GenTreeIter* const that, const int iPos) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iPos < 0 || iPos >= that->_nbNode) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iPos' is invalid (0<=%d<%d)", 
+      iPos, that->_nbNode);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  that->_curPos = iPos;
+}
+
+// Return true if the attached tree of the iterator 'that' has been 
+// modified since the creation of its sequence, false else
+#if BUILDMODE != 0
+static inline
+#endif 
+bool _GenTreeIterIsStale(const GenTreeIter* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return (that->_gen != that->_tree->_gen);
+}
+
+// ----------- GenTreeIterDepthLazy
+
+// ================ Functions implementation ====================
+
+// Reset the iterator 'that' at its start position
+#if BUILDMODE != 0
+static inline
+#endif 
+void _GenTreeIterDepthLazyReset(GenTreeIterDepthLazy* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // The first node is the attached tree if it's not root, like 
+  // GenTreeIterDepth, else its first subtree
+  if (!GenTreeIsRoot(that->_tree)) {
+    that->_curNode = that->_tree;
+  } else {
+    GSetElem* head = ((GSet*)&(that->_tree->_subtrees))->_head;
+    that->_curNode = (head != NULL ? (GenTree*)(head->_data) : NULL);
+  }
+}
+
+// Reset the iterator 'that' at its end position
+#if BUILDMODE != 0
+static inline
+#endif 
+void _GenTreeIterDepthLazyToEnd(GenTreeIterDepthLazy* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // The last node is the deepest last subtree of the attached tree, or
+  // the attached tree itself if it has no subtree and it's not root
+  GenTree* node = that->_tree;
+  while (((GSet*)&(node->_subtrees))->_tail != NULL)
+    node = (GenTree*)(((GSet*)&(node->_subtrees))->_tail->_data);
+  that->_curNode = 
+    (node != that->_tree || !GenTreeIsRoot(node) ? node : NULL);
+}
+
+// Step the iterator 'that' at its next position
+// Return true if it could move to the next position
+// Return false if it's already at the last position
+#if BUILDMODE != 0
+static inline
+#endif 
+bool _GenTreeIterDepthLazyStep(GenTreeIterDepthLazy* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (that->_curNode == NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that->_curNode' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  GenTree* node = that->_curNode;
+  // If the current node has subtrees, the next node is its first one
+  GSetElem* head = ((GSet*)&(node->_subtrees))->_head;
+  if (head != NULL) {
+    that->_curNode = (GenTree*)(head->_data);
+    return true;
+  }
+  // Else the next node is the next brother of the current node or of 
+  // its nearest ancestor having one, below the attached tree
+  while (node != that->_tree) {
+    if (node->_link._next != NULL) {
+      that->_curNode = (GenTree*)(node->_link._next->_data);
+      return true;
+    }
+    node = node->_parent;
+  }
+  return false;
+}
+
+// Step back the iterator 'that' at its previous position
+// Return true if it could move to the previous position
+// Return false if it's already at the first position
+#if BUILDMODE != 0
+static inline
+#endif 
+bool _GenTreeIterDepthLazyStepBack(GenTreeIterDepthLazy* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (that->_curNode == NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that->_curNode' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  return (GSetGenTree*)&(that->_seq);
+  GenTree* node = that->_curNode;
+  // If the current node is the attached tree it's the first node
+  if (node == that->_tree)
+    return false;
+  // If the current node is the first subtree of its parent, the 
+  // previous node is the parent, unless it's the attached tree and 
+  // it's root
+  if (node->_link._prev == NULL) {
+    if (node->_parent == that->_tree && GenTreeIsRoot(that->_tree))
+      return false;
+    that->_curNode = node->_parent;
+    return true;
+  }
+  // Else the previous node is the deepest last subtree of the previous
+  // brother
+  node = (GenTree*)(node->_link._prev->_data);
+  while (((GSet*)&(node->_subtrees))->_tail != NULL)
+    node = (GenTree*)(((GSet*)&(node->_subtrees))->_tail->_data);
+  that->_curNode = node;
+  return true;
 }
 
+// Apply a function to all elements' data of the GenTree of the iterator
+// The iterator is first reset, then the function is apply sequencially
+// using the Step function of the iterator
+#if BUILDMODE != 0
+static inline
+#endif 
+void _GenTreeIterDepthLazyApply(GenTreeIterDepthLazy* const that, 
+  void(*fun)(void* const data, void* const param), void* const param) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (fun == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'fun' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Reset the iterator
+  _GenTreeIterDepthLazyReset(that);
+  // If the sequence is empty there is nothing to do
+  if (that->_curNode == NULL)
+    return;
+  // Loop on elements
+  do {
+    // Apply the user function
+    fun(that->_curNode->_data, param);
+  } while (_GenTreeIterDepthLazyStep(that));
+}
+
+// Return true if the iterator is at the start of the elements
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif 
+bool _GenTreeIterDepthLazyIsFirst(
+  const GenTreeIterDepthLazy* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  if (!GenTreeIsRoot(that->_tree))
+    return (that->_curNode == that->_tree);
+  GSetElem* head = ((GSet*)&(that->_tree->_subtrees))->_head;
+  return (that->_curNode == (head != NULL ? head->_data : NULL));
+}
+
+// Return true if the iterator is at the end of the elements
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif 
+bool _GenTreeIterDepthLazyIsLast(
+  const GenTreeIterDepthLazy* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // If the sequence is empty the iterator is at the end
+  if (that->_curNode == NULL)
+    return true;
+  // The current node is the last one if it has no subtree and neither 
+  // it nor its ancestors below the attached tree have a next brother
+  GenTree* node = that->_curNode;
+  if (((GSet*)&(node->_subtrees))->_head != NULL)
+    return false;
+  while (node != that->_tree) {
+    if (node->_link._next != NULL)
+      return false;
+    node = node->_parent;
+  }
+  return true;
+}
+
+// Change the attached tree of the iterator, and reset it
+#if BUILDMODE != 0
+static inline
+#endif 
+void _GenTreeIterDepthLazySetGenTree(GenTreeIterDepthLazy* const that, 
+  GenTree* const tree) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Set the tree
+  that->_tree = tree;
+  // Reset the iterator
+  _GenTreeIterDepthLazyReset(that);
+}
+
+// Return the user data of the tree currently pointed to by the iterator
+#if BUILDMODE != 0
+static inline
+#endif 
+void* _GenTreeIterDepthLazyGetData(
+  const GenTreeIterDepthLazy* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (that->_curNode == NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that->_curNode' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_curNode->_data;
+}
+
+// Return the tree currently pointed to by the iterator
+#if BUILDMODE != 0
+static inline
+#endif 
+GenTree* _GenTreeIterDepthLazyGetGenTree(
+  const GenTreeIterDepthLazy* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (that->_curNode == NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that->_curNode' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_curNode;
+}
+
+// Return the tree associated to the iterator 'that'
+#if BUILDMODE != 0
+static inline
+#endif 
+GenTree* _GenTreeIterDepthLazyGenTree(
+  const GenTreeIterDepthLazy* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_tree;
+}
+
+// ----------- GenTreeIndex
+
+// ================ Functions implementation ====================
+
+// Return true if the GenTree 'that' belongs to an indexed tree
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif
+bool GenTreeIsIndexed(const GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return (GenTreeGetIndex(that) != NULL);
+}
+
+// Return the number of nodes in the index of the tree the GenTree 
+// 'that' belongs to
+#if BUILDMODE != 0
+static inline
+#endif
+long GenTreeIndexGetNbNode(const GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeGetIndex(that) == NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that' is not indexed");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return GenTreeGetIndex(that)->_nbNode;
+}
+
+// ----------- GenTreeThreadPool
+
+// ================ Functions implementation ====================
+
+// Return the number of threads of the GenTreeThreadPool 'that', 
+// including the calling thread
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeThreadPoolGetNbThread(const GenTreeThreadPool* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_nbThread;
+}
+
+// ----------- GenTreeFrozen
+
+// ================ Functions declaration ====================
+
+// ================ Functions implementation ====================
+
+// Return the number of nodes of the GenTreeFrozen 'that', including 
+// its root
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenGetNbNode(const GenTreeFrozen* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_nbNode;
+}
+
+// Return the user data of the node 'iNode' of the GenTreeFrozen 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void* GenTreeFrozenData(const GenTreeFrozen* const that, 
+  const int iNode) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iNode < 0 || iNode >= that->_nbNode) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iNode' is invalid (0<=%d<%d)", iNode, 
+      that->_nbNode);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_data[iNode];
+}
+
+// Return the sort value of the node 'iNode' of the GenTreeFrozen 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+float GenTreeFrozenSortVal(const GenTreeFrozen* const that, 
+  const int iNode) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iNode < 0 || iNode >= that->_nbNode) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iNode' is invalid (0<=%d<%d)", iNode, 
+      that->_nbNode);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_sortVal[iNode];
+}
+
+// Return the index of the parent of the node 'iNode' of the 
+// GenTreeFrozen 'that', or -1 if 'iNode' is the root
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenParent(const GenTreeFrozen* const that, 
+  const int iNode) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iNode < 0 || iNode >= that->_nbNode) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iNode' is invalid (0<=%d<%d)", iNode, 
+      that->_nbNode);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_parent[iNode];
+}
+
+// Return the number of subtrees of the node 'iNode' of the 
+// GenTreeFrozen 'that' and their subtrees recursively
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenGetSize(const GenTreeFrozen* const that, 
+  const int iNode) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iNode < 0 || iNode >= that->_nbNode) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iNode' is invalid (0<=%d<%d)", iNode, 
+      that->_nbNode);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_size[iNode];
+}
+
+// Return the number of subtrees of the node 'iNode' of the 
+// GenTreeFrozen 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenNbSubtree(const GenTreeFrozen* const that, 
+  const int iNode) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iNode < 0 || iNode >= that->_nbNode) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iNode' is invalid (0<=%d<%d)", iNode, 
+      that->_nbNode);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_nbSubtree[iNode];
+}
+
+// Return the index of the 'iSubtree'-th subtree of the node 'iNode' of 
+// the GenTreeFrozen 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenSubtree(const GenTreeFrozen* const that, 
+  const int iNode, const int iSubtree) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iNode < 0 || iNode >= that->_nbNode) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iNode' is invalid (0<=%d<%d)", iNode, 
+      that->_nbNode);
+    PBErrCatch(GenTreeErr);
+  }
+  if (iSubtree < 0 || iSubtree >= that->_nbSubtree[iNode]) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iSubtree' is invalid (0<=%d<%d)", iSubtree, 
+      that->_nbSubtree[iNode]);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_subtrees[that->_firstSubtree[iNode] + iSubtree];
+}
+
+// Return the index of the 'iStep'-th node of the GenTreeFrozen 'that' 
+// in depth first order, root excluded, 'iStep' in [0, nbNode - 1[
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenDepth(const GenTreeFrozen* const that, 
+  const int iStep) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iStep < 0 || iStep >= that->_nbNode - 1) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iStep' is invalid (0<=%d<%d)", iStep, 
+      that->_nbNode - 1);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  (void)that;
+  return iStep + 1;
+}
+
+// Return the index of the 'iStep'-th node of the GenTreeFrozen 'that' 
+// in breadth first order, root excluded, 'iStep' in [0, nbNode - 1[
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenBreadth(const GenTreeFrozen* const that, 
+  const int iStep) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iStep < 0 || iStep >= that->_nbNode - 1) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iStep' is invalid (0<=%d<%d)", iStep, 
+      that->_nbNode - 1);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_breadth[iStep];
+}
+
+// Return the index of the 'iStep'-th node of the GenTreeFrozen 'that' 
+// in value first order, root excluded, 'iStep' in [0, nbNode - 1[
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenValue(const GenTreeFrozen* const that, 
+  const int iStep) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iStep < 0 || iStep >= that->_nbNode - 1) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iStep' is invalid (0<=%d<%d)", iStep, 
+      that->_nbNode - 1);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_value[iStep];
+}
+
+// ----------- GenTreeRcu
+
+// ================ Functions implementation ====================
+
+// Return the version of the latest snapshot published by the 
+// GenTreeRcu 'that'
+// To be called by the writer, readers use GenTreeRcuReaderGetVersion
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned long GenTreeRcuGetVersion(GenTreeRcu* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return atomic_load(&(that->_current))->_version;
+}
+
+// Enter a read section with the GenTreeRcuReader 'that' and return the
+// latest snapshot, which stays valid until GenTreeRcuReadUnlock
+// Read sections can't be nested
+#if BUILDMODE != 0
+static inline
+#endif
+const struct GenTreePersist* GenTreeRcuReadLock(
+  GenTreeRcuReader* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (that->_snapshot != NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that' is already in a read section");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Announce the epoch before getting the snapshot: if the writer 
+  // replaces it after, it sees the reader and keeps it
+  atomic_store(&(that->_epoch), atomic_load(&(that->_rcu->_epoch)));
+  that->_snapshot = atomic_load(&(that->_rcu->_current));
+  return that->_snapshot->_root;
+}
+
+// Leave the read section of the GenTreeRcuReader 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void GenTreeRcuReadUnlock(GenTreeRcuReader* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (that->_snapshot == NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that' is not in a read section");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  that->_snapshot = NULL;
+  atomic_store(&(that->_epoch), 0);
+}
+
+// Return the version of the snapshot read by the GenTreeRcuReader 
+// 'that' in its read section
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned long GenTreeRcuReaderGetVersion(
+  const GenTreeRcuReader* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (that->_snapshot == NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that' is not in a read section");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_snapshot->_version;
+}
+
+// ----------- GenTreePersist
+
+// ================ Functions implementation ====================
+
+// Return the user data of the node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void* GenTreePersistData(const GenTreePersist* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_data;
+}
+
+// Return the sort value of the node 'that' in the subtrees of its 
+// parent
+#if BUILDMODE != 0
+static inline
+#endif
+float GenTreePersistSortVal(const GenTreePersist* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_sortVal;
+}
+
+// Return the number of nodes in the subtrees of the node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreePersistGetSize(const GenTreePersist* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_size;
+}
+
+// Return the number of subtrees of the node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreePersistNbSubtree(const GenTreePersist* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_nbSubtree;
+}
+
+// Return the 'iSubtree'-th subtree of the node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+const GenTreePersist* GenTreePersistSubtree(
+  const GenTreePersist* const that, const int iSubtree) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iSubtree < 0 || iSubtree >= that->_nbSubtree) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iSubtree' is invalid (0<=%d<%d)", 
+      iSubtree, that->_nbSubtree);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  return that->_subtrees[iSubtree];
+}
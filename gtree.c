@@ -9,45 +9,311 @@
 
 // ================ Functions declaration ====================
 
-// Free the memory used by 'subtrees' recursively 
-void GenTreeFreeRec(GSetGenTree* subtrees);
+// Free the memory used by the subtrees of 'that' recursively 
+void GenTreeFreeRec(GenTree* const that);
+
+// Free the memory used by the node 'that', giving it back to its pool
+// if it has one
+void GenTreeFreeNode(GenTree* const that);
+
+// Free the optional state of the node 'that' and the memory it owns, 
+// if any
+void GenTreeFreeExtra(GenTree* const that);
+
+// Set the properties of the newly allocated node 'that' with the pool
+// 'pool' and the user data 'data'
+void GenTreeInitNode(GenTree* const that, GenTreePool* const pool, 
+  void* const data);
+
+// Create 'nb' nodes with the user data 'data' and the sort values 
+// 'sortVals' (0.0 if null), allocated together, and insert them in 
+// order in the subtrees of the GenTree 'that' before the element 'next'
+// (at the end if 'next' is null)
+void GenTreeLinkDataBatch(GenTree* const that, void** const data, 
+  const float* const sortVals, const int nb, GSetElem* const next);
+
+// Create a new GenTree from the 'nb' user data 'data' where 
+// 'parents'[i] is the index of the parent of the i-th node (-1 for the
+// root), linking the nodes in the order 'order' (indices of the nodes,
+// the root excluded), or in the order of their index if 'order' is 
+// null
+GenTree* GenTreeCreateFromParentsOrder(void** const data, 
+  const int* const parents, const float* const sortVals, const int nb,
+  const int* const order);
+
+// Copy of a GenTree by GenTreeClone and GenTreeCloneParallel
+typedef struct GenTreeCloneParam {
+  // Nodes of the copy in depth first order, the root first
+  GenTree* _nodes;
+  // Block of the nodes
+  GenTreeBlock* _block;
+  // Function copying the user data, null to keep the same data
+  void* (*_cloneData)(void* const data);
+} GenTreeCloneParam;
+
+// Allocate the nodes of the copy 'param' of the GenTree 'that' and 
+// initialize its root
+void GenTreeCloneInit(GenTreeCloneParam* const param, 
+  const GenTree* const that, void* (*cloneData)(void* const data));
+
+// Initialize the copies of the subtrees of the node 'node' and link 
+// them to its copy, the 'iClone'-th node of the copy 'param'
+void GenTreeCloneSubtrees(const GenTreeCloneParam* const param, 
+  const GenTree* const node, const long iClone);
+
+// Increment the generation of the GenTree 'that' and of its ancestors
+// and add 'deltaSize' to their size
+// Return the root of 'that'
+GenTree* GenTreeUpdateAncestors(GenTree* const that, const int deltaSize);
+
+// Return the edit log of the root 'root', or null if it has none
+GenTreeEditLog* GenTreeGetEditLog(const GenTree* const root);
+
+// Return the position in depth first order in the root 'root' of the 
+// subtree just removed from the subtrees of the GenTree 'parent', 
+// where it was after the element 'prev' (null if it was the first one)
+int GenTreeRemovedRank(const GenTree* const root, 
+  const GenTree* const parent, const GSetElem* const prev);
+
+// Add to the edit log 'log' of the root 'root' the edit 'op' of the 
+// 'nbNode' nodes starting at the position 'rank', the first one at the
+// depth 'depth' for an insertion, made when the generation of the root
+// was 'gen'
+// The log is emptied first if the root has been modified otherwise 
+// since its last edit, and released instead if no iterator has been 
+// updated during the last GENTREEEDITLOG_NBEDIT edits
+void GenTreeEditLogAdd(GenTreeEditLog* const log, GenTree* const root, 
+  const unsigned long gen, const GenTreeEditOp op, const int rank, 
+  const int nbNode, const int depth);
+
+// Return the number of ancestors of the GenTree 'that'
+int GenTreeNbAncestor(const GenTree* const that);
+
+// Sort the subtrees of the GenTree 'that' by sort value, invalidating 
+// the cached positions of the subtrees but leaving the generation of 
+// 'that' and its ancestors to the caller
+// Return true if the order of the subtrees has changed
+bool GenTreeSortSubtreesNoUpdate(GenTree* const that);
+
+// Sort the subtrees of the GenTree 'that' and of all its subtrees, in 
+// depth first order, with GenTreeSortSubtreesNoUpdate
+// Return true if the order of any subtrees has changed
+bool GenTreeSortSubtreesAll(GenTree* const that);
+
+// Link the element of the GenTree 'tree' in the subtrees of the 
+// GenTree 'that' before the element 'next' (at the end if 'next' is 
+// null), with the sort value 'sortVal', and update the array of 
+// subtrees and the skip list of 'that' if any
+// Only 'that' and 'tree' are modified, their index and ancestors are
+// left to the caller
+void GenTreeLinkElem(GenTree* const that, GenTree* const tree, 
+  GSetElem* const next, const float sortVal);
+
+// Unlink the element 'elem' (the _link of a subtree) from the subtrees
+// of the GenTree 'that', and update the array of subtrees and the skip
+// list of 'that' if any
+// Only 'that' and the subtree are modified, their index and ancestors 
+// are left to the caller
+// Return the subtree
+GenTree* GenTreeUnlinkElem(GenTree* const that, GSetElem* const elem);
+
+// Return the node following 'node' in depth first order among the 
+// subtrees of the GenTree 'tree', or null if 'node' is the last one
+GenTree* GenTreeNextNode(const GenTree* const tree, 
+  const GenTree* const node);
+
+// Return the first node of the GenTree 'tree' in post order (subtrees 
+// before their parent), the tree included
+GenTree* GenTreeFirstNodePostOrder(const GenTree* const tree);
+
+// Return the node following 'node' in post order (subtrees before their
+// parent) in the GenTree 'tree', the tree included, or null if 'node' 
+// is the tree
+GenTree* GenTreeNextNodePostOrder(const GenTree* const tree, 
+  const GenTree* const node);
+
+// Insert the GenTree 'tree' in the array of subtrees of the GenTree 
+// 'that' before the element 'next' (at the end if 'next' is null)
+void GenTreeSubtreeArrayInsert(GenTree* const that, GenTree* const tree, 
+  const GSetElem* const next);
+
+// Remove the GenTree 'tree' from the array of subtrees of the GenTree 
+// 'that'
+void GenTreeSubtreeArrayRemove(GenTree* const that, 
+  GenTree* const tree);
+
+// Return the position of the subtree 'subtree' in the array of 
+// subtrees of the GenTree 'that'
+int GenTreeSubtreeArrayPos(GenTree* const that, GenTree* const subtree);
+
+// Return the address of the pointer to the next node of the node 
+// 'node' at the level 'iLevel' in the GenTreeSkipList 'that'. If 'node'
+// is null return the address of the head of the level
+GenTree** GenTreeSkipListForward(GenTreeSkipList* const that, 
+  GenTree* const node, const int iLevel);
+
+// Return a random number of levels for a new node of the 
+// GenTreeSkipList 'that'
+int GenTreeSkipListRandomLevel(GenTreeSkipList* const that);
+
+// Set 'preds' to the last node of each level of the skip list of the 
+// GenTree 'that' whose sort value is strictly lower than 'sortVal' 
+// (or lower or equal if 'inclusive' is true). Null means the head of 
+// the level
+void GenTreeSkipListFindPreds(const GenTree* const that, 
+  const float sortVal, const bool inclusive, GenTree** const preds);
+
+// Return the element of the first subtree of the GenTree 'that' whose
+// sort value is strictly greater than 'sortVal' (or greater or equal 
+// if 'inclusive' is false), using its skip list
+GSetElem* GenTreeSkipListBound(const GenTree* const that, 
+  const float sortVal, const bool inclusive);
+
+// Insert the subtree 'tree' (already in the list of subtrees) in the
+// levels of the skip list of the GenTree 'that'
+void GenTreeSkipListInsert(GenTree* const that, GenTree* const tree);
+
+// Remove the subtree 'tree' from the levels of the skip list of the 
+// GenTree 'that'
+void GenTreeSkipListRemove(GenTree* const that, GenTree* const tree);
+
+// Get 'size' bytes from the current chunk of the GenTreePool 'that'
+void* GenTreePoolAlloc(GenTreePool* const that, const size_t size);
+
+// Get a node from the GenTreePool 'that'
+GenTree* GenTreePoolAllocNode(GenTreePool* const that);
+
+// Give back the node 'node' to the GenTreePool 'that'
+void GenTreePoolReleaseNode(GenTreePool* const that, GenTree* const node);
+
+// Free the optional states of the nodes allocated from the 
+// GenTreePool 'that' and the memory they own, without freeing the nodes
+void GenTreePoolFreeExtras(GenTreePool* const that);
+
+// Add the GenTree 'tree' and its subtrees to the GenTreeIndex 'that'
+void GenTreeIndexAddSubtree(GenTreeIndex* const that, GenTree* const tree);
+
+// Remove the GenTree 'tree' and its subtrees from the GenTreeIndex 
+// 'that'
+void GenTreeIndexRemoveSubtree(GenTreeIndex* const that, 
+  GenTree* const tree);
+
+// Search with the index of the tree the GenTree 'tree' belongs to the
+// node containing 'data' whose position in depth first order in the 
+// sequence of an iterator attached to 'tree' is the smallest one not 
+// less than 'from'
+// If 'seq' is not null it's the sequence of 'nbNode' nodes of an 
+// iterator attached to 'tree', and the search fails if a node 
+// containing 'data' is not at its depth first position in it
+// Set '*pos' to the position of the node, or to -1 if the search failed
+// Return the node, null if there is none or if the search failed
+GenTree* GenTreeIndexSearchFrom(const GenTree* const tree, 
+  const void* const data, const int from, GenTree* const* const seq,
+  const int nbNode, int* const pos);
 
 // ================ Functions implementation ====================
 
 // Create a new GenTree
 GenTree* GenTreeCreate(void) {
-  // Declare the new tree
-  GenTree *that = PBErrMalloc(GenTreeErr, sizeof(GenTree));
-  // Set properties
-  that->_parent = NULL;
-  that->_subtrees = GSetGenTreeCreateStatic();
-  that->_data = NULL;
-  // Return the tree
-  return that;  
+  // Return the new tree
+  return GenTreeCreateDataPool(NULL, NULL);
 }
 
 // Create a new static GenTree
 GenTree GenTreeCreateStatic(void) {
+  // Return the new tree
+  return GenTreeCreateStaticPool(NULL);
+}
+
+// Create a new GenTree with user data 'data'
+GenTree* GenTreeCreateData(void* const data) {
+  // Return the new tree
+  return GenTreeCreateDataPool(NULL, data);
+}
+
+// Create a new GenTree allocated from the GenTreePool 'pool'
+// If 'pool' is null the GenTree is allocated with malloc
+GenTree* GenTreeCreatePool(GenTreePool* const pool) {
+  // Return the new tree
+  return GenTreeCreateDataPool(pool, NULL);
+}
+
+// Create a new static GenTree whose nodes created with the *Data 
+// functions will be allocated from the GenTreePool 'pool'
+GenTree GenTreeCreateStaticPool(GenTreePool* const pool) {
   // Declare the new tree
   GenTree that;
   // Set properties
-  that._parent = NULL;
-  that._subtrees = GSetGenTreeCreateStatic();
-  that._data = NULL;
+  GenTreeInitNode(&that, pool, NULL);
+  // The link of a static tree can't point to the copy returned
+  that._link._data = NULL;
   // Return the tree
   return that;  
 }
 
-// Create a new GenTree with user data 'data'
-GenTree* GenTreeCreateData(void* const data) {
+// Create a new GenTree with user data 'data' allocated from the 
+// GenTreePool 'pool'
+// If 'pool' is null the GenTree is allocated with malloc
+GenTree* GenTreeCreateDataPool(GenTreePool* const pool, void* const data) {
   // Declare the new tree
-  GenTree *that = PBErrMalloc(GenTreeErr, sizeof(GenTree));
+  GenTree *that = NULL;
+  if (pool != NULL)
+    that = GenTreePoolAllocNode(pool);
+  else
+    that = PBErrMalloc(GenTreeErr, sizeof(GenTree));
   // Set properties
+  GenTreeInitNode(that, pool, data);
+  // Return the tree
+  return that;  
+}
+
+// Set the properties of the newly allocated node 'that' with the pool
+// 'pool' and the user data 'data'
+void GenTreeInitNode(GenTree* const that, GenTreePool* const pool, 
+  void* const data) {
   that->_parent = NULL;
   that->_subtrees = GSetGenTreeCreateStatic();
   that->_data = data;
-  // Return the tree
-  return that;  
+  that->_pool = pool;
+  that->_block = NULL;
+  that->_link._data = that;
+  that->_link._next = NULL;
+  that->_link._prev = NULL;
+  that->_link._sortVal = 0.0;
+  that->_gen = 0;
+  that->_size = 0;
+  that->_subtreesGen = 0;
+  that->_siblingIndex = 0;
+  that->_siblingGen = 0;
+  that->_extra = NULL;
+}
+
+// Return the optional state of the GenTree 'that', allocating it if 
+// the node has none yet
+GenTreeExtra* GenTreeGetExtra(GenTree* const that) {
+  if (that->_extra == NULL) {
+    GenTreeExtra* extra = PBErrMalloc(GenTreeErr, sizeof(GenTreeExtra));
+    extra->_subtreeArr = NULL;
+    extra->_subtreeArrCapacity = 0;
+    extra->_subtreeArrNbValid = 0;
+    extra->_skipList = NULL;
+    extra->_skipNext = NULL;
+    extra->_skipLevel = 0;
+    extra->_index = NULL;
+    extra->_editLog = NULL;
+    extra->_node = that;
+    // Register the optional state in the pool of the node
+    extra->_poolPrev = NULL;
+    extra->_poolNext = NULL;
+    if (that->_pool != NULL) {
+      extra->_poolNext = that->_pool->_extras;
+      if (extra->_poolNext != NULL)
+        extra->_poolNext->_poolPrev = extra;
+      that->_pool->_extras = extra;
+    }
+    that->_extra = extra;
+  }
+  return that->_extra;
 }
 
 // Free the memory used by the GenTree 'that'
@@ -63,19 +329,196 @@ void _GenTreeFree(GenTree** that) {
   if (!GenTreeIsRoot(*that))
     // Cut the tree
     GenTreeCut(*that);
+  // Free the index if the tree is indexed
+  GenTreeIndexFree(*that);
   // Free recursively the memory
-  GenTreeFreeRec(GenTreeSubtrees(*that));
-  free(*that);
+  GenTreeFreeRec(*that);
+  GenTreeFreeNode(*that);
   *that = NULL;
 }
 
-// Free the memory used by 'subtrees' recursively 
-void GenTreeFreeRec(GSetGenTree* subtrees) {
-  while (GSetNbElem(subtrees) > 0) {
-    GenTree* tree = GSetPop(subtrees);
-    GenTreeFreeRec(GenTreeSubtrees(tree));
-    free(tree);
+// Free the memory used by the subtrees of 'that' recursively 
+// The nodes are freed in post order, without recursion so the depth of
+// the tree is not limited by the C stack
+void GenTreeFreeRec(GenTree* const that) {
+  GenTree* node = GenTreeFirstNodePostOrder(that);
+  while (node != that) {
+    // Get the next node before freeing the current one
+    GenTree* next = GenTreeNextNodePostOrder(that, node);
+    GenTreeFreeNode(node);
+    node = next;
+  }
+  that->_subtrees = GSetGenTreeCreateStatic();
+}
+
+// Free the memory used by the node 'that', giving it back to its pool
+// if it has one
+void GenTreeFreeNode(GenTree* const that) {
+  GenTreeFreeExtra(that);
+  if (that->_pool != NULL)
+    GenTreePoolReleaseNode(that->_pool, that);
+  else if (that->_block != NULL) {
+    // The block is freed with its last node
+    --(that->_block->_nbLive);
+    if (that->_block->_nbLive == 0)
+      free(that->_block);
+  } else
+    free(that);
+}
+
+// Free the optional state of the node 'that' and the memory it owns, 
+// if any
+void GenTreeFreeExtra(GenTree* const that) {
+  GenTreeExtra* extra = that->_extra;
+  if (extra == NULL)
+    return;
+  // Unregister the optional state from the pool of the node
+  if (that->_pool != NULL) {
+    if (extra->_poolPrev != NULL)
+      extra->_poolPrev->_poolNext = extra->_poolNext;
+    else
+      that->_pool->_extras = extra->_poolNext;
+    if (extra->_poolNext != NULL)
+      extra->_poolNext->_poolPrev = extra->_poolPrev;
+  }
+  free(extra->_subtreeArr);
+  free(extra->_skipList);
+  free(extra->_skipNext);
+  free(extra->_editLog);
+  free(extra);
+  that->_extra = NULL;
+}
+
+// Increment the generation of the GenTree 'that' and of its ancestors
+// and add 'deltaSize' to their size
+// Return the root of 'that'
+GenTree* GenTreeUpdateAncestors(GenTree* const that, const int deltaSize) {
+  GenTree* node = that;
+  while (true) {
+    ++(node->_gen);
+    node->_size += deltaSize;
+    if (node->_parent == NULL)
+      return node;
+    node = node->_parent;
+  }
+}
+
+// Return the edit log of the root 'root', or null if it has none
+GenTreeEditLog* GenTreeGetEditLog(const GenTree* const root) {
+  return (root->_extra != NULL ? root->_extra->_editLog : NULL);
+}
+
+// Return the position in depth first order in the root 'root' of the 
+// subtree just removed from the subtrees of the GenTree 'parent', 
+// where it was after the element 'prev' (null if it was the first one)
+int GenTreeRemovedRank(const GenTree* const root, 
+  const GenTree* const parent, const GSetElem* const prev) {
+  // Right after the previous brother and its subtrees if any, else 
+  // right after the parent
+  if (prev != NULL)
+    return _GenTreeRank(root, prev->_data) + 
+      ((GenTree*)(prev->_data))->_size + 1;
+  else if (parent != root)
+    return _GenTreeRank(root, parent) + 1;
+  else
+    return 0;
+}
+
+// Add to the edit log 'log' of the root 'root' the edit 'op' of the 
+// 'nbNode' nodes starting at the position 'rank', the first one at the
+// depth 'depth' for an insertion, made when the generation of the root
+// was 'gen'
+// The log is emptied first if the root has been modified otherwise 
+// since its last edit, and released instead if no iterator has been 
+// updated during the last GENTREEEDITLOG_NBEDIT edits
+void GenTreeEditLogAdd(GenTreeEditLog* const log, GenTree* const root, 
+  const unsigned long gen, const GenTreeEditOp op, const int rank, 
+  const int nbNode, const int depth) {
+  // If the iterators haven't been updated during the last 
+  // GENTREEEDITLOG_NBEDIT edits, none of them can be patched anymore,
+  // release the log so the next edits don't pay for it
+  if (log->_nbUnread == GENTREEEDITLOG_NBEDIT) {
+    root->_extra->_editLog = NULL;
+    free(log);
+    return;
+  }
+  ++(log->_nbUnread);
+  // The edits of an operation moving a subtree share the same 
+  // generation, else the generation must be the one at the end of the
+  // last edit
+  int iLast = (log->_first + log->_nbEdit - 1) % GENTREEEDITLOG_NBEDIT;
+  if (gen != log->_gen && 
+    (log->_nbEdit == 0 || log->_edits[iLast]._gen != gen)) {
+    log->_first = 0;
+    log->_nbEdit = 0;
+    log->_genMin = gen;
+  }
+  // If the log is full, forget the oldest edit, the sequences older 
+  // than it can't be patched anymore
+  if (log->_nbEdit == GENTREEEDITLOG_NBEDIT) {
+    log->_genMin = log->_edits[log->_first]._gen + 1;
+    log->_first = (log->_first + 1) % GENTREEEDITLOG_NBEDIT;
+    --(log->_nbEdit);
+  }
+  GenTreeEdit* edit = log->_edits + 
+    (log->_first + log->_nbEdit) % GENTREEEDITLOG_NBEDIT;
+  edit->_gen = gen;
+  edit->_op = op;
+  edit->_rank = rank;
+  edit->_nbNode = nbNode;
+  edit->_depth = depth;
+  ++(log->_nbEdit);
+  log->_gen = root->_gen;
+}
+
+// Return the number of ancestors of the GenTree 'that'
+int GenTreeNbAncestor(const GenTree* const that) {
+  int nb = 0;
+  for (const GenTree* node = that->_parent; node != NULL; 
+    node = node->_parent)
+    ++nb;
+  return nb;
+}
+
+// Return the node following 'node' in depth first order among the 
+// subtrees of the GenTree 'tree', or null if 'node' is the last one
+GenTree* GenTreeNextNode(const GenTree* const tree, 
+  const GenTree* const node) {
+  // Go down to the first subtree if any
+  GSetElem* elem = node->_subtrees._set._head;
+  // Else go to the next brother, climbing up until there is one
+  const GenTree* cur = node;
+  while (elem == NULL && cur != tree) {
+    elem = cur->_link._next;
+    if (elem == NULL)
+      cur = cur->_parent;
   }
+  return (elem != NULL ? elem->_data : NULL);
+}
+
+// Return the first node of the GenTree 'tree' in post order (subtrees 
+// before their parent), the tree included
+GenTree* GenTreeFirstNodePostOrder(const GenTree* const tree) {
+  // Go down along the first subtrees
+  GenTree* node = (GenTree*)tree;
+  while (node->_subtrees._set._head != NULL)
+    node = node->_subtrees._set._head->_data;
+  return node;
+}
+
+// Return the node following 'node' in post order (subtrees before their
+// parent) in the GenTree 'tree', the tree included, or null if 'node' 
+// is the tree
+GenTree* GenTreeNextNodePostOrder(const GenTree* const tree, 
+  const GenTree* const node) {
+  if (node == tree)
+    return NULL;
+  // The next brother's first node if any, else the parent
+  GSetElem* elem = node->_link._next;
+  if (elem != NULL)
+    return GenTreeFirstNodePostOrder(elem->_data);
+  else
+    return node->_parent;
 }
 
 // Free the memory used by the static GenTree 'that'
@@ -91,397 +534,6133 @@ void _GenTreeFreeStatic(GenTree* that) {
   if (!GenTreeIsRoot(that))
     // Cut the tree
     GenTreeCut(that);
+  // Free the index if the tree is indexed
+  GenTreeIndexFree(that);
   // Free memory
-  GenTreeFreeRec(GenTreeSubtrees(that));
+  GenTreeFreeRec(that);
+  // The static tree has lost its subtrees
+  ++(that->_gen);
+  that->_size = 0;
+  GenTreeSubtreeArrayFree(that);
+  GenTreeSubtreeSkipListFree(that);
+  GenTreeFreeExtra(that);
 }
 
-// Disconnect the GenTree 'that' from its parent
-// If it has no parent, do nothing
-void _GenTreeCut(GenTree* const that) {
+// Insert the GenTree 'tree' in the subtrees of the GenTree 'that' 
+// before the element 'next' (at the end if 'next' is null), with the 
+// sort value 'sortVal'
+// The subtrees of a GenTree must be modified only through the GenTree
+// functions
+void GenTreeLinkSubtree(GenTree* const that, GenTree* const tree, 
+  GSetElem* const next, const float sortVal) {
 #if BUILDMODE == 0
   if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'that' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeGetSkipList(that) != NULL) {
+    GSetElem* prev = (next != NULL ? next->_prev : 
+      that->_subtrees._set._tail);
+    if ((prev != NULL && prev->_sortVal > sortVal) ||
+      (next != NULL && next->_sortVal < sortVal)) {
+      GenTreeErr->_type = PBErrTypeInvalidArg;
+      sprintf(GenTreeErr->_msg, 
+        "the subtrees of a node with a skip list must stay sorted");
+      PBErrCatch(GenTreeErr);
+    }
   }
 #endif
-  // If there is no parent
-  if (GenTreeParent(that) == NULL)
-    // Nothing to do
-    return;
-  // Remove the tree from the parent's subtrees
-  GSetRemoveAll(GenTreeSubtrees(GenTreeParent(that)), that);
+  // The subtree loses its own index, if any
+  GenTreeIndexFree(tree);
+  // Link the subtree in the subtrees of the GenTree
+  GenTreeLinkElem(that, tree, next, sortVal);
+  // Update the generation of the subtree, and the generation and size
+  // of its new ancestors
+  ++(tree->_gen);
+  GenTree* root = GenTreeUpdateAncestors(that, tree->_size + 1);
+  // If the tree is indexed, add the nodes of the subtree to its index
+  if (GenTreeGetIndex(root) != NULL)
+    GenTreeIndexAddSubtree(GenTreeGetIndex(root), tree);
+  // Update the edit log of the root if any, the generation before the
+  // edit being the one before the update
+  GenTreeEditLog* log = GenTreeGetEditLog(root);
+  if (log != NULL)
+    GenTreeEditLogAdd(log, root, root->_gen - 1, GenTreeEditInsert, 
+      _GenTreeRank(root, tree), tree->_size + 1, GenTreeNbAncestor(tree));
+}
+
+// Link the element of the GenTree 'tree' in the subtrees of the 
+// GenTree 'that' before the element 'next' (at the end if 'next' is 
+// null), with the sort value 'sortVal', and update the array of 
+// subtrees and the skip list of 'that' if any
+// Only 'that' and 'tree' are modified, their index and ancestors are
+// left to the caller
+void GenTreeLinkElem(GenTree* const that, GenTree* const tree, 
+  GSetElem* const next, const float sortVal) {
+  GSet* set = &(that->_subtrees._set);
+  // Update the array of subtrees if any
+  if (GenTreeGetSubtreeArr(that) != NULL)
+    GenTreeSubtreeArrayInsert(that, tree, next);
+  // The element is the link of the subtree
+  GSetElem* elem = &(tree->_link);
+  elem->_data = tree;
+  elem->_sortVal = sortVal;
+  // Link the element
+  elem->_next = next;
+  elem->_prev = (next != NULL ? next->_prev : set->_tail);
+  if (elem->_prev != NULL)
+    elem->_prev->_next = elem;
+  else
+    set->_head = elem;
+  if (next != NULL)
+    next->_prev = elem;
+  else
+    set->_tail = elem;
+  ++(set->_nbElem);
+  // Set the parent of the subtree
+  tree->_parent = that;
+  // Invalidate the cached positions of the brotherhood
+  ++(that->_subtreesGen);
+  tree->_siblingGen = that->_subtreesGen - 1;
+  // Update the skip list over the subtrees if any
+  if (GenTreeGetSkipList(that) != NULL)
+    GenTreeSkipListInsert(that, tree);
+}
+
+// Remove the element 'elem' (the _link of a subtree) from the subtrees
+// of the GenTree 'that'
+// Return the removed subtree, which becomes a root, or null if 'elem'
+// is null
+GenTree* GenTreeUnlinkSubtree(GenTree* const that, GSetElem* const elem) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  if (elem == NULL)
+    return NULL;
+  // Memorize the previous brother to find the position of the subtree
+  // for the edit log of the root, if any
+  GSetElem* prev = elem->_prev;
+  // Unlink the subtree from the subtrees of the GenTree
+  GenTree* tree = GenTreeUnlinkElem(that, elem);
+  // Update the generation of the subtree, and the generation and size
+  // of its former ancestors
+  ++(tree->_gen);
+  GenTree* root = GenTreeUpdateAncestors(that, -(tree->_size + 1));
+  // If the tree was indexed, remove the nodes of the subtree from its
+  // index
+  if (GenTreeGetIndex(root) != NULL)
+    GenTreeIndexRemoveSubtree(GenTreeGetIndex(root), tree);
+  GenTreeEditLog* log = GenTreeGetEditLog(root);
+  if (log != NULL)
+    GenTreeEditLogAdd(log, root, root->_gen - 1, GenTreeEditRemove, 
+      GenTreeRemovedRank(root, that, prev), tree->_size + 1, 0);
+  // Return the subtree
+  return tree;
+}
+
+// Unlink the element 'elem' (the _link of a subtree) from the subtrees
+// of the GenTree 'that', and update the array of subtrees and the skip
+// list of 'that' if any
+// Only 'that' and the subtree are modified, their index and ancestors 
+// are left to the caller
+// Return the subtree
+GenTree* GenTreeUnlinkElem(GenTree* const that, GSetElem* const elem) {
+  GSet* set = &(that->_subtrees._set);
+  // Update the array of subtrees if any
+  if (GenTreeGetSubtreeArr(that) != NULL)
+    GenTreeSubtreeArrayRemove(that, elem->_data);
+  // Update the skip list over the subtrees if any
+  if (GenTreeGetSkipList(that) != NULL)
+    GenTreeSkipListRemove(that, elem->_data);
+  // Unlink the element
+  if (elem->_prev != NULL)
+    elem->_prev->_next = elem->_next;
+  else
+    set->_head = elem->_next;
+  if (elem->_next != NULL)
+    elem->_next->_prev = elem->_prev;
+  else
+    set->_tail = elem->_prev;
+  --(set->_nbElem);
+  elem->_next = NULL;
+  elem->_prev = NULL;
   // Cut the link to the parent
-  that->_parent = NULL;
+  GenTree* tree = elem->_data;
+  tree->_parent = NULL;
+  // Invalidate the cached positions of the brotherhood
+  ++(that->_subtreesGen);
+  // Return the subtree
+  return tree;
 }
 
-// Return the number of subtrees of the GenTree 'that' and their subtrees 
-// recursively
-int _GenTreeGetSize(const GenTree* const that) {
+// Return the position of the GenTree 'that' among its brothers (0 for
+// a root)
+// The positions are cached and recalculated for the whole brotherhood
+// only after a subtree has been added or removed to the parent
+int _GenTreeSiblingIndex(const GenTree* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'that' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  // Declare a variable to memorize the result and initialize it with 
-  // the number of subtrees
-  int nb = GSetNbElem(GenTreeSubtrees(that));
-  // If there are subtrees
-  if (nb > 0) {
-    // Recursion on the subtrees
-    GSetIterForward iter = 
-      GSetIterForwardCreateStatic(GenTreeSubtrees(that));
-    do {
-      GenTree* subtree = GSetIterGet(&iter);
-      nb += GenTreeGetSize(subtree);
-    } while (GSetIterStep(&iter));
+  GenTree* parent = that->_parent;
+  if (parent == NULL)
+    return 0;
+  // If the parent has an array of subtrees, get the position from it
+  if (GenTreeGetSubtreeArr(parent) != NULL)
+    return GenTreeSubtreeArrayPos(parent, (GenTree*)that);
+  // If the cached positions are out of date, recalculate them for all
+  // the brothers
+  if (that->_siblingGen != parent->_subtreesGen) {
+    int iSibling = 0;
+    GSetElem* elem = parent->_subtrees._set._head;
+    while (elem != NULL) {
+      GenTree* sibling = elem->_data;
+      sibling->_siblingIndex = iSibling;
+      sibling->_siblingGen = parent->_subtreesGen;
+      ++iSibling;
+      elem = elem->_next;
+    }
   }
-  // Return the result
-  return nb;
+  return that->_siblingIndex;
 }
 
-// Append a new node with 'data' to the first node containing 'node'
-// in the GenTree 'that'
-// Uses the iterator 'iter' to search the node
-// Return true if we could find 'node', false else
-bool _GenTreeAppendToNode(GenTree* const that, 
-  void* const data, void* const node, GenTreeIter* const iter) {
+// Return the element of the 'iSubtree'-th subtree of the GenTree 'that'
+// Return null if 'iSubtree' is greater than or equal to the number of
+// subtrees
+GSetElem* GenTreeSubtreeElem(const GenTree* const that, 
+  const int iSubtree) {
 #if BUILDMODE == 0
   if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'that' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
   }
-  if (iter == NULL) {
+#endif
+  // If the node has an array of subtrees, use it
+  GenTree** arr = GenTreeGetSubtreeArr(that);
+  if (arr != NULL) {
+    if (iSubtree >= 0 && iSubtree < that->_subtrees._set._nbElem) {
+      // Memorize the position in the subtree, it will be reused if the
+      // element is used to insert or remove a subtree
+      GenTree* subtree = arr[iSubtree];
+      subtree->_siblingIndex = iSubtree;
+      return &(subtree->_link);
+    } else
+      return NULL;
+  }
+  GSetElem* elem = that->_subtrees._set._head;
+  for (int i = iSubtree; i > 0 && elem != NULL; --i)
+    elem = elem->_next;
+  return elem;
+}
+
+// Create the array of subtrees of the GenTree 'that', giving constant 
+// time access to its subtrees by position
+// Do nothing if the node already has an array of subtrees
+void GenTreeSubtreeArrayCreate(GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'iter' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  // Declare a variable to memorize the result
-  bool res = false;
-  // Search the node where to append the data
-  GenTree* nodeTree = GenTreeSearch(that, node, iter);
-  // If we could find the node
-  if (nodeTree != NULL) {
-    // Append the data
-    GenTreeAppendData(nodeTree, data);
-    // Update the result
-    res = true;
+  if (GenTreeGetSubtreeArr(that) != NULL)
+    // Nothing to do
+    return;
+  int nb = that->_subtrees._set._nbElem;
+  GenTreeExtra* extra = GenTreeGetExtra(that);
+  extra->_subtreeArrCapacity = (nb > 16 ? nb : 16);
+  extra->_subtreeArr = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTree*) * extra->_subtreeArrCapacity);
+  int iSubtree = 0;
+  GSetElem* elem = that->_subtrees._set._head;
+  while (elem != NULL) {
+    GenTree* subtree = elem->_data;
+    extra->_subtreeArr[iSubtree] = subtree;
+    subtree->_siblingIndex = iSubtree;
+    ++iSubtree;
+    elem = elem->_next;
   }
-  // Return the result
-  return res;
+  extra->_subtreeArrNbValid = nb;
 }
 
-// Search the first node containing 'data' in the GenTree 'that'
-// Uses the iterator 'iter' to search the node. Do not reset the 
-// iterator, thus several calls with the same iterator will return 
-// eventual successive nodes containing the same data. If one want to 
-// loop on these nodes, the proper stopping condition is 
-// while(GenTreeSearch() != NULL && GenTreeIterIsLast() == false)
-// Return the node if we could find 'data', null else
-GenTree* _GenTreeSearch(const GenTree* const that, 
-  const void* const data, GenTreeIter* const iter) {
+// Free the array of subtrees of the GenTree 'that', if any
+void GenTreeSubtreeArrayFree(GenTree* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'that' is null");
-    PBErrCatch(GSetErr);
-  } 
-  if (iter == NULL) {
-    GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'iter' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  (void)that;
-  // Declare a variable to memorize the result
-  GenTree* res = NULL;
-  // Loop until we have found or reached the end
-  do {
-    // If we have found the searched data
-    if (GenTreeIterGetData(iter) == data)
-      // Memorize the node containing the data
-      res = GenTreeIterGetGenTree(iter);
-  } while (GenTreeIterStep(iter) && res == NULL);
-  // Return the result
-  return res;
+  if (GenTreeGetSubtreeArr(that) == NULL)
+    // Nothing to do
+    return;
+  free(that->_extra->_subtreeArr);
+  that->_extra->_subtreeArr = NULL;
+  that->_extra->_subtreeArrCapacity = 0;
+  // The cached positions of the subtrees are not maintained anymore
+  ++(that->_subtreesGen);
 }
 
-// ----------- GenTreeIter
-
-// ================ Functions declaration ====================
-
-// Create recursively the sequence of an iterator for depth first
-void GenTreeIterCreateSequenceDepthFirst(GSetGenTree* seq, GenTree* tree);
-
-// Create recursively the sequence of an iterator for breadth first
-void GenTreeIterCreateSequenceBreadthFirst(GSetGenTree* seq, GenTree* tree,
-  int lvl);
+// Insert the GenTree 'tree' in the array of subtrees of the GenTree 
+// 'that' before the element 'next' (at the end if 'next' is null)
+void GenTreeSubtreeArrayInsert(GenTree* const that, GenTree* const tree, 
+  const GSetElem* const next) {
+  // Number of subtrees before insertion
+  int nb = that->_subtrees._set._nbElem;
+  GenTreeExtra* extra = that->_extra;
+  // If the array is full
+  if (nb == extra->_subtreeArrCapacity) {
+    // Double its capacity
+    int capacity = extra->_subtreeArrCapacity * 2;
+    GenTree** arr = PBErrMalloc(GenTreeErr, sizeof(GenTree*) * capacity);
+    memcpy(arr, extra->_subtreeArr, sizeof(GenTree*) * nb);
+    free(extra->_subtreeArr);
+    extra->_subtreeArr = arr;
+    extra->_subtreeArrCapacity = capacity;
+  }
+  // Shift the following subtrees and insert the new one
+  int pos = (next != NULL ? 
+    GenTreeSubtreeArrayPos(that, (GenTree*)(next->_data)) : nb);
+  memmove(extra->_subtreeArr + pos + 1, extra->_subtreeArr + pos, 
+    sizeof(GenTree*) * (nb - pos));
+  extra->_subtreeArr[pos] = tree;
+  tree->_siblingIndex = pos;
+  // The positions of the shifted subtrees are out of date
+  if (extra->_subtreeArrNbValid > pos)
+    extra->_subtreeArrNbValid = pos;
+}
 
-// Create recursively the sequence of an iterator for value first
-void GenTreeIterCreateSequenceValueFirst(GSetGenTree* seq, GenTree* tree, 
-  float val);
+// Remove the GenTree 'tree' from the array of subtrees of the GenTree 
+// 'that'
+void GenTreeSubtreeArrayRemove(GenTree* const that, 
+  GenTree* const tree) {
+  // Number of subtrees after removal
+  int nb = that->_subtrees._set._nbElem - 1;
+  // Shift the following subtrees
+  int pos = GenTreeSubtreeArrayPos(that, tree);
+  GenTreeExtra* extra = that->_extra;
+  memmove(extra->_subtreeArr + pos, extra->_subtreeArr + pos + 1, 
+    sizeof(GenTree*) * (nb - pos));
+  // The positions of the shifted subtrees are out of date
+  if (extra->_subtreeArrNbValid > pos)
+    extra->_subtreeArrNbValid = pos;
+}
 
-// ================ Functions implementation ====================
+// Return the position of the subtree 'subtree' in the array of 
+// subtrees of the GenTree 'that'
+int GenTreeSubtreeArrayPos(GenTree* const that, GenTree* const subtree) {
+  // If the memorized position is correct, use it
+  GenTreeExtra* extra = that->_extra;
+  int pos = subtree->_siblingIndex;
+  if (pos >= 0 && pos < that->_subtrees._set._nbElem && 
+    extra->_subtreeArr[pos] == subtree)
+    return pos;
+  // Else update the positions of the subtrees after the valid ones
+  int nb = that->_subtrees._set._nbElem;
+  for (int iSubtree = extra->_subtreeArrNbValid; iSubtree < nb; 
+    ++iSubtree)
+    extra->_subtreeArr[iSubtree]->_siblingIndex = iSubtree;
+  extra->_subtreeArrNbValid = nb;
+  return subtree->_siblingIndex;
+}
 
-// Create a new GenTreeIterDepth for the GenTree 'tree'
-GenTreeIterDepth* _GenTreeIterDepthCreate(GenTree* const tree) {
+// Return the element of the first subtree of the GenTree 'that' whose 
+// sort value is strictly greater than 'sortVal'
+// Return null if there is none
+GSetElem* GenTreeSubtreeUpperBound(const GenTree* const that, 
+  const float sortVal) {
 #if BUILDMODE == 0
-  if (tree == NULL) {
+  if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'tree' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  // Declare the new iterator
-  GenTreeIterDepth *iter = PBErrMalloc(GenTreeErr, sizeof(GenTreeIterDepth));
-  // Set properties
-  ((GenTreeIter*)iter)->_tree = tree;
-  ((GenTreeIter*)iter)->_seq = GSetGenTreeCreateStatic();
-  GenTreeIterDepthUpdate(iter);
-  GenTreeIterReset(iter);
-  // Return the iterator
-  return iter;  
+  // If the node has a skip list, use it
+  if (GenTreeGetSkipList(that) != NULL)
+    return GenTreeSkipListBound(that, sortVal, true);
+  GSetElem* elem = that->_subtrees._set._head;
+  while (elem != NULL && elem->_sortVal <= sortVal)
+    elem = elem->_next;
+  return elem;
 }
 
-// Create a new static GenTreeIterDepth for the GenTree 'tree'
-GenTreeIterDepth _GenTreeIterDepthCreateStatic(GenTree* const tree) {
+// Return the element of the first subtree of the GenTree 'that' whose 
+// sort value is greater than or equal to 'sortVal'
+// Return null if there is none
+// The subtrees must be sorted by sort value
+GSetElem* GenTreeSubtreeLowerBound(const GenTree* const that, 
+  const float sortVal) {
 #if BUILDMODE == 0
-  if (tree == NULL) {
+  if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'tree' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  // Declare the new iterator
-  GenTreeIterDepth iter;
-  // Set properties
-  ((GenTreeIter*)&iter)->_tree = tree;
-  ((GenTreeIter*)&iter)->_seq = GSetGenTreeCreateStatic();
-  GenTreeIterDepthUpdate(&iter);
-  GenTreeIterReset(&iter);
-  // Return the iterator
-  return iter;
+  // If the node has a skip list, use it
+  if (GenTreeGetSkipList(that) != NULL)
+    return GenTreeSkipListBound(that, sortVal, false);
+  GSetElem* elem = that->_subtrees._set._head;
+  while (elem != NULL && elem->_sortVal < sortVal)
+    elem = elem->_next;
+  return elem;
 }
 
-// Create a new GenTreeIterBreadth for the GenTree 'tree'
-GenTreeIterBreadth* _GenTreeIterBreadthCreate(GenTree* const tree) {
+// Return the number of subtrees of the GenTree 'that' whose sort value
+// is in ['lo', 'hi'], and set 'first' to the first of them (null if 
+// there is none). The following ones are obtained with 
+// GenTreeNextSibling
+// The subtrees must be sorted by sort value
+int _GenTreeSubtreesInRange(const GenTree* const that, const float lo,
+  const float hi, GenTree** const first) {
 #if BUILDMODE == 0
-  if (tree == NULL) {
+  if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'tree' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (first == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'first' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  // Declare the new iterator
-  GenTreeIterBreadth *iter = 
-    PBErrMalloc(GenTreeErr, sizeof(GenTreeIterBreadth));
-  // Set properties
-  ((GenTreeIter*)iter)->_tree = tree;
-  ((GenTreeIter*)iter)->_seq = GSetGenTreeCreateStatic();
-  GenTreeIterBreadthUpdate(iter);
-  GenTreeIterReset(iter);
-  // Return the iterator
-  return iter;  
+  GSetElem* elem = GenTreeSubtreeLowerBound(that, lo);
+  *first = (elem != NULL && elem->_sortVal <= hi ? elem->_data : NULL);
+  int nb = 0;
+  while (elem != NULL && elem->_sortVal <= hi) {
+    ++nb;
+    elem = elem->_next;
+  }
+  return nb;
 }
 
-// Create a new static GenTreeIterBreadth for the GenTree 'tree'
-GenTreeIterBreadth _GenTreeIterBreadthCreateStatic(GenTree* const tree) {
+// Return the subtree of the GenTree 'that' with the lowest sort value
+// (the first one if several), or null if it has no subtree
+GenTree* _GenTreeMinSubtree(const GenTree* const that) {
 #if BUILDMODE == 0
-  if (tree == NULL) {
+  if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'tree' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  // Declare the new iterator
-  GenTreeIterBreadth iter;
-  // Set properties
-  ((GenTreeIter*)&iter)->_tree = tree;
-  ((GenTreeIter*)&iter)->_seq = GSetGenTreeCreateStatic();
-  GenTreeIterBreadthUpdate(&iter);
-  GenTreeIterReset(&iter);
-  // Return the iterator
-  return iter;
+  GSetElem* elem = that->_subtrees._set._head;
+  // If the node has a skip list, the subtrees are sorted
+  if (GenTreeGetSkipList(that) != NULL)
+    return (elem != NULL ? elem->_data : NULL);
+  GSetElem* min = elem;
+  while (elem != NULL) {
+    if (elem->_sortVal < min->_sortVal)
+      min = elem;
+    elem = elem->_next;
+  }
+  return (min != NULL ? min->_data : NULL);
 }
 
-// Create a new GenTreeIterValue for the GenTree 'tree'
-GenTreeIterValue* _GenTreeIterValueCreate(GenTree* const tree) {
+// Return the subtree of the GenTree 'that' with the highest sort value
+// (the last one if several), or null if it has no subtree
+GenTree* _GenTreeMaxSubtree(const GenTree* const that) {
 #if BUILDMODE == 0
-  if (tree == NULL) {
+  if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'tree' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  // Declare the new iterator
-  GenTreeIterValue *iter = PBErrMalloc(GenTreeErr, sizeof(GenTreeIterValue));
-  // Set properties
-  ((GenTreeIter*)iter)->_tree = tree;
-  ((GenTreeIter*)iter)->_seq = GSetGenTreeCreateStatic();
-  GenTreeIterValueUpdate(iter);
-  GenTreeIterReset(iter);
+  GSetElem* elem = that->_subtrees._set._tail;
+  // If the node has a skip list, the subtrees are sorted
+  if (GenTreeGetSkipList(that) != NULL)
+    return (elem != NULL ? elem->_data : NULL);
+  GSetElem* max = elem;
+  while (elem != NULL) {
+    if (elem->_sortVal > max->_sortVal)
+      max = elem;
+    elem = elem->_prev;
+  }
+  return (max != NULL ? max->_data : NULL);
+}
+
+// Sort the subtrees of the GenTree 'that' by sort value with a stable
+// merge sort, in O(k log k) for k subtrees
+// Do nothing if the subtrees are already sorted
+void GenTreeSortSubtrees(GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Invalidate the iterators if the order has changed
+  if (GenTreeSortSubtreesNoUpdate(that))
+    GenTreeUpdateAncestors(that, 0);
+}
+
+// Sort the subtrees of the GenTree 'that' by sort value, invalidating 
+// the cached positions of the subtrees but leaving the generation of 
+// 'that' and its ancestors to the caller
+// Return true if the order of the subtrees has changed
+bool GenTreeSortSubtreesNoUpdate(GenTree* const that) {
+  GSet* set = &(that->_subtrees._set);
+  // If the subtrees are already sorted there is nothing to do
+  GSetElem* elem = set->_head;
+  while (elem != NULL && elem->_next != NULL && 
+    elem->_sortVal <= elem->_next->_sortVal)
+    elem = elem->_next;
+  if (elem == NULL || elem->_next == NULL)
+    return false;
+  // Bottom up merge sort on the _next links, merging at each pass the 
+  // consecutive runs of 'width' elements
+  GSetElem* list = set->_head;
+  int nbMerge = 0;
+  for (int width = 1; nbMerge != 1; width *= 2) {
+    GSetElem* head = NULL;
+    GSetElem** tail = &head;
+    GSetElem* left = list;
+    nbMerge = 0;
+    while (left != NULL) {
+      ++nbMerge;
+      // Split the left run from the right one
+      GSetElem* right = left;
+      int nbLeft = 0;
+      while (nbLeft < width && right != NULL) {
+        ++nbLeft;
+        right = right->_next;
+      }
+      int nbRight = width;
+      // Merge the two runs, taking the left element in case of equality
+      // to keep the sort stable
+      while (nbLeft > 0 || (nbRight > 0 && right != NULL)) {
+        GSetElem* next = NULL;
+        if (nbLeft == 0 || (nbRight > 0 && right != NULL && 
+          right->_sortVal < left->_sortVal)) {
+          next = right;
+          right = right->_next;
+          --nbRight;
+        } else {
+          next = left;
+          left = left->_next;
+          --nbLeft;
+        }
+        *tail = next;
+        tail = &(next->_next);
+      }
+      left = right;
+    }
+    *tail = NULL;
+    list = head;
+  }
+  // Restore the _prev links, the head and the tail
+  set->_head = list;
+  GSetElem* prev = NULL;
+  for (elem = list; elem != NULL; elem = elem->_next) {
+    elem->_prev = prev;
+    prev = elem;
+  }
+  set->_tail = prev;
+  // Update the array of subtrees if any
+  if (GenTreeGetSubtreeArr(that) != NULL) {
+    int iSubtree = 0;
+    for (elem = list; elem != NULL; elem = elem->_next) {
+      that->_extra->_subtreeArr[iSubtree] = elem->_data;
+      ((GenTree*)(elem->_data))->_siblingIndex = iSubtree;
+      ++iSubtree;
+    }
+    that->_extra->_subtreeArrNbValid = iSubtree;
+  }
+  // Invalidate the cached positions of the subtrees
+  ++(that->_subtreesGen);
+  return true;
+}
+
+// Sort the subtrees of the GenTree 'that' and of all its subtrees, in 
+// depth first order, with GenTreeSortSubtreesNoUpdate
+// Return true if the order of any subtrees has changed
+bool GenTreeSortSubtreesAll(GenTree* const that) {
+  // Each node is sorted before the run goes down into its subtrees, so
+  // the loop doesn't need the C stack and runs through the nodes in 
+  // their final order
+  bool isSorted = false;
+  for (GenTree* node = that; node != NULL; 
+    node = GenTreeNextNode(that, node))
+    if (GenTreeSortSubtreesNoUpdate(node))
+      isSorted = true;
+  return isSorted;
+}
+
+// Sort the subtrees of the GenTree 'that' and of all its subtrees, 
+// with GenTreeSortSubtrees, without recursion so the depth of the tree
+// is not limited by the C stack
+void GenTreeSortSubtreesRec(GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  if (!GenTreeSortSubtreesAll(that))
+    return;
+  // Invalidate the iterators attached to any node of the tree, in one 
+  // run through the nodes instead of one climb up per sorted node
+  for (GenTree* node = GenTreeNextNode(that, that); node != NULL; 
+    node = GenTreeNextNode(that, node))
+    ++(node->_gen);
+  GenTreeUpdateAncestors(that, 0);
+}
+
+// Add new nodes with the 'nb' user data 'data' and sort values 
+// 'sortVals' to the subtrees of the GenTree 'that'
+// The result is the same as calling GenTreeAddSortData for each pair,
+// in order, but the nodes are allocated and linked in one batch and 
+// the subtrees are sorted only once
+void GenTreeAddSortDataBatch(GenTree* const that, void** const data, 
+  const float* const sortVals, const int nb) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (nb > 0 && sortVals == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'sortVals' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  GenTreeLinkDataBatch(that, data, sortVals, nb, NULL);
+  GenTreeSortSubtrees(that);
+}
+
+// Append new nodes with the 'nb' user data 'data', in order, at the end
+// of the subtrees of the GenTree 'that'
+// The nodes are allocated together and linked in one pass
+void GenTreeAppendDataBatch(GenTree* const that, void** const data, 
+  const int nb) {
+  GenTreeLinkDataBatch(that, data, NULL, nb, NULL);
+}
+
+// Insert new nodes with the 'nb' user data 'data', in order, at the 
+// head of the subtrees of the GenTree 'that'
+// The nodes are allocated together and linked in one pass
+void GenTreePushDataBatch(GenTree* const that, void** const data, 
+  const int nb) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  GenTreeLinkDataBatch(that, data, NULL, nb, that->_subtrees._set._head);
+}
+
+// Insert new nodes with the 'nb' user data 'data', in order, at the 
+// position 'pos' in the subtrees of the GenTree 'that'
+// The nodes are allocated together and linked in one pass
+void GenTreeInsertDataBatch(GenTree* const that, void** const data, 
+  const int nb, const int pos) {
+  GenTreeLinkDataBatch(that, data, NULL, nb, 
+    GenTreeSubtreeElem(that, pos));
+}
+
+// Create 'nb' nodes with the user data 'data' and the sort values 
+// 'sortVals' (0.0 if null), allocated together, and insert them in 
+// order in the subtrees of the GenTree 'that' before the element 'next'
+// (at the end if 'next' is null)
+void GenTreeLinkDataBatch(GenTree* const that, void** const data, 
+  const float* const sortVals, const int nb, GSetElem* const next) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (nb < 0) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'nb' is invalid (%d>=0)", nb);
+    PBErrCatch(GenTreeErr);
+  }
+  if (nb > 0 && data == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'data' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  if (nb == 0)
+    return;
+  // If the subtrees have an array or a skip list, the nodes are linked
+  // one by one to keep them up to date
+  bool isLinkedOneByOne = 
+    (GenTreeGetSubtreeArr(that) != NULL || GenTreeGetSkipList(that) != NULL);
+  // Chain of the new nodes, linked through their _link
+  GSetElem* first = NULL;
+  GSetElem* last = NULL;
+  // Allocate the nodes by runs of consecutive nodes: one block for 
+  // nodes allocated with malloc, the remaining of the current chunk for
+  // nodes allocated from a pool
+  GenTreePool* pool = that->_pool;
+  int iData = 0;
+  while (iData < nb) {
+    int nbRun = nb - iData;
+    GenTree* run = NULL;
+    if (pool == NULL) {
+      GenTreeBlock* block = PBErrMalloc(GenTreeErr, 
+        sizeof(GenTreeBlock) + sizeof(GenTree) * nbRun);
+      block->_nbLive = nbRun;
+      run = (GenTree*)(block + 1);
+      for (int iNode = 0; iNode < nbRun; ++iNode) {
+        GenTreeInitNode(run + iNode, NULL, data[iData + iNode]);
+        run[iNode]._block = block;
+      }
+    } else {
+      // Use the remaining of the current chunk, or a new chunk
+      int nbFree = 0;
+      if (GSetNbElem(&(pool->_chunks)) > 0)
+        nbFree = (int)((sizeof(GenTree) * pool->_nbNodePerChunk - 
+          pool->_nbUsedByte) / sizeof(GenTree));
+      if (nbFree == 0)
+        nbFree = pool->_nbNodePerChunk;
+      if (nbRun > nbFree)
+        nbRun = nbFree;
+      run = GenTreePoolAlloc(pool, sizeof(GenTree) * nbRun);
+      pool->_nbLive += nbRun;
+      for (int iNode = 0; iNode < nbRun; ++iNode)
+        GenTreeInitNode(run + iNode, pool, data[iData + iNode]);
+    }
+    // Link the nodes of the run
+    for (int iNode = 0; iNode < nbRun; ++iNode) {
+      GenTree* node = run + iNode;
+      float sortVal = (sortVals != NULL ? sortVals[iData + iNode] : 0.0);
+      if (isLinkedOneByOne) {
+        GSetElem* nextNode = (GenTreeGetSkipList(that) != NULL ? 
+          GenTreeSubtreeUpperBound(that, sortVal) : next);
+        GenTreeLinkSubtree(that, node, nextNode, sortVal);
+      } else {
+        node->_parent = that;
+        node->_link._sortVal = sortVal;
+        node->_link._prev = last;
+        if (last != NULL)
+          last->_next = &(node->_link);
+        else
+          first = &(node->_link);
+        last = &(node->_link);
+        ++(node->_gen);
+      }
+    }
+    iData += nbRun;
+  }
+  if (isLinkedOneByOne)
+    return;
+  // Splice the chain of new nodes in the subtrees
+  GSet* set = &(that->_subtrees._set);
+  last->_next = next;
+  first->_prev = (next != NULL ? next->_prev : set->_tail);
+  if (first->_prev != NULL)
+    first->_prev->_next = first;
+  else
+    set->_head = first;
+  if (next != NULL)
+    next->_prev = last;
+  else
+    set->_tail = last;
+  set->_nbElem += nb;
+  // Invalidate the cached positions of the brotherhood
+  ++(that->_subtreesGen);
+  // Update the generation and size of the ancestors, and the edit log 
+  // of the root if any, the new nodes are contiguous in depth first 
+  // order
+  GenTree* root = GenTreeUpdateAncestors(that, nb);
+  // If the tree is indexed, add the new nodes to its index
+  if (GenTreeGetIndex(root) != NULL)
+    for (GSetElem* elem = first; elem != next; elem = elem->_next)
+      GenTreeIndexAdd(GenTreeGetIndex(root), elem->_data);
+  GenTreeEditLog* log = GenTreeGetEditLog(root);
+  if (log != NULL)
+    GenTreeEditLogAdd(log, root, root->_gen - 1, GenTreeEditInsert, 
+      _GenTreeRank(root, first->_data), nb, 
+      GenTreeNbAncestor(first->_data));
+}
+
+// Create a new GenTree from the 'nb' user data 'data' (null for no 
+// data) where 'parents'[i] is the index of the parent of the i-th node,
+// -1 for the root
+// Return the root
+GenTree* GenTreeCreateFromParents(void** const data, 
+  const int* const parents, const float* const sortVals, const int nb) {
+  return GenTreeCreateFromParentsOrder(data, parents, sortVals, nb, NULL);
+}
+
+// Create a new GenTree from the 'nb' user data 'data' (null for no 
+// data) and the 'nb - 1' edges 'edges'
+// Return the root
+GenTree* GenTreeCreateFromEdges(void** const data, const int* const edges, 
+  const float* const sortVals, const int nb) {
+#if BUILDMODE == 0
+  if (nb <= 0) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'nb' is invalid (%d>0)", nb);
+    PBErrCatch(GenTreeErr);
+  }
+  if (nb > 1 && edges == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'edges' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Convert the edges into parent indices, and memorize the order of 
+  // the children
+  int* parents = PBErrMalloc(GenTreeErr, sizeof(int) * nb);
+  int* order = PBErrMalloc(GenTreeErr, sizeof(int) * nb);
+  for (int iNode = nb; iNode--;)
+    parents[iNode] = -1;
+  for (int iEdge = 0; iEdge < nb - 1; ++iEdge) {
+    int child = edges[2 * iEdge + 1];
+#if BUILDMODE == 0
+    if (child < 0 || child >= nb || parents[child] != -1 ||
+      edges[2 * iEdge] < 0 || edges[2 * iEdge] >= nb) {
+      GenTreeErr->_type = PBErrTypeInvalidArg;
+      sprintf(GenTreeErr->_msg, "edge %d is invalid", iEdge);
+      PBErrCatch(GenTreeErr);
+    }
+#endif
+    parents[child] = edges[2 * iEdge];
+    order[iEdge] = child;
+  }
+  GenTree* tree = 
+    GenTreeCreateFromParentsOrder(data, parents, sortVals, nb, order);
+  free(parents);
+  free(order);
+  return tree;
+}
+
+// Create a new GenTree from the 'nb' user data 'data' where 
+// 'parents'[i] is the index of the parent of the i-th node (-1 for the
+// root), linking the nodes in the order 'order' (indices of the nodes,
+// the root excluded), or in the order of their index if 'order' is 
+// null
+GenTree* GenTreeCreateFromParentsOrder(void** const data, 
+  const int* const parents, const float* const sortVals, const int nb,
+  const int* const order) {
+#if BUILDMODE == 0
+  if (nb <= 0) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'nb' is invalid (%d>0)", nb);
+    PBErrCatch(GenTreeErr);
+  }
+  if (parents == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'parents' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Allocate all the nodes in one block
+  GenTreeBlock* block = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeBlock) + sizeof(GenTree) * nb);
+  block->_nbLive = nb;
+  GenTree* nodes = (GenTree*)(block + 1);
+  GenTree* root = NULL;
+  for (int iNode = 0; iNode < nb; ++iNode) {
+    GenTreeInitNode(nodes + iNode, NULL, 
+      (data != NULL ? data[iNode] : NULL));
+    nodes[iNode]._block = block;
+    if (parents[iNode] == -1) {
+#if BUILDMODE == 0
+      if (root != NULL) {
+        GenTreeErr->_type = PBErrTypeInvalidArg;
+        sprintf(GenTreeErr->_msg, "there is more than one root");
+        PBErrCatch(GenTreeErr);
+      }
+#endif
+      root = nodes + iNode;
+    }
+#if BUILDMODE == 0
+    else if (parents[iNode] < 0 || parents[iNode] >= nb) {
+      GenTreeErr->_type = PBErrTypeInvalidArg;
+      sprintf(GenTreeErr->_msg, "parent of node %d is invalid (%d)", 
+        iNode, parents[iNode]);
+      PBErrCatch(GenTreeErr);
+    }
+#endif
+  }
+#if BUILDMODE == 0
+  if (root == NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "there is no root");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Link each node at the end of the subtrees of its parent
+  for (int iOrder = 0; iOrder < nb; ++iOrder) {
+    int iNode = iOrder;
+    if (order != NULL) {
+      if (iOrder == nb - 1)
+        break;
+      iNode = order[iOrder];
+    }
+    if (parents[iNode] == -1)
+      continue;
+    GenTree* node = nodes + iNode;
+    GenTree* parent = nodes + parents[iNode];
+    GSet* set = &(parent->_subtrees._set);
+    node->_parent = parent;
+    node->_link._sortVal = (sortVals != NULL ? sortVals[iNode] : 0.0);
+    node->_link._prev = set->_tail;
+    if (set->_tail != NULL)
+      set->_tail->_next = &(node->_link);
+    else
+      set->_head = &(node->_link);
+    set->_tail = &(node->_link);
+    ++(set->_nbElem);
+    // Invalidate the cached positions of the brotherhood
+    ++(parent->_subtreesGen);
+  }
+  // Get the nodes in depth first order, which also checks there is no
+  // cycle (nodes in a cycle are not reachable from the root)
+  GenTree** seq = PBErrMalloc(GenTreeErr, sizeof(GenTree*) * nb);
+  int nbReached = 0;
+  for (GenTree* node = root; node != NULL; 
+    node = GenTreeNextNode(root, node))
+    seq[nbReached++] = node;
+#if BUILDMODE == 0
+  if (nbReached != nb) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "the parents contain a cycle");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Calculate the sizes in reverse depth first order, the subtrees 
+  // before their parent
+  for (int iNode = nbReached; iNode-- > 1;)
+    seq[iNode]->_parent->_size += seq[iNode]->_size + 1;
+  free(seq);
+  // Sort the subtrees if there are sort values
+  // There is no iterator yet on the new nodes, so only the generation
+  // of the root is updated, once
+  if (sortVals != NULL && GenTreeSortSubtreesAll(root))
+    ++(root->_gen);
+  // Return the root
+  return root;
+}
+
+// Export the GenTree 'that' into the arrays 'data', 'parents' and 
+// 'sortVals' (each one can be null), which must have room for 
+// GenTreeGetSize(that) + 1 elements
+// Return the number of nodes
+int GenTreeExportParents(const GenTree* const that, void** const data, 
+  int* const parents, float* const sortVals) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Array of the parent indices, used to climb up during the run 
+  // through the nodes
+  int* par = parents;
+  if (par == NULL)
+    par = PBErrMalloc(GenTreeErr, sizeof(int) * (that->_size + 1));
+  // Run through the nodes in depth first order, memorizing the index 
+  // of the current node and of its parent
+  const GenTree* node = that;
+  int iNode = 0;
+  int iCur = 0;
+  int iParent = -1;
+  while (node != NULL) {
+    par[iCur] = iParent;
+    if (data != NULL)
+      data[iCur] = node->_data;
+    if (sortVals != NULL)
+      sortVals[iCur] = (node == that ? 0.0 : node->_link._sortVal);
+    ++iNode;
+    // Go down to the first subtree if any, else go to the next brother,
+    // climbing up until there is one
+    GSetElem* elem = node->_subtrees._set._head;
+    iParent = iCur;
+    while (elem == NULL && node != that) {
+      elem = node->_link._next;
+      iParent = par[iCur];
+      if (elem == NULL) {
+        node = node->_parent;
+        iCur = par[iCur];
+      }
+    }
+    node = (elem != NULL ? elem->_data : NULL);
+    iCur = iNode;
+  }
+  if (parents == NULL)
+    free(par);
+  // Return the number of nodes
+  return iNode;
+}
+
+// Create a copy of the GenTree 'that' and its subtrees, with the same 
+// structure and sort values. The data of each copied node is the 
+// result of 'cloneData' on the data of the original node, or the same
+// data if 'cloneData' is null
+// Return the root of the copy
+GenTree* _GenTreeClone(const GenTree* const that, 
+  void* (*cloneData)(void* const data)) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  GenTreeCloneParam param;
+  GenTreeCloneInit(&param, that, cloneData);
+  // The copies are in depth first order, so the i-th node of the run 
+  // through the tree is the i-th node of the copy, and its subtrees 
+  // have been initialized when its parent was reached
+  long iClone = 0;
+  for (const GenTree* node = that; node != NULL; 
+    node = GenTreeNextNode(that, node))
+    GenTreeCloneSubtrees(&param, node, iClone++);
+  // Return the root of the copy
+  return param._nodes;
+}
+
+// Allocate the nodes of the copy 'param' of the GenTree 'that' and 
+// initialize its root
+void GenTreeCloneInit(GenTreeCloneParam* const param, 
+  const GenTree* const that, void* (*cloneData)(void* const data)) {
+  long nb = that->_size + 1;
+  param->_block = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeBlock) + sizeof(GenTree) * nb);
+  param->_block->_nbLive = nb;
+  param->_nodes = (GenTree*)(param->_block + 1);
+  param->_cloneData = cloneData;
+  GenTree* root = param->_nodes;
+  GenTreeInitNode(root, NULL, (cloneData != NULL ? 
+    cloneData(that->_data) : that->_data));
+  root->_block = param->_block;
+  root->_size = that->_size;
+}
+
+// Initialize the copies of the subtrees of the node 'node' and link 
+// them to its copy, the 'iClone'-th node of the copy 'param'
+// Only the copy of 'node' and the copies of its subtrees are modified,
+// thus different nodes can be processed by different threads as long
+// as each node is processed after its parent
+void GenTreeCloneSubtrees(const GenTreeCloneParam* const param, 
+  const GenTree* const node, const long iClone) {
+  GenTree* clone = param->_nodes + iClone;
+  GSet* set = &(clone->_subtrees._set);
+  // The copy of each subtree follows the copies of the previous 
+  // subtrees and their own subtrees
+  long iSubtree = iClone + 1;
+  for (GSetElem* elem = node->_subtrees._set._head; elem != NULL; 
+    elem = elem->_next) {
+    GenTree* subtree = elem->_data;
+    GenTree* copy = param->_nodes + iSubtree;
+    GenTreeInitNode(copy, NULL, (param->_cloneData != NULL ? 
+      param->_cloneData(subtree->_data) : subtree->_data));
+    copy->_block = param->_block;
+    copy->_size = subtree->_size;
+    copy->_parent = clone;
+    copy->_link._sortVal = elem->_sortVal;
+    copy->_link._prev = set->_tail;
+    if (set->_tail != NULL)
+      set->_tail->_next = &(copy->_link);
+    else
+      set->_head = &(copy->_link);
+    set->_tail = &(copy->_link);
+    ++(set->_nbElem);
+    iSubtree += subtree->_size + 1;
+  }
+  // Invalidate the cached positions of the brotherhood
+  ++(clone->_subtreesGen);
+  // Copy the accelerating structures over the subtrees
+  if (GenTreeGetSubtreeArr(node) != NULL)
+    GenTreeSubtreeArrayCreate(clone);
+  if (GenTreeGetSkipList(node) != NULL)
+    GenTreeSubtreeSkipListCreate(clone);
+}
+
+// Create the skip list over the subtrees of the GenTree 'that'
+// Do nothing if the node already has a skip list
+void GenTreeSubtreeSkipListCreate(GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  GSetElem* check = that->_subtrees._set._head;
+  while (check != NULL && check->_next != NULL) {
+    if (check->_sortVal > check->_next->_sortVal) {
+      GenTreeErr->_type = PBErrTypeInvalidArg;
+      sprintf(GenTreeErr->_msg, "subtrees are not sorted");
+      PBErrCatch(GenTreeErr);
+    }
+    check = check->_next;
+  }
+#endif
+  if (GenTreeGetSkipList(that) != NULL)
+    // Nothing to do
+    return;
+  GenTreeSkipList* skipList = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeSkipList));
+  for (int iLevel = GENTREESKIPLIST_MAXLEVEL; iLevel--;)
+    skipList->_heads[iLevel] = NULL;
+  skipList->_nbLevel = 0;
+  skipList->_seed = 1;
+  GenTreeGetExtra(that)->_skipList = skipList;
+  // Append the subtrees to the levels, memorizing the last node of 
+  // each level. Only the subtrees above the list of subtrees need an
+  // optional state
+  GenTree* tails[GENTREESKIPLIST_MAXLEVEL] = {NULL};
+  GSetElem* elem = that->_subtrees._set._head;
+  while (elem != NULL) {
+    GenTree* subtree = elem->_data;
+    int nbLevel = GenTreeSkipListRandomLevel(skipList);
+    if (nbLevel > 0) {
+      GenTreeExtra* extra = GenTreeGetExtra(subtree);
+      extra->_skipLevel = nbLevel;
+      extra->_skipNext = 
+        PBErrMalloc(GenTreeErr, sizeof(GenTree*) * nbLevel);
+      for (int iLevel = 0; iLevel < nbLevel; ++iLevel) {
+        extra->_skipNext[iLevel] = NULL;
+        *GenTreeSkipListForward(skipList, tails[iLevel], iLevel) = subtree;
+        tails[iLevel] = subtree;
+      }
+      if (nbLevel > skipList->_nbLevel)
+        skipList->_nbLevel = nbLevel;
+    }
+    elem = elem->_next;
+  }
+}
+
+// Free the skip list over the subtrees of the GenTree 'that', if any
+void GenTreeSubtreeSkipListFree(GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  if (GenTreeGetSkipList(that) == NULL)
+    // Nothing to do
+    return;
+  GSetElem* elem = that->_subtrees._set._head;
+  while (elem != NULL) {
+    GenTree* subtree = elem->_data;
+    if (subtree->_extra != NULL) {
+      free(subtree->_extra->_skipNext);
+      subtree->_extra->_skipNext = NULL;
+      subtree->_extra->_skipLevel = 0;
+    }
+    elem = elem->_next;
+  }
+  free(that->_extra->_skipList);
+  that->_extra->_skipList = NULL;
+}
+
+// Return the address of the pointer to the next node of the node 
+// 'node' at the level 'iLevel' in the GenTreeSkipList 'that'. If 'node'
+// is null return the address of the head of the level
+GenTree** GenTreeSkipListForward(GenTreeSkipList* const that, 
+  GenTree* const node, const int iLevel) {
+  if (node == NULL)
+    return that->_heads + iLevel;
+  else
+    return node->_extra->_skipNext + iLevel;
+}
+
+// Return a random number of levels for a new node of the 
+// GenTreeSkipList 'that'
+int GenTreeSkipListRandomLevel(GenTreeSkipList* const that) {
+  // Linear congruential generator, local to the skip list to leave 
+  // untouched the sequence of rand() of the user
+  that->_seed = that->_seed * 1103515245UL + 12345UL;
+  unsigned long bits = (that->_seed >> 8) & 0xFFFFFFUL;
+  // Each level is kept with probability 1/4
+  int nbLevel = 0;
+  while ((bits & 3UL) == 0 && nbLevel < GENTREESKIPLIST_MAXLEVEL) {
+    ++nbLevel;
+    bits = (bits >> 2) | 0x800000UL;
+  }
+  return nbLevel;
+}
+
+// Set 'preds' to the last node of each level of the skip list of the 
+// GenTree 'that' whose sort value is strictly lower than 'sortVal' 
+// (or lower or equal if 'inclusive' is true). Null means the head of 
+// the level
+void GenTreeSkipListFindPreds(const GenTree* const that, 
+  const float sortVal, const bool inclusive, GenTree** const preds) {
+  GenTreeSkipList* skipList = GenTreeGetSkipList(that);
+  GenTree* node = NULL;
+  for (int iLevel = skipList->_nbLevel; iLevel--;) {
+    GenTree* next = *GenTreeSkipListForward(skipList, node, iLevel);
+    while (next != NULL && (next->_link._sortVal < sortVal || 
+      (inclusive && next->_link._sortVal == sortVal))) {
+      node = next;
+      next = next->_extra->_skipNext[iLevel];
+    }
+    preds[iLevel] = node;
+  }
+}
+
+// Return the element of the first subtree of the GenTree 'that' whose
+// sort value is strictly greater than 'sortVal' (or greater or equal 
+// if 'inclusive' is false), using its skip list
+GSetElem* GenTreeSkipListBound(const GenTree* const that, 
+  const float sortVal, const bool inclusive) {
+  GenTree* preds[GENTREESKIPLIST_MAXLEVEL];
+  GenTreeSkipListFindPreds(that, sortVal, inclusive, preds);
+  // Finish the search in the list of subtrees
+  GSetElem* elem = (that->_extra->_skipList->_nbLevel > 0 && 
+    preds[0] != NULL ?
+    &(preds[0]->_link) : that->_subtrees._set._head);
+  while (elem != NULL && (elem->_sortVal < sortVal || 
+    (inclusive && elem->_sortVal == sortVal)))
+    elem = elem->_next;
+  return elem;
+}
+
+// Insert the subtree 'tree' (already in the list of subtrees) in the
+// levels of the skip list of the GenTree 'that'
+void GenTreeSkipListInsert(GenTree* const that, GenTree* const tree) {
+  GenTreeSkipList* skipList = GenTreeGetSkipList(that);
+  int nbLevel = GenTreeSkipListRandomLevel(skipList);
+  if (nbLevel == 0)
+    return;
+  // Insert the node before the nodes with the same sort value, it keeps
+  // each level sorted whatever the position of the node among these 
+  // nodes in the list of subtrees
+  GenTree* preds[GENTREESKIPLIST_MAXLEVEL];
+  GenTreeSkipListFindPreds(that, tree->_link._sortVal, false, preds);
+  for (int iLevel = skipList->_nbLevel; iLevel < nbLevel; ++iLevel)
+    preds[iLevel] = NULL;
+  if (nbLevel > skipList->_nbLevel)
+    skipList->_nbLevel = nbLevel;
+  GenTreeExtra* extra = GenTreeGetExtra(tree);
+  extra->_skipLevel = nbLevel;
+  extra->_skipNext = PBErrMalloc(GenTreeErr, sizeof(GenTree*) * nbLevel);
+  for (int iLevel = 0; iLevel < nbLevel; ++iLevel) {
+    GenTree** forward = 
+      GenTreeSkipListForward(skipList, preds[iLevel], iLevel);
+    extra->_skipNext[iLevel] = *forward;
+    *forward = tree;
+  }
+}
+
+// Remove the subtree 'tree' from the levels of the skip list of the 
+// GenTree 'that'
+void GenTreeSkipListRemove(GenTree* const that, GenTree* const tree) {
+  GenTreeSkipList* skipList = GenTreeGetSkipList(that);
+  GenTreeExtra* extra = tree->_extra;
+  // The nodes without optional state are only in the list of subtrees
+  if (extra == NULL || extra->_skipLevel == 0)
+    return;
+  GenTree* preds[GENTREESKIPLIST_MAXLEVEL];
+  GenTreeSkipListFindPreds(that, tree->_link._sortVal, false, preds);
+  for (int iLevel = 0; iLevel < extra->_skipLevel; ++iLevel) {
+    // Skip the nodes with the same sort value preceding the node
+    GenTree** forward = 
+      GenTreeSkipListForward(skipList, preds[iLevel], iLevel);
+    while (*forward != tree)
+      forward = (*forward)->_extra->_skipNext + iLevel;
+    *forward = extra->_skipNext[iLevel];
+  }
+  // Remove the levels which have become empty
+  while (skipList->_nbLevel > 0 && 
+    skipList->_heads[skipList->_nbLevel - 1] == NULL)
+    --(skipList->_nbLevel);
+  free(extra->_skipNext);
+  extra->_skipNext = NULL;
+  extra->_skipLevel = 0;
+}
+
+// Disconnect the GenTree 'that' from its parent
+// If it has no parent, do nothing
+void _GenTreeCut(GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GSetErr->_msg, "'that' is null");
+    PBErrCatch(GSetErr);
+  }
+#endif
+  // If there is no parent
+  if (GenTreeParent(that) == NULL)
+    // Nothing to do
+    return;
+  // Remove the tree from the parent's subtrees, it also cuts the link
+  // to the parent
+  GenTreeUnlinkSubtree(GenTreeParent(that), &(that->_link));
+}
+
+// Move the GenTree 'that' and its subtrees to the 'pos'-th position in
+// the subtrees of the GenTree 'parent'
+void _GenTreeMoveSubtree(GenTree* const that, GenTree* const parent, 
+  const int pos) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (parent == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'parent' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  for (const GenTree* node = parent; node != NULL; node = node->_parent) {
+    if (node == that) {
+      GenTreeErr->_type = PBErrTypeInvalidArg;
+      sprintf(GenTreeErr->_msg, "'parent' is in 'that'");
+      PBErrCatch(GenTreeErr);
+    }
+  }
+  int nbSubtree = parent->_subtrees._set._nbElem - 
+    (that->_parent == parent ? 1 : 0);
+  if (pos < 0 || pos > nbSubtree) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'pos' is invalid (0<=%d<=%d)", pos, 
+      nbSubtree);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  float sortVal = that->_link._sortVal;
+  GenTree* oldParent = that->_parent;
+  // A root is simply inserted
+  if (oldParent == NULL) {
+    GenTreeLinkSubtree(parent, that, (GenTreeGetSkipList(parent) != NULL ? 
+      GenTreeSubtreeUpperBound(parent, sortVal) : 
+      GenTreeSubtreeElem(parent, pos)), sortVal);
+    return;
+  }
+  // Unlink the subtree and update its former ancestors, memorizing the
+  // generation of the former root and the former position of the 
+  // subtree, while the tree is without it, for its edit log if any
+  GSetElem* prev = that->_link._prev;
+  GenTreeUnlinkElem(oldParent, &(that->_link));
+  GenTree* oldRoot = GenTreeUpdateAncestors(oldParent, -(that->_size + 1));
+  unsigned long oldGen = oldRoot->_gen - 1;
+  GenTreeEditLog* oldLog = GenTreeGetEditLog(oldRoot);
+  int oldRank = (oldLog != NULL ? 
+    GenTreeRemovedRank(oldRoot, oldParent, prev) : 0);
+  // Link the subtree and update its new ancestors
+  GenTreeLinkElem(parent, that, (GenTreeGetSkipList(parent) != NULL ? 
+    GenTreeSubtreeUpperBound(parent, sortVal) : 
+    GenTreeSubtreeElem(parent, pos)), sortVal);
+  ++(that->_gen);
+  GenTree* root = GenTreeUpdateAncestors(parent, that->_size + 1);
+  // The nodes stay in the index if they stay in the same tree
+  if (root != oldRoot) {
+    if (GenTreeGetIndex(oldRoot) != NULL)
+      GenTreeIndexRemoveSubtree(GenTreeGetIndex(oldRoot), that);
+    if (GenTreeGetIndex(root) != NULL)
+      GenTreeIndexAddSubtree(GenTreeGetIndex(root), that);
+  }
+  // The edits of the move share the generation before the move
+  unsigned long gen = (root == oldRoot ? oldGen : root->_gen - 1);
+  if (oldLog != NULL)
+    GenTreeEditLogAdd(oldLog, oldRoot, oldGen, GenTreeEditRemove, 
+      oldRank, that->_size + 1, 0);
+  // Get the log of the new root once the removal is added, as it may 
+  // have released the log if the roots are the same
+  GenTreeEditLog* log = GenTreeGetEditLog(root);
+  if (log != NULL)
+    GenTreeEditLogAdd(log, root, gen, GenTreeEditInsert, 
+      _GenTreeRank(root, that), that->_size + 1, 
+      GenTreeNbAncestor(that));
+}
+
+// Move all the subtrees of the GenTree 'that' at the end of the 
+// subtrees of the GenTree 'to', keeping their order
+void _GenTreeGraftChildren(GenTree* const that, GenTree* const to) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (to == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'to' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  for (const GenTree* node = to->_parent; node != NULL; 
+    node = node->_parent) {
+    if (node == that) {
+      GenTreeErr->_type = PBErrTypeInvalidArg;
+      sprintf(GenTreeErr->_msg, "'to' is in the subtrees of 'that'");
+      PBErrCatch(GenTreeErr);
+    }
+  }
+#endif
+  GSet* set = &(that->_subtrees._set);
+  if (that == to || set->_nbElem == 0)
+    // Nothing to do
+    return;
+  int weight = that->_size;
+  // The nodes stay in the index if they stay in the same indexed tree
+  GenTreeIndex* index = GenTreeGetIndex(that);
+  bool isSameIndex = (index == GenTreeGetIndex(to));
+  if (index != NULL && !isSameIndex)
+    for (GSetElem* elem = set->_head; elem != NULL; elem = elem->_next)
+      GenTreeIndexRemoveSubtree(index, elem->_data);
+  GenTreeIndex* toIndex = (isSameIndex ? NULL : GenTreeGetIndex(to));
+  if (GenTreeGetSubtreeArr(that) != NULL || GenTreeGetSkipList(that) != NULL ||
+    GenTreeGetSubtreeArr(to) != NULL || GenTreeGetSkipList(to) != NULL) {
+    // If the subtrees have an array or a skip list, the subtrees are 
+    // moved one by one to keep them up to date
+    while (set->_head != NULL) {
+      float sortVal = set->_head->_sortVal;
+      GenTree* tree = GenTreeUnlinkElem(that, set->_head);
+      GenTreeLinkElem(to, tree, (GenTreeGetSkipList(to) != NULL ? 
+        GenTreeSubtreeUpperBound(to, sortVal) : NULL), sortVal);
+      ++(tree->_gen);
+      if (toIndex != NULL)
+        GenTreeIndexAddSubtree(toIndex, tree);
+    }
+  } else {
+    // Splice the whole list of subtrees at the end of the subtrees of
+    // 'to'
+    GSet* toSet = &(to->_subtrees._set);
+    GSetElem* first = set->_head;
+    first->_prev = toSet->_tail;
+    if (toSet->_tail != NULL)
+      toSet->_tail->_next = first;
+    else
+      toSet->_head = first;
+    toSet->_tail = set->_tail;
+    toSet->_nbElem += set->_nbElem;
+    that->_subtrees = GSetGenTreeCreateStatic();
+    // Invalidate the cached positions of both brotherhoods
+    ++(that->_subtreesGen);
+    ++(to->_subtreesGen);
+    // Update the parent and generation of the moved subtrees
+    for (GSetElem* elem = first; elem != NULL; elem = elem->_next) {
+      GenTree* tree = elem->_data;
+      tree->_parent = to;
+      tree->_siblingGen = to->_subtreesGen - 1;
+      ++(tree->_gen);
+      if (toIndex != NULL)
+        GenTreeIndexAddSubtree(toIndex, tree);
+    }
+  }
+  // Update the generation and size of the former and new ancestors
+  GenTreeUpdateAncestors(that, -weight);
+  GenTreeUpdateAncestors(to, weight);
+}
+
+// Return the 'iNode'-th node (starting at 0) of the subtrees of the 
+// GenTree 'that' in depth first order, the order of GenTreeIterDepth
+// Return null if 'iNode' is not in [0, GenTreeGetSize(that)[
+GenTree* _GenTreeSelect(const GenTree* const that, const int iNode) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  if (iNode < 0 || iNode >= that->_size)
+    return NULL;
+  // Number of nodes remaining to skip
+  int nbSkip = iNode;
+  const GenTree* node = that;
+  while (true) {
+    // Run through the subtrees of the current node, skipping the whole
+    // subtrees before the searched node
+    GSetElem* elem = node->_subtrees._set._head;
+    while (elem != NULL) {
+      GenTree* subtree = elem->_data;
+      if (nbSkip == 0)
+        return subtree;
+      --nbSkip;
+      if (nbSkip < subtree->_size)
+        break;
+      nbSkip -= subtree->_size;
+      elem = elem->_next;
+    }
+    // The searched node is in this subtree
+    node = elem->_data;
+  }
+}
+
+// Return the position of the node 'node' in the subtrees of the 
+// GenTree 'that' in depth first order, the order of GenTreeIterDepth
+// 'node' must be a descendant of 'that'
+int _GenTreeRank(const GenTree* const that, const GenTree* const node) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (node == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'node' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  const GenTree* ancestor = node->_parent;
+  while (ancestor != NULL && ancestor != that)
+    ancestor = ancestor->_parent;
+  if (ancestor == NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'node' is not a descendant of 'that'");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  int rank = 0;
+  const GenTree* cur = node;
+  while (true) {
+    // Add the nodes of the previous brothers and their subtrees, 
+    // counting them from both ends of the brotherhood at once so the 
+    // cost is the one of the nearest end: if the next brothers end 
+    // first, the previous ones are the rest of the subtrees of the 
+    // parent
+    GSetElem* prev = cur->_link._prev;
+    GSetElem* next = cur->_link._next;
+    int nbBefore = 0;
+    int nbAfter = 0;
+    while (prev != NULL && next != NULL) {
+      nbBefore += ((GenTree*)(prev->_data))->_size + 1;
+      nbAfter += ((GenTree*)(next->_data))->_size + 1;
+      prev = prev->_prev;
+      next = next->_next;
+    }
+    if (prev == NULL)
+      rank += nbBefore;
+    else
+      rank += cur->_parent->_size - (cur->_size + 1) - nbAfter;
+    if (cur->_parent == that)
+      return rank;
+    // Add the parent itself and climb up
+    ++rank;
+    cur = cur->_parent;
+  }
+}
+
+// Append a new node with 'data' to the first node containing 'node'
+// in the GenTree 'that'
+// Uses the iterator 'iter' to search the node
+// Return true if we could find 'node', false else
+bool _GenTreeAppendToNode(GenTree* const that, 
+  void* const data, void* const node, GenTreeIter* const iter) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GSetErr->_msg, "'that' is null");
+    PBErrCatch(GSetErr);
+  }
+  if (iter == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GSetErr->_msg, "'iter' is null");
+    PBErrCatch(GSetErr);
+  }
+#endif
+  // Declare a variable to memorize the result
+  bool res = false;
+  // Search the node where to append the data
+  GenTree* nodeTree = GenTreeSearch(that, node, iter);
+  // If we could find the node
+  if (nodeTree != NULL) {
+    // Append the data
+    GenTreeAppendData(nodeTree, data);
+    // Update the result
+    res = true;
+  }
+  // Return the result
+  return res;
+}
+
+// Search the first node containing 'data' in the GenTree 'that'
+// Uses the iterator 'iter' to search the node. Do not reset the 
+// iterator, thus several calls with the same iterator will return 
+// eventual successive nodes containing the same data. If one want to 
+// loop on these nodes, the proper stopping condition is 
+// while(GenTreeSearch() != NULL && GenTreeIterIsLast() == false)
+// If the tree is indexed and 'iter' is an up to date GenTreeIterDepth,
+// the node is found with the index and the iterator moved directly 
+// after it, else the iterator runs through the nodes
+// Return the node if we could find 'data', null else
+GenTree* _GenTreeSearch(const GenTree* const that, 
+  const void* const data, GenTreeIter* const iter) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GSetErr->_msg, "'that' is null");
+    PBErrCatch(GSetErr);
+  } 
+  if (iter == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GSetErr->_msg, "'iter' is null");
+    PBErrCatch(GSetErr);
+  }
+#endif
+  (void)that;
+  // Declare a variable to memorize the result
+  GenTree* res = NULL;
+  // If the attached tree is indexed
+  if (GenTreeGetIndex(iter->_tree) != NULL) {
+    // If no node contains the data there is no need to run through the
+    // nodes
+    if (GenTreeIndexSearch(iter->_tree, data, NULL) == NULL) {
+      GenTreeIterToEnd(iter);
+      return res;
+    }
+    // If the sequence is up to date and the nodes containing the data
+    // are at their depth first position in it, move directly after 
+    // the first one from the current position
+    if (!GenTreeIterIsStale(iter)) {
+      int pos = 0;
+      res = GenTreeIndexSearchFrom(iter->_tree, data, 
+        GenTreeIterGetPos(iter), iter->_seq, iter->_nbNode, &pos);
+      if (res != NULL) {
+        GenTreeIterSeek(iter, pos);
+        GenTreeIterStep(iter);
+        return res;
+      } else if (pos != -1) {
+        GenTreeIterToEnd(iter);
+        return res;
+      }
+    }
+  }
+  // Loop until we have found or reached the end
+  do {
+    // If we have found the searched data
+    if (GenTreeIterGetData(iter) == data)
+      // Memorize the node containing the data
+      res = GenTreeIterGetGenTree(iter);
+  } while (GenTreeIterStep(iter) && res == NULL);
+  // Return the result
+  return res;
+}
+
+// ----------- GenTreePool
+
+// ================ Functions implementation ====================
+
+// Create a new GenTreePool allocating nodes by chunks of 
+// 'nbNodePerChunk' nodes
+GenTreePool* GenTreePoolCreate(const int nbNodePerChunk) {
+#if BUILDMODE == 0
+  if (nbNodePerChunk <= 0) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'nbNodePerChunk' is invalid (%d>0)",
+      nbNodePerChunk);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Declare the new pool
+  GenTreePool* that = PBErrMalloc(GenTreeErr, sizeof(GenTreePool));
+  // Set properties
+  *that = GenTreePoolCreateStatic(nbNodePerChunk);
+  // Return the pool
+  return that;
+}
+
+// Create a new static GenTreePool allocating nodes by chunks of 
+// 'nbNodePerChunk' nodes
+GenTreePool GenTreePoolCreateStatic(const int nbNodePerChunk) {
+#if BUILDMODE == 0
+  if (nbNodePerChunk <= 0) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'nbNodePerChunk' is invalid (%d>0)",
+      nbNodePerChunk);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Declare the new pool
+  GenTreePool that;
+  // Set properties
+  that._nbNodePerChunk = nbNodePerChunk;
+  that._chunks = GSetCreateStatic();
+  that._nbUsedByte = 0;
+  that._freeNodes = NULL;
+  that._isArena = false;
+  that._nbLive = 0;
+  that._nbRecycled = 0;
+  that._extras = NULL;
+  // Return the pool
+  return that;
+}
+
+// Create a new GenTreePool in arena mode allocating memory by chunks 
+// of 'nbNodePerChunk' nodes
+GenTreePool* GenTreePoolCreateArena(const int nbNodePerChunk) {
+  // Declare the new pool
+  GenTreePool* that = GenTreePoolCreate(nbNodePerChunk);
+  // Set properties
+  that->_isArena = true;
+  // Return the pool
+  return that;
+}
+
+// Create a new static GenTreePool in arena mode allocating memory by 
+// chunks of 'nbNodePerChunk' nodes
+GenTreePool GenTreePoolCreateStaticArena(const int nbNodePerChunk) {
+  // Declare the new pool
+  GenTreePool that = GenTreePoolCreateStatic(nbNodePerChunk);
+  // Set properties
+  that._isArena = true;
+  // Return the pool
+  return that;
+}
+
+// Free the memory used by the GenTreePool 'that'
+// All the nodes allocated from the pool must have been freed before
+void GenTreePoolFree(GenTreePool** that) {
+  // Check argument
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // Free memory
+  GenTreePoolFreeStatic(*that);
+  free(*that);
+  *that = NULL;
+}
+
+// Free the memory used by the static GenTreePool 'that'
+// All the nodes allocated from the pool must have been freed before
+void GenTreePoolFreeStatic(GenTreePool* const that) {
+  // Check argument
+  if (that == NULL)
+    // Nothing to do
+    return;
+  // Free the optional states of the nodes not freed
+  GenTreePoolFreeExtras(that);
+  // Free the chunks
+  while (GSetNbElem(&(that->_chunks)) > 0) {
+    void* chunk = GSetPop(&(that->_chunks));
+    free(chunk);
+  }
+  that->_nbUsedByte = 0;
+  that->_freeNodes = NULL;
+  that->_nbLive = 0;
+}
+
+// Release at once all the nodes allocated from the GenTreePool 'that'
+// The trees allocated from the pool must not be used anymore, the 
+// memory is kept for reuse
+void GenTreePoolReset(GenTreePool* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Free the optional states of the nodes, while they are still 
+  // readable
+  GenTreePoolFreeExtras(that);
+  // Keep the current chunk and free the other ones
+  if (GSetNbElem(&(that->_chunks)) > 1) {
+    void* chunk = GSetPop(&(that->_chunks));
+    while (GSetNbElem(&(that->_chunks)) > 0) {
+      void* oldChunk = GSetPop(&(that->_chunks));
+      free(oldChunk);
+    }
+    GSetPush(&(that->_chunks), chunk);
+  }
+  that->_nbUsedByte = 0;
+  that->_freeNodes = NULL;
+  that->_nbLive = 0;
+}
+
+// Get 'size' bytes from the current chunk of the GenTreePool 'that'
+void* GenTreePoolAlloc(GenTreePool* const that, const size_t size) {
+  // Size in byte of the chunks
+  size_t sizeChunk = sizeof(GenTree) * that->_nbNodePerChunk;
+  // If there is no chunk or the current chunk is full
+  if (GSetNbElem(&(that->_chunks)) == 0 || 
+    that->_nbUsedByte + size > sizeChunk) {
+    // Allocate a new chunk
+    void* chunk = PBErrMalloc(GenTreeErr, sizeChunk);
+    GSetPush(&(that->_chunks), chunk);
+    that->_nbUsedByte = 0;
+  }
+  // Take the memory in the current chunk
+  void* ptr = (char*)GSetHead(&(that->_chunks)) + that->_nbUsedByte;
+  that->_nbUsedByte += size;
+  // Return the memory
+  return ptr;
+}
+
+// Get a node from the GenTreePool 'that'
+GenTree* GenTreePoolAllocNode(GenTreePool* const that) {
+  // Declare a variable to memorize the node
+  GenTree* node = NULL;
+  // If there is a recycled node
+  if (that->_freeNodes != NULL) {
+    // Pop it from the freelist
+    node = that->_freeNodes;
+    that->_freeNodes = node->_parent;
+    ++(that->_nbRecycled);
+  } else {
+    // Take a new node in the current chunk
+    node = GenTreePoolAlloc(that, sizeof(GenTree));
+  }
+  ++(that->_nbLive);
+  // Return the node
+  return node;
+}
+
+// Free the optional states of the nodes allocated from the 
+// GenTreePool 'that' and the memory they own, without freeing the nodes
+void GenTreePoolFreeExtras(GenTreePool* const that) {
+  GenTreeExtra* extra = that->_extras;
+  while (extra != NULL) {
+    GenTreeExtra* next = extra->_poolNext;
+    // The index is owned by the root of the tree
+    if (extra->_index != NULL) {
+      free(extra->_index->_slots);
+      free(extra->_index->_buckets);
+      free(extra->_index);
+    }
+    free(extra->_subtreeArr);
+    free(extra->_skipList);
+    free(extra->_skipNext);
+    free(extra->_editLog);
+    extra->_node->_extra = NULL;
+    free(extra);
+    extra = next;
+  }
+  that->_extras = NULL;
+}
+
+// Give back the node 'node' to the GenTreePool 'that'
+void GenTreePoolReleaseNode(GenTreePool* const that, GenTree* const node) {
+  // Push the node in the freelist, nodes of an arena are released 
+  // with the arena
+  if (!(that->_isArena)) {
+    node->_parent = that->_freeNodes;
+    that->_freeNodes = node;
+  }
+  --(that->_nbLive);
+}
+
+// ----------- GenTreeIter
+
+// ================ Functions declaration ====================
+
+// Initialise the iterator 'that' on the GenTree 'tree' with an empty 
+// sequence stored in 'buffer' of 'capacity' nodes if 'buffer' is not 
+// null
+void GenTreeIterInit(GenTreeIter* const that, GenTree* const tree, 
+  GenTree** const buffer, const int capacity);
+
+// Append the node 'node' at the end of the sequence of the iterator 
+// 'that', growing the array of the sequence if necessary
+void GenTreeIterSeqAppend(GenTreeIter* const that, GenTree* const node);
+
+// Grow the array of the sequence of the iterator 'that' to 'capacity'
+// nodes if it's smaller, keeping the nodes already in the sequence
+void GenTreeIterSeqReserve(GenTreeIter* const that, const int capacity);
+
+// Allocate the positions of the nodes of the sequence of the iterator
+// 'that' for the capacity of the array of the sequence, if it has none
+void GenTreeIterPosReserve(GenTreeIter* const that);
+
+// Create the sequence of an iterator for depth first
+void GenTreeIterCreateSequenceDepthFirst(GenTreeIter* const that);
+
+// Orders of the sequences of the iterators
+typedef enum GenTreeIterOrder {
+  GenTreeIterOrderDepth, GenTreeIterOrderBreadth, GenTreeIterOrderValue
+} GenTreeIterOrder;
+
+// Part of the former sequence of an iterator kept by a patch
+typedef struct GenTreeIterPatchSeg {
+  // Position of the part in the former sequence and in the patched one
+  int _from;
+  int _to;
+  // Number of nodes in the part
+  int _nb;
+} GenTreeIterPatchSeg;
+
+// Edits of a tree replayed on the positions in depth first order of the
+// sequence of an iterator
+typedef struct GenTreeIterPatch {
+  // Parts of the former sequence kept in the patched one, in order, 
+  // each replayed edit splits at most one part
+  GenTreeIterPatchSeg _segs[GENTREEEDITLOG_NBEDIT + 1];
+  int _nbSeg;
+  // Number of nodes in the patched sequence
+  int _nbNode;
+  // Root of the attached tree, and position in depth first order in the
+  // root of the first node of the patched sequence
+  GenTree* _root;
+  int _rootRank;
+} GenTreeIterPatch;
+
+// Node inserted in the sequence of an iterator for breadth first or 
+// value first by a patch
+typedef struct GenTreeIterPatchNode {
+  // The node
+  GenTree* _tree;
+  // Its position in depth first order and its depth in the attached 
+  // tree
+  GenTreeIterPos _pos;
+} GenTreeIterPatchNode;
+
+// Patch the sequence in the order 'order' of the iterator 'that' with 
+// the edits memorized in the edit log of the root of its attached tree
+// since the last update
+// Return false, and leave the sequence untouched, if the sequence 
+// can't be patched and must be recreated
+bool GenTreeIterPatchSequence(GenTreeIter* const that, 
+  const GenTreeIterOrder order);
+
+// Replay in 'patch' the edits memorized in the edit log of the root of
+// the attached tree of the iterator 'that' since the last update
+// Return false if the log doesn't allow to patch the sequence
+bool GenTreeIterPatchReplay(const GenTreeIter* const that, 
+  GenTreeIterPatch* const patch);
+
+// Replay in 'that' the insertion of 'nb' nodes at the position 'rank'
+void GenTreeIterPatchInsert(GenTreeIterPatch* const that, const int rank, 
+  const int nb);
+
+// Replay in 'that' the removal of 'nb' nodes at the position 'rank'
+void GenTreeIterPatchRemove(GenTreeIterPatch* const that, const int rank, 
+  const int nb);
+
+// Apply the patch 'patch' to the sequence of the iterator 'that' for 
+// depth first
+void GenTreeIterPatchDepthFirst(GenTreeIter* const that, 
+  const GenTreeIterPatch* const patch);
+
+// Apply the patch 'patch' to the sequence of the iterator 'that' for 
+// the order 'order', breadth first or value first
+void GenTreeIterPatchSorted(GenTreeIter* const that, 
+  const GenTreeIterPatch* const patch, const GenTreeIterOrder order);
+
+// Return true if the node 'node' inserted by a patch is after the 
+// 'iNode'-th node of the sequence of the iterator 'that' in the order
+// 'order', breadth first or value first
+bool GenTreeIterPatchIsAfter(const GenTreeIter* const that, 
+  const GenTreeIterOrder order, const GenTreeIterPatchNode* const node, 
+  const int iNode);
+
+// Comparison of GenTreeIterPatchNode in breadth first order, by depth 
+// then rank, and in value first order, by sort value then rank
+int GenTreeIterPatchNodeCmpBreadth(const void* a, const void* b);
+int GenTreeIterPatchNodeCmpValue(const void* a, const void* b);
+
+// Memorize in the iterator 'that', whose sequence has just been 
+// created, the root of its attached tree to patch the sequence at the 
+// next update, creating the edit log of the root if it has none
+void GenTreeIterAttachLog(GenTreeIter* const that);
+
+// Create the sequence of an iterator for breadth first
+void GenTreeIterCreateSequenceBreadthFirst(GenTreeIter* const that);
+
+// Append the node 'node' at the end of the sequence of the iterator 
+// 'that' as GenTreeIterSeqAppend, with its position 'rank' in depth 
+// first order and its depth 'depth'
+void GenTreeIterSeqAppendPos(GenTreeIter* const that, GenTree* const node,
+  const int rank, const int depth);
+
+// Write the subtrees of the node 'node', at the position 'rank' in 
+// depth first order and the depth 'depth', in the array of sequence 
+// 'seq' and their positions in 'pos', from the index 'iSeq'
+// Return the index following the last subtree
+int GenTreeIterSeqWriteSubtrees(GenTree** const seq, 
+  GenTreeIterPos* const pos, const GenTree* const node, const int rank, 
+  const int depth, int iSeq);
+
+// Create the sequence of an iterator for value first, limited to the 
+// 'nb' first nodes if 'nb' is not negative
+void GenTreeIterCreateSequenceValueFirst(GenTreeIter* const that, int nb);
+
+// Node of the heap used to create the sequence of an iterator for value
+// first
+typedef struct GenTreeIterValueHeapNode {
+  // The node
+  GenTree* _tree;
+  // Its sort value
+  float _sortVal;
+  // Its rank in depth first order, used to keep the order of 
+  // GSetAddSort between nodes with same sort value
+  int _rank;
+} GenTreeIterValueHeapNode;
+
+// Sift down the node at index 'iNode' in the heap 'heap' of 'nbNode' 
+// nodes
+void GenTreeIterValueHeapSiftDown(GenTreeIterValueHeapNode* const heap, 
+  const int nbNode, int iNode);
+
+// ================ Functions implementation ====================
+
+// Create a new GenTreeIterDepth for the GenTree 'tree'
+GenTreeIterDepth* _GenTreeIterDepthCreate(GenTree* const tree) {
+#if BUILDMODE == 0
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Declare the new iterator
+  GenTreeIterDepth *iter = PBErrMalloc(GenTreeErr, sizeof(GenTreeIterDepth));
+  // Set properties
+  GenTreeIterInit((GenTreeIter*)iter, tree, NULL, 0);
+  GenTreeIterDepthUpdate(iter);
+  // Return the iterator
+  return iter;  
+}
+
+// Create a new static GenTreeIterDepth for the GenTree 'tree'
+GenTreeIterDepth _GenTreeIterDepthCreateStatic(GenTree* const tree) {
+  // Return the new iterator
+  return _GenTreeIterDepthCreateStaticBuffer(tree, NULL, 0);
+}
+
+// Create a new static GenTreeIterDepth for the GenTree 'tree' whose 
+// sequence is stored in the user array 'buffer' of 'capacity' nodes
+// If the sequence grows beyond 'capacity' it's moved to an array 
+// allocated by the iterator
+GenTreeIterDepth _GenTreeIterDepthCreateStaticBuffer(GenTree* const tree,
+  GenTree** const buffer, const int capacity) {
+#if BUILDMODE == 0
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Declare the new iterator
+  GenTreeIterDepth iter;
+  // Set properties
+  GenTreeIterInit((GenTreeIter*)&iter, tree, buffer, capacity);
+  GenTreeIterDepthUpdate(&iter);
+  // Return the iterator
+  return iter;
+}
+
+// Create a new GenTreeIterBreadth for the GenTree 'tree'
+GenTreeIterBreadth* _GenTreeIterBreadthCreate(GenTree* const tree) {
+#if BUILDMODE == 0
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Declare the new iterator
+  GenTreeIterBreadth *iter = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeIterBreadth));
+  // Set properties
+  GenTreeIterInit((GenTreeIter*)iter, tree, NULL, 0);
+  GenTreeIterBreadthUpdate(iter);
+  // Return the iterator
+  return iter;  
+}
+
+// Create a new static GenTreeIterBreadth for the GenTree 'tree'
+GenTreeIterBreadth _GenTreeIterBreadthCreateStatic(GenTree* const tree) {
+  // Return the new iterator
+  return _GenTreeIterBreadthCreateStaticBuffer(tree, NULL, 0);
+}
+
+// Create a new static GenTreeIterBreadth for the GenTree 'tree' whose 
+// sequence is stored in the user array 'buffer' of 'capacity' nodes
+// If the sequence grows beyond 'capacity' it's moved to an array 
+// allocated by the iterator
+GenTreeIterBreadth _GenTreeIterBreadthCreateStaticBuffer(
+  GenTree* const tree, GenTree** const buffer, const int capacity) {
+#if BUILDMODE == 0
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Declare the new iterator
+  GenTreeIterBreadth iter;
+  // Set properties
+  GenTreeIterInit((GenTreeIter*)&iter, tree, buffer, capacity);
+  GenTreeIterBreadthUpdate(&iter);
+  // Return the iterator
+  return iter;
+}
+
+// Create a new GenTreeIterValue for the GenTree 'tree'
+GenTreeIterValue* _GenTreeIterValueCreate(GenTree* const tree) {
+#if BUILDMODE == 0
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Declare the new iterator
+  GenTreeIterValue *iter = PBErrMalloc(GenTreeErr, sizeof(GenTreeIterValue));
+  // Set properties
+  GenTreeIterInit((GenTreeIter*)iter, tree, NULL, 0);
+  GenTreeIterValueUpdate(iter);
+  // Return the iterator
+  return iter;  
+}
+
+// Create a new static GenTreeIterValue for the GenTree 'tree'
+GenTreeIterValue _GenTreeIterValueCreateStatic(GenTree* const tree) {
+  // Return the new iterator
+  return _GenTreeIterValueCreateStaticBuffer(tree, NULL, 0);
+}
+
+// Create a new static GenTreeIterValue for the GenTree 'tree' whose 
+// sequence is stored in the user array 'buffer' of 'capacity' nodes
+// If the sequence grows beyond 'capacity' it's moved to an array 
+// allocated by the iterator
+GenTreeIterValue _GenTreeIterValueCreateStaticBuffer(GenTree* const tree,
+  GenTree** const buffer, const int capacity) {
+#if BUILDMODE == 0
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Declare the new iterator
+  GenTreeIterValue iter;
+  // Set properties
+  GenTreeIterInit((GenTreeIter*)&iter, tree, buffer, capacity);
+  GenTreeIterValueUpdate(&iter);
+  // Return the iterator
+  return iter;
+}
+
+// Initialise the iterator 'that' on the GenTree 'tree' with an empty 
+// sequence stored in 'buffer' of 'capacity' nodes if 'buffer' is not 
+// null
+void GenTreeIterInit(GenTreeIter* const that, GenTree* const tree, 
+  GenTree** const buffer, const int capacity) {
+#if BUILDMODE == 0
+  if (buffer != NULL && capacity < 0) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'capacity' is invalid (0<=%d)", capacity);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  that->_tree = tree;
+  that->_curPos = 0;
+  that->_seq = buffer;
+  that->_nbNode = 0;
+  that->_capacity = (buffer != NULL ? capacity : 0);
+  that->_isUserBuffer = (buffer != NULL);
+  // The generation of the tree only increases, hence the iterator is 
+  // stale until its first update
+  that->_gen = tree->_gen - 1;
+  that->_root = NULL;
+  that->_rootGen = 0;
+  that->_rootRank = 0;
+  that->_pos = NULL;
+}
+
+// Append the node 'node' at the end of the sequence of the iterator 
+// 'that', growing the array of the sequence if necessary
+void GenTreeIterSeqAppend(GenTreeIter* const that, GenTree* const node) {
+  // If the array is full, double its capacity
+  if (that->_nbNode == that->_capacity)
+    GenTreeIterSeqReserve(that, 
+      (that->_capacity > 0 ? that->_capacity * 2 : 16));
+  // Append the node
+  that->_seq[that->_nbNode] = node;
+  ++(that->_nbNode);
+}
+
+// Grow the array of the sequence of the iterator 'that' to 'capacity'
+// nodes if it's smaller, keeping the nodes already in the sequence
+void GenTreeIterSeqReserve(GenTreeIter* const that, const int capacity) {
+  if (capacity <= that->_capacity)
+    return;
+  GenTree** seq = PBErrMalloc(GenTreeErr, sizeof(GenTree*) * capacity);
+  if (that->_nbNode > 0)
+    memcpy(seq, that->_seq, sizeof(GenTree*) * that->_nbNode);
+  // A user array is left untouched, the sequence moves to the array 
+  // allocated by the iterator
+  if (!(that->_isUserBuffer))
+    free(that->_seq);
+  that->_seq = seq;
+  that->_isUserBuffer = false;
+  // Grow the positions of the nodes along with the sequence, if any
+  if (that->_pos != NULL) {
+    GenTreeIterPos* pos = 
+      PBErrMalloc(GenTreeErr, sizeof(GenTreeIterPos) * capacity);
+    if (that->_nbNode > 0)
+      memcpy(pos, that->_pos, sizeof(GenTreeIterPos) * that->_nbNode);
+    free(that->_pos);
+    that->_pos = pos;
+  }
+  that->_capacity = capacity;
+}
+
+// Allocate the positions of the nodes of the sequence of the iterator
+// 'that' for the capacity of the array of the sequence, if it has none
+void GenTreeIterPosReserve(GenTreeIter* const that) {
+  if (that->_pos == NULL && that->_capacity > 0)
+    that->_pos = 
+      PBErrMalloc(GenTreeErr, sizeof(GenTreeIterPos) * that->_capacity);
+}
+
+// Update the GenTreeIterDepth 'that' in case its attached GenTree has been 
+// modified
+// The node sequence doesn't include the root node of the attached tree
+// Do nothing if the iterator is not stale
+void GenTreeIterDepthUpdate(GenTreeIterDepth* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // If the attached tree has been modified since the last update
+  if (GenTreeIterIsStale(that)) {
+    // Patch the sequence with the edits of the tree if possible, else
+    // create the sequence with a Depth First run through nodes of the 
+    // tree
+    if (!GenTreeIterPatchSequence((GenTreeIter*)that, 
+      GenTreeIterOrderDepth)) {
+      GenTreeIterCreateSequenceDepthFirst((GenTreeIter*)that);
+      GenTreeIterAttachLog((GenTreeIter*)that);
+    }
+    // Memorize the generation of the attached tree
+    ((GenTreeIter*)that)->_gen = GenTreeIterGenTree(that)->_gen;
+  }
+  // Reset the current position
+  GenTreeIterReset(that);
+}
+
+// Create the sequence of an iterator for depth first
+// The array of the sequence is reused, the run through the tree is 
+// done without recursion
+void GenTreeIterCreateSequenceDepthFirst(GenTreeIter* const that) {
+  // Empty the sequence
+  that->_nbNode = 0;
+  // Append the current tree to the sequence if it's not root
+  GenTree* tree = that->_tree;
+  if (!GenTreeIsRoot(tree))
+    GenTreeIterSeqAppend(that, tree);
+  // Run through the tree in depth first order
+  GenTree* node = tree;
+  while (node != NULL) {
+    // If the node has subtrees, the next node is its first subtree
+    GSetElem* elem = node->_subtrees._set._head;
+    // Else it's the next brother of the node or of its nearest ancestor
+    while (elem == NULL && node != tree) {
+      elem = node->_link._next;
+      if (elem == NULL)
+        node = node->_parent;
+    }
+    if (elem != NULL) {
+      node = elem->_data;
+      GenTreeIterSeqAppend(that, node);
+    } else {
+      node = NULL;
+    }
+  }
+}
+
+// Patch the sequence in the order 'order' of the iterator 'that' with
+// the edits memorized in the edit log of the root of its attached tree
+// since the last update
+// Return false, and leave the sequence untouched, if the sequence
+// can't be patched and must be recreated
+bool GenTreeIterPatchSequence(GenTreeIter* const that,
+  const GenTreeIterOrder order) {
+  GenTreeIterPatch patch;
+  if (!GenTreeIterPatchReplay(that, &patch))
+    return false;
+  if (order == GenTreeIterOrderDepth)
+    GenTreeIterPatchDepthFirst(that, &patch);
+  else
+    GenTreeIterPatchSorted(that, &patch, order);
+  // Memorize the state of the root for the next patch, the log has
+  // been read
+  that->_rootGen = patch._root->_gen;
+  that->_rootRank = patch._rootRank;
+  GenTreeGetEditLog(patch._root)->_nbUnread = 0;
+  return true;
+}
+
+// Replay in 'patch' the edits memorized in the edit log of the root of
+// the attached tree of the iterator 'that' since the last update
+// Return false if the log doesn't allow to patch the sequence
+bool GenTreeIterPatchReplay(const GenTreeIter* const that,
+  GenTreeIterPatch* const patch) {
+  // The positions in the log are relative to the root, which must be
+  // the one of the last update
+  GenTree* tree = that->_tree;
+  GenTree* root = tree;
+  int depth = 0;
+  while (root->_parent != NULL) {
+    root = root->_parent;
+    ++depth;
+  }
+  if (root != that->_root)
+    return false;
+  // The log must contain all the edits since the last update, and the
+  // tree must not have been modified otherwise
+  GenTreeEditLog* log = GenTreeGetEditLog(root);
+  if (log == NULL || log->_gen != root->_gen ||
+    that->_rootGen < log->_genMin)
+    return false;
+  // The whole former sequence is kept until the first edit
+  bool isRoot = (tree == root);
+  int offset = that->_rootRank;
+  int nbNode = that->_nbNode;
+  patch->_nbSeg = 0;
+  if (nbNode > 0) {
+    patch->_segs[0]._from = 0;
+    patch->_segs[0]._to = 0;
+    patch->_segs[0]._nb = nbNode;
+    patch->_nbSeg = 1;
+  }
+  for (int iEdit = 0; iEdit < log->_nbEdit; ++iEdit) {
+    const GenTreeEdit* edit =
+      log->_edits + (log->_first + iEdit) % GENTREEEDITLOG_NBEDIT;
+    if (edit->_gen < that->_rootGen)
+      continue;
+    // Position of the edit in the sequence
+    int rank = edit->_rank - offset;
+    int nb = edit->_nbNode;
+    if (edit->_op == GenTreeEditInsert) {
+      // If the attached tree is not the root, the nodes inserted before
+      // it shift it, and the ones inserted right after its last node
+      // are in it only if they are deeper than it
+      if (!isRoot && rank <= 0) {
+        offset += nb;
+      } else if (isRoot || rank < nbNode ||
+        (rank == nbNode && edit->_depth > depth)) {
+        GenTreeIterPatchInsert(patch, rank, nb);
+        nbNode += nb;
+      }
+    } else {
+      // A removed subtree is either before, after or in the attached
+      // tree, unless the attached tree is in it
+      if (!isRoot && rank + nb <= 0) {
+        offset -= nb;
+      } else if (isRoot || rank >= 1) {
+        if (rank < nbNode) {
+          GenTreeIterPatchRemove(patch, rank, nb);
+          nbNode -= nb;
+        }
+      } else {
+        return false;
+      }
+    }
+  }
+  // The patched sequence must contain all the nodes of the tree
+  if (nbNode != tree->_size + (isRoot ? 0 : 1))
+    return false;
+  patch->_nbNode = nbNode;
+  patch->_root = root;
+  patch->_rootRank = offset;
+  return true;
+}
+
+// Replay in 'that' the insertion of 'nb' nodes at the position 'rank'
+void GenTreeIterPatchInsert(GenTreeIterPatch* const that, const int rank,
+  const int nb) {
+  // Shift the parts after the inserted nodes, and split the one
+  // containing them if any
+  for (int iSeg = that->_nbSeg; iSeg--;) {
+    GenTreeIterPatchSeg* seg = that->_segs + iSeg;
+    if (seg->_to >= rank) {
+      seg->_to += nb;
+    } else {
+      if (seg->_to + seg->_nb > rank) {
+        memmove(seg + 2, seg + 1,
+          sizeof(GenTreeIterPatchSeg) * (that->_nbSeg - iSeg - 1));
+        int nbBefore = rank - seg->_to;
+        seg[1]._from = seg->_from + nbBefore;
+        seg[1]._to = rank + nb;
+        seg[1]._nb = seg->_nb - nbBefore;
+        seg->_nb = nbBefore;
+        ++(that->_nbSeg);
+      }
+      return;
+    }
+  }
+}
+
+// Replay in 'that' the removal of 'nb' nodes at the position 'rank'
+void GenTreeIterPatchRemove(GenTreeIterPatch* const that, const int rank,
+  const int nb) {
+  // Cut the parts overlapping the removed nodes, which splits the part
+  // containing them if any, and shift the parts after them
+  GenTreeIterPatchSeg segs[GENTREEEDITLOG_NBEDIT + 1];
+  int nbSeg = 0;
+  for (int iSeg = 0; iSeg < that->_nbSeg; ++iSeg) {
+    const GenTreeIterPatchSeg* seg = that->_segs + iSeg;
+    int end = seg->_to + seg->_nb;
+    if (seg->_to < rank) {
+      segs[nbSeg] = *seg;
+      segs[nbSeg]._nb = (end < rank ? end : rank) - seg->_to;
+      ++nbSeg;
+    }
+    if (end > rank + nb) {
+      int start = (seg->_to > rank + nb ? seg->_to : rank + nb);
+      segs[nbSeg]._from = seg->_from + start - seg->_to;
+      segs[nbSeg]._to = start - nb;
+      segs[nbSeg]._nb = end - start;
+      ++nbSeg;
+    }
+  }
+  memcpy(that->_segs, segs, sizeof(GenTreeIterPatchSeg) * nbSeg);
+  that->_nbSeg = nbSeg;
+}
+
+// Apply the patch 'patch' to the sequence of the iterator 'that' for
+// depth first
+void GenTreeIterPatchDepthFirst(GenTreeIter* const that,
+  const GenTreeIterPatch* const patch) {
+  if (patch->_nbNode > that->_capacity)
+    GenTreeIterSeqReserve(that, (patch->_nbNode > 2 * that->_capacity ?
+      patch->_nbNode : 2 * that->_capacity));
+  // Move the kept parts, the ones moving toward the start in order,
+  // then the ones moving toward the end in reverse order, so no part
+  // overwrites one not moved yet
+  const GenTreeIterPatchSeg* segs = patch->_segs;
+  for (int iSeg = 0; iSeg < patch->_nbSeg; ++iSeg)
+    if (segs[iSeg]._to < segs[iSeg]._from)
+      memmove(that->_seq + segs[iSeg]._to, that->_seq + segs[iSeg]._from,
+        sizeof(GenTree*) * segs[iSeg]._nb);
+  for (int iSeg = patch->_nbSeg; iSeg--;)
+    if (segs[iSeg]._to > segs[iSeg]._from)
+      memmove(that->_seq + segs[iSeg]._to, that->_seq + segs[iSeg]._from,
+        sizeof(GenTree*) * segs[iSeg]._nb);
+  // Fill the gaps between the kept parts, each inserted node follows the
+  // previous node of the sequence in depth first order
+  that->_nbNode = patch->_nbNode;
+  int iNode = 0;
+  for (int iSeg = 0; iSeg <= patch->_nbSeg; ++iSeg) {
+    int end = (iSeg < patch->_nbSeg ? segs[iSeg]._to : that->_nbNode);
+    for (; iNode < end; ++iNode)
+      that->_seq[iNode] = GenTreeNextNode(that->_tree,
+        (iNode > 0 ? that->_seq[iNode - 1] : that->_tree));
+    if (iSeg < patch->_nbSeg)
+      iNode = segs[iSeg]._to + segs[iSeg]._nb;
+  }
+}
+
+// Apply the patch 'patch' to the sequence of the iterator 'that' for
+// the order 'order', breadth first or value first
+void GenTreeIterPatchSorted(GenTreeIter* const that,
+  const GenTreeIterPatch* const patch, const GenTreeIterOrder order) {
+  GenTree* tree = that->_tree;
+  if (patch->_nbNode > that->_capacity)
+    GenTreeIterSeqReserve(that, (patch->_nbNode > 2 * that->_capacity ?
+      patch->_nbNode : 2 * that->_capacity));
+  GenTreeIterPosReserve(that);
+  // Filter out the removed nodes, the kept ones stay in the same order
+  // at their new position in depth first order
+  const GenTreeIterPatchSeg* segs = patch->_segs;
+  int nbKept = 0;
+  for (int iNode = 0; iNode < that->_nbNode; ++iNode) {
+    // Search the last part starting at or before the node
+    int rank = that->_pos[iNode]._rank;
+    int iSeg = 0;
+    int nbSeg = patch->_nbSeg;
+    while (nbSeg > 1) {
+      int half = nbSeg / 2;
+      if (segs[iSeg + half]._from <= rank)
+        iSeg += half;
+      nbSeg -= half;
+    }
+    if (patch->_nbSeg > 0 && segs[iSeg]._from <= rank &&
+      rank < segs[iSeg]._from + segs[iSeg]._nb) {
+      that->_seq[nbKept] = that->_seq[iNode];
+      that->_pos[nbKept]._rank = segs[iSeg]._to + rank - segs[iSeg]._from;
+      that->_pos[nbKept]._depth = that->_pos[iNode]._depth;
+      ++nbKept;
+    }
+  }
+  int nbInsert = patch->_nbNode - nbKept;
+  that->_nbNode = patch->_nbNode;
+  if (nbInsert == 0)
+    return;
+  // Get the inserted nodes, in the gaps between the kept parts, with
+  // their position
+  GenTreeIterPatchNode* inserted =
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeIterPatchNode) * nbInsert);
+  int iInsert = 0;
+  int rank = 0;
+  for (int iSeg = 0; iSeg <= patch->_nbSeg; ++iSeg) {
+    int end = (iSeg < patch->_nbSeg ? segs[iSeg]._to : patch->_nbNode);
+    if (rank < end) {
+      // The first node of the gap is searched from the tree, the next
+      // ones follow it in depth first order
+      GenTree* node =
+        _GenTreeSelect(tree, (GenTreeIsRoot(tree) ? rank : rank - 1));
+      int depth = 0;
+      for (const GenTree* cur = node; cur != tree; cur = cur->_parent)
+        ++depth;
+      while (true) {
+        inserted[iInsert]._tree = node;
+        inserted[iInsert]._pos._rank = rank;
+        inserted[iInsert]._pos._depth = depth;
+        ++iInsert;
+        ++rank;
+        if (rank == end)
+          break;
+        // The next node is the first subtree of the node, or the next
+        // brother of the node or one of its ancestors
+        GenTree* next = GenTreeNextNode(tree, node);
+        if (next->_parent == node) {
+          ++depth;
+        } else {
+          const GenTree* cur = node;
+          while (cur->_parent != next->_parent) {
+            cur = cur->_parent;
+            --depth;
+          }
+        }
+        node = next;
+      }
+    }
+    if (iSeg < patch->_nbSeg)
+      rank = segs[iSeg]._to + segs[iSeg]._nb;
+  }
+  // Sort the inserted nodes and merge them with the kept ones, from the
+  // end of the sequence
+  qsort(inserted, nbInsert, sizeof(GenTreeIterPatchNode),
+    (order == GenTreeIterOrderBreadth ? GenTreeIterPatchNodeCmpBreadth :
+    GenTreeIterPatchNodeCmpValue));
+  int iKept = nbKept - 1;
+  iInsert = nbInsert - 1;
+  for (int iNode = that->_nbNode; iInsert >= 0 && iNode--;) {
+    if (iKept < 0 ||
+      GenTreeIterPatchIsAfter(that, order, inserted + iInsert, iKept)) {
+      that->_seq[iNode] = inserted[iInsert]._tree;
+      that->_pos[iNode] = inserted[iInsert]._pos;
+      --iInsert;
+    } else {
+      that->_seq[iNode] = that->_seq[iKept];
+      that->_pos[iNode] = that->_pos[iKept];
+      --iKept;
+    }
+  }
+  free(inserted);
+}
+
+// Return true if the node 'node' inserted by a patch is after the
+// 'iNode'-th node of the sequence of the iterator 'that' in the order
+// 'order', breadth first or value first
+bool GenTreeIterPatchIsAfter(const GenTreeIter* const that,
+  const GenTreeIterOrder order, const GenTreeIterPatchNode* const node,
+  const int iNode) {
+  const GenTreeIterPos* pos = that->_pos + iNode;
+  if (order == GenTreeIterOrderBreadth) {
+    if (node->_pos._depth != pos->_depth)
+      return (node->_pos._depth > pos->_depth);
+  } else {
+    // The attached tree is in the sequence with a sort value of 0.0
+    float sortVal = node->_tree->_link._sortVal;
+    const GenTree* kept = that->_seq[iNode];
+    float keptSortVal = (kept == that->_tree ? 0.0 : kept->_link._sortVal);
+    if (sortVal != keptSortVal)
+      return (sortVal > keptSortVal);
+  }
+  return (node->_pos._rank > pos->_rank);
+}
+
+// Comparison of GenTreeIterPatchNode in breadth first order, by depth
+// then rank, and in value first order, by sort value then rank
+int GenTreeIterPatchNodeCmpBreadth(const void* a, const void* b) {
+  const GenTreeIterPatchNode* na = a;
+  const GenTreeIterPatchNode* nb = b;
+  if (na->_pos._depth != nb->_pos._depth)
+    return (na->_pos._depth > nb->_pos._depth) -
+      (na->_pos._depth < nb->_pos._depth);
+  return (na->_pos._rank > nb->_pos._rank) -
+    (na->_pos._rank < nb->_pos._rank);
+}
+
+int GenTreeIterPatchNodeCmpValue(const void* a, const void* b) {
+  const GenTreeIterPatchNode* na = a;
+  const GenTreeIterPatchNode* nb = b;
+  float sa = na->_tree->_link._sortVal;
+  float sb = nb->_tree->_link._sortVal;
+  if (sa != sb)
+    return (sa > sb) - (sa < sb);
+  return (na->_pos._rank > nb->_pos._rank) -
+    (na->_pos._rank < nb->_pos._rank);
+}
+
+// Memorize in the iterator 'that', whose sequence has just been
+// created, the root of its attached tree to patch the sequence at the
+// next update, creating the edit log of the root if it has none
+void GenTreeIterAttachLog(GenTreeIter* const that) {
+  GenTree* tree = that->_tree;
+  GenTree* root = tree;
+  while (root->_parent != NULL)
+    root = root->_parent;
+  // Create the log at the first update, the edits are memorized from
+  // now on
+  GenTreeExtra* extra = GenTreeGetExtra(root);
+  if (extra->_editLog == NULL) {
+    GenTreeEditLog* log = PBErrMalloc(GenTreeErr, sizeof(GenTreeEditLog));
+    log->_first = 0;
+    log->_nbEdit = 0;
+    log->_gen = root->_gen;
+    log->_genMin = root->_gen;
+    extra->_editLog = log;
+  }
+  extra->_editLog->_nbUnread = 0;
+  that->_root = root;
+  that->_rootGen = root->_gen;
+  that->_rootRank = (tree == root ? 0 : _GenTreeRank(root, tree));
+}
+
+// Update the GenTreeIterBreadth 'that' in case its attached GenTree has 
+// been modified
+// The node sequence doesn't include the root node of the attached tree
+// Do nothing if the iterator is not stale
+void GenTreeIterBreadthUpdate(GenTreeIterBreadth* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // If the attached tree has been modified since the last update
+  if (GenTreeIterIsStale(that)) {
+    // Patch the sequence with the edits of the tree if possible, else
+    // create the sequence with a Breadth First run through nodes of 
+    // the tree
+    if (!GenTreeIterPatchSequence((GenTreeIter*)that, 
+      GenTreeIterOrderBreadth)) {
+      GenTreeIterCreateSequenceBreadthFirst((GenTreeIter*)that);
+      GenTreeIterAttachLog((GenTreeIter*)that);
+    }
+    // Memorize the generation of the attached tree
+    ((GenTreeIter*)that)->_gen = GenTreeIterGenTree(that)->_gen;
+  }
+  // Reset the current position
+  GenTreeIterReset(that);
+}
+
+// Create the sequence of an iterator for breadth first
+// The sequence is used as the queue of the run through the nodes, thus
+// the nodes are appended in breadth first order in linear time, along
+// with their position in depth first order and their depth
+void GenTreeIterCreateSequenceBreadthFirst(GenTreeIter* const that) {
+  // Empty the sequence
+  that->_nbNode = 0;
+  // Append the current tree to the sequence if it's not root, the root
+  // being else before the first node of its sequence
+  GenTree* node = that->_tree;
+  int rank = -1;
+  int depth = 0;
+  if (!GenTreeIsRoot(node)) {
+    GenTreeIterSeqAppendPos(that, node, 0, 0);
+    rank = 0;
+  }
+  // Declare a variable to memorize the index in the sequence of the 
+  // next node whose subtrees are appended
+  int iQueue = that->_nbNode;
+  // Loop on the nodes in the queue
+  while (node != NULL) {
+    // Append the subtrees of the node, the first one follows it in 
+    // depth first order, the next ones follow the previous one and its
+    // subtrees
+    int rankSubtree = rank + 1;
+    for (GSetElem* elem = node->_subtrees._set._head; elem != NULL; 
+      elem = elem->_next) {
+      GenTree* subtree = elem->_data;
+      GenTreeIterSeqAppendPos(that, subtree, rankSubtree, depth + 1);
+      rankSubtree += subtree->_size + 1;
+    }
+    // Move to the next node in the queue
+    node = NULL;
+    if (iQueue < that->_nbNode) {
+      node = that->_seq[iQueue];
+      rank = that->_pos[iQueue]._rank;
+      depth = that->_pos[iQueue]._depth;
+    }
+    ++iQueue;
+  }
+}
+
+// Append the node 'node' at the end of the sequence of the iterator 
+// 'that' as GenTreeIterSeqAppend, with its position 'rank' in depth 
+// first order and its depth 'depth'
+void GenTreeIterSeqAppendPos(GenTreeIter* const that, GenTree* const node,
+  const int rank, const int depth) {
+  GenTreeIterSeqAppend(that, node);
+  GenTreeIterPosReserve(that);
+  that->_pos[that->_nbNode - 1]._rank = rank;
+  that->_pos[that->_nbNode - 1]._depth = depth;
+}
+
+// Write the subtrees of the node 'node', at the position 'rank' in 
+// depth first order and the depth 'depth', in the array of sequence 
+// 'seq' and their positions in 'pos', from the index 'iSeq'
+// Return the index following the last subtree
+int GenTreeIterSeqWriteSubtrees(GenTree** const seq, 
+  GenTreeIterPos* const pos, const GenTree* const node, const int rank, 
+  const int depth, int iSeq) {
+  // The first subtree follows the node in depth first order, the next 
+  // ones follow the previous one and its subtrees
+  int rankSubtree = rank + 1;
+  for (GSetElem* elem = node->_subtrees._set._head; elem != NULL; 
+    elem = elem->_next) {
+    GenTree* subtree = elem->_data;
+    seq[iSeq] = subtree;
+    pos[iSeq]._rank = rankSubtree;
+    pos[iSeq]._depth = depth + 1;
+    rankSubtree += subtree->_size + 1;
+    ++iSeq;
+  }
+  return iSeq;
+}
+
+// Update the GenTreeIterValue 'that' in case its attached GenTree has been 
+// modified
+// The node sequence doesn't include the root node of the attached tree
+// Do nothing if the iterator is not stale
+void GenTreeIterValueUpdate(GenTreeIterValue* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // If the attached tree has been modified since the last update
+  if (GenTreeIterIsStale(that)) {
+    // Patch the sequence with the edits of the tree if possible, else
+    // create the sequence with a Value First run through nodes of the 
+    // tree
+    if (!GenTreeIterPatchSequence((GenTreeIter*)that, 
+      GenTreeIterOrderValue)) {
+      GenTreeIterCreateSequenceValueFirst((GenTreeIter*)that, -1);
+      GenTreeIterAttachLog((GenTreeIter*)that);
+    }
+    // Memorize the generation of the attached tree
+    ((GenTreeIter*)that)->_gen = GenTreeIterGenTree(that)->_gen;
+  }
+  // Reset the current position
+  GenTreeIterReset(that);
+}
+
+// Update the GenTreeIterValue 'that' with only the 'nb' first nodes in 
+// value first order of its attached GenTree
+// The nodes are kept in a heap, so the cost is linear in the size of the
+// tree plus 'nb' times logarithmic in the size of the tree
+// If 'nb' is negative or greater than the number of nodes, all the nodes
+// are in the sequence, as with GenTreeIterValueUpdate
+// The iterator stays stale, thus the next GenTreeIterValueUpdate 
+// recreates the whole sequence
+void GenTreeIterValueUpdateFirst(GenTreeIterValue* const that, 
+  const int nb) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Create the sequence with a Value First run through nodes of the tree
+  GenTreeIterCreateSequenceValueFirst((GenTreeIter*)that, nb);
+  // The sequence may not contain all the nodes, keep the iterator stale
+  // to rebuild the whole sequence at the next update
+  ((GenTreeIter*)that)->_gen = GenTreeIterGenTree(that)->_gen - 1;
+  ((GenTreeIter*)that)->_root = NULL;
+  // Reset the current position
+  GenTreeIterReset(that);
+}
+
+// Create the sequence of an iterator for value first, limited to the 
+// 'nb' first nodes if 'nb' is not negative
+// The nodes are ordered by their sort value, and by depth first order 
+// for nodes with the same sort value. If the attached tree is not a 
+// root, it's included in the sequence with a sort value of 0.0
+void GenTreeIterCreateSequenceValueFirst(GenTreeIter* const that, int nb) {
+  // Get the nodes in depth first order
+  GenTreeIterCreateSequenceDepthFirst(that);
+  int nbNode = that->_nbNode;
+  if (nbNode == 0)
+    return;
+  // Allocate and fill the heap
+  GenTreeIterValueHeapNode* heap = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeIterValueHeapNode) * nbNode);
+  for (int iNode = 0; iNode < nbNode; ++iNode) {
+    heap[iNode]._tree = that->_seq[iNode];
+    heap[iNode]._sortVal = that->_seq[iNode]->_link._sortVal;
+    heap[iNode]._rank = iNode;
+  }
+  if (!GenTreeIsRoot(that->_tree))
+    heap[0]._sortVal = 0.0;
+  // Build the heap
+  for (int iNode = nbNode / 2 - 1; iNode >= 0; --iNode)
+    GenTreeIterValueHeapSiftDown(heap, nbNode, iNode);
+  // Pop the 'nb' first nodes from the heap into the sequence, with 
+  // their position in depth first order
+  if (nb < 0 || nb > nbNode)
+    nb = nbNode;
+  GenTreeIterPosReserve(that);
+  int nbHeap = nbNode;
+  for (int iNode = 0; iNode < nb; ++iNode) {
+    that->_seq[iNode] = heap[0]._tree;
+    that->_pos[iNode]._rank = heap[0]._rank;
+    that->_pos[iNode]._depth = 0;
+    --nbHeap;
+    heap[0] = heap[nbHeap];
+    GenTreeIterValueHeapSiftDown(heap, nbHeap, 0);
+  }
+  that->_nbNode = nb;
+  // Free the heap
+  free(heap);
+}
+
+// Sift down the node at index 'iNode' in the heap 'heap' of 'nbNode' 
+// nodes
+void GenTreeIterValueHeapSiftDown(GenTreeIterValueHeapNode* const heap, 
+  const int nbNode, int iNode) {
+  GenTreeIterValueHeapNode node = heap[iNode];
+  // Loop until the node is smaller than its children
+  int iChild = 2 * iNode + 1;
+  while (iChild < nbNode) {
+    // Get the smallest child
+    if (iChild + 1 < nbNode && 
+      (heap[iChild + 1]._sortVal < heap[iChild]._sortVal ||
+      (heap[iChild + 1]._sortVal == heap[iChild]._sortVal &&
+      heap[iChild + 1]._rank < heap[iChild]._rank)))
+      ++iChild;
+    // If the node is smaller than the smallest child, stop here
+    if (node._sortVal < heap[iChild]._sortVal ||
+      (node._sortVal == heap[iChild]._sortVal &&
+      node._rank < heap[iChild]._rank))
+      break;
+    // Move the child up
+    heap[iNode] = heap[iChild];
+    iNode = iChild;
+    iChild = 2 * iNode + 1;
+  }
+  heap[iNode] = node;
+}
+
+// Free the memory used by the iterator 'that'
+void _GenTreeIterFree(GenTreeIter** that) {
+  // Check argument
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // Free memory
+  if (!((*that)->_isUserBuffer))
+    free((*that)->_seq);
+  free((*that)->_pos);
+  free(*that);
+  *that = NULL;
+}
+
+// Free the memory used by the static iterator 'that'
+void _GenTreeIterFreeStatic(GenTreeIter* const that) {
+  // Check argument
+  if (that == NULL)
+    // Nothing to do
+    return;
+  // Free memory
+  if (!(that->_isUserBuffer))
+    free(that->_seq);
+  free(that->_pos);
+  that->_seq = NULL;
+  that->_pos = NULL;
+  that->_root = NULL;
+  that->_nbNode = 0;
+  that->_capacity = 0;
+  that->_curPos = 0;
+}
+
+
+// ----------- GenTreeIterDepthLazy
+
+// ================ Functions implementation ====================
+
+// Create a new GenTreeIterDepthLazy for the GenTree 'tree'
+GenTreeIterDepthLazy* _GenTreeIterDepthLazyCreate(GenTree* const tree) {
+#if BUILDMODE == 0
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Declare the new iterator
+  GenTreeIterDepthLazy *iter = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeIterDepthLazy));
+  // Set properties
+  iter->_tree = tree;
+  GenTreeIterReset(iter);
   // Return the iterator
   return iter;  
 }
 
-// Create a new static GenTreeIterValue for the GenTree 'tree' with 
-// 'rootval' the value of its root node
-GenTreeIterValue _GenTreeIterValueCreateStatic(GenTree* const tree) {
+// Create a new static GenTreeIterDepthLazy for the GenTree 'tree'
+GenTreeIterDepthLazy _GenTreeIterDepthLazyCreateStatic(
+  GenTree* const tree) {
+#if BUILDMODE == 0
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Declare the new iterator
+  GenTreeIterDepthLazy iter;
+  // Set properties
+  iter._tree = tree;
+  GenTreeIterReset(&iter);
+  // Return the iterator
+  return iter;
+}
+
+// Free the memory used by the iterator 'that'
+void _GenTreeIterDepthLazyFree(GenTreeIterDepthLazy** that) {
+  // Check argument
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // Free memory
+  free(*that);
+  *that = NULL;
+}
+
+// Free the memory used by the static iterator 'that'
+void _GenTreeIterDepthLazyFreeStatic(GenTreeIterDepthLazy* const that) {
+  // Check argument
+  if (that == NULL)
+    // Nothing to do
+    return;
+  // The iterator owns no memory, only forget the current node
+  that->_curNode = NULL;
+}
+
+// Append a new node with 'data' to the first node containing 'node'
+// in the GenTree 'that'
+// Uses the iterator 'iter' to search the node
+// Return true if we could find 'node', false else
+bool _GenTreeAppendToNodeDepthLazy(GenTree* const that, 
+  void* const data, void* const node, GenTreeIterDepthLazy* const iter) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iter == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'iter' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Declare a variable to memorize the result
+  bool res = false;
+  // Search the node where to append the data
+  GenTree* nodeTree = GenTreeSearch(that, node, iter);
+  // If we could find the node
+  if (nodeTree != NULL) {
+    // Append the data
+    GenTreeAppendData(nodeTree, data);
+    // Update the result
+    res = true;
+  }
+  // Return the result
+  return res;
+}
+
+// Search the first node containing 'data' in the GenTree 'that'
+// Uses the iterator 'iter' to search the node, with the same semantic
+// as _GenTreeSearch
+// If the tree is indexed, the node is found with the index and the 
+// iterator moved directly after it
+// Return the node if we could find 'data', null else
+GenTree* _GenTreeSearchDepthLazy(const GenTree* const that, 
+  const void* const data, GenTreeIterDepthLazy* const iter) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  } 
+  if (iter == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'iter' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  (void)that;
+  // Declare a variable to memorize the result
+  GenTree* res = NULL;
+  // If the node sequence is empty there is nothing to search
+  if (iter->_curNode == NULL)
+    return res;
+  // If the attached tree is indexed, move directly after the node 
+  // containing the data following the current node in depth first 
+  // order
+  if (GenTreeGetIndex(iter->_tree) != NULL) {
+    int from = 0;
+    if (iter->_curNode != iter->_tree)
+      from = _GenTreeRank(iter->_tree, iter->_curNode) + 
+        (GenTreeIsRoot(iter->_tree) ? 0 : 1);
+    int pos = 0;
+    res = GenTreeIndexSearchFrom(iter->_tree, data, from, NULL, 0, &pos);
+    if (res != NULL) {
+      iter->_curNode = res;
+      GenTreeIterStep(iter);
+    } else {
+      GenTreeIterToEnd(iter);
+    }
+    return res;
+  }
+  // Loop until we have found or reached the end
+  do {
+    // If we have found the searched data
+    if (GenTreeIterGetData(iter) == data)
+      // Memorize the node containing the data
+      res = GenTreeIterGetGenTree(iter);
+  } while (GenTreeIterStep(iter) && res == NULL);
+  // Return the result
+  return res;
+}
+
+// ----------- GenTreeIndex
+
+// ================ Functions declaration ====================
+
+// Return the key of the user data 'data' in the GenTreeIndex 'that'
+unsigned long GenTreeIndexKey(const GenTreeIndex* const that, 
+  const void* const data);
+
+// Return the bucket of the key 'key' in the GenTreeIndex 'that'
+int GenTreeIndexBucket(const GenTreeIndex* const that, 
+  const unsigned long key);
+
+// Set the number of buckets of the GenTreeIndex 'that' to 'nbBucket'
+// and redistribute its nodes, dropping the slots of the removed nodes
+void GenTreeIndexResize(GenTreeIndex* const that, const int nbBucket);
+
+// Insert the node 'node' in a free slot of the GenTreeIndex 'that', 
+// which must have one
+void GenTreeIndexInsert(GenTreeIndex* const that, GenTree* const node);
+
+// Return the slot of the node 'node' in the GenTreeIndex 'that', -1 if
+// it's not in the index
+int GenTreeIndexSlotOf(const GenTreeIndex* const that, 
+  const GenTree* const node);
+
+// ================ Functions implementation ====================
+
+// Create the index of the root GenTree 'that', using the function 
+// 'keyFun' to calculate the key of the user data, or the address of the
+// data if 'keyFun' is null
+// Nodes whose data have the same key are considered as holding the 
+// same data
+// The index is then kept up to date when the tree is modified, until 
+// the tree is attached to another one or freed
+// If the tree is already indexed its index is recreated
+void GenTreeIndexCreate(GenTree* const that, 
+  unsigned long (*keyFun)(const void* const data)) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (!GenTreeIsRoot(that)) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that' is not a root");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Free the eventual current index
+  GenTreeIndexFree(that);
+  // Allocate memory for the index
+  GenTreeIndex* index = PBErrMalloc(GenTreeErr, sizeof(GenTreeIndex));
+  index->_keyFun = keyFun;
+  index->_slots = NULL;
+  index->_buckets = NULL;
+  GenTreeIndexResize(index, GENTREEINDEX_NBBUCKET);
+  // The root owns the index but is not in it
+  GenTreeGetExtra(that)->_index = index;
+  // Add the subtrees to the index
+  GSetElem* elem = that->_subtrees._set._head;
+  while (elem != NULL) {
+    GenTreeIndexAddSubtree(index, elem->_data);
+    elem = elem->_next;
+  }
+}
+
+// Free the index of the tree the GenTree 'that' is the root of
+void GenTreeIndexFree(GenTree* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeGetIndex(that) != NULL && !GenTreeIsRoot(that)) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that' is not a root");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  if (that->_extra == NULL || that->_extra->_index == NULL)
+    // Nothing to do
+    return;
+  // Free memory, the nodes don't refer to the index
+  free(that->_extra->_index->_slots);
+  free(that->_extra->_index->_buckets);
+  free(that->_extra->_index);
+  that->_extra->_index = NULL;
+}
+
+// Search a node containing 'data' in the indexed tree the GenTree 
+// 'that' belongs to
+// If 'prev' is null return the first node found, else the next one 
+// after 'prev', thus several calls return the successive nodes 
+// containing 'data' (in no particular order)
+// Return null if there is no (more) node containing 'data'
+GenTree* GenTreeIndexSearch(const GenTree* const that, 
+  const void* const data, const GenTree* const prev) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeGetIndex(that) == NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that' is not indexed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (prev != NULL && 
+    GenTreeIndexSlotOf(GenTreeGetIndex(that), prev) == -1) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'prev' is not in the index of 'that'");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  const GenTreeIndex* index = GenTreeGetIndex(that);
+  unsigned long key = GenTreeIndexKey(index, data);
+  // Start from the head of the bucket or after the previous result
+  int iSlot = (prev == NULL ? 
+    index->_buckets[GenTreeIndexBucket(index, key)] : 
+    index->_slots[GenTreeIndexSlotOf(index, prev)]._next);
+  // Run through the bucket until we find a node with the same key
+  while (iSlot != -1 && 
+    GenTreeIndexKey(index, index->_slots[iSlot]._node->_data) != key)
+    iSlot = index->_slots[iSlot]._next;
+  // Return the result
+  return (iSlot != -1 ? index->_slots[iSlot]._node : NULL);
+}
+
+// Append a new node with 'data' to a node containing 'node' in the 
+// indexed tree the GenTree 'that' belongs to
+// Return true if we could find 'node', false else
+bool GenTreeIndexAppendToNode(GenTree* const that, void* const data, 
+  void* const node) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  GenTree* parent = GenTreeIndexSearch(that, node, NULL);
+  if (parent == NULL)
+    return false;
+  GenTreeAppendData(parent, data);
+  return true;
+}
+
+// Add the node 'node' to the GenTreeIndex 'that'
+void GenTreeIndexAdd(GenTreeIndex* const that, GenTree* const node) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (node == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'node' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Keep the load of the slots, removed ones included, under 0.75, and
+  // the load of the nodes under 0.5 after a resize
+  if ((that->_nbNode + that->_nbRemoved + 1) * 4 > 
+    (long)(that->_nbBucket) * 3) {
+    int nbBucket = GENTREEINDEX_NBBUCKET;
+    while ((that->_nbNode + 1) * 2 > (long)nbBucket)
+      nbBucket *= 2;
+    GenTreeIndexResize(that, nbBucket);
+  }
+  GenTreeIndexInsert(that, node);
+}
+
+// Remove the node 'node' from the GenTreeIndex 'that'
+void GenTreeIndexRemove(GenTreeIndex* const that, GenTree* const node) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (node == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'node' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  int iSlot = GenTreeIndexSlotOf(that, node);
+#if BUILDMODE == 0
+  if (iSlot == -1) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'node' is not in the index");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Unlink the slot from its bucket
+  GenTreeIndexSlot* slot = that->_slots + iSlot;
+  if (slot->_prev != -1)
+    that->_slots[slot->_prev]._next = slot->_next;
+  else
+    that->_buckets[GenTreeIndexBucket(that, 
+      GenTreeIndexKey(that, node->_data))] = slot->_next;
+  if (slot->_next != -1)
+    that->_slots[slot->_next]._prev = slot->_prev;
+  // Free the slot, the search of the nodes after it must go on
+  slot->_node = NULL;
+  slot->_next = GENTREEINDEX_REMOVED;
+  slot->_prev = -1;
+  --(that->_nbNode);
+  ++(that->_nbRemoved);
+}
+
+// Search with the index of the tree the GenTree 'tree' belongs to the
+// node containing 'data' whose position in depth first order in the 
+// sequence of an iterator attached to 'tree' is the smallest one not 
+// less than 'from'
+// If 'seq' is not null it's the sequence of 'nbNode' nodes of an 
+// iterator attached to 'tree', and the search fails if a node 
+// containing 'data' is not at its depth first position in it
+// Set '*pos' to the position of the node, or to -1 if the search failed
+// Return the node, null if there is none or if the search failed
+GenTree* GenTreeIndexSearchFrom(const GenTree* const tree, 
+  const void* const data, const int from, GenTree* const* const seq,
+  const int nbNode, int* const pos) {
+  const GenTreeIndex* index = GenTreeGetIndex(tree);
+  // The subtrees of the attached tree follow it in the sequence if 
+  // it's not a root
+  int offset = (GenTreeIsRoot(tree) ? 0 : 1);
+  GenTree* res = NULL;
+  *pos = -1;
+  // Run through the bucket of the data
+  int iSlot = index->_buckets[
+    GenTreeIndexBucket(index, GenTreeIndexKey(index, data))];
+  for (; iSlot != -1; iSlot = index->_slots[iSlot]._next) {
+    GenTree* node = index->_slots[iSlot]._node;
+    if (node->_data != data)
+      continue;
+    // Skip the nodes out of the attached tree
+    const GenTree* ancestor = node;
+    while (ancestor != NULL && ancestor != tree)
+      ancestor = ancestor->_parent;
+    if (ancestor == NULL)
+      continue;
+    int rank = (node == tree ? 0 : _GenTreeRank(tree, node) + offset);
+    if (seq != NULL && (rank >= nbNode || seq[rank] != node)) {
+      *pos = -1;
+      return NULL;
+    }
+    if (rank >= from && (res == NULL || rank < *pos)) {
+      res = node;
+      *pos = rank;
+    }
+  }
+  // If there is no node, the search has succeeded all the same
+  if (res == NULL)
+    *pos = 0;
+  return res;
+}
+
+// Add the GenTree 'tree' and its subtrees to the GenTreeIndex 'that'
+void GenTreeIndexAddSubtree(GenTreeIndex* const that, GenTree* const tree) {
+  for (GenTree* node = tree; node != NULL; 
+    node = GenTreeNextNode(tree, node))
+    GenTreeIndexAdd(that, node);
+}
+
+// Remove the GenTree 'tree' and its subtrees from the GenTreeIndex 
+// 'that'
+void GenTreeIndexRemoveSubtree(GenTreeIndex* const that, 
+  GenTree* const tree) {
+  for (GenTree* node = tree; node != NULL; 
+    node = GenTreeNextNode(tree, node))
+    GenTreeIndexRemove(that, node);
+}
+
+// Return the key of the user data 'data' in the GenTreeIndex 'that'
+unsigned long GenTreeIndexKey(const GenTreeIndex* const that, 
+  const void* const data) {
+  if (that->_keyFun != NULL)
+    return that->_keyFun(data);
+  else
+    return (unsigned long)(size_t)data;
+}
+
+// Return the bucket of the key 'key' in the GenTreeIndex 'that'
+int GenTreeIndexBucket(const GenTreeIndex* const that, 
+  const unsigned long key) {
+  // Mix the bits of the key, as addresses are aligned and user keys 
+  // may be consecutive
+  unsigned long hash = key;
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3bUL;
+  hash ^= hash >> 16;
+  return (int)(hash & (unsigned long)(that->_nbBucket - 1));
+}
+
+// Set the number of buckets of the GenTreeIndex 'that' to 'nbBucket'
+// and redistribute its nodes, dropping the slots of the removed nodes
+void GenTreeIndexResize(GenTreeIndex* const that, const int nbBucket) {
+  GenTreeIndexSlot* slots = that->_slots;
+  int nbSlot = (slots != NULL ? that->_nbBucket : 0);
+  that->_nbBucket = nbBucket;
+  that->_nbNode = 0;
+  that->_nbRemoved = 0;
+  that->_slots = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeIndexSlot) * nbBucket);
+  free(that->_buckets);
+  that->_buckets = PBErrMalloc(GenTreeErr, sizeof(int) * nbBucket);
+  for (int iBucket = nbBucket; iBucket--;) {
+    that->_slots[iBucket]._node = NULL;
+    that->_slots[iBucket]._next = -1;
+    that->_slots[iBucket]._prev = -1;
+    that->_buckets[iBucket] = -1;
+  }
+  for (int iSlot = 0; iSlot < nbSlot; ++iSlot)
+    if (slots[iSlot]._node != NULL)
+      GenTreeIndexInsert(that, slots[iSlot]._node);
+  free(slots);
+}
+
+// Insert the node 'node' in a free slot of the GenTreeIndex 'that', 
+// which must have one
+void GenTreeIndexInsert(GenTreeIndex* const that, GenTree* const node) {
+  // Take the first free slot from the position of the address of the
+  // node
+  int mask = that->_nbBucket - 1;
+  int iSlot = GenTreeIndexBucket(that, (unsigned long)(size_t)node);
+  while (that->_slots[iSlot]._node != NULL)
+    iSlot = (iSlot + 1) & mask;
+  GenTreeIndexSlot* slot = that->_slots + iSlot;
+  if (slot->_next == GENTREEINDEX_REMOVED)
+    --(that->_nbRemoved);
+  // Insert the slot at the head of the bucket of the node
+  int iBucket = 
+    GenTreeIndexBucket(that, GenTreeIndexKey(that, node->_data));
+  slot->_node = node;
+  slot->_prev = -1;
+  slot->_next = that->_buckets[iBucket];
+  if (slot->_next != -1)
+    that->_slots[slot->_next]._prev = iSlot;
+  that->_buckets[iBucket] = iSlot;
+  ++(that->_nbNode);
+}
+
+// Return the slot of the node 'node' in the GenTreeIndex 'that', -1 if
+// it's not in the index
+int GenTreeIndexSlotOf(const GenTreeIndex* const that, 
+  const GenTree* const node) {
+  // Run through the slots from the position of the address of the 
+  // node until the node or a slot which has never been used
+  int mask = that->_nbBucket - 1;
+  int iSlot = GenTreeIndexBucket(that, (unsigned long)(size_t)node);
+  while (that->_slots[iSlot]._node != node) {
+    if (that->_slots[iSlot]._node == NULL && 
+      that->_slots[iSlot]._next != GENTREEINDEX_REMOVED)
+      return -1;
+    iSlot = (iSlot + 1) & mask;
+  }
+  return iSlot;
+}
+
+// ----------- GenTreeThreadPool
+
+// ================ Functions declaration ====================
+
+// Argument of the threads of a GenTreeThreadPool
+typedef struct GenTreeThreadPoolArg {
+  // The pool
+  GenTreeThreadPool* _pool;
+  // Index of the thread in the pool
+  int _iThread;
+} GenTreeThreadPoolArg;
+
+// Main function of the threads of a GenTreeThreadPool, 'arg' is a 
+// GenTreeThreadPoolArg freed by the thread
+void* GenTreeThreadPoolMain(void* arg);
+
+// Execute tasks with the 'iThread'-th thread of the GenTreeThreadPool 
+// 'that' until all the tasks of the current call are completed
+void GenTreeThreadPoolWork(GenTreeThreadPool* const that, 
+  const int iThread);
+
+// Pop the newest task of the 'iThread'-th thread of the 
+// GenTreeThreadPool 'that', or steal the oldest task of another thread 
+// if it has none
+// Return null if there is no task
+GenTreeTask* GenTreeThreadPoolGetTask(GenTreeThreadPool* const that, 
+  const int iThread);
+
+// Pool used by the parallel functions called with a null pool, created
+// by the first of them and kept until the end of the process, and 
+// mutex held by the call using it
+GenTreeThreadPool* GenTreeThreadPoolShared = NULL;
+pthread_mutex_t GenTreeThreadPoolSharedMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Return the GenTreeThreadPool to be used by a parallel function called
+// with the pool 'pool': 'pool' if it's not null, else the shared pool,
+// or a temporary pool if the shared one is used by another call
+// Each call must be matched by a call to GenTreeThreadPoolRelease
+GenTreeThreadPool* GenTreeThreadPoolAcquire(GenTreeThreadPool* const pool);
+
+// Release the GenTreeThreadPool 'threadPool' returned by 
+// GenTreeThreadPoolAcquire for the pool 'pool'
+void GenTreeThreadPoolRelease(GenTreeThreadPool* const pool,
+  GenTreeThreadPool* threadPool);
+
+// Free the shared pool at the end of the process
+void GenTreeThreadPoolFreeShared(void);
+
+// Join of the tasks of a parallel function processing the subtrees of
+// a node in bottom up order, the node is processed when they are all 
+// completed
+// For a reduction, the value of the node and its completed subtrees 
+// follows the join in memory
+typedef struct GenTreeApplyJoin {
+  // The node
+  GenTree* _node;
+  // Number of tasks not yet completed
+  atomic_long _nbPending;
+  // Join of the parent of the node, null if the parent is the 
+  // processed tree
+  struct GenTreeApplyJoin* _parent;
+  // Mutex protecting the value of a reduction
+  pthread_mutex_t _mutex;
+} GenTreeApplyJoin;
+
+// Parameters of a call to a parallel function shared by its tasks
+typedef struct GenTreeApplyParam {
+  // Process with the 'iThread'-th thread the node 'node' of rank 'rank'
+  // before its subtrees are split into tasks, in top down order
+  void (*_visit)(const struct GenTreeApplyParam* const apply, 
+    const int iThread, GenTree* const node, const long rank);
+  // Process sequentially with the 'iThread'-th thread the range of 
+  // subtrees from 'first' to 'next' (excluded) whose first node has 
+  // the rank 'rank' and whose parent has the join 'join'
+  void (*_serial)(const struct GenTreeApplyParam* const apply, 
+    const int iThread, GSetElem* const first, GSetElem* const next, 
+    const long rank, GenTreeApplyJoin* const join);
+  // Process with the 'iThread'-th thread the node of the join 'join' 
+  // whose tasks are all completed, in bottom up order
+  void (*_complete)(const struct GenTreeApplyParam* const apply, 
+    const int iThread, GenTreeApplyJoin* const join);
+  // User functions and their parameters
+  void(*_fun)(void* const data, void* const param);
+  void(*_map)(void* const data, void* const value, void* const param);
+  void(*_combine)(void* const acc, const void* const value, 
+    void* const param);
+  void(*_store)(void* const data, const void* const value, 
+    void* const param);
+  void* _param;
+  // Identity of a reduction and size in bytes of its values, 0 if it's
+  // not a reduction
+  const void* _identity;
+  size_t _size;
+  // Values of a reduction for each thread: its partial result and a 
+  // temporary value, each one taking _stride bytes to avoid false 
+  // sharing between threads
+  char* _values;
+  size_t _stride;
+  // Order of the nodes
+  GenTreeApplyOrder _order;
+  // Number of nodes under which a task is not split
+  long _grain;
+} GenTreeApplyParam;
+
+// Task of a parallel function processing a range of brother subtrees
+typedef struct GenTreeApplyTask {
+  // Embedded task
+  GenTreeTask _task;
+  // Parameters of the call
+  const GenTreeApplyParam* _apply;
+  // First subtree of the range
+  GSetElem* _first;
+  // Element following the last subtree of the range, null if it is the
+  // last brother
+  GSetElem* _next;
+  // Number of nodes in the range
+  long _weight;
+  // Rank of the first node of the range in depth first order among 
+  // the subtrees of the processed tree
+  long _rank;
+  // Join of the parent of the range, null if the parent is the 
+  // processed tree
+  GenTreeApplyJoin* _join;
+} GenTreeApplyTask;
+
+// Process the subtrees of the GenTree 'that' with the threads of the 
+// GenTreeThreadPool 'pool' as set by 'apply'
+void GenTreeApplyRun(GenTree* const that, GenTreeApplyParam* const apply,
+  GenTreeThreadPool* const pool);
+
+// Create a new GenTreeApplyTask for the call 'apply' over the range 
+// of subtrees from 'first' to 'next' (excluded) of 'weight' nodes, 
+// the first one of rank 'rank', whose parent has the join 'join'
+GenTreeApplyTask* GenTreeApplyTaskCreate(
+  const GenTreeApplyParam* const apply, GSetElem* const first, 
+  GSetElem* const next, const long weight, const long rank,
+  GenTreeApplyJoin* const join);
+
+// Run the GenTreeApplyTask 'task' with the 'iThread'-th thread of the
+// GenTreeThreadPool 'pool', splitting it and pushing the parts if it's 
+// too large
+void GenTreeApplyTaskRun(GenTreeThreadPool* const pool, 
+  const int iThread, GenTreeTask* const task);
+
+// Create a new join for the node 'node' of the call 'apply', whose 
+// parent has the join 'parent'
+GenTreeApplyJoin* GenTreeApplyJoinCreate(
+  const GenTreeApplyParam* const apply, GenTree* const node, 
+  GenTreeApplyJoin* const parent);
+
+// Release the join 'join' at the end of a task of the call 'apply' 
+// with the 'iThread'-th thread, completing it (and the joins of its 
+// ancestors in turn) if it was the last pending task
+void GenTreeApplyJoinRelease(const GenTreeApplyParam* const apply,
+  const int iThread, GenTreeApplyJoin* join);
+
+// Hooks of GenTreeParallelApply, see GenTreeApplyParam
+void GenTreeApplyVisit(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTree* const node, const long rank);
+void GenTreeApplySerial(const GenTreeApplyParam* const apply, 
+  const int iThread, GSetElem* const first, GSetElem* const next, 
+  const long rank, GenTreeApplyJoin* const join);
+void GenTreeApplyComplete(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTreeApplyJoin* const join);
+
+// Hooks of GenTreeReduce and GenTreeReduceBottomUp, see 
+// GenTreeApplyParam
+void GenTreeReduceVisit(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTree* const node, const long rank);
+void GenTreeReduceSerial(const GenTreeApplyParam* const apply, 
+  const int iThread, GSetElem* const first, GSetElem* const next, 
+  const long rank, GenTreeApplyJoin* const join);
+void GenTreeReduceSerialBottomUp(const GenTreeApplyParam* const apply, 
+  const int iThread, GSetElem* const first, GSetElem* const next, 
+  const long rank, GenTreeApplyJoin* const join);
+void GenTreeReduceComplete(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTreeApplyJoin* const join);
+
+// Return the 'iValue'-th value of the 'iThread'-th thread of the 
+// reduction 'apply' (0: partial result, 1: temporary value)
+void* GenTreeReduceValue(const GenTreeApplyParam* const apply, 
+  const int iThread, const int iValue);
+
+// Combine the value 'value' of the reduction 'apply' into the value of
+// the join 'join', or into the partial result of the 'iThread'-th 
+// thread if 'join' is null
+void GenTreeReduceAddTo(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTreeApplyJoin* const join, 
+  const void* const value);
+
+// Combine the value of the GenTree 'subtree' and its subtrees for the
+// reduction 'apply' into 'acc', storing the value of each node if the
+// reduction has a store function. '*stack' and '*capacity' are the 
+// array of values (of the nodes from 'subtree' to the current one) and
+// its capacity in number of values, enlarged as needed
+void GenTreeReduceSubtree(const GenTreeApplyParam* const apply, 
+  GenTree* const subtree, void* const acc, char** const stack, 
+  int* const capacity);
+
+// Allocate the values of the reduction 'apply' of values of 'size' 
+// bytes for the 'nbThread' threads and set its partial results to its
+// identity
+void GenTreeReduceInitValues(GenTreeApplyParam* const apply, 
+  const int nbThread);
+
+// Combine the partial results of the 'nbThread' threads of the 
+// reduction 'apply' into 'result' and free its values
+void GenTreeReduceResult(GenTreeApplyParam* const apply, 
+  const int nbThread, void* const result);
+
+// Hooks of GenTreeCloneParallel, see GenTreeApplyParam
+void GenTreeCloneVisit(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTree* const node, const long rank);
+void GenTreeCloneSerial(const GenTreeApplyParam* const apply, 
+  const int iThread, GSetElem* const first, GSetElem* const next, 
+  const long rank, GenTreeApplyJoin* const join);
+
+// Task of GenTreeThreadPoolFor
+typedef struct GenTreeForTask {
+  // Embedded task
+  GenTreeTask _task;
+  // User function and its parameters
+  void (*_fun)(void* const param, const int i);
+  void* _param;
+  // Index of the task
+  int _i;
+  // Number of tasks, the first one pushes the others
+  int _nb;
+  // Array of the tasks
+  struct GenTreeForTask* _tasks;
+} GenTreeForTask;
+
+// Call 'fun'('param', i) for i in [0, 'nb'[ with the threads of the 
+// GenTreeThreadPool 'pool'
+void GenTreeThreadPoolFor(GenTreeThreadPool* const pool, const int nb,
+  void (*fun)(void* const param, const int i), void* const param);
+
+// Run the GenTreeForTask 'task'
+void GenTreeForTaskRun(GenTreeThreadPool* const pool, 
+  const int iThread, GenTreeTask* const task);
+
+// Hooks of the parallel creation of the sequence of an iterator in 
+// depth first order, see GenTreeApplyParam
+void GenTreeIterSeqVisit(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTree* const node, const long rank);
+void GenTreeIterSeqSerial(const GenTreeApplyParam* const apply, 
+  const int iThread, GSetElem* const first, GSetElem* const next, 
+  const long rank, GenTreeApplyJoin* const join);
+
+// Create the sequence of the iterator 'that' in depth first order with
+// the threads of the GenTreeThreadPool 'pool'
+void GenTreeIterCreateSequenceDepthFirstParallel(GenTreeIter* const that,
+  GenTreeThreadPool* const pool);
+
+// Create the sequence of the iterator 'that' in breadth first order 
+// with the threads of the GenTreeThreadPool 'pool'
+void GenTreeIterCreateSequenceBreadthFirstParallel(
+  GenTreeIter* const that, GenTreeThreadPool* const pool);
+
+// Create the sequence of the iterator 'that' in value first order with
+// the threads of the GenTreeThreadPool 'pool'
+void GenTreeIterCreateSequenceValueFirstParallel(GenTreeIter* const that,
+  GenTreeThreadPool* const pool);
+
+// Level of the parallel creation of the sequence of a 
+// GenTreeIterBreadth
+typedef struct GenTreeIterBreadthLevel {
+  // Array of the sequence, and positions of its nodes
+  GenTree** _seq;
+  GenTreeIterPos* _seqPos;
+  // Position in the sequence of the first node of the level, and 
+  // number of nodes in the level
+  int _start;
+  int _width;
+  // Number of chunks of the level, processed in parallel
+  int _nbChunk;
+  // Number of subtrees of the nodes of each chunk, then position in the
+  // sequence of the first of them
+  int* _pos;
+} GenTreeIterBreadthLevel;
+
+// Count, or append to the sequence, the subtrees of the nodes of the 
+// 'iChunk'-th chunk of the GenTreeIterBreadthLevel 'param'
+void GenTreeIterBreadthCount(void* const param, const int iChunk);
+void GenTreeIterBreadthAppend(void* const param, const int iChunk);
+
+// Sort of the parallel creation of the sequence of a GenTreeIterValue
+typedef struct GenTreeIterValueSort {
+  // Nodes to sort, and array of the same size for the merges
+  GenTreeIterValueHeapNode* _nodes;
+  GenTreeIterValueHeapNode* _tmp;
+  // Sequence in depth first order
+  GenTree** _seq;
+  // Flag to use a sort value of 0.0 for the first node of the sequence
+  bool _isFirstZero;
+  // Number of chunks sorted in parallel, then merged two by two
+  int _nbChunk;
+  // Position of the first node of each chunk, plus the number of nodes
+  int* _bounds;
+  // Number of chunks in each of the two runs of a merge
+  int _runWidth;
+} GenTreeIterValueSort;
+
+// Set, then sort, the nodes of the 'iChunk'-th chunk of the 
+// GenTreeIterValueSort 'param'
+void GenTreeIterValueSortChunk(void* const param, const int iChunk);
+
+// Merge the 'iMerge'-th pair of runs of chunks of the 
+// GenTreeIterValueSort 'param' from _nodes into _tmp
+void GenTreeIterValueSortMerge(void* const param, const int iMerge);
+
+// Comparison of GenTreeIterValueHeapNode by sort value then rank, the
+// order of the heap of GenTreeIterCreateSequenceValueFirst
+int GenTreeIterValueHeapNodeCmp(const void* a, const void* b);
+
+// ================ Functions implementation ====================
+
+// Create a new GenTreeThreadPool with 'nbThread' threads, including 
+// the calling thread, or as many threads as online processors if 
+// 'nbThread' is not positive
+GenTreeThreadPool* GenTreeThreadPoolCreate(const int nbThread) {
+  // Allocate memory
+  GenTreeThreadPool* that = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeThreadPool));
+  // Set the properties
+  that->_nbThread = nbThread;
+  if (that->_nbThread <= 0) {
+    long nbProc = sysconf(_SC_NPROCESSORS_ONLN);
+    that->_nbThread = (nbProc > 0 ? (int)nbProc : 1);
+  }
+  that->_nbRun = 0;
+  that->_isStopping = false;
+  atomic_init(&(that->_nbPending), 0);
+  atomic_init(&(that->_nbPush), 0);
+  atomic_init(&(that->_nbIdle), 0);
+  pthread_mutex_init(&(that->_mutex), NULL);
+  pthread_cond_init(&(that->_cond), NULL);
+  that->_deques = PBErrMalloc(GenTreeErr, 
+    sizeof(GenTreeThreadPoolDeque) * that->_nbThread);
+  for (int iThread = 0; iThread < that->_nbThread; ++iThread) {
+    GenTreeThreadPoolDeque* deque = that->_deques + iThread;
+    pthread_mutex_init(&(deque->_mutex), NULL);
+    deque->_capacity = 64;
+    deque->_tasks = 
+      PBErrMalloc(GenTreeErr, sizeof(GenTreeTask*) * deque->_capacity);
+    deque->_top = 0;
+    deque->_bottom = 0;
+  }
+  // Start the threads other than the calling one
+  that->_threads = NULL;
+  if (that->_nbThread > 1)
+    that->_threads = 
+      PBErrMalloc(GenTreeErr, sizeof(pthread_t) * (that->_nbThread - 1));
+  for (int iThread = 1; iThread < that->_nbThread; ++iThread) {
+    GenTreeThreadPoolArg* arg = 
+      PBErrMalloc(GenTreeErr, sizeof(GenTreeThreadPoolArg));
+    arg->_pool = that;
+    arg->_iThread = iThread;
+    if (pthread_create(that->_threads + iThread - 1, NULL, 
+      GenTreeThreadPoolMain, arg) != 0) {
+      GenTreeErr->_type = PBErrTypeOther;
+      sprintf(GenTreeErr->_msg, "can't create thread %d", iThread);
+      PBErrCatch(GenTreeErr);
+    }
+  }
+  // Return the new pool
+  return that;
+}
+
+// Free the memory used by the GenTreeThreadPool 'that' and stop its 
+// threads
+void GenTreeThreadPoolFree(GenTreeThreadPool** that) {
+  // Check argument
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // Stop the threads
+  pthread_mutex_lock(&((*that)->_mutex));
+  (*that)->_isStopping = true;
+  pthread_cond_broadcast(&((*that)->_cond));
+  pthread_mutex_unlock(&((*that)->_mutex));
+  for (int iThread = 1; iThread < (*that)->_nbThread; ++iThread)
+    pthread_join((*that)->_threads[iThread - 1], NULL);
+  // Free memory
+  for (int iThread = 0; iThread < (*that)->_nbThread; ++iThread) {
+    pthread_mutex_destroy(&((*that)->_deques[iThread]._mutex));
+    free((*that)->_deques[iThread]._tasks);
+  }
+  free((*that)->_deques);
+  free((*that)->_threads);
+  pthread_mutex_destroy(&((*that)->_mutex));
+  pthread_cond_destroy(&((*that)->_cond));
+  free(*that);
+  *that = NULL;
+}
+
+// Main function of the threads of a GenTreeThreadPool, 'arg' is a 
+// GenTreeThreadPoolArg freed by the thread
+void* GenTreeThreadPoolMain(void* arg) {
+  GenTreeThreadPool* pool = ((GenTreeThreadPoolArg*)arg)->_pool;
+  int iThread = ((GenTreeThreadPoolArg*)arg)->_iThread;
+  free(arg);
+  unsigned long nbRun = 0;
+  while (true) {
+    // Wait for the next call or the end of the pool
+    pthread_mutex_lock(&(pool->_mutex));
+    while (pool->_nbRun == nbRun && !(pool->_isStopping))
+      pthread_cond_wait(&(pool->_cond), &(pool->_mutex));
+    bool isStopping = pool->_isStopping;
+    nbRun = pool->_nbRun;
+    pthread_mutex_unlock(&(pool->_mutex));
+    if (isStopping)
+      break;
+    // Execute the tasks of the call
+    GenTreeThreadPoolWork(pool, iThread);
+  }
+  return NULL;
+}
+
+// Execute tasks with the 'iThread'-th thread of the GenTreeThreadPool 
+// 'that' until all the tasks of the current call are completed
+// A thread finding no task GENTREETHREADPOOL_NBSPIN times in a row 
+// waits on the condition of the pool until a task is pushed or the 
+// call is completed
+void GenTreeThreadPoolWork(GenTreeThreadPool* const that, 
+  const int iThread) {
+  int nbSpin = 0;
+  while (atomic_load(&(that->_nbPending)) > 0) {
+    // Get the number of pushed tasks before looking for one, to know
+    // if a task has been pushed since
+    unsigned long nbPush = atomic_load(&(that->_nbPush));
+    GenTreeTask* task = GenTreeThreadPoolGetTask(that, iThread);
+    if (task != NULL) {
+      nbSpin = 0;
+      task->_run(that, iThread, task);
+      // Wake up the waiting threads if it was the last task
+      if (atomic_fetch_sub(&(that->_nbPending), 1) == 1 &&
+        atomic_load(&(that->_nbIdle)) > 0) {
+        pthread_mutex_lock(&(that->_mutex));
+        pthread_cond_broadcast(&(that->_cond));
+        pthread_mutex_unlock(&(that->_mutex));
+      }
+    } else if (nbSpin < GENTREETHREADPOOL_NBSPIN) {
+      // Other threads are busy with the last tasks, or about to push
+      // new ones
+      ++nbSpin;
+      sched_yield();
+    } else {
+      // Wait for a task to be pushed or the call to be completed
+      // _nbIdle is incremented before checking _nbPush and _nbPending,
+      // which are modified before checking _nbIdle, so either the 
+      // thread sees the change or it is woken up
+      pthread_mutex_lock(&(that->_mutex));
+      atomic_fetch_add(&(that->_nbIdle), 1);
+      while (atomic_load(&(that->_nbPending)) > 0 &&
+        atomic_load(&(that->_nbPush)) == nbPush)
+        pthread_cond_wait(&(that->_cond), &(that->_mutex));
+      atomic_fetch_sub(&(that->_nbIdle), 1);
+      pthread_mutex_unlock(&(that->_mutex));
+      nbSpin = 0;
+    }
+  }
+}
+
+// Pop the newest task of the 'iThread'-th thread of the 
+// GenTreeThreadPool 'that', or steal the oldest task of another thread 
+// if it has none
+// Return null if there is no task
+GenTreeTask* GenTreeThreadPoolGetTask(GenTreeThreadPool* const that, 
+  const int iThread) {
+  GenTreeTask* task = NULL;
+  // Pop from the bottom of the thread's own deque
+  GenTreeThreadPoolDeque* deque = that->_deques + iThread;
+  pthread_mutex_lock(&(deque->_mutex));
+  if (deque->_bottom > deque->_top) {
+    --(deque->_bottom);
+    task = deque->_tasks[deque->_bottom & (deque->_capacity - 1)];
+  }
+  pthread_mutex_unlock(&(deque->_mutex));
+  // Steal from the top of the other threads' deques
+  for (int iVictim = 1; task == NULL && iVictim < that->_nbThread; 
+    ++iVictim) {
+    deque = that->_deques + (iThread + iVictim) % that->_nbThread;
+    pthread_mutex_lock(&(deque->_mutex));
+    if (deque->_bottom > deque->_top) {
+      task = deque->_tasks[deque->_top & (deque->_capacity - 1)];
+      ++(deque->_top);
+    }
+    pthread_mutex_unlock(&(deque->_mutex));
+  }
+  return task;
+}
+
+// Execute the task 'task' and the tasks it pushes with the threads of 
+// the GenTreeThreadPool 'that', and return when they are all completed
+// Used by the parallel functions, not meant to be used directly
+void GenTreeThreadPoolRun(GenTreeThreadPool* const that, 
+  GenTreeTask* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (task == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'task' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Push the task in the deque of the calling thread and wake up the 
+  // other threads
+  GenTreeThreadPoolPush(that, 0, task);
+  if (that->_nbThread > 1) {
+    pthread_mutex_lock(&(that->_mutex));
+    ++(that->_nbRun);
+    pthread_cond_broadcast(&(that->_cond));
+    pthread_mutex_unlock(&(that->_mutex));
+  }
+  // Work with the other threads until all the tasks are completed
+  GenTreeThreadPoolWork(that, 0);
+}
+
+// Push the task 'task' in the deque of the 'iThread'-th thread of the 
+// GenTreeThreadPool 'that' during a call to GenTreeThreadPoolRun
+// Used by the parallel functions, not meant to be used directly
+void GenTreeThreadPoolPush(GenTreeThreadPool* const that, 
+  const int iThread, GenTreeTask* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (task == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'task' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iThread < 0 || iThread >= that->_nbThread) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iThread' is invalid (0<=%d<%d)", 
+      iThread, that->_nbThread);
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Count the task before it can be stolen and completed
+  atomic_fetch_add(&(that->_nbPending), 1);
+  GenTreeThreadPoolDeque* deque = that->_deques + iThread;
+  pthread_mutex_lock(&(deque->_mutex));
+  // Double the ring buffer if it's full
+  if (deque->_bottom - deque->_top == deque->_capacity) {
+    GenTreeTask** tasks = PBErrMalloc(GenTreeErr, 
+      sizeof(GenTreeTask*) * deque->_capacity * 2);
+    for (long pos = deque->_top; pos < deque->_bottom; ++pos)
+      tasks[pos & (deque->_capacity * 2 - 1)] = 
+        deque->_tasks[pos & (deque->_capacity - 1)];
+    free(deque->_tasks);
+    deque->_tasks = tasks;
+    deque->_capacity *= 2;
+  }
+  deque->_tasks[deque->_bottom & (deque->_capacity - 1)] = task;
+  ++(deque->_bottom);
+  pthread_mutex_unlock(&(deque->_mutex));
+  // Wake up the threads waiting for a task
+  atomic_fetch_add(&(that->_nbPush), 1);
+  if (atomic_load(&(that->_nbIdle)) > 0) {
+    pthread_mutex_lock(&(that->_mutex));
+    pthread_cond_broadcast(&(that->_cond));
+    pthread_mutex_unlock(&(that->_mutex));
+  }
+}
+
+// Return the GenTreeThreadPool to be used by a parallel function called
+// with the pool 'pool': 'pool' if it's not null, else the shared pool,
+// or a temporary pool if the shared one is used by another call
+// Each call must be matched by a call to GenTreeThreadPoolRelease
+GenTreeThreadPool* GenTreeThreadPoolAcquire(GenTreeThreadPool* const pool) {
+  // Use the given pool if any
+  if (pool != NULL)
+    return pool;
+  // Use a temporary pool if the shared one is used by another call 
+  // (possibly a parallel function called by a task of this one)
+  if (pthread_mutex_trylock(&GenTreeThreadPoolSharedMutex) != 0)
+    return GenTreeThreadPoolCreate(0);
+  // Create the shared pool at the first call
+  if (GenTreeThreadPoolShared == NULL) {
+    GenTreeThreadPoolShared = GenTreeThreadPoolCreate(0);
+    atexit(GenTreeThreadPoolFreeShared);
+  }
+  return GenTreeThreadPoolShared;
+}
+
+// Release the GenTreeThreadPool 'threadPool' returned by 
+// GenTreeThreadPoolAcquire for the pool 'pool'
+void GenTreeThreadPoolRelease(GenTreeThreadPool* const pool,
+  GenTreeThreadPool* threadPool) {
+  if (pool != NULL)
+    // Nothing to do
+    return;
+  if (threadPool == GenTreeThreadPoolShared)
+    pthread_mutex_unlock(&GenTreeThreadPoolSharedMutex);
+  else
+    GenTreeThreadPoolFree(&threadPool);
+}
+
+// Free the shared pool at the end of the process
+void GenTreeThreadPoolFreeShared(void) {
+  // Leave the pool if a call is still using it
+  if (pthread_mutex_trylock(&GenTreeThreadPoolSharedMutex) != 0)
+    return;
+  GenTreeThreadPoolFree(&GenTreeThreadPoolShared);
+  pthread_mutex_unlock(&GenTreeThreadPoolSharedMutex);
+}
+
+// Apply the function 'fun' to the data of the nodes of the GenTree 
+// 'that' (the root excluded, as GenTreeIterApply) with the threads of
+// the GenTreeThreadPool 'pool', or of the shared pool with as many 
+// threads as online processors if 'pool' is null
+// The tree is split along its subtrees into tasks of similar size, 
+// balanced between the threads by work stealing. 'order' sets if a 
+// node is processed after its parent or after its subtrees, otherwise
+// the nodes are processed in no particular order and 'fun' must be
+// thread safe. The tree must not be modified until the function returns
+void _GenTreeParallelApply(GenTree* const that, 
+  void(*fun)(void* const data, void* const param), void* const param,
+  GenTreeThreadPool* const pool, const GenTreeApplyOrder order) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (fun == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'fun' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // If the tree has no subtrees, nothing to do
+  if (that->_size == 0)
+    return;
+  // Use the shared pool if none is given
+  GenTreeThreadPool* threadPool = GenTreeThreadPoolAcquire(pool);
+  // Process the tree
+  GenTreeApplyParam apply = {0};
+  apply._visit = GenTreeApplyVisit;
+  apply._serial = GenTreeApplySerial;
+  apply._complete = GenTreeApplyComplete;
+  apply._fun = fun;
+  apply._param = param;
+  apply._order = order;
+  GenTreeApplyRun(that, &apply, threadPool);
+  // Release the pool
+  GenTreeThreadPoolRelease(pool, threadPool);
+}
+
+// Reduce the nodes of the GenTree 'that' (the root excluded) with the 
+// threads of the GenTreeThreadPool 'pool', or of the shared pool with
+// as many threads as online processors if 'pool' is null, and copy 
+// the result in 'result'
+// Values are user defined memory blocks of 'size' bytes. 'map' sets 
+// 'value' to the value of a node from its data, 'combine' combines 
+// 'value' into 'acc', 'identity' is the neutral value of 'combine'
+// 'param' is passed to 'map' and 'combine'. Each thread reduces the 
+// nodes of its tasks into its own partial result and the partial 
+// results are combined at the end, so 'combine' must be associative 
+// and commutative. 'map' and 'combine' must be thread safe. The tree 
+// must not be modified until the function returns
+void _GenTreeReduce(GenTree* const that, void* const result, 
+  const void* const identity, const size_t size,
+  void(*map)(void* const data, void* const value, void* const param),
+  void(*combine)(void* const acc, const void* const value, 
+    void* const param),
+  void* const param, GenTreeThreadPool* const pool) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (result == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'result' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (identity == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'identity' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (size == 0) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'size' is invalid (>0)");
+    PBErrCatch(GenTreeErr);
+  }
+  if (map == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'map' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (combine == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'combine' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Use the shared pool if none is given
+  GenTreeThreadPool* threadPool = GenTreeThreadPoolAcquire(pool);
+  // Reduce the tree, in top down order as the nodes don't need to wait
+  // for their subtrees
+  GenTreeApplyParam apply = {0};
+  apply._visit = GenTreeReduceVisit;
+  apply._serial = GenTreeReduceSerial;
+  apply._map = map;
+  apply._combine = combine;
+  apply._param = param;
+  apply._identity = identity;
+  apply._size = size;
+  apply._order = GenTreeApplyOrderTopDown;
+  GenTreeReduceInitValues(&apply, threadPool->_nbThread);
+  if (that->_size > 0)
+    GenTreeApplyRun(that, &apply, threadPool);
+  GenTreeReduceResult(&apply, threadPool->_nbThread, result);
+  // Release the pool
+  GenTreeThreadPoolRelease(pool, threadPool);
+}
+
+// Reduce the nodes of the GenTree 'that' (the root excluded) in bottom
+// up order as GenTreeReduce: the value of each node is the combination
+// of its mapped value and the values of its subtrees, 'store' (if not
+// null) is called with the data and value of each node once its value
+// is complete, and 'result' is set to the combination of the values 
+// of the subtrees of 'that'
+// 'store' must be thread safe, it's called for a node after being 
+// called for all its subtrees
+void _GenTreeReduceBottomUp(GenTree* const that, void* const result, 
+  const void* const identity, const size_t size,
+  void(*map)(void* const data, void* const value, void* const param),
+  void(*combine)(void* const acc, const void* const value, 
+    void* const param),
+  void(*store)(void* const data, const void* const value, 
+    void* const param),
+  void* const param, GenTreeThreadPool* const pool) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (result == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'result' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (identity == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'identity' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (size == 0) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'size' is invalid (>0)");
+    PBErrCatch(GenTreeErr);
+  }
+  if (map == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'map' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (combine == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'combine' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Use the shared pool if none is given
+  GenTreeThreadPool* threadPool = GenTreeThreadPoolAcquire(pool);
+  // Reduce the tree
+  GenTreeApplyParam apply = {0};
+  apply._serial = GenTreeReduceSerialBottomUp;
+  apply._complete = GenTreeReduceComplete;
+  apply._map = map;
+  apply._combine = combine;
+  apply._store = store;
+  apply._param = param;
+  apply._identity = identity;
+  apply._size = size;
+  apply._order = GenTreeApplyOrderBottomUp;
+  GenTreeReduceInitValues(&apply, threadPool->_nbThread);
+  if (that->_size > 0)
+    GenTreeApplyRun(that, &apply, threadPool);
+  GenTreeReduceResult(&apply, threadPool->_nbThread, result);
+  // Release the pool
+  GenTreeThreadPoolRelease(pool, threadPool);
+}
+
+// Create a copy of the GenTree 'that' as GenTreeClone, with the 
+// threads of the GenTreeThreadPool 'pool', or of the shared pool with
+// as many threads as online processors if 'pool' is null
+// Return the root of the copy
+GenTree* _GenTreeCloneParallel(const GenTree* const that, 
+  void* (*cloneData)(void* const data), GenTreeThreadPool* const pool) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  GenTreeCloneParam param;
+  GenTreeCloneInit(&param, that, cloneData);
+  GenTreeCloneSubtrees(&param, that, 0);
+  if (that->_size > 0) {
+    // Use the shared pool if none is given
+    GenTreeThreadPool* threadPool = GenTreeThreadPoolAcquire(pool);
+    // Copy the subtrees in top down order, the rank of a node in depth 
+    // first order among the subtrees giving the position of its copy
+    GenTreeApplyParam apply = {0};
+    apply._visit = GenTreeCloneVisit;
+    apply._serial = GenTreeCloneSerial;
+    apply._param = &param;
+    apply._order = GenTreeApplyOrderTopDown;
+    GenTreeApplyRun((GenTree*)that, &apply, threadPool);
+    // Release the pool
+    GenTreeThreadPoolRelease(pool, threadPool);
+  }
+  // Return the root of the copy
+  return param._nodes;
+}
+
+// Process the subtrees of the GenTree 'that' with the threads of the 
+// GenTreeThreadPool 'pool' as set by 'apply'
+void GenTreeApplyRun(GenTree* const that, GenTreeApplyParam* const apply,
+  GenTreeThreadPool* const pool) {
+  // Split the tree in about GENTREETHREADPOOL_NBTASKPERTHREAD tasks per
+  // thread
+  apply->_grain = that->_size / 
+    ((long)(pool->_nbThread) * GENTREETHREADPOOL_NBTASKPERTHREAD);
+  if (pool->_nbThread == 1)
+    apply->_grain = that->_size;
+  else if (apply->_grain < 1)
+    apply->_grain = 1;
+  // Process the subtrees of the tree
+  GenTreeApplyTask* task = GenTreeApplyTaskCreate(apply, 
+    that->_subtrees._set._head, NULL, that->_size, 0, NULL);
+  GenTreeThreadPoolRun(pool, (GenTreeTask*)task);
+}
+
+// Create a new GenTreeApplyTask for the call 'apply' over the range 
+// of subtrees from 'first' to 'next' (excluded) of 'weight' nodes, 
+// the first one of rank 'rank', whose parent has the join 'join'
+GenTreeApplyTask* GenTreeApplyTaskCreate(
+  const GenTreeApplyParam* const apply, GSetElem* const first, 
+  GSetElem* const next, const long weight, const long rank,
+  GenTreeApplyJoin* const join) {
+  GenTreeApplyTask* task = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeApplyTask));
+  task->_task._run = GenTreeApplyTaskRun;
+  task->_apply = apply;
+  task->_first = first;
+  task->_next = next;
+  task->_weight = weight;
+  task->_rank = rank;
+  task->_join = join;
+  return task;
+}
+
+// Run the GenTreeApplyTask 'task' with the 'iThread'-th thread of the
+// GenTreeThreadPool 'pool', splitting it and pushing the parts if it's 
+// too large
+void GenTreeApplyTaskRun(GenTreeThreadPool* const pool, 
+  const int iThread, GenTreeTask* const task) {
+  GenTreeApplyTask* that = (GenTreeApplyTask*)task;
+  const GenTreeApplyParam* apply = that->_apply;
+  GSetElem* first = that->_first;
+  long weight = that->_weight;
+  long rank = that->_rank;
+  GenTreeApplyJoin* join = that->_join;
+  while (weight > apply->_grain) {
+    if (first->_next == that->_next) {
+      // The range is one large subtree, process it and go down to its 
+      // subtrees. In bottom up order, it's processed by its join when
+      // all the tasks of its subtrees are completed
+      GenTree* node = first->_data;
+      if (apply->_order == GenTreeApplyOrderTopDown)
+        apply->_visit(apply, iThread, node, rank);
+      else
+        join = GenTreeApplyJoinCreate(apply, node, join);
+      ++rank;
+      first = node->_subtrees._set._head;
+      that->_next = NULL;
+      weight = node->_size;
+    } else {
+      // Split the range into parts of at most _grain nodes (or one 
+      // larger subtree), push all of them but the last one which is 
+      // processed by this task
+      GSetElem* partFirst = first;
+      long partWeight = 0;
+      for (GSetElem* elem = first; elem != that->_next; 
+        elem = elem->_next) {
+        long w = ((GenTree*)(elem->_data))->_size + 1;
+        if (partWeight > 0 && partWeight + w > apply->_grain) {
+          if (join != NULL)
+            atomic_fetch_add(&(join->_nbPending), 1);
+          GenTreeThreadPoolPush(pool, iThread, 
+            (GenTreeTask*)GenTreeApplyTaskCreate(
+              apply, partFirst, elem, partWeight, rank, join));
+          partFirst = elem;
+          rank += partWeight;
+          partWeight = 0;
+        }
+        partWeight += w;
+      }
+      first = partFirst;
+      weight = partWeight;
+    }
+  }
+  // Process the remaining range sequentially
+  apply->_serial(apply, iThread, first, that->_next, rank, join);
+  GenTreeApplyJoinRelease(apply, iThread, join);
+  free(that);
+}
+
+// Create a new join for the node 'node' of the call 'apply', whose 
+// parent has the join 'parent'
+GenTreeApplyJoin* GenTreeApplyJoinCreate(
+  const GenTreeApplyParam* const apply, GenTree* const node, 
+  GenTreeApplyJoin* const parent) {
+  GenTreeApplyJoin* join = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeApplyJoin) + apply->_size);
+  join->_node = node;
+  atomic_init(&(join->_nbPending), 1);
+  join->_parent = parent;
+  // For a reduction, start from the value of the node
+  if (apply->_size > 0) {
+    pthread_mutex_init(&(join->_mutex), NULL);
+    apply->_map(node->_data, join + 1, apply->_param);
+  }
+  return join;
+}
+
+// Release the join 'join' at the end of a task of the call 'apply' 
+// with the 'iThread'-th thread, completing it (and the joins of its 
+// ancestors in turn) if it was the last pending task
+void GenTreeApplyJoinRelease(const GenTreeApplyParam* const apply,
+  const int iThread, GenTreeApplyJoin* join) {
+  while (join != NULL && atomic_fetch_sub(&(join->_nbPending), 1) == 1) {
+    apply->_complete(apply, iThread, join);
+    GenTreeApplyJoin* parent = join->_parent;
+    if (apply->_size > 0)
+      pthread_mutex_destroy(&(join->_mutex));
+    free(join);
+    join = parent;
+  }
+}
+
+// Hooks of GenTreeParallelApply, see GenTreeApplyParam
+void GenTreeApplyVisit(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTree* const node, const long rank) {
+  (void)iThread;
+  (void)rank;
+  apply->_fun(node->_data, apply->_param);
+}
+
+void GenTreeApplySerial(const GenTreeApplyParam* const apply, 
+  const int iThread, GSetElem* const first, GSetElem* const next, 
+  const long rank, GenTreeApplyJoin* const join) {
+  (void)iThread;
+  (void)rank;
+  (void)join;
+  for (GSetElem* elem = first; elem != next; elem = elem->_next) {
+    GenTree* subtree = elem->_data;
+    if (apply->_order == GenTreeApplyOrderTopDown) {
+      for (GenTree* node = subtree; node != NULL; 
+        node = GenTreeNextNode(subtree, node))
+        apply->_fun(node->_data, apply->_param);
+    } else {
+      for (GenTree* node = GenTreeFirstNodePostOrder(subtree); 
+        node != NULL; node = GenTreeNextNodePostOrder(subtree, node))
+        apply->_fun(node->_data, apply->_param);
+    }
+  }
+}
+
+void GenTreeApplyComplete(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTreeApplyJoin* const join) {
+  (void)iThread;
+  apply->_fun(join->_node->_data, apply->_param);
+}
+
+// Hooks of GenTreeReduce and GenTreeReduceBottomUp, see 
+// GenTreeApplyParam
+void GenTreeReduceVisit(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTree* const node, const long rank) {
+  (void)rank;
+  void* value = GenTreeReduceValue(apply, iThread, 1);
+  apply->_map(node->_data, value, apply->_param);
+  apply->_combine(GenTreeReduceValue(apply, iThread, 0), value, 
+    apply->_param);
+}
+
+void GenTreeReduceSerial(const GenTreeApplyParam* const apply, 
+  const int iThread, GSetElem* const first, GSetElem* const next, 
+  const long rank, GenTreeApplyJoin* const join) {
+  (void)rank;
+  (void)join;
+  void* acc = GenTreeReduceValue(apply, iThread, 0);
+  void* value = GenTreeReduceValue(apply, iThread, 1);
+  for (GSetElem* elem = first; elem != next; elem = elem->_next) {
+    GenTree* subtree = elem->_data;
+    for (GenTree* node = subtree; node != NULL; 
+      node = GenTreeNextNode(subtree, node)) {
+      apply->_map(node->_data, value, apply->_param);
+      apply->_combine(acc, value, apply->_param);
+    }
+  }
+}
+
+void GenTreeReduceSerialBottomUp(const GenTreeApplyParam* const apply, 
+  const int iThread, GSetElem* const first, GSetElem* const next, 
+  const long rank, GenTreeApplyJoin* const join) {
+  (void)rank;
+  // Reduce the range locally then combine it into the join of the 
+  // parent, to lock it only once
+  void* acc = GenTreeReduceValue(apply, iThread, 1);
+  memcpy(acc, apply->_identity, apply->_size);
+  char* stack = NULL;
+  int capacity = 0;
+  for (GSetElem* elem = first; elem != next; elem = elem->_next)
+    GenTreeReduceSubtree(apply, elem->_data, acc, &stack, &capacity);
+  free(stack);
+  GenTreeReduceAddTo(apply, iThread, join, acc);
+}
+
+void GenTreeReduceComplete(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTreeApplyJoin* const join) {
+  // The value of the join is the value of its node and its subtrees
+  if (apply->_store != NULL)
+    apply->_store(join->_node->_data, join + 1, apply->_param);
+  GenTreeReduceAddTo(apply, iThread, join->_parent, join + 1);
+}
+
+// Return the 'iValue'-th value of the 'iThread'-th thread of the 
+// reduction 'apply' (0: partial result, 1: temporary value)
+void* GenTreeReduceValue(const GenTreeApplyParam* const apply, 
+  const int iThread, const int iValue) {
+  return apply->_values + (iThread * 2 + iValue) * apply->_stride;
+}
+
+// Combine the value 'value' of the reduction 'apply' into the value of
+// the join 'join', or into the partial result of the 'iThread'-th 
+// thread if 'join' is null
+void GenTreeReduceAddTo(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTreeApplyJoin* const join, 
+  const void* const value) {
+  if (join == NULL) {
+    apply->_combine(GenTreeReduceValue(apply, iThread, 0), value, 
+      apply->_param);
+  } else {
+    pthread_mutex_lock(&(join->_mutex));
+    apply->_combine(join + 1, value, apply->_param);
+    pthread_mutex_unlock(&(join->_mutex));
+  }
+}
+
+// Combine the value of the GenTree 'subtree' and its subtrees for the
+// reduction 'apply' into 'acc', storing the value of each node if the
+// reduction has a store function. '*stack' and '*capacity' are the 
+// array of values (of the nodes from 'subtree' to the current one) and
+// its capacity in number of values, enlarged as needed
+void GenTreeReduceSubtree(const GenTreeApplyParam* const apply, 
+  GenTree* const subtree, void* const acc, char** const stack, 
+  int* const capacity) {
+  size_t size = apply->_size;
+  int depth = 0;
+  GenTree* node = subtree;
+  if (*capacity == 0) {
+    *capacity = 16;
+    *stack = PBErrMalloc(GenTreeErr, size * *capacity);
+  }
+  apply->_map(node->_data, *stack, apply->_param);
+  while (true) {
+    // Go down to the first subtree if any
+    GSetElem* elem = node->_subtrees._set._head;
+    if (elem != NULL) {
+      node = elem->_data;
+      ++depth;
+      if (depth == *capacity) {
+        *capacity *= 2;
+        char* values = PBErrMalloc(GenTreeErr, size * *capacity);
+        memcpy(values, *stack, size * depth);
+        free(*stack);
+        *stack = values;
+      }
+      apply->_map(node->_data, *stack + depth * size, apply->_param);
+      continue;
+    }
+    // Else the value of the node is complete, combine it into its 
+    // parent and go to the next brother, climbing up until there is one
+    while (true) {
+      char* value = *stack + depth * size;
+      if (apply->_store != NULL)
+        apply->_store(node->_data, value, apply->_param);
+      if (depth == 0) {
+        apply->_combine(acc, value, apply->_param);
+        return;
+      }
+      apply->_combine(value - size, value, apply->_param);
+      elem = node->_link._next;
+      if (elem != NULL) {
+        node = elem->_data;
+        apply->_map(node->_data, value, apply->_param);
+        break;
+      }
+      node = node->_parent;
+      --depth;
+    }
+  }
+}
+
+// Allocate the values of the reduction 'apply' of values of 'size' 
+// bytes for the 'nbThread' threads and set its partial results to its
+// identity
+void GenTreeReduceInitValues(GenTreeApplyParam* const apply, 
+  const int nbThread) {
+  // Round the size of the values to a multiple of 64 bytes, the usual 
+  // size of cache lines
+  apply->_stride = ((apply->_size + 63) / 64) * 64;
+  apply->_values = 
+    PBErrMalloc(GenTreeErr, apply->_stride * 2 * nbThread);
+  for (int iThread = 0; iThread < nbThread; ++iThread)
+    memcpy(GenTreeReduceValue(apply, iThread, 0), apply->_identity, 
+      apply->_size);
+}
+
+// Combine the partial results of the 'nbThread' threads of the 
+// reduction 'apply' into 'result' and free its values
+void GenTreeReduceResult(GenTreeApplyParam* const apply, 
+  const int nbThread, void* const result) {
+  memcpy(result, apply->_identity, apply->_size);
+  for (int iThread = 0; iThread < nbThread; ++iThread)
+    apply->_combine(result, GenTreeReduceValue(apply, iThread, 0), 
+      apply->_param);
+  free(apply->_values);
+  apply->_values = NULL;
+}
+
+// Hooks of GenTreeCloneParallel, see GenTreeApplyParam
+void GenTreeCloneVisit(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTree* const node, const long rank) {
+  (void)iThread;
+  GenTreeCloneSubtrees(apply->_param, node, rank + 1);
+}
+
+void GenTreeCloneSerial(const GenTreeApplyParam* const apply, 
+  const int iThread, GSetElem* const first, GSetElem* const next, 
+  const long rank, GenTreeApplyJoin* const join) {
+  (void)iThread;
+  (void)join;
+  long iClone = rank + 1;
+  for (GSetElem* elem = first; elem != next; elem = elem->_next) {
+    GenTree* subtree = elem->_data;
+    for (GenTree* node = subtree; node != NULL; 
+      node = GenTreeNextNode(subtree, node))
+      GenTreeCloneSubtrees(apply->_param, node, iClone++);
+  }
+}
+
+// Update the GenTreeIterDepth 'that' as GenTreeIterDepthUpdate, with 
+// the threads of the GenTreeThreadPool 'pool', or of the shared pool 
+// with as many threads as online processors if 'pool' is null
+// The sequence is the same as the one of GenTreeIterDepthUpdate
+void GenTreeIterDepthUpdateParallel(GenTreeIterDepth* const that, 
+  GenTreeThreadPool* const pool) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // If the attached tree has been modified since the last update and
+  // the sequence can't be patched with the edits of the tree
+  if (GenTreeIterIsStale(that) && 
+    !GenTreeIterPatchSequence((GenTreeIter*)that, GenTreeIterOrderDepth)) {
+    // Use the shared pool if none is given
+    GenTreeThreadPool* threadPool = GenTreeThreadPoolAcquire(pool);
+    // Create the sequence
+    GenTreeIterCreateSequenceDepthFirstParallel((GenTreeIter*)that, 
+      threadPool);
+    GenTreeIterAttachLog((GenTreeIter*)that);
+    // Release the pool
+    GenTreeThreadPoolRelease(pool, threadPool);
+  }
+  // Memorize the generation of the attached tree
+  ((GenTreeIter*)that)->_gen = GenTreeIterGenTree(that)->_gen;
+  // Reset the current position
+  GenTreeIterReset(that);
+}
+
+// Update the GenTreeIterBreadth 'that' as GenTreeIterBreadthUpdate, 
+// with the threads of the GenTreeThreadPool 'pool', or of the shared 
+// pool with as many threads as online processors if 'pool' is null
+// The sequence is the same as the one of GenTreeIterBreadthUpdate
+void GenTreeIterBreadthUpdateParallel(GenTreeIterBreadth* const that, 
+  GenTreeThreadPool* const pool) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // If the attached tree has been modified since the last update and
+  // the sequence can't be patched with the edits of the tree
+  if (GenTreeIterIsStale(that) && 
+    !GenTreeIterPatchSequence((GenTreeIter*)that, GenTreeIterOrderBreadth)) {
+    // Use the shared pool if none is given
+    GenTreeThreadPool* threadPool = GenTreeThreadPoolAcquire(pool);
+    // Create the sequence
+    GenTreeIterCreateSequenceBreadthFirstParallel((GenTreeIter*)that, 
+      threadPool);
+    GenTreeIterAttachLog((GenTreeIter*)that);
+    // Release the pool
+    GenTreeThreadPoolRelease(pool, threadPool);
+  }
+  // Memorize the generation of the attached tree
+  ((GenTreeIter*)that)->_gen = GenTreeIterGenTree(that)->_gen;
+  // Reset the current position
+  GenTreeIterReset(that);
+}
+
+// Update the GenTreeIterValue 'that' as GenTreeIterValueUpdate, with 
+// the threads of the GenTreeThreadPool 'pool', or of the shared pool 
+// with as many threads as online processors if 'pool' is null
+// The sequence is the same as the one of GenTreeIterValueUpdate
+void GenTreeIterValueUpdateParallel(GenTreeIterValue* const that, 
+  GenTreeThreadPool* const pool) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // If the attached tree has been modified since the last update and
+  // the sequence can't be patched with the edits of the tree
+  if (GenTreeIterIsStale(that) && 
+    !GenTreeIterPatchSequence((GenTreeIter*)that, GenTreeIterOrderValue)) {
+    // Use the shared pool if none is given
+    GenTreeThreadPool* threadPool = GenTreeThreadPoolAcquire(pool);
+    // Create the sequence
+    GenTreeIterCreateSequenceValueFirstParallel((GenTreeIter*)that, 
+      threadPool);
+    GenTreeIterAttachLog((GenTreeIter*)that);
+    // Release the pool
+    GenTreeThreadPoolRelease(pool, threadPool);
+  }
+  // Memorize the generation of the attached tree
+  ((GenTreeIter*)that)->_gen = GenTreeIterGenTree(that)->_gen;
+  // Reset the current position
+  GenTreeIterReset(that);
+}
+
+// Call 'fun'('param', i) for i in [0, 'nb'[ with the threads of the 
+// GenTreeThreadPool 'pool'
+void GenTreeThreadPoolFor(GenTreeThreadPool* const pool, const int nb,
+  void (*fun)(void* const param, const int i), void* const param) {
+  if (nb <= 0)
+    return;
+  GenTreeForTask* tasks = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeForTask) * nb);
+  for (int i = 0; i < nb; ++i) {
+    tasks[i]._task._run = GenTreeForTaskRun;
+    tasks[i]._fun = fun;
+    tasks[i]._param = param;
+    tasks[i]._i = i;
+    tasks[i]._nb = nb;
+    tasks[i]._tasks = tasks;
+  }
+  GenTreeThreadPoolRun(pool, (GenTreeTask*)tasks);
+  free(tasks);
+}
+
+// Run the GenTreeForTask 'task'
+void GenTreeForTaskRun(GenTreeThreadPool* const pool, 
+  const int iThread, GenTreeTask* const task) {
+  GenTreeForTask* that = (GenTreeForTask*)task;
+  // The first task pushes the other ones, in reverse order to execute
+  // them in order as the thread pops its newest task first
+  if (that->_i == 0)
+    for (int i = that->_nb; i-- > 1;)
+      GenTreeThreadPoolPush(pool, iThread, 
+        (GenTreeTask*)(that->_tasks + i));
+  that->_fun(that->_param, that->_i);
+}
+
+// Hooks of the parallel creation of the sequence of an iterator in 
+// depth first order, see GenTreeApplyParam
+// The sequence is in _param, its position for the subtrees of the 
+// tree is their rank
+void GenTreeIterSeqVisit(const GenTreeApplyParam* const apply, 
+  const int iThread, GenTree* const node, const long rank) {
+  (void)iThread;
+  ((GenTree**)(apply->_param))[rank] = node;
+}
+
+void GenTreeIterSeqSerial(const GenTreeApplyParam* const apply, 
+  const int iThread, GSetElem* const first, GSetElem* const next, 
+  const long rank, GenTreeApplyJoin* const join) {
+  (void)iThread;
+  (void)join;
+  GenTree** seq = (GenTree**)(apply->_param) + rank;
+  for (GSetElem* elem = first; elem != next; elem = elem->_next) {
+    GenTree* subtree = elem->_data;
+    for (GenTree* node = subtree; node != NULL; 
+      node = GenTreeNextNode(subtree, node))
+      *(seq++) = node;
+  }
+}
+
+// Create the sequence of the iterator 'that' in depth first order with
+// the threads of the GenTreeThreadPool 'pool'
+// Thanks to the number of nodes cached in each node, the position of 
+// each part of the tree in the sequence is known and the parts are 
+// written directly at their position
+void GenTreeIterCreateSequenceDepthFirstParallel(GenTreeIter* const that,
+  GenTreeThreadPool* const pool) {
+  GenTree* tree = that->_tree;
+  // Append the current tree to the sequence if it's not root
+  that->_nbNode = 0;
+  if (!GenTreeIsRoot(tree))
+    GenTreeIterSeqAppend(that, tree);
+  int offset = that->_nbNode;
+  GenTreeIterSeqReserve(that, offset + (int)(tree->_size));
+  that->_nbNode = offset + (int)(tree->_size);
+  if (tree->_size == 0)
+    return;
+  // Write the subtrees in parallel
+  GenTreeApplyParam apply = {0};
+  apply._visit = GenTreeIterSeqVisit;
+  apply._serial = GenTreeIterSeqSerial;
+  apply._param = that->_seq + offset;
+  apply._order = GenTreeApplyOrderTopDown;
+  GenTreeApplyRun(tree, &apply, pool);
+}
+
+// Create the sequence of the iterator 'that' in breadth first order 
+// with the threads of the GenTreeThreadPool 'pool'
+// As in GenTreeIterCreateSequenceBreadthFirst the sequence is used as 
+// the queue, one level at a time. The subtrees of a large level are 
+// counted by chunks in parallel, then appended in parallel at the 
+// position of their chunk
+void GenTreeIterCreateSequenceBreadthFirstParallel(
+  GenTreeIter* const that, GenTreeThreadPool* const pool) {
+  GenTree* tree = that->_tree;
+  // Append the current tree to the sequence if it's not root
+  that->_nbNode = 0;
+  if (!GenTreeIsRoot(tree))
+    GenTreeIterSeqAppend(that, tree);
+  GenTreeIterSeqReserve(that, that->_nbNode + (int)(tree->_size));
+  GenTreeIterPosReserve(that);
+  // The first level is the subtrees of the tree, the root being before
+  // the first node of its sequence
+  GenTree** seq = that->_seq;
+  int nbNode = 0;
+  if (that->_nbNode > 0) {
+    that->_pos[0]._rank = 0;
+    that->_pos[0]._depth = 0;
+    nbNode = GenTreeIterSeqWriteSubtrees(seq, that->_pos, tree, 0, 0, 1);
+  } else {
+    nbNode = GenTreeIterSeqWriteSubtrees(seq, that->_pos, tree, -1, 0, 0);
+  }
+  GenTreeIterBreadthLevel level;
+  level._seq = seq;
+  level._seqPos = that->_pos;
+  level._start = that->_nbNode;
+  level._nbChunk = 0;
+  level._pos = NULL;
+  if (pool->_nbThread > 1)
+    level._pos = PBErrMalloc(GenTreeErr, 
+      sizeof(int) * (pool->_nbThread * 4 + 1));
+  // Loop on the levels
+  while (level._start < nbNode) {
+    level._width = nbNode - level._start;
+    if (pool->_nbThread == 1 || 
+      level._width < GENTREEITER_PARALLELMINWIDTH) {
+      // Append the subtrees of the nodes of the level sequentially
+      for (int iNode = level._start; iNode < level._start + level._width;
+        ++iNode)
+        nbNode = GenTreeIterSeqWriteSubtrees(seq, that->_pos, seq[iNode],
+          that->_pos[iNode]._rank, that->_pos[iNode]._depth, nbNode);
+    } else {
+      // Count the subtrees of each chunk, get the position of their 
+      // first subtree, then append them
+      level._nbChunk = pool->_nbThread * 4;
+      GenTreeThreadPoolFor(pool, level._nbChunk, 
+        GenTreeIterBreadthCount, &level);
+      for (int iChunk = 0; iChunk < level._nbChunk; ++iChunk) {
+        int nb = level._pos[iChunk];
+        level._pos[iChunk] = nbNode;
+        nbNode += nb;
+      }
+      GenTreeThreadPoolFor(pool, level._nbChunk, 
+        GenTreeIterBreadthAppend, &level);
+    }
+    level._start += level._width;
+  }
+  that->_nbNode = nbNode;
+  free(level._pos);
+}
+
+// Count, or append to the sequence, the subtrees of the nodes of the 
+// 'iChunk'-th chunk of the GenTreeIterBreadthLevel 'param'
+void GenTreeIterBreadthCount(void* const param, const int iChunk) {
+  GenTreeIterBreadthLevel* level = param;
+  int first = level->_start + 
+    (int)((long)(level->_width) * iChunk / level->_nbChunk);
+  int last = level->_start + 
+    (int)((long)(level->_width) * (iChunk + 1) / level->_nbChunk);
+  int nb = 0;
+  for (int iNode = first; iNode < last; ++iNode)
+    nb += level->_seq[iNode]->_subtrees._set._nbElem;
+  level->_pos[iChunk] = nb;
+}
+
+void GenTreeIterBreadthAppend(void* const param, const int iChunk) {
+  GenTreeIterBreadthLevel* level = param;
+  int first = level->_start + 
+    (int)((long)(level->_width) * iChunk / level->_nbChunk);
+  int last = level->_start + 
+    (int)((long)(level->_width) * (iChunk + 1) / level->_nbChunk);
+  int iSeq = level->_pos[iChunk];
+  for (int iNode = first; iNode < last; ++iNode)
+    iSeq = GenTreeIterSeqWriteSubtrees(level->_seq, level->_seqPos, 
+      level->_seq[iNode], level->_seqPos[iNode]._rank, 
+      level->_seqPos[iNode]._depth, iSeq);
+}
+
+// Create the sequence of the iterator 'that' in value first order with
+// the threads of the GenTreeThreadPool 'pool'
+// The nodes are ordered as in GenTreeIterCreateSequenceValueFirst, by
+// sort value then rank in depth first order. The sequence in depth 
+// first order is created in parallel, split into one chunk per thread 
+// sorted in parallel, and the chunks are merged two by two in parallel
+void GenTreeIterCreateSequenceValueFirstParallel(GenTreeIter* const that,
+  GenTreeThreadPool* const pool) {
+  // Get the nodes in depth first order
+  GenTreeIterCreateSequenceDepthFirstParallel(that, pool);
+  int nbNode = that->_nbNode;
+  if (nbNode == 0)
+    return;
+  // Sort the chunks
+  GenTreeIterValueSort sort;
+  sort._nodes = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeIterValueHeapNode) * nbNode);
+  sort._tmp = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeIterValueHeapNode) * nbNode);
+  sort._seq = that->_seq;
+  sort._isFirstZero = !GenTreeIsRoot(that->_tree);
+  sort._nbChunk = pool->_nbThread;
+  if (sort._nbChunk > nbNode)
+    sort._nbChunk = nbNode;
+  sort._bounds = PBErrMalloc(GenTreeErr, sizeof(int) * (sort._nbChunk + 1));
+  for (int iChunk = 0; iChunk <= sort._nbChunk; ++iChunk)
+    sort._bounds[iChunk] = 
+      (int)((long)nbNode * iChunk / sort._nbChunk);
+  GenTreeThreadPoolFor(pool, sort._nbChunk, 
+    GenTreeIterValueSortChunk, &sort);
+  // Merge the runs of chunks two by two until there is only one
+  for (sort._runWidth = 1; sort._runWidth < sort._nbChunk; 
+    sort._runWidth *= 2) {
+    int nbRun = (sort._nbChunk + sort._runWidth - 1) / sort._runWidth;
+    GenTreeThreadPoolFor(pool, (nbRun + 1) / 2, 
+      GenTreeIterValueSortMerge, &sort);
+    GenTreeIterValueHeapNode* nodes = sort._nodes;
+    sort._nodes = sort._tmp;
+    sort._tmp = nodes;
+  }
+  // Copy the sorted nodes in the sequence, with their position in depth
+  // first order
+  GenTreeIterPosReserve(that);
+  for (int iNode = 0; iNode < nbNode; ++iNode) {
+    that->_seq[iNode] = sort._nodes[iNode]._tree;
+    that->_pos[iNode]._rank = sort._nodes[iNode]._rank;
+    that->_pos[iNode]._depth = 0;
+  }
+  free(sort._nodes);
+  free(sort._tmp);
+  free(sort._bounds);
+}
+
+// Set, then sort, the nodes of the 'iChunk'-th chunk of the 
+// GenTreeIterValueSort 'param'
+void GenTreeIterValueSortChunk(void* const param, const int iChunk) {
+  GenTreeIterValueSort* sort = param;
+  int first = sort->_bounds[iChunk];
+  int last = sort->_bounds[iChunk + 1];
+  for (int iNode = first; iNode < last; ++iNode) {
+    sort->_nodes[iNode]._tree = sort->_seq[iNode];
+    sort->_nodes[iNode]._sortVal = sort->_seq[iNode]->_link._sortVal;
+    sort->_nodes[iNode]._rank = iNode;
+  }
+  if (iChunk == 0 && sort->_isFirstZero)
+    sort->_nodes[0]._sortVal = 0.0;
+  qsort(sort->_nodes + first, last - first, 
+    sizeof(GenTreeIterValueHeapNode), GenTreeIterValueHeapNodeCmp);
+}
+
+// Merge the 'iMerge'-th pair of runs of chunks of the 
+// GenTreeIterValueSort 'param' from _nodes into _tmp
+void GenTreeIterValueSortMerge(void* const param, const int iMerge) {
+  GenTreeIterValueSort* sort = param;
+  int iChunk = 2 * iMerge * sort->_runWidth;
+  int iMid = iChunk + sort->_runWidth;
+  int iEnd = iMid + sort->_runWidth;
+  if (iMid > sort->_nbChunk)
+    iMid = sort->_nbChunk;
+  if (iEnd > sort->_nbChunk)
+    iEnd = sort->_nbChunk;
+  int a = sort->_bounds[iChunk];
+  int mid = sort->_bounds[iMid];
+  int b = mid;
+  int end = sort->_bounds[iEnd];
+  GenTreeIterValueHeapNode* out = sort->_tmp + a;
+  while (a < mid && b < end) {
+    if (GenTreeIterValueHeapNodeCmp(sort->_nodes + b, 
+      sort->_nodes + a) < 0)
+      *(out++) = sort->_nodes[b++];
+    else
+      *(out++) = sort->_nodes[a++];
+  }
+  while (a < mid)
+    *(out++) = sort->_nodes[a++];
+  while (b < end)
+    *(out++) = sort->_nodes[b++];
+}
+
+// Comparison of GenTreeIterValueHeapNode by sort value then rank, the
+// order of the heap of GenTreeIterCreateSequenceValueFirst
+int GenTreeIterValueHeapNodeCmp(const void* a, const void* b) {
+  const GenTreeIterValueHeapNode* na = a;
+  const GenTreeIterValueHeapNode* nb = b;
+  if (na->_sortVal < nb->_sortVal)
+    return -1;
+  if (na->_sortVal > nb->_sortVal)
+    return 1;
+  return (na->_rank > nb->_rank) - (na->_rank < nb->_rank);
+}
+
+// ----------- GenTreeFrozen
+
+// ================ Functions declaration ====================
+
+// Pair of sort value and node index used to sort the nodes in value 
+// first order
+typedef struct GenTreeFrozenValuePair {
+  float _sortVal;
+  int _iNode;
+} GenTreeFrozenValuePair;
+
+// Comparison function to sort GenTreeFrozenValuePair by sort value, 
+// then by depth first index to keep the order of GSetAddSort
+int GenTreeFrozenValuePairCmp(const void* a, const void* b);
+
+// ================ Functions implementation ====================
+
+// Create a GenTreeFrozen snapshot of the GenTree 'tree'
+// The user data are not copied
+GenTreeFrozen* GenTreeFreeze(const GenTree* const tree) {
 #if BUILDMODE == 0
   if (tree == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'tree' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  // Declare the new iterator
-  GenTreeIterValue iter;
-  // Set properties
-  ((GenTreeIter*)&iter)->_tree = tree;
-  ((GenTreeIter*)&iter)->_seq = GSetGenTreeCreateStatic();
-  GenTreeIterValueUpdate(&iter);
-  GenTreeIterReset(&iter);
-  // Return the iterator
-  return iter;
+  // Declare the new frozen tree
+  GenTreeFrozen* that = PBErrMalloc(GenTreeErr, sizeof(GenTreeFrozen));
+  // Allocate the arrays
+  int nbNode = GenTreeGetSize(tree) + 1;
+  that->_nbNode = nbNode;
+  that->_data = PBErrMalloc(GenTreeErr, sizeof(void*) * nbNode);
+  that->_sortVal = PBErrMalloc(GenTreeErr, sizeof(float) * nbNode);
+  that->_parent = PBErrMalloc(GenTreeErr, sizeof(int) * nbNode);
+  that->_size = PBErrMalloc(GenTreeErr, sizeof(int) * nbNode);
+  that->_firstSubtree = PBErrMalloc(GenTreeErr, sizeof(int) * nbNode);
+  that->_nbSubtree = PBErrMalloc(GenTreeErr, sizeof(int) * nbNode);
+  that->_subtrees = PBErrMalloc(GenTreeErr, sizeof(int) * nbNode);
+  that->_breadth = PBErrMalloc(GenTreeErr, sizeof(int) * nbNode);
+  that->_value = PBErrMalloc(GenTreeErr, sizeof(int) * nbNode);
+  // Run through the tree in depth first order without recursion
+  const GenTree* node = tree;
+  int iNode = 0;
+  int iNext = 1;
+  that->_data[0] = tree->_data;
+  that->_sortVal[0] = tree->_link._sortVal;
+  that->_parent[0] = -1;
+  while (node != NULL) {
+    // Declare a variable to memorize the index of the parent of the 
+    // next node
+    int iParent = iNode;
+    // If the node has subtrees, the next node is its first subtree
+    GSetElem* elem = node->_subtrees._set._head;
+    // Else it's the next brother of the node or of its nearest ancestor
+    while (elem == NULL && node != tree) {
+      elem = node->_link._next;
+      iParent = that->_parent[iNode];
+      if (elem == NULL) {
+        node = node->_parent;
+        iNode = iParent;
+      }
+    }
+    if (elem != NULL) {
+      node = elem->_data;
+      iNode = iNext;
+      ++iNext;
+      that->_data[iNode] = node->_data;
+      that->_sortVal[iNode] = elem->_sortVal;
+      that->_parent[iNode] = iParent;
+    } else {
+      node = NULL;
+    }
+  }
+  // Calculate the sizes and numbers of subtrees
+  for (iNode = 0; iNode < nbNode; ++iNode) {
+    that->_size[iNode] = 0;
+    that->_nbSubtree[iNode] = 0;
+  }
+  for (iNode = nbNode - 1; iNode > 0; --iNode) {
+    that->_size[that->_parent[iNode]] += that->_size[iNode] + 1;
+    ++(that->_nbSubtree[that->_parent[iNode]]);
+  }
+  // Calculate the indices of the subtrees, nodes are run in depth first 
+  // order so subtrees of a same node are met in their order
+  int iFirst = 0;
+  for (iNode = 0; iNode < nbNode; ++iNode) {
+    that->_firstSubtree[iNode] = iFirst;
+    iFirst += that->_nbSubtree[iNode];
+    // Use _breadth to memorize the number of subtrees already set
+    that->_breadth[iNode] = 0;
+  }
+  for (iNode = 1; iNode < nbNode; ++iNode) {
+    int iParent = that->_parent[iNode];
+    that->_subtrees[that->_firstSubtree[iParent] + 
+      that->_breadth[iParent]] = iNode;
+    ++(that->_breadth[iParent]);
+  }
+  // Calculate the breadth first order, using _breadth as the queue
+  int iQueue = 0;
+  int nbQueue = 0;
+  iNode = 0;
+  while (iNode >= 0) {
+    for (int iSubtree = 0; iSubtree < that->_nbSubtree[iNode]; 
+      ++iSubtree) {
+      that->_breadth[nbQueue] = 
+        that->_subtrees[that->_firstSubtree[iNode] + iSubtree];
+      ++nbQueue;
+    }
+    iNode = (iQueue < nbQueue ? that->_breadth[iQueue] : -1);
+    ++iQueue;
+  }
+  // Calculate the value first order
+  if (nbNode > 1) {
+    GenTreeFrozenValuePair* pairs = PBErrMalloc(GenTreeErr, 
+      sizeof(GenTreeFrozenValuePair) * (nbNode - 1));
+    for (iNode = 1; iNode < nbNode; ++iNode) {
+      pairs[iNode - 1]._sortVal = that->_sortVal[iNode];
+      pairs[iNode - 1]._iNode = iNode;
+    }
+    qsort(pairs, nbNode - 1, sizeof(GenTreeFrozenValuePair), 
+      GenTreeFrozenValuePairCmp);
+    for (iNode = 1; iNode < nbNode; ++iNode)
+      that->_value[iNode - 1] = pairs[iNode - 1]._iNode;
+    free(pairs);
+  }
+  // Return the frozen tree
+  return that;
 }
 
-// Update the GenTreeIterDepth 'that' in case its attached GenTree has been 
-// modified
-// The node sequence doesn't include the root node of the attached tree
-void GenTreeIterDepthUpdate(GenTreeIterDepth* const that) {
+// Comparison function to sort GenTreeFrozenValuePair by sort value, 
+// then by depth first index to keep the order of GSetAddSort
+int GenTreeFrozenValuePairCmp(const void* a, const void* b) {
+  const GenTreeFrozenValuePair* pa = a;
+  const GenTreeFrozenValuePair* pb = b;
+  if (pa->_sortVal < pb->_sortVal)
+    return -1;
+  else if (pa->_sortVal > pb->_sortVal)
+    return 1;
+  else
+    return (pa->_iNode > pb->_iNode) - (pa->_iNode < pb->_iNode);
+}
+
+// Create a new GenTree from the GenTreeFrozen 'that'
+// Nodes are allocated from the GenTreePool 'pool', or with malloc if 
+// 'pool' is null
+GenTree* GenTreeFrozenThaw(const GenTreeFrozen* const that, 
+  GenTreePool* const pool) {
 #if BUILDMODE == 0
   if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'that' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  // Flush the sequence
-  GSetFlush(GenTreeIterSeq(that));
-  // Create the sequence with a Depth First run through nodes of the tree
-  GenTreeIterCreateSequenceDepthFirst(GenTreeIterSeq(that), 
-    GenTreeIterGenTree(that));
-  // Reset the current position
-  GenTreeIterReset(that);
+  // Declare a variable to memorize the nodes of the new tree
+  GenTree** nodes = PBErrMalloc(GenTreeErr, 
+    sizeof(GenTree*) * that->_nbNode);
+  // Create the nodes in depth first order, subtrees of a same node are 
+  // met in their order and can be appended
+  nodes[0] = GenTreeCreateDataPool(pool, that->_data[0]);
+  for (int iNode = 1; iNode < that->_nbNode; ++iNode) {
+    nodes[iNode] = GenTreeCreateDataPool(pool, that->_data[iNode]);
+    GenTreeLinkSubtree(nodes[that->_parent[iNode]], nodes[iNode], NULL,
+      that->_sortVal[iNode]);
+  }
+  // Return the tree
+  GenTree* tree = nodes[0];
+  free(nodes);
+  return tree;
 }
 
-// Create recursively the sequence of an iterator for depth first
-void GenTreeIterCreateSequenceDepthFirst(GSetGenTree* seq, GenTree* tree) {
-  // Append the current tree to the sequence if it's not root
-  if (!GenTreeIsRoot(tree)) GSetAppend(seq, tree);
-  // If there are subtrees
-  if (GSetNbElem(GenTreeSubtrees(tree)) > 0) {
-    // Append the subtrees recursively
-    GSetIterForward iter = 
-      GSetIterForwardCreateStatic(GenTreeSubtrees(tree));
-    do {
-      GenTree* subtree = GSetIterGet(&iter);
-      GenTreeIterCreateSequenceDepthFirst(seq, subtree);
-    } while (GSetIterStep(&iter));
-  }
+// Free the memory used by the GenTreeFrozen 'that'
+// User data must be freed by the user
+void GenTreeFrozenFree(GenTreeFrozen** that) {
+  // Check argument
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // Free memory
+  free((*that)->_data);
+  free((*that)->_sortVal);
+  free((*that)->_parent);
+  free((*that)->_size);
+  free((*that)->_firstSubtree);
+  free((*that)->_nbSubtree);
+  free((*that)->_subtrees);
+  free((*that)->_breadth);
+  free((*that)->_value);
+  free(*that);
+  *that = NULL;
 }
 
-// Update the GenTreeIterBreadth 'that' in case its attached GenTree has 
-// been modified
-// The node sequence doesn't include the root node of the attached tree
-void GenTreeIterBreadthUpdate(GenTreeIterBreadth* const that) {
+// Search the first node containing 'data' in the GenTreeFrozen 'that'
+// among the nodes of index greater than or equal to 'iNode', in depth 
+// first order. To loop on the nodes containing the same data, call it 
+// again with the previous result plus one
+// Return the index of the node, or -1 if there is none
+int GenTreeFrozenSearch(const GenTreeFrozen* const that, 
+  const void* const data, const int iNode) {
 #if BUILDMODE == 0
   if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'that' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iNode < 0) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iNode' is invalid (%d>=0)", iNode);
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  // Flush the sequence
-  GSetFlush(GenTreeIterSeq(that));
-  // Create the sequence with a Breadth First run through nodes of 
-  // the tree
-  GenTreeIterCreateSequenceBreadthFirst(GenTreeIterSeq(that), 
-    GenTreeIterGenTree(that), 0);
-  // Reset the current position
-  GenTreeIterReset(that);
+  for (int i = iNode; i < that->_nbNode; ++i)
+    if (that->_data[i] == data)
+      return i;
+  return -1;
 }
 
-// Create recursively the sequence of an iterator for breadth first
-void GenTreeIterCreateSequenceBreadthFirst(GSetGenTree* seq, GenTree* tree,
-  int lvl) {
-  // Append the current tree to the sequence if it's not root
-  if (!GenTreeIsRoot(tree)) GSetAddSort(seq, tree, lvl);
-  // If there are subtrees
-  if (GSetNbElem(GenTreeSubtrees(tree)) > 0) {
-    // Declare a variable to memorize the next lvl
-    int nextLvl = lvl + 1;
-    // Append the subtrees recursively
-    GSetIterForward iter = 
-      GSetIterForwardCreateStatic(GenTreeSubtrees(tree));
-    do {
-      GenTree* subtree = GSetIterGet(&iter);
-      GenTreeIterCreateSequenceBreadthFirst(seq, subtree, nextLvl);
-    } while (GSetIterStep(&iter));
+// ----------- GenTreeRcu
+
+// ================ Functions declaration ====================
+
+// Create a new snapshot of the GenTree 'tree' with version 'version',
+// sharing the unmodified subtrees with the snapshot 'prev' (may be 
+// null)
+GenTreeRcuSnapshot* GenTreeRcuSnapshotCreate(const GenTree* const tree,
+  const GenTreeRcuSnapshot* const prev, const unsigned long version);
+
+// Free the memory used by the snapshot 'that'
+void GenTreeRcuSnapshotFree(GenTreeRcuSnapshot** that);
+
+// ================ Functions implementation ====================
+
+// Create a new GenTreeRcu publishing the GenTree 'tree', and publish 
+// its first snapshot
+GenTreeRcu* GenTreeRcuCreate(GenTree* const tree) {
+#if BUILDMODE == 0
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
   }
+#endif
+  // Allocate memory
+  GenTreeRcu* that = PBErrMalloc(GenTreeErr, sizeof(GenTreeRcu));
+  // Set the properties, the epoch of readers outside of read sections 
+  // is 0 hence the epochs start at 1
+  that->_tree = tree;
+  atomic_init(&(that->_current), GenTreeRcuSnapshotCreate(tree, NULL, 0));
+  atomic_init(&(that->_epoch), 1);
+  that->_retired = NULL;
+  that->_nbRetired = 0;
+  that->_readers = NULL;
+  pthread_mutex_init(&(that->_mutex), NULL);
+  // Return the new GenTreeRcu
+  return that;
 }
 
-// Update the GenTreeIterValue 'that' in case its attached GenTree has been 
-// modified
-// The node sequence doesn't include the root node of the attached tree
-void GenTreeIterValueUpdate(GenTreeIterValue* const that) {
+// Free the memory used by the GenTreeRcu 'that' and its snapshots
+// Its readers must have been freed
+// The tree and the user data must be freed by the user
+void GenTreeRcuFree(GenTreeRcu** that) {
+  // Check argument
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+#if BUILDMODE == 0
+  if ((*that)->_readers != NULL) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'that' has readers");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Free memory
+  GenTreeRcuSnapshot* snapshot = atomic_load(&((*that)->_current));
+  GenTreeRcuSnapshotFree(&snapshot);
+  while ((*that)->_retired != NULL) {
+    snapshot = (*that)->_retired;
+    (*that)->_retired = snapshot->_next;
+    GenTreeRcuSnapshotFree(&snapshot);
+  }
+  pthread_mutex_destroy(&((*that)->_mutex));
+  free(*that);
+  *that = NULL;
+}
+
+// Publish a new snapshot of the tree of the GenTreeRcu 'that', sharing
+// the unmodified subtrees with the previous one, then free the replaced
+// snapshots no reader can be reading
+// To be called by the writer, which must not modify the tree until the
+// function returns
+void GenTreeRcuPublish(GenTreeRcu* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
     GenTreeErr->_type = PBErrTypeNullPointer;
-    sprintf(GSetErr->_msg, "'that' is null");
-    PBErrCatch(GSetErr);
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
   }
 #endif
-  // Flush the sequence
-  GSetFlush(GenTreeIterSeq(that));
-  // Create the sequence with a Value First run through nodes of the tree
-  GenTreeIterCreateSequenceValueFirst(GenTreeIterSeq(that), 
-    GenTreeIterGenTree(that), 0.0);
-  // Reset the current position
-  GenTreeIterReset(that);
+  // Replace the current snapshot by a new one sharing the unmodified
+  // subtrees with it
+  GenTreeRcuSnapshot* snapshot = atomic_load(&(that->_current));
+  snapshot = GenTreeRcuSnapshotCreate(that->_tree, snapshot, 
+    snapshot->_version + 1);
+  snapshot = atomic_exchange(&(that->_current), snapshot);
+  // Retire the replaced snapshot at the current epoch and move to the 
+  // next one: readers entering their read section from now on get the 
+  // new snapshot
+  snapshot->_retireEpoch = atomic_fetch_add(&(that->_epoch), 1);
+  snapshot->_next = that->_retired;
+  that->_retired = snapshot;
+  ++(that->_nbRetired);
+  // Free the replaced snapshots which are not read anymore
+  GenTreeRcuReclaim(that);
 }
 
-// Create recursively the sequence of an iterator for value first
-void GenTreeIterCreateSequenceValueFirst(GSetGenTree* seq, GenTree* tree, 
-  float val) {
-  // Append the current tree to the sequence if it's not root
-  if (!GenTreeIsRoot(tree)) GSetAddSort(seq, tree, val);
-  // If there are subtrees
-  if (GSetNbElem(GenTreeSubtrees(tree)) > 0) {
-    // Append the subtrees recursively
-    GSetIterForward iter = 
-      GSetIterForwardCreateStatic(GenTreeSubtrees(tree));
-    do {
-      GenTree* subtree = GSetIterGet(&iter);
-      GenTreeIterCreateSequenceValueFirst(seq, subtree, 
-        GSetIterGetSortVal(&iter));
-    } while (GSetIterStep(&iter));
+// Free the replaced snapshots of the GenTreeRcu 'that' no reader can 
+// be reading
+// To be called by the writer
+// Return the number of replaced snapshots not yet freed
+int GenTreeRcuReclaim(GenTreeRcu* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Get the oldest epoch of the readers in a read section
+  unsigned long minEpoch = ULONG_MAX;
+  pthread_mutex_lock(&(that->_mutex));
+  for (GenTreeRcuReader* reader = that->_readers; reader != NULL; 
+    reader = reader->_next) {
+    unsigned long epoch = atomic_load(&(reader->_epoch));
+    if (epoch != 0 && epoch < minEpoch)
+      minEpoch = epoch;
+  }
+  pthread_mutex_unlock(&(that->_mutex));
+  // A snapshot retired at a given epoch can only be read by readers 
+  // which entered their read section at this epoch or before
+  GenTreeRcuSnapshot** ptr = &(that->_retired);
+  while (*ptr != NULL) {
+    GenTreeRcuSnapshot* snapshot = *ptr;
+    if (snapshot->_retireEpoch < minEpoch) {
+      *ptr = snapshot->_next;
+      GenTreeRcuSnapshotFree(&snapshot);
+      --(that->_nbRetired);
+    } else {
+      ptr = &(snapshot->_next);
+    }
   }
+  return that->_nbRetired;
 }
 
-// Free the memory used by the iterator 'that'
-void _GenTreeIterFree(GenTreeIter** that) {
+// Create a new reader of the GenTreeRcu 'rcu'
+GenTreeRcuReader* GenTreeRcuReaderCreate(GenTreeRcu* const rcu) {
+#if BUILDMODE == 0
+  if (rcu == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'rcu' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Allocate memory
+  GenTreeRcuReader* that = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeRcuReader));
+  // Set the properties
+  that->_rcu = rcu;
+  atomic_init(&(that->_epoch), 0);
+  that->_snapshot = NULL;
+  that->_prev = NULL;
+  // Add the reader to the readers of the GenTreeRcu
+  pthread_mutex_lock(&(rcu->_mutex));
+  that->_next = rcu->_readers;
+  if (rcu->_readers != NULL)
+    rcu->_readers->_prev = that;
+  rcu->_readers = that;
+  pthread_mutex_unlock(&(rcu->_mutex));
+  // Return the new reader
+  return that;
+}
+
+// Free the memory used by the GenTreeRcuReader 'that'
+void GenTreeRcuReaderFree(GenTreeRcuReader** that) {
   // Check argument
   if (that == NULL || *that == NULL)
     // Nothing to do
     return;
+  // Remove the reader from the readers of the GenTreeRcu
+  GenTreeRcu* rcu = (*that)->_rcu;
+  pthread_mutex_lock(&(rcu->_mutex));
+  if ((*that)->_prev != NULL)
+    (*that)->_prev->_next = (*that)->_next;
+  else
+    rcu->_readers = (*that)->_next;
+  if ((*that)->_next != NULL)
+    (*that)->_next->_prev = (*that)->_prev;
+  pthread_mutex_unlock(&(rcu->_mutex));
   // Free memory
-  GSetFlush(GenTreeIterSeq(*that));
   free(*that);
   *that = NULL;
 }
 
-// Free the memory used by the static iterator 'that'
-void _GenTreeIterFreeStatic(GenTreeIter* const that) {
+// Create a new snapshot of the GenTree 'tree' with version 'version',
+// sharing the unmodified subtrees with the snapshot 'prev' (may be 
+// null)
+GenTreeRcuSnapshot* GenTreeRcuSnapshotCreate(const GenTree* const tree,
+  const GenTreeRcuSnapshot* const prev, const unsigned long version) {
+  GenTreeRcuSnapshot* that = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeRcuSnapshot));
+  that->_root = GenTreePersistCreateFromTree(tree, 
+    (prev != NULL ? prev->_root : NULL));
+  that->_version = version;
+  that->_retireEpoch = 0;
+  that->_next = NULL;
+  return that;
+}
+
+// Free the memory used by the snapshot 'that'
+void GenTreeRcuSnapshotFree(GenTreeRcuSnapshot** that) {
+  GenTreePersistFree(&((*that)->_root));
+  free(*that);
+  *that = NULL;
+}
+
+// ----------- GenTreeConcurrent
+
+// ================ Functions declaration ====================
+
+// Return the mutex of the GenTreeConcurrent 'that' protecting the 
+// object at address 'ptr'
+pthread_mutex_t* GenTreeConcurrentGetMutex(GenTreeConcurrent* const that,
+  const void* const ptr);
+
+// Allocate a new node with user data 'data' for the node 'node' of the
+// tree of the GenTreeConcurrent 'that'
+GenTree* GenTreeConcurrentCreateNode(GenTreeConcurrent* const that,
+  GenTree* const node, void* const data);
+
+// Return true if the node 'node' is in the tree of the 
+// GenTreeConcurrent 'that'
+bool GenTreeConcurrentIsInTree(const GenTreeConcurrent* const that,
+  const GenTree* const node);
+
+// Update the index and the ancestors of the node 'node' of the tree of
+// the GenTreeConcurrent 'that' after the new node 'tree' has been 
+// linked to its subtrees
+void GenTreeConcurrentUpdateAncestors(GenTreeConcurrent* const that,
+  GenTree* const node, GenTree* const tree);
+
+// ================ Functions implementation ====================
+
+// Create a new GenTreeConcurrent adding subtrees to the GenTree 'tree'
+GenTreeConcurrent* _GenTreeConcurrentCreate(GenTree* const tree) {
+#if BUILDMODE == 0
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Allocate memory
+  GenTreeConcurrent* that = 
+    PBErrMalloc(GenTreeErr, sizeof(GenTreeConcurrent));
+  // Set the properties
+  that->_tree = tree;
+  for (int iLock = 0; iLock < GENTREECONCURRENT_NBLOCK; ++iLock)
+    pthread_mutex_init(&(that->_locks[iLock]._mutex), NULL);
+  // Return the new GenTreeConcurrent
+  return that;
+}
+
+// Free the memory used by the GenTreeConcurrent 'that'
+// The tree is not freed
+void GenTreeConcurrentFree(GenTreeConcurrent** that) {
   // Check argument
-  if (that == NULL)
+  if (that == NULL || *that == NULL)
     // Nothing to do
     return;
   // Free memory
-  GSetFlush(GenTreeIterSeq(that));
+  for (int iLock = 0; iLock < GENTREECONCURRENT_NBLOCK; ++iLock)
+    pthread_mutex_destroy(&((*that)->_locks[iLock]._mutex));
+  free(*that);
+  *that = NULL;
+}
+
+// Append a new node with user data 'data' to the subtrees of the node
+// 'node' of the tree of the GenTreeConcurrent 'that'
+// Return the new node
+// The new node is allocated from the pool of 'node', if any
+// Can be called by several threads at once, on the same node or on 
+// different nodes
+GenTree* _GenTreeConcurrentAppendData(GenTreeConcurrent* const that,
+  GenTree* const node, void* const data) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (node == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'node' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (!GenTreeConcurrentIsInTree(that, node)) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'node' is not in the tree of 'that'");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  GenTree* tree = GenTreeConcurrentCreateNode(that, node, data);
+  // Link the new node under the lock of the node
+  pthread_mutex_t* mutex = GenTreeConcurrentGetMutex(that, node);
+  pthread_mutex_lock(mutex);
+  GenTreeLinkElem(node, tree, NULL, 0.0);
+  pthread_mutex_unlock(mutex);
+  GenTreeConcurrentUpdateAncestors(that, node, tree);
+  return tree;
+}
+
+// Add a new node with user data 'data' and sort value 'sortVal' to the
+// subtrees of the node 'node' of the tree of the GenTreeConcurrent 
+// 'that', sorted in increasing order of sort value, like 
+// GenTreeAddSortData
+// Return the new node
+// The new node is allocated from the pool of 'node', if any
+// Can be called by several threads at once, on the same node or on 
+// different nodes
+GenTree* _GenTreeConcurrentAddSortData(GenTreeConcurrent* const that,
+  GenTree* const node, void* const data, const float sortVal) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (node == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'node' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (!GenTreeConcurrentIsInTree(that, node)) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'node' is not in the tree of 'that'");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  GenTree* tree = GenTreeConcurrentCreateNode(that, node, data);
+  // Search the position and link the new node under the lock of the 
+  // node
+  pthread_mutex_t* mutex = GenTreeConcurrentGetMutex(that, node);
+  pthread_mutex_lock(mutex);
+  GenTreeLinkElem(node, tree, GenTreeSubtreeUpperBound(node, sortVal), 
+    sortVal);
+  pthread_mutex_unlock(mutex);
+  GenTreeConcurrentUpdateAncestors(that, node, tree);
+  return tree;
+}
+
+// Return the mutex of the GenTreeConcurrent 'that' protecting the 
+// object at address 'ptr'
+pthread_mutex_t* GenTreeConcurrentGetMutex(GenTreeConcurrent* const that,
+  const void* const ptr) {
+  // Mix the bits of the address, as nodes allocated together have 
+  // regularly spaced addresses
+  unsigned long hash = (unsigned long)(size_t)ptr;
+  hash ^= hash >> 17;
+  hash *= 0x9E3779B97F4A7C15UL;
+  hash ^= hash >> 29;
+  return &(that->_locks[hash % GENTREECONCURRENT_NBLOCK]._mutex);
+}
+
+// Return true if the node 'node' is in the tree of the 
+// GenTreeConcurrent 'that'
+bool GenTreeConcurrentIsInTree(const GenTreeConcurrent* const that,
+  const GenTree* const node) {
+  const GenTree* ancestor = node;
+  while (ancestor != NULL && ancestor != that->_tree)
+    ancestor = ancestor->_parent;
+  return (ancestor != NULL);
+}
+
+// Allocate a new node with user data 'data' for the node 'node' of the
+// tree of the GenTreeConcurrent 'that'
+GenTree* GenTreeConcurrentCreateNode(GenTreeConcurrent* const that,
+  GenTree* const node, void* const data) {
+  // The pool is shared by the nodes of the tree
+  if (node->_pool != NULL) {
+    pthread_mutex_t* mutex = GenTreeConcurrentGetMutex(that, node->_pool);
+    pthread_mutex_lock(mutex);
+    GenTree* tree = GenTreeCreateDataPool(node->_pool, data);
+    // The optional state of the new node is registered in the pool, 
+    // allocate it now if the index or the skip list will need it
+    if (GenTreeGetIndex(node) != NULL || GenTreeGetSkipList(node) != NULL)
+      GenTreeGetExtra(tree);
+    pthread_mutex_unlock(mutex);
+    return tree;
+  } else
+    return GenTreeCreateDataPool(NULL, data);
+}
+
+// Update the index and the ancestors of the node 'node' of the tree of
+// the GenTreeConcurrent 'that' after the new node 'tree' has been 
+// linked to its subtrees
+void GenTreeConcurrentUpdateAncestors(GenTreeConcurrent* const that,
+  GenTree* const node, GenTree* const tree) {
+  // The index is shared by the nodes of the tree
+  if (GenTreeGetIndex(node) != NULL) {
+    pthread_mutex_t* mutex = 
+      GenTreeConcurrentGetMutex(that, GenTreeGetIndex(node));
+    pthread_mutex_lock(mutex);
+    GenTreeIndexAddSubtree(GenTreeGetIndex(node), tree);
+    pthread_mutex_unlock(mutex);
+  }
+  ++(tree->_gen);
+  // Update the ancestors with atomic increments instead of their lock,
+  // the lock of a node only protects the list of its subtrees, so 
+  // threads adding to different branches never wait for each other on
+  // the path to the root
+  for (GenTree* ancestor = node; ancestor != NULL; 
+    ancestor = ancestor->_parent) {
+    __atomic_fetch_add(&(ancestor->_gen), 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&(ancestor->_size), 1, __ATOMIC_RELAXED);
+  }
+}
+
+// ----------- GenTreePersist
+
+// ================= Data structure ===================
+
+// Edits of a persistent tree
+typedef enum GenTreePersistOp {
+  GenTreePersistOpAppend,
+  GenTreePersistOpAddSort,
+  GenTreePersistOpSetData,
+  GenTreePersistOpCut
+} GenTreePersistOp;
+
+// Parameters of an edit of a persistent tree
+typedef struct GenTreePersistEdit {
+  // Edit
+  GenTreePersistOp _op;
+  // User data of the added node or new user data of the edited node
+  void* _data;
+  // Sort value of the added node
+  float _sortVal;
+} GenTreePersistEdit;
+
+// Step of a run through a persistent tree without recursion
+typedef struct GenTreePersistStep {
+  // Node
+  const GenTreePersist* _node;
+  // Index of the subtree followed from the node
+  int _iSubtree;
+} GenTreePersistStep;
+
+// Stack of the steps of a run through a persistent tree, growing as 
+// needed so the depth of the tree is not limited by the C stack
+typedef struct GenTreePersistStack {
+  // Steps, null until the first one is pushed
+  GenTreePersistStep* _steps;
+  // Number of steps in the stack
+  int _nbStep;
+  // Number of steps the array can contain
+  int _capacity;
+} GenTreePersistStack;
+
+// Step of the copy of a GenTree into a persistent tree without 
+// recursion
+typedef struct GenTreePersistCopyStep {
+  // Node of the GenTree
+  const GenTree* _node;
+  // Node of the previous version which may be shared instead of a copy
+  // of the node, null if none
+  const GenTreePersist* _prev;
+  // Next subtree of the node to copy, null once they are all copied
+  const GSetElem* _next;
+  // Number of subtrees of the node remaining to copy
+  int _nbNext;
+  // Index in the subtrees of _prev of the next node which may be 
+  // shared
+  int _iPrev;
+  // Index of the step of the parent of the node, -1 for the root
+  int _iParent;
+  // Copy of the node, once its subtrees are copied
+  GenTreePersist* _copy;
+  // Flag to memorize if _copy is a new node or a shared one
+  bool _isNew;
+} GenTreePersistCopyStep;
+
+// Stack of the steps of the copy of a GenTree into a persistent tree
+// Each step becomes the copy of its node once its subtrees are copied,
+// thus the steps above the step of a node are the copies of its 
+// subtrees when it's its turn to be copied
+typedef struct GenTreePersistCopyStack {
+  // Steps, null until the first one is pushed
+  GenTreePersistCopyStep* _steps;
+  // Number of steps in the stack
+  int _nbStep;
+  // Number of steps the array can contain
+  int _capacity;
+} GenTreePersistCopyStack;
+
+// ================ Functions declaration ====================
+
+// Allocate a new node of persistent tree with user data 'data', sort 
+// value 'sortVal' and room for 'nbSubtree' subtrees
+// The subtrees and the size must be set by the caller
+GenTreePersist* GenTreePersistAlloc(void* const data, 
+  const float sortVal, const int nbSubtree);
+
+// Return a copy of the node 'that' of a persistent tree with room for
+// 'nbSubtree' subtrees, where the subtrees of 'that' are copied (and 
+// retained) except the 'iSkip'-th one, and an empty room is left at 
+// position 'iHole'
+// If 'iSkip' or 'iHole' is -1 no subtree is skipped or no room is left
+GenTreePersist* GenTreePersistCopy(const GenTreePersist* const that, 
+  const int nbSubtree, const int iSkip, const int iHole);
+
+// Return the root of the new version of the subtree 'that' of a 
+// persistent tree after the edit 'edit' of its 'iNode'-th node, 
+// copying the nodes on the path to the edited node
+GenTreePersist* GenTreePersistApply(const GenTreePersist* const that,
+  const int iNode, const GenTreePersistEdit* const edit);
+
+// Check the arguments of the edit of the 'iNode'-th node of the 
+// persistent tree 'that'
+#if BUILDMODE == 0
+void GenTreePersistCheckArg(const GenTreePersist* const that, 
+  const int iNode);
+#endif
+
+// Push the node 'node' and the index 'iSubtree' of the subtree 
+// followed from it on the stack 'that', growing its array if necessary
+void GenTreePersistStackPush(GenTreePersistStack* const that, 
+  const GenTreePersist* const node, const int iSubtree);
+
+// Push the step of the copy of the node 'node' of a GenTree, whose 
+// node 'prev' of the previous version may be shared, and the step of 
+// whose parent is the 'iParent'-th one on the stack 'that', growing its
+// array if necessary
+void GenTreePersistCopyStackPush(GenTreePersistCopyStack* const that, 
+  const GenTree* const node, const GenTreePersist* const prev, 
+  const int iParent);
+
+// Return the node of the previous version which may be shared instead
+// of a copy of the next subtree 'node' of the step 'step', and move to
+// the next one
+const GenTreePersist* GenTreePersistCopyStepNextPrev(
+  GenTreePersistCopyStep* const step, const GenTree* const node);
+
+// Set the copy of the node of the 'iStep'-th step of the stack 'that',
+// sharing the node of the previous version if its subtrees are the 
+// copies above it, and pop these copies
+void GenTreePersistCopyStackSetCopy(GenTreePersistCopyStack* const that,
+  const int iStep);
+
+// ================ Functions implementation ====================
+
+// Create a new persistent tree made of one node with user data 'data'
+// Return its root
+GenTreePersist* GenTreePersistCreate(void* const data) {
+  GenTreePersist* that = GenTreePersistAlloc(data, 0.0, 0);
+  that->_size = 0;
+  return that;
+}
+
+// Create a new version of a persistent tree copied from the GenTree 
+// 'tree', sharing with the version 'prev' the subtrees identical in 
+// both (same user data, sort values and shape). 'prev' may be null, 
+// then all the nodes are copied
+// The whole tree is run through, as the user data may have been
+// modified by GenTreeSetData, but only the nodes on the paths to the 
+// differences are allocated
+// Return its root
+GenTreePersist* GenTreePersistCreateFromTree(const GenTree* const tree,
+  const GenTreePersist* const prev) {
+#if BUILDMODE == 0
+  if (tree == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'tree' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  // Run through the tree in depth first order without recursion, a 
+  // node is copied once all its subtrees are copied, the node of the 
+  // previous version at the same place being shared if it has the same
+  // user data and exactly the same subtrees
+  GenTreePersistCopyStack stack = {._steps = NULL, ._nbStep = 0, 
+    ._capacity = 0};
+  GenTreePersistCopyStackPush(&stack, tree, prev, -1);
+  int iStep = 0;
+  while (iStep >= 0) {
+    GenTreePersistCopyStep* step = stack._steps + iStep;
+    if (step->_next != NULL) {
+      const GenTree* node = step->_next->_data;
+      const GenTreePersist* nodePrev = 
+        GenTreePersistCopyStepNextPrev(step, node);
+      GenTreePersistCopyStackPush(&stack, node, nodePrev, iStep);
+      iStep = stack._nbStep - 1;
+    } else {
+      int iParent = step->_iParent;
+      GenTreePersistCopyStackSetCopy(&stack, iStep);
+      iStep = iParent;
+    }
+  }
+  // The root shared with the previous version is a new reference to it
+  GenTreePersist* that = stack._steps[0]._copy;
+  if (!(stack._steps[0]._isNew))
+    GenTreePersistRetain(that);
+  free(stack._steps);
+  return that;
+}
+
+// Add a reference to the version of the persistent tree 'that' is the
+// root of, to be freed with GenTreePersistFree. It's the O(1) snapshot
+// of the version
+// Return 'that'
+GenTreePersist* GenTreePersistRetain(GenTreePersist* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  atomic_fetch_add(&(that->_nbRef), 1);
+  return that;
+}
+
+// Release the reference to the version of the persistent tree 'that' 
+// is the root of, and free the nodes which are not referenced anymore
+// by other versions
+// User data must be freed by the user
+void GenTreePersistFree(GenTreePersist** that) {
+  // Check argument
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // The subtrees are released only when the node itself is freed, so
+  // the nodes shared with other versions are left untouched. The nodes
+  // to free are kept in a stack instead of the C stack
+  GenTreePersistStack stack = {._steps = NULL, ._nbStep = 0, 
+    ._capacity = 0};
+  if (atomic_fetch_sub(&((*that)->_nbRef), 1) == 1)
+    GenTreePersistStackPush(&stack, *that, 0);
+  while (stack._nbStep > 0) {
+    --(stack._nbStep);
+    GenTreePersist* node = 
+      (GenTreePersist*)(stack._steps[stack._nbStep]._node);
+    for (int iSubtree = node->_nbSubtree; iSubtree--;)
+      if (atomic_fetch_sub(&(node->_subtrees[iSubtree]->_nbRef), 1) == 1)
+        GenTreePersistStackPush(&stack, node->_subtrees[iSubtree], 0);
+    free(node);
+  }
+  free(stack._steps);
+  *that = NULL;
+}
+
+// Return the root of a new version of the persistent tree 'that' where
+// a node with user data 'data' is appended to the subtrees of the 
+// 'iNode'-th node (in depth first order, the root being the node 0)
+// 'that' is unchanged
+GenTreePersist* GenTreePersistAppendData(
+  const GenTreePersist* const that, const int iNode, void* const data) {
+#if BUILDMODE == 0
+  GenTreePersistCheckArg(that, iNode);
+#endif
+  GenTreePersistEdit edit = {
+    ._op = GenTreePersistOpAppend, ._data = data, ._sortVal = 0.0};
+  return GenTreePersistApply(that, iNode, &edit);
+}
+
+// Return the root of a new version of the persistent tree 'that' where
+// a node with user data 'data' and sort value 'sortVal' is added to the
+// subtrees of the 'iNode'-th node (in depth first order, the root 
+// being the node 0), with the same order as GenTreeAddSortData
+// 'that' is unchanged
+GenTreePersist* GenTreePersistAddSortData(
+  const GenTreePersist* const that, const int iNode, void* const data, 
+  const float sortVal) {
+#if BUILDMODE == 0
+  GenTreePersistCheckArg(that, iNode);
+#endif
+  GenTreePersistEdit edit = {
+    ._op = GenTreePersistOpAddSort, ._data = data, ._sortVal = sortVal};
+  return GenTreePersistApply(that, iNode, &edit);
+}
+
+// Return the root of a new version of the persistent tree 'that' where
+// the user data of the 'iNode'-th node (in depth first order, the root
+// being the node 0) is 'data'
+// 'that' is unchanged
+GenTreePersist* GenTreePersistSetData(const GenTreePersist* const that,
+  const int iNode, void* const data) {
+#if BUILDMODE == 0
+  GenTreePersistCheckArg(that, iNode);
+#endif
+  GenTreePersistEdit edit = {
+    ._op = GenTreePersistOpSetData, ._data = data, ._sortVal = 0.0};
+  return GenTreePersistApply(that, iNode, &edit);
+}
+
+// Return the root of a new version of the persistent tree 'that' where
+// the 'iNode'-th node (in depth first order, the root being the node 0)
+// and its subtrees are removed
+// 'iNode' must not be the root
+// 'that' is unchanged
+GenTreePersist* GenTreePersistCut(const GenTreePersist* const that,
+  const int iNode) {
+#if BUILDMODE == 0
+  GenTreePersistCheckArg(that, iNode);
+  if (iNode == 0) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iNode' can't be the root");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  GenTreePersistEdit edit = {
+    ._op = GenTreePersistOpCut, ._data = NULL, ._sortVal = 0.0};
+  return GenTreePersistApply(that, iNode, &edit);
+}
+
+// Return the 'iNode'-th node (in depth first order, the root being the
+// node 0) of the persistent tree 'that'
+// Return null if 'iNode' is not in [0, GenTreePersistGetSize(that)]
+const GenTreePersist* GenTreePersistSelect(
+  const GenTreePersist* const that, const int iNode) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+#endif
+  if (iNode < 0 || iNode > that->_size)
+    return NULL;
+  // Number of nodes remaining to skip
+  int nbSkip = iNode;
+  const GenTreePersist* node = that;
+  while (nbSkip > 0) {
+    // Skip the node itself and the whole subtrees before the searched 
+    // node
+    --nbSkip;
+    GenTreePersist* const* subtree = node->_subtrees;
+    while (nbSkip > (*subtree)->_size) {
+      nbSkip -= (*subtree)->_size + 1;
+      ++subtree;
+    }
+    node = *subtree;
+  }
+  return node;
+}
+
+// Allocate a new node of persistent tree with user data 'data', sort 
+// value 'sortVal' and room for 'nbSubtree' subtrees
+// The subtrees and the size must be set by the caller
+GenTreePersist* GenTreePersistAlloc(void* const data, 
+  const float sortVal, const int nbSubtree) {
+  // The array of subtrees is allocated with the node
+  GenTreePersist* that = PBErrMalloc(GenTreeErr, 
+    sizeof(GenTreePersist) + sizeof(GenTreePersist*) * nbSubtree);
+  atomic_init(&(that->_nbRef), 1);
+  that->_data = data;
+  that->_sortVal = sortVal;
+  that->_nbSubtree = nbSubtree;
+  return that;
+}
+
+// Return a copy of the node 'that' of a persistent tree with room for
+// 'nbSubtree' subtrees, where the subtrees of 'that' are copied (and 
+// retained) except the 'iSkip'-th one, and an empty room is left at 
+// position 'iHole'
+// If 'iSkip' or 'iHole' is -1 no subtree is skipped or no room is left
+GenTreePersist* GenTreePersistCopy(const GenTreePersist* const that, 
+  const int nbSubtree, const int iSkip, const int iHole) {
+  GenTreePersist* copy = 
+    GenTreePersistAlloc(that->_data, that->_sortVal, nbSubtree);
+  copy->_size = that->_size;
+  int iCopy = 0;
+  for (int iSubtree = 0; iSubtree < that->_nbSubtree; ++iSubtree) {
+    if (iCopy == iHole)
+      ++iCopy;
+    if (iSubtree != iSkip) {
+      copy->_subtrees[iCopy] = that->_subtrees[iSubtree];
+      atomic_fetch_add(&(copy->_subtrees[iCopy]->_nbRef), 1);
+      ++iCopy;
+    }
+  }
+  return copy;
+}
+
+// Return the root of the new version of the subtree 'that' of a 
+// persistent tree after the edit 'edit' of its 'iNode'-th node, 
+// copying the nodes on the path to the edited node
+GenTreePersist* GenTreePersistApply(const GenTreePersist* const that,
+  const int iNode, const GenTreePersistEdit* const edit) {
+  // Go down to the edited node, memorizing the path in a stack instead
+  // of the C stack
+  GenTreePersistStack path = {._steps = NULL, ._nbStep = 0, 
+    ._capacity = 0};
+  const GenTreePersist* node = that;
+  int nbSkip = iNode;
+  GenTreePersist* edited = NULL;
+  while (edited == NULL) {
+    int nb = node->_nbSubtree;
+    // If the edited node is this node
+    if (nbSkip == 0) {
+      if (edit->_op == GenTreePersistOpSetData) {
+        edited = GenTreePersistCopy(node, nb, -1, -1);
+        edited->_data = edit->_data;
+      } else {
+        // Search the position of the new node, after the subtrees with
+        // lower or equal sort value as GenTreeSubtreeUpperBound
+        int iHole = nb;
+        if (edit->_op == GenTreePersistOpAddSort) {
+          iHole = 0;
+          while (iHole < nb && 
+            node->_subtrees[iHole]->_sortVal <= edit->_sortVal)
+            ++iHole;
+        }
+        edited = GenTreePersistCopy(node, nb + 1, -1, iHole);
+        GenTreePersist* tree = 
+          GenTreePersistAlloc(edit->_data, edit->_sortVal, 0);
+        tree->_size = 0;
+        edited->_subtrees[iHole] = tree;
+        ++(edited->_size);
+      }
+    } else {
+      // Search the subtree containing the edited node, skipping the 
+      // node itself and the whole subtrees before it
+      --nbSkip;
+      int iSubtree = 0;
+      while (nbSkip > node->_subtrees[iSubtree]->_size) {
+        nbSkip -= node->_subtrees[iSubtree]->_size + 1;
+        ++iSubtree;
+      }
+      const GenTreePersist* subtree = node->_subtrees[iSubtree];
+      // If the edited node is this subtree and it is cut, copy this 
+      // node without it
+      if (nbSkip == 0 && edit->_op == GenTreePersistOpCut) {
+        edited = GenTreePersistCopy(node, nb - 1, iSubtree, -1);
+        edited->_size -= subtree->_size + 1;
+      } else {
+        GenTreePersistStackPush(&path, node, iSubtree);
+        node = subtree;
+      }
+    }
+  }
+  // Climb back up the path, copying each node with the new version of
+  // its subtree, all the other subtrees being shared
+  while (path._nbStep > 0) {
+    --(path._nbStep);
+    const GenTreePersistStep* step = path._steps + path._nbStep;
+    int iSubtree = step->_iSubtree;
+    GenTreePersist* copy = GenTreePersistCopy(step->_node, 
+      step->_node->_nbSubtree, iSubtree, iSubtree);
+    copy->_subtrees[iSubtree] = edited;
+    copy->_size += edited->_size - step->_node->_subtrees[iSubtree]->_size;
+    edited = copy;
+  }
+  free(path._steps);
+  return edited;
+}
+
+// Push the node 'node' and the index 'iSubtree' of the subtree 
+// followed from it on the stack 'that', growing its array if necessary
+void GenTreePersistStackPush(GenTreePersistStack* const that, 
+  const GenTreePersist* const node, const int iSubtree) {
+  // If the array is full, double its capacity
+  if (that->_nbStep == that->_capacity) {
+    int capacity = (that->_capacity > 0 ? that->_capacity * 2 : 16);
+    GenTreePersistStep* steps = 
+      PBErrMalloc(GenTreeErr, sizeof(GenTreePersistStep) * capacity);
+    if (that->_nbStep > 0)
+      memcpy(steps, that->_steps, 
+        sizeof(GenTreePersistStep) * that->_nbStep);
+    free(that->_steps);
+    that->_steps = steps;
+    that->_capacity = capacity;
+  }
+  that->_steps[that->_nbStep]._node = node;
+  that->_steps[that->_nbStep]._iSubtree = iSubtree;
+  ++(that->_nbStep);
 }
 
+// Push the step of the copy of the node 'node' of a GenTree, whose 
+// node 'prev' of the previous version may be shared, and the step of 
+// whose parent is the 'iParent'-th one on the stack 'that', growing its
+// array if necessary
+void GenTreePersistCopyStackPush(GenTreePersistCopyStack* const that, 
+  const GenTree* const node, const GenTreePersist* const prev, 
+  const int iParent) {
+  // If the array is full, double its capacity
+  if (that->_nbStep == that->_capacity) {
+    int capacity = (that->_capacity > 0 ? that->_capacity * 2 : 16);
+    GenTreePersistCopyStep* steps = 
+      PBErrMalloc(GenTreeErr, sizeof(GenTreePersistCopyStep) * capacity);
+    if (that->_nbStep > 0)
+      memcpy(steps, that->_steps, 
+        sizeof(GenTreePersistCopyStep) * that->_nbStep);
+    free(that->_steps);
+    that->_steps = steps;
+    that->_capacity = capacity;
+  }
+  GenTreePersistCopyStep* step = that->_steps + that->_nbStep;
+  step->_node = node;
+  step->_prev = prev;
+  step->_next = node->_subtrees._set._head;
+  step->_nbNext = node->_subtrees._set._nbElem;
+  step->_iPrev = 0;
+  step->_iParent = iParent;
+  step->_copy = NULL;
+  step->_isNew = false;
+  ++(that->_nbStep);
+}
+
+// Return the node of the previous version which may be shared instead
+// of a copy of the next subtree 'node' of the step 'step', and move to
+// the next one
+const GenTreePersist* GenTreePersistCopyStepNextPrev(
+  GenTreePersistCopyStep* const step, const GenTree* const node) {
+  step->_next = step->_next->_next;
+  --(step->_nbNext);
+  if (step->_prev == NULL)
+    return NULL;
+  // The subtrees of the previous version are followed in order: the 
+  // next one if it has the same user data, or the one after it if it 
+  // has the same user data (the next one has been cut), or the next one
+  // if there are as many subtrees remaining on both sides (its user 
+  // data has been modified). Else the node has been added and has no 
+  // previous version
+  GenTreePersist* const* subtrees = step->_prev->_subtrees + step->_iPrev;
+  int nbPrev = step->_prev->_nbSubtree - step->_iPrev;
+  if (nbPrev > 1 && subtrees[0]->_data != node->_data && 
+    subtrees[1]->_data == node->_data) {
+    step->_iPrev += 2;
+    return subtrees[1];
+  } else if (nbPrev > 0 && (subtrees[0]->_data == node->_data || 
+    nbPrev == step->_nbNext + 1)) {
+    ++(step->_iPrev);
+    return subtrees[0];
+  } else {
+    return NULL;
+  }
+}
+
+// Set the copy of the node of the 'iStep'-th step of the stack 'that',
+// sharing the node of the previous version if its subtrees are the 
+// copies above it, and pop these copies
+void GenTreePersistCopyStackSetCopy(GenTreePersistCopyStack* const that,
+  const int iStep) {
+  GenTreePersistCopyStep* step = that->_steps + iStep;
+  const GenTreePersistCopyStep* subtrees = step + 1;
+  int nbSubtree = that->_nbStep - iStep - 1;
+  // A new node is never one of the nodes of the previous version, so
+  // the shared subtrees are exactly the subtrees of the previous 
+  // version
+  const GenTreePersist* prev = step->_prev;
+  bool isShared = (prev != NULL && prev->_data == step->_node->_data &&
+    prev->_sortVal == step->_node->_link._sortVal && 
+    prev->_nbSubtree == nbSubtree);
+  for (int iSubtree = 0; isShared && iSubtree < nbSubtree; ++iSubtree)
+    isShared = (subtrees[iSubtree]._copy == prev->_subtrees[iSubtree]);
+  if (isShared) {
+    step->_copy = (GenTreePersist*)prev;
+    step->_isNew = false;
+  } else {
+    // The new node takes the references of the new subtrees and adds 
+    // one to the shared ones
+    step->_copy = GenTreePersistAlloc(step->_node->_data, 
+      step->_node->_link._sortVal, nbSubtree);
+    step->_copy->_size = step->_node->_size;
+    for (int iSubtree = 0; iSubtree < nbSubtree; ++iSubtree) {
+      step->_copy->_subtrees[iSubtree] = subtrees[iSubtree]._copy;
+      if (!(subtrees[iSubtree]._isNew))
+        atomic_fetch_add(&(subtrees[iSubtree]._copy->_nbRef), 1);
+    }
+    step->_isNew = true;
+  }
+  that->_nbStep = iStep + 1;
+}
+
+// Check the arguments of the edit of the 'iNode'-th node of the 
+// persistent tree 'that'
+#if BUILDMODE == 0
+void GenTreePersistCheckArg(const GenTreePersist* const that, 
+  const int iNode) {
+  if (that == NULL) {
+    GenTreeErr->_type = PBErrTypeNullPointer;
+    sprintf(GenTreeErr->_msg, "'that' is null");
+    PBErrCatch(GenTreeErr);
+  }
+  if (iNode < 0 || iNode > that->_size) {
+    GenTreeErr->_type = PBErrTypeInvalidArg;
+    sprintf(GenTreeErr->_msg, "'iNode' is invalid (0<=%d<=%d)", 
+      iNode, that->_size);
+    PBErrCatch(GenTreeErr);
+  }
+}
+#endif
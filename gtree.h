@@ -10,6 +10,11 @@
 #include <math.h>
 #include <string.h>
 #include <stdbool.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 #include "pberr.h"
 #include "gset.h"
 
@@ -17,20 +22,235 @@
 
 // ================= Define ==================
 
+// Default number of nodes per chunk of a GenTreePool
+#define GENTREEPOOL_NBNODEPERCHUNK 1024
+
+// Initial number of buckets of a GenTreeIndex
+#define GENTREEINDEX_NBBUCKET 16
+
+// Value of the next slot of a slot of a GenTreeIndex whose node has 
+// been removed
+#define GENTREEINDEX_REMOVED -2
+
+// Maximum number of levels of a GenTreeSkipList, enough for 4^16 
+// subtrees
+#define GENTREESKIPLIST_MAXLEVEL 16
+
+// Number of edits memorized by the edit log of a tree
+#define GENTREEEDITLOG_NBEDIT 128
+
 // ================= Data structure ===================
 
 struct GenTree;
+struct GenTreePool;
+struct GenTreeIndex;
+struct GenTreeSkipList;
+struct GenTreeBlock;
+struct GenTreeExtra;
+struct GenTreeEditLog;
 typedef struct GenTree {
   // Parent node
   struct GenTree* _parent;
   // Branches
   // Branch cannot be null, if the user tries to add a null branch 
   // nothing happen
+  // The elements of the set are the _link of the subtrees, hence the 
+  // set can be read with the GSet functions but must be modified only
+  // through the GenTree functions
   GSetGenTree _subtrees;
   // User data
   void* _data;
+  // Link of the node in the set of subtrees of its parent
+  // _data points to the node, _next and _prev to its brothers, and 
+  // _sortVal is the sort value of the node
+  GSetElem _link;
+  // Pool the node has been allocated from, null if it has been 
+  // allocated with malloc
+  // Nodes created with the *Data functions are allocated from the pool
+  // of their parent
+  struct GenTreePool* _pool;
+  // Block of memory the node has been allocated in with other nodes by 
+  // a batch function, null if the node has been allocated alone or 
+  // from a pool
+  struct GenTreeBlock* _block;
+  // Generation of the tree, incremented each time the subtrees of the 
+  // tree or of one of its descendants are modified, or the tree is 
+  // attached to or cut from its parent
+  unsigned long _gen;
+  // Generation of the subtrees list of the node, incremented each time
+  // a subtree is added or removed
+  unsigned long _subtreesGen;
+  // Cached position of the node among its brothers, valid if 
+  // _siblingGen equals the _subtreesGen of the parent, or if the parent
+  // has an array of subtrees and the node is at this position in it
+  unsigned long _siblingGen;
+  int _siblingIndex;
+  // Number of nodes in the subtrees of the node, recursively
+  int _size;
+  // Optional state of the node, allocated only when the node uses one
+  // of the optional features (array of subtrees, skip list, index, 
+  // edit log), null else
+  struct GenTreeExtra* _extra;
 } GenTree;
 
+// Optional state of a node, allocated with malloc by the first 
+// optional feature used by the node and freed with the node, or by the
+// pool of the node when it's reset
+typedef struct GenTreeExtra {
+  // Optional array of the subtrees, in the same order as _subtrees, 
+  // null if not used
+  struct GenTree** _subtreeArr;
+  // Capacity of _subtreeArr
+  int _subtreeArrCapacity;
+  // Number of leading subtrees in _subtreeArr whose _siblingIndex is 
+  // known to be up to date
+  int _subtreeArrNbValid;
+  // Optional skip list over the subtrees ordered by sort value, null if
+  // not used
+  struct GenTreeSkipList* _skipList;
+  // Next nodes of the node in the levels of the skip list of its parent
+  // above the list of subtrees, and number of these levels
+  struct GenTree** _skipNext;
+  int _skipLevel;
+  // Index of the tree the node is the root of, null if the tree is not
+  // indexed
+  struct GenTreeIndex* _index;
+  // Log of the last edits of the tree, null if not used. The log is 
+  // owned by the root of the tree
+  struct GenTreeEditLog* _editLog;
+  // Node the optional state belongs to
+  struct GenTree* _node;
+  // Previous and next optional states of the nodes allocated from the
+  // same pool, for the pool to release them when it's reset
+  struct GenTreeExtra* _poolPrev;
+  struct GenTreeExtra* _poolNext;
+} GenTreeExtra;
+
+// Pool of nodes, allocated by chunks and recycled through a freelist
+// In arena mode the nodes are never recycled and all the trees 
+// allocated from the pool are released at once with GenTreePoolReset
+// A pool is not thread safe, use one pool per thread
+typedef struct GenTreePool {
+  // Number of nodes per chunk
+  int _nbNodePerChunk;
+  // Chunks of memory, the head is the one currently used
+  GSet _chunks;
+  // Number of bytes already used in the head chunk
+  size_t _nbUsedByte;
+  // Freelist of recycled nodes, chained through their _parent
+  struct GenTree* _freeNodes;
+  // Flag for the arena mode
+  bool _isArena;
+  // Number of nodes currently in use
+  long _nbLive;
+  // Number of nodes served from the freelist
+  long _nbRecycled;
+  // Optional states of the nodes allocated from the pool, chained 
+  // through their _poolNext
+  struct GenTreeExtra* _extras;
+} GenTreePool;
+
+// Slot of a node in a GenTreeIndex
+typedef struct GenTreeIndexSlot {
+  // Node in the slot, null if the slot is free
+  struct GenTree* _node;
+  // Next and previous slots in the chain of the bucket of the node, -1
+  // if none. _next is GENTREEINDEX_REMOVED for a free slot whose node 
+  // has been removed, the search of a node continuing after it
+  int _next;
+  int _prev;
+} GenTreeIndexSlot;
+
+// Hash index from user data to the nodes of a tree holding them
+// The root of the tree is not in the index, as it's not in the 
+// sequences of the iterators
+// The nodes are kept in an open addressed table of slots on their 
+// address, the slots being chained per bucket of the key of their data,
+// so the index doesn't use any memory in the nodes and the index of a
+// node is the one of its root
+// The index is allocated with malloc, even for a tree allocated from a
+// GenTreePool, and freed with the tree or when the pool is reset
+typedef struct GenTreeIndex {
+  // Function calculating the key of a user data, null to use the 
+  // address of the data as its key
+  unsigned long (*_keyFun)(const void* const data);
+  // Slots of the nodes
+  GenTreeIndexSlot* _slots;
+  // First slot of the chain of each bucket, -1 if the bucket is empty
+  int* _buckets;
+  // Number of slots and buckets, a power of 2
+  int _nbBucket;
+  // Number of nodes in the index
+  long _nbNode;
+  // Number of free slots left by removed nodes
+  long _nbRemoved;
+} GenTreeIndex;
+
+// Header of a block of memory containing nodes allocated together by a
+// batch function, the nodes follow the header. The block is freed when
+// its last node is freed
+typedef struct GenTreeBlock {
+  // Number of nodes of the block not yet freed
+  long _nbLive;
+} GenTreeBlock;
+
+// Skip list over the subtrees of a node, sorted by sort value
+// The list of subtrees is the lowest level, the levels above are 
+// threaded through the _skipNext of the subtrees
+typedef struct GenTreeSkipList {
+  // Heads of the levels above the list of subtrees
+  struct GenTree* _heads[GENTREESKIPLIST_MAXLEVEL];
+  // Number of levels above the list of subtrees currently used
+  int _nbLevel;
+  // State of the generator of the levels of new subtrees
+  unsigned long _seed;
+} GenTreeSkipList;
+
+// Edits memorized in the edit log of a tree
+typedef enum GenTreeEditOp {
+  GenTreeEditInsert, GenTreeEditRemove
+} GenTreeEditOp;
+
+// Edit memorized in the edit log of a tree
+typedef struct GenTreeEdit {
+  // Generation of the root of the tree before the edit
+  unsigned long _gen;
+  // Insertion or removal of nodes
+  GenTreeEditOp _op;
+  // Position in depth first order (the order of GenTreeIterDepth) of 
+  // the first inserted or removed node, the others follow it
+  int _rank;
+  // Number of inserted or removed nodes
+  int _nbNode;
+  // Depth of the first inserted node (its number of ancestors), unused
+  // for removals
+  int _depth;
+} GenTreeEdit;
+
+// Log of the last insertions and removals of subtrees in a tree, used
+// by the iterators' update to patch their sequence instead of 
+// recreating it
+// The log is created by the first update of an iterator on the tree 
+// or on one of its subtrees, and is allocated with malloc like the 
+// other optional states. It's released when GENTREEEDITLOG_NBEDIT 
+// edits have been made without any update, as no iterator could be 
+// patched with it anymore
+typedef struct GenTreeEditLog {
+  // Edits, in a circular array where the oldest one is overwritten 
+  // when the log is full
+  GenTreeEdit _edits[GENTREEEDITLOG_NBEDIT];
+  // Index of the oldest edit and number of edits
+  int _first;
+  int _nbEdit;
+  // Generation of the root after the last edit in the log
+  unsigned long _gen;
+  // Oldest generation of the root from which the edits in the log can
+  // be replayed
+  unsigned long _genMin;
+  // Number of edits since the last update of an iterator with the log
+  int _nbUnread;
+} GenTreeEditLog;
+
 typedef struct GenTreeIter GenTreeIter;
 
 // ================ Functions declaration ====================
@@ -44,6 +264,19 @@ GenTree GenTreeCreateStatic(void);
 // Create a new GenTree with user data 'data'
 GenTree* GenTreeCreateData(void* const data);
 
+// Create a new GenTree allocated from the GenTreePool 'pool'
+// If 'pool' is null the GenTree is allocated with malloc
+GenTree* GenTreeCreatePool(GenTreePool* const pool);
+
+// Create a new static GenTree whose nodes created with the *Data 
+// functions will be allocated from the GenTreePool 'pool'
+GenTree GenTreeCreateStaticPool(GenTreePool* const pool);
+
+// Create a new GenTree with user data 'data' allocated from the 
+// GenTreePool 'pool'
+// If 'pool' is null the GenTree is allocated with malloc
+GenTree* GenTreeCreateDataPool(GenTreePool* const pool, void* const data);
+
 // Free the memory used by the GenTree 'that'
 // If 'that' is not a root node it is cut prior to be freed
 // Subtrees are recursively freed
@@ -69,15 +302,58 @@ static inline
 void _GenTreeSetData(GenTree* const that, void* const data);
 
 // Get the set of subtrees of the GenTree 'that'
+// The elements of the set are embedded in the subtrees, the set must 
+// be modified only through the GenTree functions
+#if BUILDMODE != 0
+static inline
+#endif
+const GSetGenTree* _GenTreeSubtrees(const GenTree* const that);
+
+// Get the pool of the GenTree 'that'
 #if BUILDMODE != 0
 static inline
 #endif
-GSetGenTree* _GenTreeSubtrees(const GenTree* const that);
+GenTreePool* _GenTreeGetPool(const GenTree* const that);
+
+// Get the sort value of the GenTree 'that' in the subtrees of its 
+// parent
+#if BUILDMODE != 0
+static inline
+#endif
+float _GenTreeSortVal(const GenTree* const that);
+
+// Get the generation of the GenTree 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned long _GenTreeGen(const GenTree* const that);
 
 // Disconnect the GenTree 'that' from its parent
 // If it has no parent, do nothing
 void _GenTreeCut(GenTree* const that);
 
+// Move the GenTree 'that' and its subtrees to the 'pos'-th position in
+// the subtrees of the GenTree 'parent' (counted once 'that' is removed
+// if it's already a subtree of 'parent'), keeping its sort value
+// If 'parent' has a skip list 'pos' is ignored and 'that' is inserted
+// at its position by sort value
+// 'parent' must not be in 'that'
+// The subtree is relinked without being cut and added again: nodes 
+// moved inside an indexed tree stay in the index, and only the sizes 
+// of the former and new ancestors are updated
+void _GenTreeMoveSubtree(GenTree* const that, GenTree* const parent, 
+  const int pos);
+
+// Move all the subtrees of the GenTree 'that' at the end of the 
+// subtrees of the GenTree 'to', keeping their order and sort values
+// 'to' must not be in the subtrees of 'that'
+// The whole list of subtrees is spliced at once, only their parent is 
+// updated. If 'that' or 'to' has an array of subtrees or a skip list,
+// the subtrees are moved one by one to keep them up to date, and if 
+// 'to' has a skip list they are inserted at their position by sort 
+// value
+void _GenTreeGraftChildren(GenTree* const that, GenTree* const to);
+
 // Return true if the GenTree 'that' is a root
 // Return false else
 #if BUILDMODE != 0
@@ -105,10 +381,43 @@ static inline
 #endif
 GenTree* _GenTreeParent(const GenTree* const that);
 
+// Return the next brother of the GenTree 'that', null if it is the last
+// of its brotherhood or a root
+#if BUILDMODE != 0
+static inline
+#endif
+GenTree* _GenTreeNextSibling(const GenTree* const that);
+
+// Return the previous brother of the GenTree 'that', null if it is the
+// first of its brotherhood or a root
+#if BUILDMODE != 0
+static inline
+#endif
+GenTree* _GenTreePrevSibling(const GenTree* const that);
+
+// Return the position of the GenTree 'that' among its brothers (0 for
+// a root)
+// The positions are cached and recalculated for the whole brotherhood
+// only after a subtree has been added or removed to the parent
+int _GenTreeSiblingIndex(const GenTree* const that);
+
 // Return the number of subtrees of the GenTree 'that' and their subtrees 
 // recursively
+#if BUILDMODE != 0
+static inline
+#endif
 int _GenTreeGetSize(const GenTree* const that);
 
+// Return the 'iNode'-th node (starting at 0) of the subtrees of the 
+// GenTree 'that' in depth first order, the order of GenTreeIterDepth
+// Return null if 'iNode' is not in [0, GenTreeGetSize(that)[
+GenTree* _GenTreeSelect(const GenTree* const that, const int iNode);
+
+// Return the position of the node 'node' in the subtrees of the 
+// GenTree 'that' in depth first order, the order of GenTreeIterDepth
+// 'node' must be a descendant of 'that'
+int _GenTreeRank(const GenTree* const that, const GenTree* const node);
+
 // Append a new node with 'data' to the first node containing 'node'
 // in the GenTree 'that'
 // Uses the iterator 'iter' to search the node
@@ -122,74 +431,289 @@ bool _GenTreeAppendToNode(GenTree* const that,
 // eventual successive nodes containing the same data. If one want to 
 // loop on these nodes, the proper stopping condition is 
 // while(GenTreeSearch() != NULL && GenTreeIterIsLast() == false)
+// If the tree is indexed and 'iter' is an up to date GenTreeIterDepth,
+// the node is found with the index and the iterator moved directly 
+// after it, else the iterator runs through the nodes
 // Return the node if we could find 'data', null else
 GenTree* _GenTreeSearch(const GenTree* const that, 
   const void* const data, GenTreeIter* const iter);
 
+// Insert the GenTree 'tree' in the subtrees of the GenTree 'that' 
+// before the element 'next' (at the end if 'next' is null), with the 
+// sort value 'sortVal'
+// The subtrees of a GenTree must be modified only through the GenTree
+// functions
+void GenTreeLinkSubtree(GenTree* const that, GenTree* const tree, 
+  GSetElem* const next, const float sortVal);
+
+// Remove the element 'elem' (the _link of a subtree) from the subtrees
+// of the GenTree 'that'
+// Return the removed subtree, which becomes a root, or null if 'elem'
+// is null
+GenTree* GenTreeUnlinkSubtree(GenTree* const that, GSetElem* const elem);
+
+// Return the optional state of the GenTree 'that', allocating it if 
+// the node has none yet
+GenTreeExtra* GenTreeGetExtra(GenTree* const that);
+
+// Return the array of subtrees of the GenTree 'that', null if it has 
+// none
+#if BUILDMODE != 0
+static inline
+#endif
+GenTree** GenTreeGetSubtreeArr(const GenTree* const that);
+
+// Return the skip list over the subtrees of the GenTree 'that', null 
+// if it has none
+#if BUILDMODE != 0
+static inline
+#endif
+GenTreeSkipList* GenTreeGetSkipList(const GenTree* const that);
+
+// Return the index of the tree the GenTree 'that' belongs to, null if
+// it's not indexed
+// The index is owned by the root of the tree, this function climbs up
+// to it
+#if BUILDMODE != 0
+static inline
+#endif
+GenTreeIndex* GenTreeGetIndex(const GenTree* const that);
+
+// Return the element of the 'iSubtree'-th subtree of the GenTree 'that'
+// Return null if 'iSubtree' is greater than or equal to the number of
+// subtrees
+GSetElem* GenTreeSubtreeElem(const GenTree* const that, 
+  const int iSubtree);
+
+// Return the element of the first subtree of the GenTree 'that' whose 
+// sort value is strictly greater than 'sortVal'
+// Return null if there is none
+GSetElem* GenTreeSubtreeUpperBound(const GenTree* const that, 
+  const float sortVal);
+
+// Create the array of subtrees of the GenTree 'that', giving constant 
+// time access to its subtrees by position. Inserting or removing a 
+// subtree by position then shifts the array instead of running 
+// through the list of subtrees
+// Meant for nodes with many subtrees, the array is kept up to date 
+// until it is freed or the node is freed
+// The array is allocated with malloc, even for a node allocated from a
+// GenTreePool, and freed with the node or when the pool is reset
+// Do nothing if the node already has an array of subtrees
+void GenTreeSubtreeArrayCreate(GenTree* const that);
+
+// Free the array of subtrees of the GenTree 'that', if any
+void GenTreeSubtreeArrayFree(GenTree* const that);
+
+// Return true if the GenTree 'that' has an array of subtrees
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif
+bool GenTreeHasSubtreeArray(const GenTree* const that);
+
+// Create the skip list over the subtrees of the GenTree 'that', giving
+// logarithmic time insertion with the AddSort functions, search of 
+// the subtrees by sort value and range queries
+// The subtrees must be sorted by sort value, and stay sorted while the
+// skip list exists (i.e. subtrees must be added only with the AddSort
+// functions)
+// Meant for nodes with many subtrees, the skip list is kept up to date
+// until it is freed or the node is freed
+// The skip list is allocated with malloc, even for a node allocated 
+// from a GenTreePool, and freed with the node or when the pool is reset
+// Do nothing if the node already has a skip list
+void GenTreeSubtreeSkipListCreate(GenTree* const that);
+
+// Free the skip list over the subtrees of the GenTree 'that', if any
+void GenTreeSubtreeSkipListFree(GenTree* const that);
+
+// Return true if the GenTree 'that' has a skip list over its subtrees
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif
+bool GenTreeHasSubtreeSkipList(const GenTree* const that);
+
+// Return the element of the first subtree of the GenTree 'that' whose 
+// sort value is greater than or equal to 'sortVal'
+// Return null if there is none
+// The subtrees must be sorted by sort value
+GSetElem* GenTreeSubtreeLowerBound(const GenTree* const that, 
+  const float sortVal);
+
+// Return the number of subtrees of the GenTree 'that' whose sort value
+// is in ['lo', 'hi'], and set 'first' to the first of them (null if 
+// there is none). The following ones are obtained with 
+// GenTreeNextSibling
+// The subtrees must be sorted by sort value
+int _GenTreeSubtreesInRange(const GenTree* const that, const float lo,
+  const float hi, GenTree** const first);
+
+// Return the subtree of the GenTree 'that' with the lowest sort value
+// (the first one if several), or null if it has no subtree
+GenTree* _GenTreeMinSubtree(const GenTree* const that);
+
+// Return the subtree of the GenTree 'that' with the highest sort value
+// (the last one if several), or null if it has no subtree
+GenTree* _GenTreeMaxSubtree(const GenTree* const that);
+
+// Sort the subtrees of the GenTree 'that' by sort value with a stable
+// merge sort, in O(k log k) for k subtrees. The resulting order is the
+// one obtained by adding the subtrees with the AddSort functions in 
+// their current order
+// Do nothing if the subtrees are already sorted
+void GenTreeSortSubtrees(GenTree* const that);
+
+// Sort the subtrees of the GenTree 'that' and of all its subtrees, 
+// with GenTreeSortSubtrees, without recursion so the depth of the tree
+// is not limited by the C stack
+void GenTreeSortSubtreesRec(GenTree* const that);
+
+// Add new nodes with the 'nb' user data 'data' and sort values 
+// 'sortVals' to the subtrees of the GenTree 'that'
+// The result is the same as calling GenTreeAddSortData for each pair,
+// in order, but the nodes are allocated and linked in one batch and 
+// the subtrees are sorted only once, in O(k log k)
+void GenTreeAddSortDataBatch(GenTree* const that, void** const data, 
+  const float* const sortVals, const int nb);
+
+// Append new nodes with the 'nb' user data 'data', in order, at the end
+// of the subtrees of the GenTree 'that'
+// The nodes are allocated together (in one block of memory, or in 
+// consecutive memory of the pool of 'that') and linked in one pass
+void GenTreeAppendDataBatch(GenTree* const that, void** const data, 
+  const int nb);
+
+// Insert new nodes with the 'nb' user data 'data', in order, at the 
+// head of the subtrees of the GenTree 'that'
+// The nodes are allocated together and linked in one pass
+void GenTreePushDataBatch(GenTree* const that, void** const data, 
+  const int nb);
+
+// Insert new nodes with the 'nb' user data 'data', in order, at the 
+// position 'pos' in the subtrees of the GenTree 'that'
+// The nodes are allocated together and linked in one pass
+void GenTreeInsertDataBatch(GenTree* const that, void** const data, 
+  const int nb, const int pos);
+
+// Create a new GenTree from the 'nb' user data 'data' (null for no 
+// data) where 'parents'[i] is the index of the parent of the i-th node,
+// -1 for the root. There must be one and only one root, and no cycle
+// The subtrees of each node are in the order of their index, and 
+// sorted by sort value with the same order as GenTreeAddSortData if 
+// 'sortVals' is not null
+// The nodes are allocated in one block and the tree is built in linear
+// time (plus the sort if any)
+// Return the root
+GenTree* GenTreeCreateFromParents(void** const data, 
+  const int* const parents, const float* const sortVals, const int nb);
+
+// Create a new GenTree from the 'nb' user data 'data' (null for no 
+// data) and the 'nb - 1' edges 'edges', where ('edges'[2 * i], 
+// 'edges'[2 * i + 1]) are the indices of the parent and the child of 
+// the i-th edge. The node without parent is the root
+// The subtrees of each node are in the order of the edges, and sorted
+// by sort value ('sortVals'[i] is the sort value of the i-th node) 
+// with the same order as GenTreeAddSortData if 'sortVals' is not null
+// The nodes are allocated in one block and the tree is built in linear
+// time (plus the sort if any)
+// Return the root
+GenTree* GenTreeCreateFromEdges(void** const data, const int* const edges, 
+  const float* const sortVals, const int nb);
+
+// Export the GenTree 'that' into the arrays 'data', 'parents' and 
+// 'sortVals' (each one can be null), which must have room for 
+// GenTreeGetSize(that) + 1 elements. The nodes are numbered in depth 
+// first order, 'that' being the node 0 with parent -1. 
+// GenTreeCreateFromParents on the exported arrays recreates the tree
+// Return the number of nodes
+int GenTreeExportParents(const GenTree* const that, void** const data, 
+  int* const parents, float* const sortVals);
+
+// Create a copy of the GenTree 'that' and its subtrees, with the same 
+// structure and sort values. The data of each copied node is the 
+// result of 'cloneData' on the data of the original node, or the same
+// data if 'cloneData' is null
+// The nodes are allocated in one block and copied in one run through 
+// the tree. The subtrees keep their order. Nodes with an array of 
+// subtrees or a skip list get them in the copy, the index and the pool
+// are not copied
+// Return the root of the copy
+GenTree* _GenTreeClone(const GenTree* const that, 
+  void* (*cloneData)(void* const data));
+
 // Wrapping of GSet functions
 static inline GenTree* _GenTreeSubtree(const GenTree* const that, const int iSubtree) {
-  return GSetGet(_GenTreeSubtrees(that), iSubtree);
+  GenTree** arr = GenTreeGetSubtreeArr(that);
+  if (arr != NULL && iSubtree >= 0 && 
+    iSubtree < that->_subtrees._set._nbElem)
+    return arr[iSubtree];
+  return GSetGet((const GSet*)_GenTreeSubtrees(that), iSubtree);
 }
 static inline GenTree* _GenTreeFirstSubtree(const GenTree* const that) {
-  return GSetHead(_GenTreeSubtrees(that));
+  return GSetHead((const GSet*)_GenTreeSubtrees(that));
 }
 static inline GenTree* _GenTreeLastSubtree(const GenTree* const that) {
-  return GSetTail(_GenTreeSubtrees(that));
+  return GSetTail((const GSet*)_GenTreeSubtrees(that));
 }
 static inline GenTree* _GenTreePopSubtree(GenTree* const that) {
-  return GSetPop(_GenTreeSubtrees(that));
+  return GenTreeUnlinkSubtree(that, that->_subtrees._set._head);
 }
 static inline GenTree* _GenTreeDropSubtree(GenTree* const that) {
-  return GSetDrop(_GenTreeSubtrees(that));
+  return GenTreeUnlinkSubtree(that, that->_subtrees._set._tail);
 }
 static inline GenTree* _GenTreeRemoveSubtree(GenTree* const that, const int iSubtree) {
-  return GSetRemove((GSet*)_GenTreeSubtrees(that), iSubtree);
+  return GenTreeUnlinkSubtree(that, GenTreeSubtreeElem(that, iSubtree));
 }
 
 static inline void _GenTreePushSubtree(GenTree* const that, GenTree* const tree) {
   if (!tree) return;
-  GSetPush(_GenTreeSubtrees(that), tree);
-  tree->_parent = that;
+  GenTreeLinkSubtree(that, tree, that->_subtrees._set._head, 0.0);
 }
 static inline void _GenTreeAddSortSubTree(GenTree* const that, GenTree* const tree, 
   const float sortVal) {
   if (!tree) return;
-  GSetAddSort(_GenTreeSubtrees(that), tree, sortVal);
-  tree->_parent = that;
+  GenTreeLinkSubtree(that, tree, GenTreeSubtreeUpperBound(that, sortVal), 
+    sortVal);
 }
 static inline void _GenTreeInsertSubtree(GenTree* const that, GenTree* const tree, 
   const int pos) {
   if (!tree) return;
-  GSetInsert(_GenTreeSubtrees(that), tree, pos);
-  tree->_parent = that;
+  GenTreeLinkSubtree(that, tree, GenTreeSubtreeElem(that, pos), 0.0);
 }
 static inline void _GenTreeAppendSubtree(GenTree* const that, GenTree* const tree) {
   if (!tree) return;
-  GSetAppend(_GenTreeSubtrees(that), tree);
-  tree->_parent = that;
+  GenTreeLinkSubtree(that, tree, NULL, 0.0);
 }
 
 static inline void _GenTreePushData(GenTree* const that, void* const data) {
-  GenTree* tree = GenTreeCreateData(data);
-  GSetPush(_GenTreeSubtrees(that), tree);
-  tree->_parent = that;
+  GenTree* tree = GenTreeCreateDataPool(that->_pool, data);
+  GenTreeLinkSubtree(that, tree, that->_subtrees._set._head, 0.0);
 }
 static inline void _GenTreeAddSortData(GenTree* const that, void* const data, 
   const float sortVal) {
-  GenTree* tree = GenTreeCreateData(data);
-  GSetAddSort(_GenTreeSubtrees(that), tree, sortVal);
-  tree->_parent = that;
+  GenTree* tree = GenTreeCreateDataPool(that->_pool, data);
+  GenTreeLinkSubtree(that, tree, GenTreeSubtreeUpperBound(that, sortVal), 
+    sortVal);
 }
 static inline void _GenTreeInsertData(GenTree* const that, void* const data, 
   const int pos) {
-  GenTree* tree = GenTreeCreateData(data);
-  GSetInsert(_GenTreeSubtrees(that), tree, pos);
-  tree->_parent = that;
+  GenTree* tree = GenTreeCreateDataPool(that->_pool, data);
+  GenTreeLinkSubtree(that, tree, GenTreeSubtreeElem(that, pos), 0.0);
 }
 static inline void _GenTreeAppendData(GenTree* const that, void* const data) {
-  GenTree* tree = GenTreeCreateData(data);
-  GSetAppend(_GenTreeSubtrees(that), tree);
-  tree->_parent = that;
+  GenTree* tree = GenTreeCreateDataPool(that->_pool, data);
+  GenTreeLinkSubtree(that, tree, NULL, 0.0);
+}
+// Append a node with the sort value 'sortVal' without sorting, for 
+// bulk loading followed by GenTreeSortSubtrees. A node with a skip 
+// list stays sorted, the node is then added at its sorted position
+static inline void _GenTreeAppendSortData(GenTree* const that, void* const data, 
+  const float sortVal) {
+  GenTree* tree = GenTreeCreateDataPool(that->_pool, data);
+  GenTreeLinkSubtree(that, tree, (GenTreeGetSkipList(that) != NULL ? 
+    GenTreeSubtreeUpperBound(that, sortVal) : NULL), sortVal);
 }
 
 // ----------- GenTreeIter
@@ -198,14 +722,45 @@ static inline void _GenTreeAppendData(GenTree* const that, void* const data) {
 
 // ================= Data structure ===================
 
+// Position of a node of the sequence of a GenTreeIterBreadth or 
+// GenTreeIterValue, used to patch the sequence with the edit log of 
+// the tree
+typedef struct GenTreeIterPos {
+  // Position of the node in depth first order in the attached tree, the
+  // attached tree being at 0 if it's in the sequence
+  int _rank;
+  // Depth of the node in the attached tree (breadth first only)
+  int _depth;
+} GenTreeIterPos;
+
 typedef struct GenTreeIter {
   // Attached tree
   GenTree* _tree;
-  // Current position
-  GSetElem* _curPos;
-  // GSet to memorize nodes sequence
+  // Index in the sequence of the current position
+  int _curPos;
+  // Array to memorize nodes sequence
   // The node sequence doesn't include the root node of the attached tree
-  GSetGenTree _seq;
+  GenTree** _seq;
+  // Number of nodes in the sequence
+  int _nbNode;
+  // Number of nodes the array of the sequence can contain
+  int _capacity;
+  // Flag to memorize if the array of the sequence has been given by the
+  // user, in which case it's never freed by the iterator
+  bool _isUserBuffer;
+  // Generation of the attached tree when the sequence has been created
+  unsigned long _gen;
+  // Root of the attached tree when the sequence has been created or 
+  // patched, null if the sequence can't be patched, the generation of
+  // this root, and the position in depth first order in the root of 
+  // the first node of the sequence (0 if the attached tree is the root)
+  GenTree* _root;
+  unsigned long _rootGen;
+  int _rootRank;
+  // Positions of the nodes of the sequence (as many as the capacity of
+  // the array of the sequence) for the breadth first and value first 
+  // iterators, null else
+  GenTreeIterPos* _pos;
 } GenTreeIter;
 
 typedef struct GenTreeIterDepth {GenTreeIter _iter;} GenTreeIterDepth;
@@ -220,33 +775,79 @@ GenTreeIterDepth* _GenTreeIterDepthCreate(GenTree* const tree);
 // Create a new static GenTreeIterDepth for the GenTree 'tree'
 GenTreeIterDepth _GenTreeIterDepthCreateStatic(GenTree* const tree);
 
+// Create a new static GenTreeIterDepth for the GenTree 'tree' whose 
+// sequence is stored in the user array 'buffer' of 'capacity' nodes
+// If the sequence grows beyond 'capacity' it's moved to an array 
+// allocated by the iterator
+GenTreeIterDepth _GenTreeIterDepthCreateStaticBuffer(GenTree* const tree,
+  GenTree** const buffer, const int capacity);
+
 // Create a new GenTreeIterBreadth for the GenTree 'tree'
 GenTreeIterBreadth* _GenTreeIterBreadthCreate(GenTree* const tree);
 
 // Create a new static GenTreeIterBreadth for the GenTree 'tree'
 GenTreeIterBreadth _GenTreeIterBreadthCreateStatic(GenTree* const tree);
 
+// Create a new static GenTreeIterBreadth for the GenTree 'tree' whose 
+// sequence is stored in the user array 'buffer' of 'capacity' nodes
+// If the sequence grows beyond 'capacity' it's moved to an array 
+// allocated by the iterator
+GenTreeIterBreadth _GenTreeIterBreadthCreateStaticBuffer(
+  GenTree* const tree, GenTree** const buffer, const int capacity);
+
 // Create a new GenTreeIterValue for the GenTree 'tree'
 GenTreeIterValue* _GenTreeIterValueCreate(GenTree* const tree);
 
 // Create a new static GenTreeIterValue for the GenTree 'tree'
 GenTreeIterValue _GenTreeIterValueCreateStatic(GenTree* const tree);
 
+// Create a new static GenTreeIterValue for the GenTree 'tree' whose 
+// sequence is stored in the user array 'buffer' of 'capacity' nodes
+// If the sequence grows beyond 'capacity' it's moved to an array 
+// allocated by the iterator
+GenTreeIterValue _GenTreeIterValueCreateStaticBuffer(GenTree* const tree,
+  GenTree** const buffer, const int capacity);
+
 // Update the GenTreeIterDepth 'that' in case its attached GenTree has been 
 // modified
 // The node sequence doesn't include the root node of the attached tree
+// Do nothing if the iterator is not stale
+// The subtrees inserted and removed since the last update are patched 
+// in the sequence with the edit log of the root of the tree, in time 
+// proportional to the edits. The sequence is recreated if the tree has
+// been modified otherwise (sort, graft, concurrent adds...), if the 
+// attached tree has been moved, or if there has been more than 
+// GENTREEEDITLOG_NBEDIT edits
 void GenTreeIterDepthUpdate(GenTreeIterDepth* const that);
 
 // Update the GenTreeIterBreadth 'that' in case its attached GenTree has 
 // been modified
 // The node sequence doesn't include the root node of the attached tree
+// Do nothing if the iterator is not stale
+// The sequence is patched as with GenTreeIterDepthUpdate: the removed
+// nodes are filtered out and the inserted ones, sorted, are merged in,
+// in time linear in the size of the sequence plus the inserted nodes 
+// times logarithmic in their number
 void GenTreeIterBreadthUpdate(GenTreeIterBreadth* const that);
 
 // Update the GenTreeIterValue 'that' in case its attached GenTree has been 
 // modified
 // The node sequence doesn't include the root node of the attached tree
+// Do nothing if the iterator is not stale
+// The sequence is patched as with GenTreeIterBreadthUpdate
 void GenTreeIterValueUpdate(GenTreeIterValue* const that);
 
+// Update the GenTreeIterValue 'that' with only the 'nb' first nodes in 
+// value first order of its attached GenTree
+// The nodes are kept in a heap, so the cost is linear in the size of the
+// tree plus 'nb' times logarithmic in the size of the tree
+// If 'nb' is negative or greater than the number of nodes, all the nodes
+// are in the sequence, as with GenTreeIterValueUpdate
+// The iterator stays stale, thus the next GenTreeIterValueUpdate 
+// recreates the whole sequence
+void GenTreeIterValueUpdateFirst(GenTreeIterValue* const that, 
+  const int nb);
+
 // Free the memory used by the iterator 'that'
 void _GenTreeIterFree(GenTreeIter** that);
 
@@ -348,7 +949,904 @@ GenTree* _GenTreeIterGenTree(const GenTreeIter* const that);
 #if BUILDMODE != 0
 static inline
 #endif 
-GSetGenTree* _GenTreeIterSeq(const GenTreeIter* const that);
+GenTree** _GenTreeIterSeq(const GenTreeIter* const that);
+
+// Return the number of nodes in the sequence of the iterator 'that'
+#if BUILDMODE != 0
+static inline
+#endif 
+int _GenTreeIterGetNbNode(const GenTreeIter* const that);
+
+// Return the index in the sequence of the current position of the 
+// iterator 'that'
+#if BUILDMODE != 0
+static inline
+#endif 
+int _GenTreeIterGetPos(const GenTreeIter* const that);
+
+// Move the iterator 'that' to the 'iPos'-th node of its sequence
+#if BUILDMODE != 0
+static inline
+#endif 
+void _GenTreeIterSeek(GenTreeIter* const that, const int iPos);
+
+// Return true if the attached tree of the iterator 'that' has been 
+// modified since the creation of its sequence, false else
+#if BUILDMODE != 0
+static inline
+#endif 
+bool _GenTreeIterIsStale(const GenTreeIter* const that);
+
+// ----------- GenTreeIterDepthLazy
+
+// ================= Data structure ===================
+
+// Depth first iterator calculating the next node on the fly from the 
+// links of the current node instead of memorizing the node sequence
+// The node sequence is the same as the one of GenTreeIterDepth
+// The iterator stays valid when the attached tree is modified, as long
+// as its current node is not removed from the attached tree
+typedef struct GenTreeIterDepthLazy {
+  // Attached tree
+  GenTree* _tree;
+  // Current node, null if the node sequence is empty
+  GenTree* _curNode;
+} GenTreeIterDepthLazy;
+
+// ================ Functions declaration ====================
+
+// Create a new GenTreeIterDepthLazy for the GenTree 'tree'
+GenTreeIterDepthLazy* _GenTreeIterDepthLazyCreate(GenTree* const tree);
+
+// Create a new static GenTreeIterDepthLazy for the GenTree 'tree'
+GenTreeIterDepthLazy _GenTreeIterDepthLazyCreateStatic(
+  GenTree* const tree);
+
+// Free the memory used by the iterator 'that'
+void _GenTreeIterDepthLazyFree(GenTreeIterDepthLazy** that);
+
+// Free the memory used by the static iterator 'that'
+void _GenTreeIterDepthLazyFreeStatic(GenTreeIterDepthLazy* const that);
+
+// Append a new node with 'data' to the first node containing 'node'
+// in the GenTree 'that'
+// Uses the iterator 'iter' to search the node
+// Return true if we could find 'node', false else
+bool _GenTreeAppendToNodeDepthLazy(GenTree* const that, 
+  void* const data, void* const node, GenTreeIterDepthLazy* const iter);
+
+// Search the first node containing 'data' in the GenTree 'that'
+// Uses the iterator 'iter' to search the node, with the same semantic
+// as _GenTreeSearch
+// If the tree is indexed, the node is found with the index and the 
+// iterator moved directly after it
+// Return the node if we could find 'data', null else
+GenTree* _GenTreeSearchDepthLazy(const GenTree* const that, 
+  const void* const data, GenTreeIterDepthLazy* const iter);
+
+// Reset the iterator 'that' at its start position
+#if BUILDMODE != 0
+static inline
+#endif 
+void _GenTreeIterDepthLazyReset(GenTreeIterDepthLazy* const that);
+
+// Reset the iterator 'that' at its end position
+#if BUILDMODE != 0
+static inline
+#endif 
+void _GenTreeIterDepthLazyToEnd(GenTreeIterDepthLazy* const that);
+
+// Step the iterator 'that' at its next position
+// Return true if it could move to the next position
+// Return false if it's already at the last position
+#if BUILDMODE != 0
+static inline
+#endif 
+bool _GenTreeIterDepthLazyStep(GenTreeIterDepthLazy* const that);
+
+// Step back the iterator 'that' at its previous position
+// Return true if it could move to the previous position
+// Return false if it's already at the first position
+#if BUILDMODE != 0
+static inline
+#endif 
+bool _GenTreeIterDepthLazyStepBack(GenTreeIterDepthLazy* const that);
+
+// Apply a function to all elements' data of the GenTree of the iterator
+// The iterator is first reset, then the function is apply sequencially
+// using the Step function of the iterator
+#if BUILDMODE != 0
+static inline
+#endif 
+void _GenTreeIterDepthLazyApply(GenTreeIterDepthLazy* const that, 
+  void(*fun)(void* const data, void* const param), void* const param);
+
+// Return true if the iterator is at the start of the elements
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif 
+bool _GenTreeIterDepthLazyIsFirst(const GenTreeIterDepthLazy* const that);
+
+// Return true if the iterator is at the end of the elements
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif 
+bool _GenTreeIterDepthLazyIsLast(const GenTreeIterDepthLazy* const that);
+
+// Change the attached tree of the iterator, and reset it
+#if BUILDMODE != 0
+static inline
+#endif 
+void _GenTreeIterDepthLazySetGenTree(GenTreeIterDepthLazy* const that, 
+  GenTree* const tree);
+
+// Return the user data of the tree currently pointed to by the iterator
+#if BUILDMODE != 0
+static inline
+#endif 
+void* _GenTreeIterDepthLazyGetData(const GenTreeIterDepthLazy* const that);
+
+// Return the tree currently pointed to by the iterator
+#if BUILDMODE != 0
+static inline
+#endif 
+GenTree* _GenTreeIterDepthLazyGetGenTree(
+  const GenTreeIterDepthLazy* const that);
+
+// Return the tree associated to the iterator 'that'
+#if BUILDMODE != 0
+static inline
+#endif 
+GenTree* _GenTreeIterDepthLazyGenTree(
+  const GenTreeIterDepthLazy* const that);
+
+// ----------- GenTreePool
+
+// ================ Functions declaration ====================
+
+// Create a new GenTreePool allocating nodes by chunks of 
+// 'nbNodePerChunk' nodes
+GenTreePool* GenTreePoolCreate(const int nbNodePerChunk);
+
+// Create a new static GenTreePool allocating nodes by chunks of 
+// 'nbNodePerChunk' nodes
+GenTreePool GenTreePoolCreateStatic(const int nbNodePerChunk);
+
+// Create a new GenTreePool in arena mode allocating memory by chunks 
+// of 'nbNodePerChunk' nodes
+GenTreePool* GenTreePoolCreateArena(const int nbNodePerChunk);
+
+// Create a new static GenTreePool in arena mode allocating memory by 
+// chunks of 'nbNodePerChunk' nodes
+GenTreePool GenTreePoolCreateStaticArena(const int nbNodePerChunk);
+
+// Free the memory used by the GenTreePool 'that'
+// All the nodes allocated from the pool must have been freed before
+void GenTreePoolFree(GenTreePool** that);
+
+// Free the memory used by the static GenTreePool 'that'
+// All the nodes allocated from the pool must have been freed before
+void GenTreePoolFreeStatic(GenTreePool* const that);
+
+// Release at once all the nodes allocated from the GenTreePool 'that'
+// The trees allocated from the pool must not be used anymore, the 
+// memory is kept for reuse
+// The arrays of subtrees, skip lists, indexes and edit logs of these 
+// trees are freed
+void GenTreePoolReset(GenTreePool* const that);
+
+// Return true if the GenTreePool 'that' is in arena mode
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif
+bool GenTreePoolIsArena(const GenTreePool* const that);
+
+// Return the number of nodes currently in use in the GenTreePool 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+long GenTreePoolGetNbLive(const GenTreePool* const that);
+
+// Return the number of nodes served from the freelist of the 
+// GenTreePool 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+long GenTreePoolGetNbRecycled(const GenTreePool* const that);
+
+// ----------- GenTreeIndex
+
+// ================ Functions declaration ====================
+
+// Create the index of the root GenTree 'that', using the function 
+// 'keyFun' to calculate the key of the user data, or the address of the
+// data if 'keyFun' is null
+// Nodes whose data have the same key are considered as holding the 
+// same data
+// The index is then kept up to date when the tree is modified, until 
+// the tree is attached to another one or freed
+// If the tree is already indexed its index is recreated
+void GenTreeIndexCreate(GenTree* const that, 
+  unsigned long (*keyFun)(const void* const data));
+
+// Free the index of the tree the GenTree 'that' is the root of
+void GenTreeIndexFree(GenTree* const that);
+
+// Search a node containing 'data' in the indexed tree the GenTree 
+// 'that' belongs to
+// If 'prev' is null return the first node found, else the next one 
+// after 'prev', thus several calls return the successive nodes 
+// containing 'data' (in no particular order)
+// Return null if there is no (more) node containing 'data'
+GenTree* GenTreeIndexSearch(const GenTree* const that, 
+  const void* const data, const GenTree* const prev);
+
+// Append a new node with 'data' to a node containing 'node' in the 
+// indexed tree the GenTree 'that' belongs to
+// Return true if we could find 'node', false else
+bool GenTreeIndexAppendToNode(GenTree* const that, void* const data, 
+  void* const node);
+
+// Add the node 'node' to the GenTreeIndex 'that'
+// The index is kept up to date by the GenTree functions, this function
+// is not meant to be used directly
+void GenTreeIndexAdd(GenTreeIndex* const that, GenTree* const node);
+
+// Remove the node 'node' from the GenTreeIndex 'that'
+// The index is kept up to date by the GenTree functions, this function
+// is not meant to be used directly
+void GenTreeIndexRemove(GenTreeIndex* const that, GenTree* const node);
+
+// Return true if the GenTree 'that' belongs to an indexed tree
+// Return false else
+#if BUILDMODE != 0
+static inline
+#endif
+bool GenTreeIsIndexed(const GenTree* const that);
+
+// Return the number of nodes in the index of the tree the GenTree 
+// 'that' belongs to
+#if BUILDMODE != 0
+static inline
+#endif
+long GenTreeIndexGetNbNode(const GenTree* const that);
+
+// ----------- GenTreeThreadPool
+
+// ================= Define ==================
+
+// Number of tasks per thread the parallel functions aim at splitting a
+// tree into, to balance the load between the threads
+#define GENTREETHREADPOOL_NBTASKPERTHREAD 32
+
+// Number of times a thread of a GenTreeThreadPool looks for a task
+// before waiting for one on the condition of the pool
+#define GENTREETHREADPOOL_NBSPIN 16
+
+// Minimum number of nodes in a level for their subtrees to be appended
+// in parallel to the sequence of a GenTreeIterBreadth
+#define GENTREEITER_PARALLELMINWIDTH 4096
+
+// ================= Data structure ===================
+
+struct GenTreeThreadPool;
+
+// Task executed by the threads of a GenTreeThreadPool
+// Tasks of the parallel functions embed it as their first member
+typedef struct GenTreeTask {
+  // Function executing the task 'task' on the 'iThread'-th thread of 
+  // the pool 'pool'
+  void (*_run)(struct GenTreeThreadPool* const pool, const int iThread,
+    struct GenTreeTask* const task);
+} GenTreeTask;
+
+// Deque of the tasks of one thread of a GenTreeThreadPool
+// The thread pushes and pops its tasks at the bottom, the other threads
+// steal the oldest ones at the top
+typedef struct GenTreeThreadPoolDeque {
+  // Mutex protecting the deque
+  pthread_mutex_t _mutex;
+  // Ring buffer of the tasks
+  GenTreeTask** _tasks;
+  // Capacity of the ring buffer, a power of 2
+  long _capacity;
+  // Position of the oldest task
+  long _top;
+  // Position after the newest task
+  long _bottom;
+} GenTreeThreadPoolDeque;
+
+// Pool of threads executing the tasks of the parallel functions, each 
+// thread stealing tasks from the others when it has none left
+// The thread calling a parallel function is the first thread of the 
+// pool, the other ones wait for the next call between two calls
+// A pool executes one parallel function at a time
+// The parallel functions called with a null pool use a shared pool 
+// with as many threads as online processors, created by the first of
+// them and freed at the end of the process, or a temporary pool if 
+// the shared one is used by another call
+typedef struct GenTreeThreadPool {
+  // Number of threads, including the calling thread
+  int _nbThread;
+  // Threads of the pool, the calling thread excluded
+  pthread_t* _threads;
+  // Deques of tasks, one per thread
+  GenTreeThreadPoolDeque* _deques;
+  // Mutex and condition used to wake up the threads
+  pthread_mutex_t _mutex;
+  pthread_cond_t _cond;
+  // Number of the current call, protected by _mutex
+  unsigned long _nbRun;
+  // Flag to stop the threads, protected by _mutex
+  bool _isStopping;
+  // Number of tasks of the current call not yet completed
+  atomic_long _nbPending;
+  // Number of tasks pushed since the creation of the pool
+  atomic_ulong _nbPush;
+  // Number of threads waiting for a task on _cond
+  atomic_int _nbIdle;
+} GenTreeThreadPool;
+
+// Order in which a parallel function processes the nodes
+typedef enum GenTreeApplyOrder {
+  // A node is processed after its parent
+  GenTreeApplyOrderTopDown,
+  // A node is processed after all its subtrees
+  GenTreeApplyOrderBottomUp
+} GenTreeApplyOrder;
+
+// ================ Functions declaration ====================
+
+// Create a new GenTreeThreadPool with 'nbThread' threads, including 
+// the calling thread, or as many threads as online processors if 
+// 'nbThread' is not positive
+GenTreeThreadPool* GenTreeThreadPoolCreate(const int nbThread);
+
+// Free the memory used by the GenTreeThreadPool 'that' and stop its 
+// threads
+void GenTreeThreadPoolFree(GenTreeThreadPool** that);
+
+// Return the number of threads of the GenTreeThreadPool 'that', 
+// including the calling thread
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeThreadPoolGetNbThread(const GenTreeThreadPool* const that);
+
+// Execute the task 'task' and the tasks it pushes with the threads of 
+// the GenTreeThreadPool 'that', and return when they are all completed
+// Used by the parallel functions, not meant to be used directly
+void GenTreeThreadPoolRun(GenTreeThreadPool* const that, 
+  GenTreeTask* const task);
+
+// Push the task 'task' in the deque of the 'iThread'-th thread of the 
+// GenTreeThreadPool 'that' during a call to GenTreeThreadPoolRun
+// Used by the parallel functions, not meant to be used directly
+void GenTreeThreadPoolPush(GenTreeThreadPool* const that, 
+  const int iThread, GenTreeTask* const task);
+
+// Apply the function 'fun' to the data of the nodes of the GenTree 
+// 'that' (the root excluded, as GenTreeIterApply) with the threads of
+// the GenTreeThreadPool 'pool', or of the shared pool with as many 
+// threads as online processors if 'pool' is null
+// The tree is split along its subtrees into tasks of similar size, 
+// balanced between the threads by work stealing. 'order' sets if a 
+// node is processed after its parent or after its subtrees, otherwise
+// the nodes are processed in no particular order and 'fun' must be
+// thread safe. The tree must not be modified until the function returns
+void _GenTreeParallelApply(GenTree* const that, 
+  void(*fun)(void* const data, void* const param), void* const param,
+  GenTreeThreadPool* const pool, const GenTreeApplyOrder order);
+
+// Reduce the nodes of the GenTree 'that' (the root excluded) with the 
+// threads of the GenTreeThreadPool 'pool', or of the shared pool with
+// as many threads as online processors if 'pool' is null, and copy 
+// the result in 'result'
+// Values are user defined memory blocks of 'size' bytes. 'map' sets 
+// 'value' to the value of a node from its data, 'combine' combines 
+// 'value' into 'acc', 'identity' is the neutral value of 'combine'
+// 'param' is passed to 'map' and 'combine'. Each thread reduces the 
+// nodes of its tasks into its own partial result and the partial 
+// results are combined at the end, so 'combine' must be associative 
+// and commutative. 'map' and 'combine' must be thread safe. The tree 
+// must not be modified until the function returns
+void _GenTreeReduce(GenTree* const that, void* const result, 
+  const void* const identity, const size_t size,
+  void(*map)(void* const data, void* const value, void* const param),
+  void(*combine)(void* const acc, const void* const value, 
+    void* const param),
+  void* const param, GenTreeThreadPool* const pool);
+
+// Reduce the nodes of the GenTree 'that' (the root excluded) in bottom
+// up order as GenTreeReduce: the value of each node is the combination
+// of its mapped value and the values of its subtrees, 'store' (if not
+// null) is called with the data and value of each node once its value
+// is complete, and 'result' is set to the combination of the values 
+// of the subtrees of 'that'
+// 'store' must be thread safe, it's called for a node after being 
+// called for all its subtrees
+void _GenTreeReduceBottomUp(GenTree* const that, void* const result, 
+  const void* const identity, const size_t size,
+  void(*map)(void* const data, void* const value, void* const param),
+  void(*combine)(void* const acc, const void* const value, 
+    void* const param),
+  void(*store)(void* const data, const void* const value, 
+    void* const param),
+  void* const param, GenTreeThreadPool* const pool);
+
+// Create a copy of the GenTree 'that' as GenTreeClone, with the 
+// threads of the GenTreeThreadPool 'pool', or of the shared pool with
+// as many threads as online processors if 'pool' is null
+// Thanks to the number of nodes cached in each node, the position of 
+// each node in the block of the copy is known and independent 
+// subtrees are copied in parallel. 'cloneData' must be thread safe. 
+// The tree must not be modified until the function returns
+// Return the root of the copy
+GenTree* _GenTreeCloneParallel(const GenTree* const that, 
+  void* (*cloneData)(void* const data), GenTreeThreadPool* const pool);
+
+// Update the GenTreeIterDepth 'that' as GenTreeIterDepthUpdate, with 
+// the threads of the GenTreeThreadPool 'pool', or of the shared pool 
+// with as many threads as online processors if 'pool' is null
+// The sequence is the same as the one of GenTreeIterDepthUpdate
+void GenTreeIterDepthUpdateParallel(GenTreeIterDepth* const that, 
+  GenTreeThreadPool* const pool);
+
+// Update the GenTreeIterBreadth 'that' as GenTreeIterBreadthUpdate, 
+// with the threads of the GenTreeThreadPool 'pool', or of the shared 
+// pool with as many threads as online processors if 'pool' is null
+// The sequence is the same as the one of GenTreeIterBreadthUpdate
+void GenTreeIterBreadthUpdateParallel(GenTreeIterBreadth* const that, 
+  GenTreeThreadPool* const pool);
+
+// Update the GenTreeIterValue 'that' as GenTreeIterValueUpdate, with 
+// the threads of the GenTreeThreadPool 'pool', or of the shared pool 
+// with as many threads as online processors if 'pool' is null
+// The sequence is the same as the one of GenTreeIterValueUpdate
+void GenTreeIterValueUpdateParallel(GenTreeIterValue* const that, 
+  GenTreeThreadPool* const pool);
+
+// ----------- GenTreeFrozen
+
+// ================= Data structure ===================
+
+// Immutable snapshot of a GenTree stored in contiguous arrays
+// Nodes are identified by their index in depth first order, the root
+// of the frozen tree has index 0
+typedef struct GenTreeFrozen {
+  // Number of nodes, including the root
+  int _nbNode;
+  // User data of the nodes
+  void** _data;
+  // Sort values of the nodes
+  float* _sortVal;
+  // Index of the parent of the nodes, -1 for the root
+  int* _parent;
+  // Number of nodes in the subtrees of the nodes and their subtrees
+  // recursively
+  int* _size;
+  // Index in _subtrees of the first subtree of the nodes
+  int* _firstSubtree;
+  // Number of subtrees of the nodes
+  int* _nbSubtree;
+  // Indices of the subtrees of each node, contiguously and in order
+  int* _subtrees;
+  // Indices of the nodes in breadth first order, root excluded
+  int* _breadth;
+  // Indices of the nodes in value first order, root excluded
+  int* _value;
+} GenTreeFrozen;
+
+// ================ Functions declaration ====================
+
+// Create a GenTreeFrozen snapshot of the GenTree 'tree'
+// The user data are not copied
+GenTreeFrozen* GenTreeFreeze(const GenTree* const tree);
+
+// Create a new GenTree from the GenTreeFrozen 'that'
+// Nodes are allocated from the GenTreePool 'pool', or with malloc if 
+// 'pool' is null
+GenTree* GenTreeFrozenThaw(const GenTreeFrozen* const that, 
+  GenTreePool* const pool);
+
+// Free the memory used by the GenTreeFrozen 'that'
+// User data must be freed by the user
+void GenTreeFrozenFree(GenTreeFrozen** that);
+
+// Search the first node containing 'data' in the GenTreeFrozen 'that'
+// among the nodes of index greater than or equal to 'iNode', in depth 
+// first order. To loop on the nodes containing the same data, call it 
+// again with the previous result plus one
+// Return the index of the node, or -1 if there is none
+int GenTreeFrozenSearch(const GenTreeFrozen* const that, 
+  const void* const data, const int iNode);
+
+// Return the number of nodes of the GenTreeFrozen 'that', including 
+// its root
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenGetNbNode(const GenTreeFrozen* const that);
+
+// Return the user data of the node 'iNode' of the GenTreeFrozen 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void* GenTreeFrozenData(const GenTreeFrozen* const that, 
+  const int iNode);
+
+// Return the sort value of the node 'iNode' of the GenTreeFrozen 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+float GenTreeFrozenSortVal(const GenTreeFrozen* const that, 
+  const int iNode);
+
+// Return the index of the parent of the node 'iNode' of the 
+// GenTreeFrozen 'that', or -1 if 'iNode' is the root
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenParent(const GenTreeFrozen* const that, 
+  const int iNode);
+
+// Return the number of subtrees of the node 'iNode' of the 
+// GenTreeFrozen 'that' and their subtrees recursively
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenGetSize(const GenTreeFrozen* const that, 
+  const int iNode);
+
+// Return the number of subtrees of the node 'iNode' of the 
+// GenTreeFrozen 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenNbSubtree(const GenTreeFrozen* const that, 
+  const int iNode);
+
+// Return the index of the 'iSubtree'-th subtree of the node 'iNode' of 
+// the GenTreeFrozen 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenSubtree(const GenTreeFrozen* const that, 
+  const int iNode, const int iSubtree);
+
+// Return the index of the 'iStep'-th node of the GenTreeFrozen 'that' 
+// in depth first order, root excluded, 'iStep' in [0, nbNode - 1[
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenDepth(const GenTreeFrozen* const that, 
+  const int iStep);
+
+// Return the index of the 'iStep'-th node of the GenTreeFrozen 'that' 
+// in breadth first order, root excluded, 'iStep' in [0, nbNode - 1[
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenBreadth(const GenTreeFrozen* const that, 
+  const int iStep);
+
+// Return the index of the 'iStep'-th node of the GenTreeFrozen 'that' 
+// in value first order, root excluded, 'iStep' in [0, nbNode - 1[
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreeFrozenValue(const GenTreeFrozen* const that, 
+  const int iStep);
+
+// ----------- GenTreeRcu
+
+// ================= Data structure ===================
+
+struct GenTreePersist;
+
+// Snapshot of a tree published by a GenTreeRcu
+typedef struct GenTreeRcuSnapshot {
+  // Version of the persistent tree copied from the tree, sharing its
+  // unmodified subtrees with the previous snapshot
+  struct GenTreePersist* _root;
+  // Version of the snapshot, incremented at each publication
+  unsigned long _version;
+  // Epoch of the GenTreeRcu when the snapshot has been replaced by a 
+  // newer one
+  unsigned long _retireEpoch;
+  // Next snapshot in the list of the replaced snapshots not yet freed
+  struct GenTreeRcuSnapshot* _next;
+} GenTreeRcuSnapshot;
+
+// Reader of a GenTreeRcu, to be used by one thread
+typedef struct GenTreeRcuReader {
+  // The GenTreeRcu
+  struct GenTreeRcu* _rcu;
+  // Epoch of the GenTreeRcu when the reader entered its read section,
+  // 0 outside of the read sections
+  atomic_ulong _epoch;
+  // Snapshot being read
+  GenTreeRcuSnapshot* _snapshot;
+  // Next and previous readers of the GenTreeRcu
+  struct GenTreeRcuReader* _next;
+  struct GenTreeRcuReader* _prev;
+} GenTreeRcuReader;
+
+// Read-copy-update publisher of a GenTree modified by one writer thread
+// and read by any number of reader threads
+// The writer modifies the tree as usual and publishes it as a version
+// of a persistent tree (GenTreePersist), where only the nodes on the 
+// paths to the modifications since the previous snapshot are copied 
+// and the other subtrees are shared (path copying). The readers get 
+// the latest snapshot without lock and read it while the writer goes 
+// on. Replaced snapshots are freed by the writer once no reader can be
+// reading them (epoch based reclamation)
+typedef struct GenTreeRcu {
+  // The published tree
+  GenTree* _tree;
+  // Latest published snapshot
+  _Atomic(GenTreeRcuSnapshot*) _current;
+  // Current epoch, incremented each time a snapshot is replaced
+  atomic_ulong _epoch;
+  // List of the replaced snapshots not yet freed, used by the writer 
+  // only
+  GenTreeRcuSnapshot* _retired;
+  // Number of replaced snapshots not yet freed
+  int _nbRetired;
+  // List of the readers, protected by _mutex
+  GenTreeRcuReader* _readers;
+  pthread_mutex_t _mutex;
+} GenTreeRcu;
+
+// ================ Functions declaration ====================
+
+// Create a new GenTreeRcu publishing the GenTree 'tree', and publish 
+// its first snapshot
+GenTreeRcu* GenTreeRcuCreate(GenTree* const tree);
+
+// Free the memory used by the GenTreeRcu 'that' and its snapshots
+// Its readers must have been freed
+// The tree and the user data must be freed by the user
+void GenTreeRcuFree(GenTreeRcu** that);
+
+// Publish a new snapshot of the tree of the GenTreeRcu 'that', sharing
+// the unmodified subtrees with the previous one, then free the replaced
+// snapshots no reader can be reading
+// To be called by the writer, which must not modify the tree until the
+// function returns
+void GenTreeRcuPublish(GenTreeRcu* const that);
+
+// Free the replaced snapshots of the GenTreeRcu 'that' no reader can 
+// be reading
+// To be called by the writer
+// Return the number of replaced snapshots not yet freed
+int GenTreeRcuReclaim(GenTreeRcu* const that);
+
+// Return the version of the latest snapshot published by the 
+// GenTreeRcu 'that'
+// To be called by the writer, readers use GenTreeRcuReaderGetVersion
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned long GenTreeRcuGetVersion(GenTreeRcu* const that);
+
+// Create a new reader of the GenTreeRcu 'rcu'
+GenTreeRcuReader* GenTreeRcuReaderCreate(GenTreeRcu* const rcu);
+
+// Free the memory used by the GenTreeRcuReader 'that'
+void GenTreeRcuReaderFree(GenTreeRcuReader** that);
+
+// Enter a read section with the GenTreeRcuReader 'that' and return the
+// latest snapshot, which stays valid until GenTreeRcuReadUnlock
+// Read sections can't be nested
+#if BUILDMODE != 0
+static inline
+#endif
+const struct GenTreePersist* GenTreeRcuReadLock(
+  GenTreeRcuReader* const that);
+
+// Leave the read section of the GenTreeRcuReader 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void GenTreeRcuReadUnlock(GenTreeRcuReader* const that);
+
+// Return the version of the snapshot read by the GenTreeRcuReader 
+// 'that' in its read section
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned long GenTreeRcuReaderGetVersion(
+  const GenTreeRcuReader* const that);
+
+// ----------- GenTreeConcurrent
+
+// ================= Define ==================
+
+// Number of locks of a GenTreeConcurrent, nodes sharing a lock are 
+// modified one at a time
+#define GENTREECONCURRENT_NBLOCK 256
+
+// ================= Data structure ===================
+
+// Lock of a GenTreeConcurrent, padded to its own cache line
+typedef struct GenTreeConcurrentLock {
+  pthread_mutex_t _mutex;
+  char _pad[64 - sizeof(pthread_mutex_t) % 64];
+} GenTreeConcurrentLock;
+
+// Adds subtrees to the nodes of a GenTree from several threads at once
+// Each node is protected by one of the locks, chosen by its address 
+// (lock striping), so threads adding subtrees to different nodes 
+// rarely wait for each other. While threads add subtrees, the tree must
+// be modified only through the GenTreeConcurrent functions and the 
+// nodes must not be read except their user data
+typedef struct GenTreeConcurrent {
+  // The tree
+  GenTree* _tree;
+  // Locks of the nodes
+  GenTreeConcurrentLock _locks[GENTREECONCURRENT_NBLOCK];
+} GenTreeConcurrent;
+
+// ================ Functions declaration ====================
+
+// Create a new GenTreeConcurrent adding subtrees to the GenTree 'tree'
+GenTreeConcurrent* _GenTreeConcurrentCreate(GenTree* const tree);
+
+// Free the memory used by the GenTreeConcurrent 'that'
+// The tree is not freed
+void GenTreeConcurrentFree(GenTreeConcurrent** that);
+
+// Append a new node with user data 'data' to the subtrees of the node
+// 'node' of the tree of the GenTreeConcurrent 'that'
+// Return the new node
+// The new node is allocated from the pool of 'node', if any
+// Can be called by several threads at once, on the same node or on 
+// different nodes
+GenTree* _GenTreeConcurrentAppendData(GenTreeConcurrent* const that,
+  GenTree* const node, void* const data);
+
+// Add a new node with user data 'data' and sort value 'sortVal' to the
+// subtrees of the node 'node' of the tree of the GenTreeConcurrent 
+// 'that', sorted in increasing order of sort value, like 
+// GenTreeAddSortData
+// Return the new node
+// The new node is allocated from the pool of 'node', if any
+// Can be called by several threads at once, on the same node or on 
+// different nodes
+GenTree* _GenTreeConcurrentAddSortData(GenTreeConcurrent* const that,
+  GenTree* const node, void* const data, const float sortVal);
+
+// ----------- GenTreePersist
+
+// ================= Data structure ===================
+
+// Node of a persistent tree: a tree is never modified, an edit returns
+// the root of a new version which shares all the untouched subtrees 
+// with the previous one (path copying). Each version is referenced by 
+// its root and stays valid until it is freed. The nodes are shared 
+// between versions and freed when their last reference is released
+// The subtrees of a node are stored in an array allocated with the 
+// node, thus an edit copies the nodes on the path from the root to the
+// edited node and their arrays of subtrees
+// The nodes of a version are identified by their rank in depth first
+// order, the root being the node 0
+typedef struct GenTreePersist {
+  // Number of references to the node: versions it is the root of and 
+  // nodes it is a subtree of
+  atomic_long _nbRef;
+  // User data
+  void* _data;
+  // Sort value in the subtrees of its parent
+  float _sortVal;
+  // Number of nodes in the subtrees
+  int _size;
+  // Number of subtrees
+  int _nbSubtree;
+  // Subtrees
+  struct GenTreePersist* _subtrees[];
+} GenTreePersist;
+
+// ================ Functions declaration ====================
+
+// Create a new persistent tree made of one node with user data 'data'
+// Return its root
+GenTreePersist* GenTreePersistCreate(void* const data);
+
+// Create a new version of a persistent tree copied from the GenTree 
+// 'tree', sharing with the version 'prev' the subtrees identical in 
+// both (same user data, sort values and shape). 'prev' may be null, 
+// then all the nodes are copied
+// The whole tree is run through, as the user data may have been
+// modified by GenTreeSetData, but only the nodes on the paths to the 
+// differences are allocated
+// Return its root
+GenTreePersist* GenTreePersistCreateFromTree(const GenTree* const tree,
+  const GenTreePersist* const prev);
+
+// Add a reference to the version of the persistent tree 'that' is the
+// root of, to be freed with GenTreePersistFree. It's the O(1) snapshot
+// of the version
+// Return 'that'
+GenTreePersist* GenTreePersistRetain(GenTreePersist* const that);
+
+// Release the reference to the version of the persistent tree 'that' 
+// is the root of, and free the nodes which are not referenced anymore
+// by other versions
+// User data must be freed by the user
+void GenTreePersistFree(GenTreePersist** that);
+
+// Return the root of a new version of the persistent tree 'that' where
+// a node with user data 'data' is appended to the subtrees of the 
+// 'iNode'-th node (in depth first order, the root being the node 0)
+// 'that' is unchanged
+GenTreePersist* GenTreePersistAppendData(
+  const GenTreePersist* const that, const int iNode, void* const data);
+
+// Return the root of a new version of the persistent tree 'that' where
+// a node with user data 'data' and sort value 'sortVal' is added to the
+// subtrees of the 'iNode'-th node (in depth first order, the root 
+// being the node 0), with the same order as GenTreeAddSortData
+// 'that' is unchanged
+GenTreePersist* GenTreePersistAddSortData(
+  const GenTreePersist* const that, const int iNode, void* const data, 
+  const float sortVal);
+
+// Return the root of a new version of the persistent tree 'that' where
+// the user data of the 'iNode'-th node (in depth first order, the root
+// being the node 0) is 'data'
+// 'that' is unchanged
+GenTreePersist* GenTreePersistSetData(const GenTreePersist* const that,
+  const int iNode, void* const data);
+
+// Return the root of a new version of the persistent tree 'that' where
+// the 'iNode'-th node (in depth first order, the root being the node 0)
+// and its subtrees are removed
+// 'iNode' must not be the root
+// 'that' is unchanged
+GenTreePersist* GenTreePersistCut(const GenTreePersist* const that,
+  const int iNode);
+
+// Return the 'iNode'-th node (in depth first order, the root being the
+// node 0) of the persistent tree 'that'
+// Return null if 'iNode' is not in [0, GenTreePersistGetSize(that)]
+const GenTreePersist* GenTreePersistSelect(
+  const GenTreePersist* const that, const int iNode);
+
+// Return the user data of the node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void* GenTreePersistData(const GenTreePersist* const that);
+
+// Return the sort value of the node 'that' in the subtrees of its 
+// parent
+#if BUILDMODE != 0
+static inline
+#endif
+float GenTreePersistSortVal(const GenTreePersist* const that);
+
+// Return the number of nodes in the subtrees of the node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreePersistGetSize(const GenTreePersist* const that);
+
+// Return the number of subtrees of the node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+int GenTreePersistNbSubtree(const GenTreePersist* const that);
+
+// Return the 'iSubtree'-th subtree of the node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+const GenTreePersist* GenTreePersistSubtree(
+  const GenTreePersist* const that, const int iSubtree);
 
 // ================= Typed GenTree ==================
 
@@ -357,14 +1855,17 @@ typedef struct GenTreeStr {GenTree _tree;} GenTreeStr;
 static inline GenTreeStr GenTreeStrCreateStatic(void) 
   {GenTreeStr ret = {._tree=GenTreeCreateStatic()}; return ret;}
 #define GenTreeStrCreateData(Data) ((GenTreeStr*)GenTreeCreateData(Data))
+#define GenTreeStrCreatePool(Pool) ((GenTreeStr*)GenTreeCreatePool(Pool))
+#define GenTreeStrCreateDataPool(Pool, Data) \
+  ((GenTreeStr*)GenTreeCreateDataPool(Pool, Data))
 static inline char* _GenTreeStrData(const GenTreeStr* const that) {
   return (char*)_GenTreeData((const GenTree* const)that);
 }
 static inline void _GenTreeStrSetData(GenTreeStr* const that, char* const data) {
   _GenTreeSetData((GenTree* const)that, (void* const)data);
 }
-static inline GSetGenTreeStr* _GenTreeStrSubtrees(const GenTreeStr* const that) {
-  return (GSetGenTreeStr*)_GenTreeSubtrees((const GenTree* const)that);
+static inline const GSetGenTreeStr* _GenTreeStrSubtrees(const GenTreeStr* const that) {
+  return (const GSetGenTreeStr*)_GenTreeSubtrees((const GenTree* const)that);
 }
 static inline GenTreeStr* _GenTreeStrParent(const GenTreeStr* const that) {
   return (GenTreeStr*)_GenTreeParent((const GenTree* const)that);
@@ -376,6 +1877,10 @@ static inline void _GenTreeStrAddSortData(GenTreeStr* const that, char* const da
   const float sortVal) {
   _GenTreeAddSortData((GenTree* const)that, (void* const)data, sortVal);
 }
+static inline void _GenTreeStrAppendSortData(GenTreeStr* const that, char* const data, 
+  const float sortVal) {
+  _GenTreeAppendSortData((GenTree* const)that, (void* const)data, sortVal);
+}
 static inline void _GenTreeStrInsertData(GenTreeStr* const that, char* const data, 
   const int pos) {
   _GenTreeInsertData((GenTree* const)that, (void* const)data, pos);
@@ -383,6 +1888,16 @@ static inline void _GenTreeStrInsertData(GenTreeStr* const that, char* const dat
 static inline void _GenTreeStrAppendData(GenTreeStr* const that, char* const data) {
   _GenTreeAppendData((GenTree* const)that, (void* const)data);
 }
+static inline GenTreeStr* _GenTreeStrClone(const GenTreeStr* const that, 
+  void* (*cloneData)(void* const data)) {
+  return (GenTreeStr*)_GenTreeClone((const GenTree* const)that, cloneData);
+}
+static inline GenTreeStr* _GenTreeStrCloneParallel(
+  const GenTreeStr* const that, void* (*cloneData)(void* const data), 
+  GenTreeThreadPool* const pool) {
+  return (GenTreeStr*)_GenTreeCloneParallel((const GenTree* const)that, 
+    cloneData, pool);
+}
 static inline GenTreeStr* _GenTreeStrSubtree(const GenTreeStr* const that, 
   const int iSubtree) {
   return (GenTreeStr*)_GenTreeSubtree((const GenTree* const)that, iSubtree);
@@ -393,12 +1908,24 @@ static inline GenTreeStr* _GenTreeStrFirstSubtree(const GenTreeStr* const that)
 static inline GenTreeStr* _GenTreeStrLastSubtree(const GenTreeStr* const that) {
   return (GenTreeStr*)_GenTreeLastSubtree((const GenTree* const)that);
 }
+static inline GenTreeStr* _GenTreeStrMinSubtree(const GenTreeStr* const that) {
+  return (GenTreeStr*)_GenTreeMinSubtree((const GenTree* const)that);
+}
+static inline GenTreeStr* _GenTreeStrMaxSubtree(const GenTreeStr* const that) {
+  return (GenTreeStr*)_GenTreeMaxSubtree((const GenTree* const)that);
+}
 static inline GenTreeStr* _GenTreeStrPopSubtree(GenTreeStr* const that) {
   return (GenTreeStr*)_GenTreePopSubtree((GenTree* const)that);
 }
 static inline GenTreeStr* _GenTreeStrDropSubtree(GenTreeStr* const that) {
   return (GenTreeStr*)_GenTreeDropSubtree((GenTree* const)that);
 }
+static inline GenTreeStr* _GenTreeStrNextSibling(const GenTreeStr* const that) {
+  return (GenTreeStr*)_GenTreeNextSibling((const GenTree* const)that);
+}
+static inline GenTreeStr* _GenTreeStrPrevSibling(const GenTreeStr* const that) {
+  return (GenTreeStr*)_GenTreePrevSibling((const GenTree* const)that);
+}
 static inline GenTreeStr* _GenTreeStrRemoveSubtree(GenTreeStr* const that, 
   const int iSubtree) {
   return (GenTreeStr*)_GenTreeRemoveSubtree((GenTree* const)that, iSubtree);
@@ -441,6 +1968,27 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeStr*: _GenTreeStrParent, \
   default: PBErrInvalidPolymorphism) (Tree)
 
+#define GenTreeNextSibling(Tree) _Generic(Tree, \
+  GenTree*: _GenTreeNextSibling, \
+  const GenTree*: _GenTreeNextSibling, \
+  GenTreeStr*: _GenTreeStrNextSibling, \
+  const GenTreeStr*: _GenTreeStrNextSibling, \
+  default: PBErrInvalidPolymorphism) (Tree)
+
+#define GenTreePrevSibling(Tree) _Generic(Tree, \
+  GenTree*: _GenTreePrevSibling, \
+  const GenTree*: _GenTreePrevSibling, \
+  GenTreeStr*: _GenTreeStrPrevSibling, \
+  const GenTreeStr*: _GenTreeStrPrevSibling, \
+  default: PBErrInvalidPolymorphism) (Tree)
+
+#define GenTreeSiblingIndex(Tree) _Generic(Tree, \
+  GenTree*: _GenTreeSiblingIndex, \
+  const GenTree*: _GenTreeSiblingIndex, \
+  GenTreeStr*: _GenTreeSiblingIndex, \
+  const GenTreeStr*: _GenTreeSiblingIndex, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
+
 #define GenTreeSubtrees(Tree) _Generic(Tree, \
   GenTree*: _GenTreeSubtrees, \
   const GenTree*: _GenTreeSubtrees, \
@@ -448,6 +1996,27 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeStr*: _GenTreeStrSubtrees, \
   default: PBErrInvalidPolymorphism) (Tree)
 
+#define GenTreeGetPool(Tree) _Generic(Tree, \
+  GenTree*: _GenTreeGetPool, \
+  const GenTree*: _GenTreeGetPool, \
+  GenTreeStr*: _GenTreeGetPool, \
+  const GenTreeStr*: _GenTreeGetPool, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
+
+#define GenTreeGen(Tree) _Generic(Tree, \
+  GenTree*: _GenTreeGen, \
+  const GenTree*: _GenTreeGen, \
+  GenTreeStr*: _GenTreeGen, \
+  const GenTreeStr*: _GenTreeGen, \
+  default: PBErrInvalidPolymorphism) ((const GenTree*)(Tree))
+
+#define GenTreeSortVal(Tree) _Generic(Tree, \
+  GenTree*: _GenTreeSortVal, \
+  const GenTree*: _GenTreeSortVal, \
+  GenTreeStr*: _GenTreeSortVal, \
+  const GenTreeStr*: _GenTreeSortVal, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
+
 #define GenTreeData(Tree) _Generic(Tree, \
   GenTree*: _GenTreeData, \
   const GenTree*: _GenTreeData, \
@@ -465,6 +2034,17 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   GenTreeStr*: _GenTreeCut, \
   default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
 
+#define GenTreeMoveSubtree(Tree, Parent, Pos) _Generic(Tree, \
+  GenTree*: _GenTreeMoveSubtree, \
+  GenTreeStr*: _GenTreeMoveSubtree, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree), \
+    (GenTree*)(Parent), Pos)
+
+#define GenTreeGraftChildren(Tree, To) _Generic(Tree, \
+  GenTree*: _GenTreeGraftChildren, \
+  GenTreeStr*: _GenTreeGraftChildren, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree), (GenTree*)(To))
+
 #define GenTreeIsRoot(Tree) _Generic(Tree, \
   GenTree*: _GenTreeIsRoot, \
   const GenTree*: _GenTreeIsRoot, \
@@ -486,6 +2066,13 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeStr*: _GenTreeIsLastBrother, \
   default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
 
+#define GenTreeClone(Tree, CloneData) _Generic(Tree, \
+  GenTree*: _GenTreeClone, \
+  const GenTree*: _GenTreeClone, \
+  GenTreeStr*: _GenTreeStrClone, \
+  const GenTreeStr*: _GenTreeStrClone, \
+  default: PBErrInvalidPolymorphism) (Tree, CloneData)
+
 #define GenTreeGetSize(Tree) _Generic(Tree, \
   GenTree*: _GenTreeGetSize, \
   const GenTree*: _GenTreeGetSize, \
@@ -493,6 +2080,20 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeStr*: _GenTreeGetSize, \
   default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
 
+#define GenTreeSelect(Tree, INode) _Generic(Tree, \
+  GenTree*: _GenTreeSelect, \
+  const GenTree*: _GenTreeSelect, \
+  GenTreeStr*: _GenTreeSelect, \
+  const GenTreeStr*: _GenTreeSelect, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree), INode)
+
+#define GenTreeRank(Tree, Node) _Generic(Tree, \
+  GenTree*: _GenTreeRank, \
+  const GenTree*: _GenTreeRank, \
+  GenTreeStr*: _GenTreeRank, \
+  const GenTreeStr*: _GenTreeRank, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree), (GenTree*)(Node))
+
 #define GenTreePushData(Tree, Data) _Generic(Tree, \
   GenTree*: _GenTreePushData, \
   GenTreeStr*: _GenTreeStrPushData, \
@@ -503,6 +2104,11 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   GenTreeStr*: _GenTreeStrAddSortData, \
   default: PBErrInvalidPolymorphism) (Tree, Data, SortVal);
 
+#define GenTreeAppendSortData(Tree, Data, SortVal) _Generic(Tree, \
+  GenTree*: _GenTreeAppendSortData, \
+  GenTreeStr*: _GenTreeStrAppendSortData, \
+  default: PBErrInvalidPolymorphism) (Tree, Data, SortVal);
+
 #define GenTreeInsertData(Tree, Data, Pos) _Generic(Tree, \
   GenTree*: _GenTreeInsertData, \
   GenTreeStr*: _GenTreeStrInsertData, \
@@ -527,6 +2133,28 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeStr*: _GenTreeStrFirstSubtree, \
   default: PBErrInvalidPolymorphism) (Tree)
 
+#define GenTreeMinSubtree(Tree) _Generic(Tree, \
+  GenTree*: _GenTreeMinSubtree, \
+  const GenTree*: _GenTreeMinSubtree, \
+  GenTreeStr*: _GenTreeStrMinSubtree, \
+  const GenTreeStr*: _GenTreeStrMinSubtree, \
+  default: PBErrInvalidPolymorphism) (Tree)
+
+#define GenTreeMaxSubtree(Tree) _Generic(Tree, \
+  GenTree*: _GenTreeMaxSubtree, \
+  const GenTree*: _GenTreeMaxSubtree, \
+  GenTreeStr*: _GenTreeStrMaxSubtree, \
+  const GenTreeStr*: _GenTreeStrMaxSubtree, \
+  default: PBErrInvalidPolymorphism) (Tree)
+
+#define GenTreeSubtreesInRange(Tree, Lo, Hi, First) _Generic(Tree, \
+  GenTree*: _GenTreeSubtreesInRange, \
+  const GenTree*: _GenTreeSubtreesInRange, \
+  GenTreeStr*: _GenTreeSubtreesInRange, \
+  const GenTreeStr*: _GenTreeSubtreesInRange, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree), Lo, Hi, \
+    (GenTree**)(First))
+
 #define GenTreeLastSubtree(Tree) _Generic(Tree, \
   GenTree*: _GenTreeLastSubtree, \
   const GenTree*: _GenTreeLastSubtree, \
@@ -555,8 +2183,8 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   default: PBErrInvalidPolymorphism) (Tree, SubTree)
 
 #define GenTreeAddSortSubtree(Tree, SubTree, SortVal) _Generic(Tree, \
-  GenTree*: _GenTreeAddSortSubtree, \
-  GenTreeStr*: _GenTreeStrAddSortSubtree, \
+  GenTree*: _GenTreeAddSortSubTree, \
+  GenTreeStr*: _GenTreeStrAddSortSubTree, \
   default: PBErrInvalidPolymorphism) (Tree, SubTree, SortVal)
 
 #define GenTreeInsertSubtree(Tree, SubTree, Pos) _Generic(Tree, \
@@ -569,19 +2197,23 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   GenTreeStr*: _GenTreeStrAppendSubtree, \
   default: PBErrInvalidPolymorphism) (Tree, SubTree)
 
-#define GenTreeAppendToNode(Tree, Data, Node, Iter) _Generic(Tree, \
-  GenTree*: _GenTreeAppendToNode, \
-  GenTreeStr*: _GenTreeAppendToNode, \
-  default: PBErrInvalidPolymorphism) ((GenTree*)Tree, Data, Node, \
-    (GenTreeIter*)Iter)
-
-#define GenTreeSearch(Tree, Data, Iter) _Generic(Tree, \
-  GenTree*: _GenTreeSearch, \
-  const GenTree*: _GenTreeSearch, \
-  GenTreeStr*: _GenTreeSearch, \
-  const GenTreeStr*: _GenTreeSearch, \
-  default: PBErrInvalidPolymorphism) ((GenTree*)Tree, Data, \
-    (GenTreeIter*)Iter)
+#define GenTreeAppendToNode(Tree, Data, Node, Iter) _Generic(Iter, \
+  GenTreeIterDepthLazy*: _GenTreeAppendToNodeDepthLazy, \
+  default: _Generic(Tree, \
+    GenTree*: _GenTreeAppendToNode, \
+    GenTreeStr*: _GenTreeAppendToNode, \
+    default: PBErrInvalidPolymorphism)) ((GenTree*)Tree, Data, Node, \
+    (void*)(Iter))
+
+#define GenTreeSearch(Tree, Data, Iter) _Generic(Iter, \
+  GenTreeIterDepthLazy*: _GenTreeSearchDepthLazy, \
+  default: _Generic(Tree, \
+    GenTree*: _GenTreeSearch, \
+    const GenTree*: _GenTreeSearch, \
+    GenTreeStr*: _GenTreeSearch, \
+    const GenTreeStr*: _GenTreeSearch, \
+    default: PBErrInvalidPolymorphism)) ((GenTree*)Tree, Data, \
+    (void*)(Iter))
 
 #define GenTreeIterDepthCreate(Tree) _Generic(Tree, \
   GenTree*: _GenTreeIterDepthCreate, \
@@ -597,6 +2229,15 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeStr*: _GenTreeIterDepthCreateStatic, \
   default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
 
+#define GenTreeIterDepthCreateStaticBuffer(Tree, Buffer, Capacity) \
+  _Generic(Tree, \
+  GenTree*: _GenTreeIterDepthCreateStaticBuffer, \
+  const GenTree*: _GenTreeIterDepthCreateStaticBuffer, \
+  GenTreeStr*: _GenTreeIterDepthCreateStaticBuffer, \
+  const GenTreeStr*: _GenTreeIterDepthCreateStaticBuffer, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree), \
+    (GenTree**)(Buffer), Capacity)
+
 #define GenTreeIterBreadthCreate(Tree) _Generic(Tree, \
   GenTree*: _GenTreeIterBreadthCreate, \
   const GenTree*: _GenTreeIterBreadthCreate, \
@@ -611,6 +2252,15 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeStr*: _GenTreeIterBreadthCreateStatic, \
   default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
 
+#define GenTreeIterBreadthCreateStaticBuffer(Tree, Buffer, Capacity) \
+  _Generic(Tree, \
+  GenTree*: _GenTreeIterBreadthCreateStaticBuffer, \
+  const GenTree*: _GenTreeIterBreadthCreateStaticBuffer, \
+  GenTreeStr*: _GenTreeIterBreadthCreateStaticBuffer, \
+  const GenTreeStr*: _GenTreeIterBreadthCreateStaticBuffer, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree), \
+    (GenTree**)(Buffer), Capacity)
+
 #define GenTreeIterValueCreate(Tree) _Generic(Tree, \
   GenTree*: _GenTreeIterValueCreate, \
   const GenTree*: _GenTreeIterValueCreate, \
@@ -625,54 +2275,130 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeStr*: _GenTreeIterValueCreateStatic, \
   default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
 
+#define GenTreeIterValueCreateStaticBuffer(Tree, Buffer, Capacity) \
+  _Generic(Tree, \
+  GenTree*: _GenTreeIterValueCreateStaticBuffer, \
+  const GenTree*: _GenTreeIterValueCreateStaticBuffer, \
+  GenTreeStr*: _GenTreeIterValueCreateStaticBuffer, \
+  const GenTreeStr*: _GenTreeIterValueCreateStaticBuffer, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree), \
+    (GenTree**)(Buffer), Capacity)
+
+#define GenTreeIterDepthLazyCreate(Tree) _Generic(Tree, \
+  GenTree*: _GenTreeIterDepthLazyCreate, \
+  const GenTree*: _GenTreeIterDepthLazyCreate, \
+  GenTreeStr*: _GenTreeIterDepthLazyCreate, \
+  const GenTreeStr*: _GenTreeIterDepthLazyCreate, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
+
+#define GenTreeIterDepthLazyCreateStatic(Tree) _Generic(Tree, \
+  GenTree*: _GenTreeIterDepthLazyCreateStatic, \
+  const GenTree*: _GenTreeIterDepthLazyCreateStatic, \
+  GenTreeStr*: _GenTreeIterDepthLazyCreateStatic, \
+  const GenTreeStr*: _GenTreeIterDepthLazyCreateStatic, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
+
 #define GenTreeIterFree(RefIter) _Generic(RefIter, \
   GenTreeIter**: _GenTreeIterFree, \
   GenTreeIterDepth**: _GenTreeIterFree, \
   GenTreeIterBreadth**: _GenTreeIterFree, \
   GenTreeIterValue**: _GenTreeIterFree, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter**)(RefIter))
+  GenTreeIterDepthLazy**: _GenTreeIterDepthLazyFree, \
+  default: PBErrInvalidPolymorphism) ((void*)(RefIter))
 
 #define GenTreeIterFreeStatic(Iter) _Generic(Iter, \
   GenTreeIter*: _GenTreeIterFreeStatic, \
   GenTreeIterDepth*: _GenTreeIterFreeStatic, \
   GenTreeIterBreadth*: _GenTreeIterFreeStatic, \
   GenTreeIterValue*: _GenTreeIterFreeStatic, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazyFreeStatic, \
+  default: PBErrInvalidPolymorphism) ((void*)(Iter))
 
 #define GenTreeIterReset(Iter) _Generic(Iter, \
   GenTreeIter*: _GenTreeIterReset, \
   GenTreeIterDepth*: _GenTreeIterReset, \
   GenTreeIterBreadth*: _GenTreeIterReset, \
   GenTreeIterValue*: _GenTreeIterReset, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazyReset, \
+  default: PBErrInvalidPolymorphism) ((void*)(Iter))
 
 #define GenTreeIterToEnd(Iter) _Generic(Iter, \
   GenTreeIter*: _GenTreeIterToEnd, \
   GenTreeIterDepth*: _GenTreeIterToEnd, \
   GenTreeIterBreadth*: _GenTreeIterToEnd, \
   GenTreeIterValue*: _GenTreeIterToEnd, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazyToEnd, \
+  default: PBErrInvalidPolymorphism) ((void*)(Iter))
 
 #define GenTreeIterStep(Iter) _Generic(Iter, \
   GenTreeIter*: _GenTreeIterStep, \
   GenTreeIterDepth*: _GenTreeIterStep, \
   GenTreeIterBreadth*: _GenTreeIterStep, \
   GenTreeIterValue*: _GenTreeIterStep, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazyStep, \
+  default: PBErrInvalidPolymorphism) ((void*)(Iter))
 
 #define GenTreeIterStepBack(Iter) _Generic(Iter, \
   GenTreeIter*: _GenTreeIterStepBack, \
   GenTreeIterDepth*: _GenTreeIterStepBack, \
   GenTreeIterBreadth*: _GenTreeIterStepBack, \
   GenTreeIterValue*: _GenTreeIterStepBack, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazyStepBack, \
+  default: PBErrInvalidPolymorphism) ((void*)(Iter))
 
 #define GenTreeIterApply(Iter, Fun, Param) _Generic(Iter, \
   GenTreeIter*: _GenTreeIterApply, \
   GenTreeIterDepth*: _GenTreeIterApply, \
   GenTreeIterBreadth*: _GenTreeIterApply, \
   GenTreeIterValue*: _GenTreeIterApply, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter), Fun, Param)
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazyApply, \
+  default: PBErrInvalidPolymorphism) ((void*)(Iter), Fun, Param)
+
+#define GenTreeParallelApply(Tree, Fun, Param, Pool, Order) \
+  _Generic(Tree, \
+  GenTree*: _GenTreeParallelApply, \
+  GenTreeStr*: _GenTreeParallelApply, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree), Fun, Param, \
+    Pool, Order)
+
+#define GenTreeReduce(Tree, Result, Identity, Size, Map, Combine, \
+  Param, Pool) _Generic(Tree, \
+  GenTree*: _GenTreeReduce, \
+  GenTreeStr*: _GenTreeReduce, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree), Result, \
+    Identity, Size, Map, Combine, Param, Pool)
+
+#define GenTreeReduceBottomUp(Tree, Result, Identity, Size, Map, \
+  Combine, Store, Param, Pool) _Generic(Tree, \
+  GenTree*: _GenTreeReduceBottomUp, \
+  GenTreeStr*: _GenTreeReduceBottomUp, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree), Result, \
+    Identity, Size, Map, Combine, Store, Param, Pool)
+
+#define GenTreeCloneParallel(Tree, CloneData, Pool) _Generic(Tree, \
+  GenTree*: _GenTreeCloneParallel, \
+  const GenTree*: _GenTreeCloneParallel, \
+  GenTreeStr*: _GenTreeStrCloneParallel, \
+  const GenTreeStr*: _GenTreeStrCloneParallel, \
+  default: PBErrInvalidPolymorphism) (Tree, CloneData, Pool)
+
+#define GenTreeConcurrentCreate(Tree) _Generic(Tree, \
+  GenTree*: _GenTreeConcurrentCreate, \
+  GenTreeStr*: _GenTreeConcurrentCreate, \
+  default: PBErrInvalidPolymorphism) ((GenTree*)(Tree))
+
+#define GenTreeConcurrentAppendData(Conc, Node, Data) _Generic(Node, \
+  GenTree*: _GenTreeConcurrentAppendData, \
+  GenTreeStr*: _GenTreeConcurrentAppendData, \
+  default: PBErrInvalidPolymorphism) (Conc, (GenTree*)(Node), \
+    (void*)(Data))
+
+#define GenTreeConcurrentAddSortData(Conc, Node, Data, SortVal) \
+  _Generic(Node, \
+  GenTree*: _GenTreeConcurrentAddSortData, \
+  GenTreeStr*: _GenTreeConcurrentAddSortData, \
+  default: PBErrInvalidPolymorphism) (Conc, (GenTree*)(Node), \
+    (void*)(Data), SortVal)
 
 #define GenTreeIterIsFirst(Iter) _Generic(Iter, \
   GenTreeIter*: _GenTreeIterIsFirst, \
@@ -683,7 +2409,9 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeIterBreadth*: _GenTreeIterIsFirst, \
   GenTreeIterValue*: _GenTreeIterIsFirst, \
   const GenTreeIterValue*: _GenTreeIterIsFirst, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazyIsFirst, \
+  const GenTreeIterDepthLazy*: _GenTreeIterDepthLazyIsFirst, \
+  default: PBErrInvalidPolymorphism) ((void*)(Iter))
 
 #define GenTreeIterIsLast(Iter) _Generic(Iter, \
   GenTreeIter*: _GenTreeIterIsLast, \
@@ -694,12 +2422,15 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeIterBreadth*: _GenTreeIterIsLast, \
   GenTreeIterValue*: _GenTreeIterIsLast, \
   const GenTreeIterValue*: _GenTreeIterIsLast, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazyIsLast, \
+  const GenTreeIterDepthLazy*: _GenTreeIterDepthLazyIsLast, \
+  default: PBErrInvalidPolymorphism) ((void*)(Iter))
 
 #define GenTreeIterSetGenTree(Iter, Tree) _Generic(Iter, \
   GenTreeIterDepth*: _GenTreeIterDepthSetGenTree, \
   GenTreeIterBreadth*: _GenTreeIterBreadthSetGenTree, \
   GenTreeIterValue*: _GenTreeIterValueSetGenTree, \
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazySetGenTree, \
   default: PBErrInvalidPolymorphism) (Iter, Tree)
 
 #define GenTreeIterGetData(Iter) _Generic(Iter, \
@@ -711,7 +2442,9 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeIterBreadth*: _GenTreeIterGetData, \
   GenTreeIterValue*: _GenTreeIterGetData, \
   const GenTreeIterValue*: _GenTreeIterGetData, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazyGetData, \
+  const GenTreeIterDepthLazy*: _GenTreeIterDepthLazyGetData, \
+  default: PBErrInvalidPolymorphism) ((void*)(Iter))
 
 #define GenTreeIterGenTree(Iter) _Generic(Iter, \
   GenTreeIter*: _GenTreeIterGenTree, \
@@ -722,7 +2455,9 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeIterBreadth*: _GenTreeIterGenTree, \
   GenTreeIterValue*: _GenTreeIterGenTree, \
   const GenTreeIterValue*: _GenTreeIterGenTree, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazyGenTree, \
+  const GenTreeIterDepthLazy*: _GenTreeIterDepthLazyGenTree, \
+  default: PBErrInvalidPolymorphism) ((void*)(Iter))
 
 #define GenTreeIterGetGenTree(Iter) _Generic(Iter, \
   GenTreeIter*: _GenTreeIterGetGenTree, \
@@ -733,7 +2468,9 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeIterBreadth*: _GenTreeIterGetGenTree, \
   GenTreeIterValue*: _GenTreeIterGetGenTree, \
   const GenTreeIterValue*: _GenTreeIterGetGenTree, \
-  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+  GenTreeIterDepthLazy*: _GenTreeIterDepthLazyGetGenTree, \
+  const GenTreeIterDepthLazy*: _GenTreeIterDepthLazyGetGenTree, \
+  default: PBErrInvalidPolymorphism) ((void*)(Iter))
 
 #define GenTreeIterSeq(Iter) _Generic(Iter, \
   GenTreeIter*: _GenTreeIterSeq, \
@@ -746,12 +2483,58 @@ static inline void _GenTreeStrAppendSubtree(GenTreeStr* const that,
   const GenTreeIterValue*: _GenTreeIterSeq, \
   default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
 
+#define GenTreeIterGetNbNode(Iter) _Generic(Iter, \
+  GenTreeIter*: _GenTreeIterGetNbNode, \
+  const GenTreeIter*: _GenTreeIterGetNbNode, \
+  GenTreeIterDepth*: _GenTreeIterGetNbNode, \
+  const GenTreeIterDepth*: _GenTreeIterGetNbNode, \
+  GenTreeIterBreadth*: _GenTreeIterGetNbNode, \
+  const GenTreeIterBreadth*: _GenTreeIterGetNbNode, \
+  GenTreeIterValue*: _GenTreeIterGetNbNode, \
+  const GenTreeIterValue*: _GenTreeIterGetNbNode, \
+  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+
+#define GenTreeIterGetPos(Iter) _Generic(Iter, \
+  GenTreeIter*: _GenTreeIterGetPos, \
+  const GenTreeIter*: _GenTreeIterGetPos, \
+  GenTreeIterDepth*: _GenTreeIterGetPos, \
+  const GenTreeIterDepth*: _GenTreeIterGetPos, \
+  GenTreeIterBreadth*: _GenTreeIterGetPos, \
+  const GenTreeIterBreadth*: _GenTreeIterGetPos, \
+  GenTreeIterValue*: _GenTreeIterGetPos, \
+  const GenTreeIterValue*: _GenTreeIterGetPos, \
+  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter))
+
+#define GenTreeIterSeek(Iter, IPos) _Generic(Iter, \
+  GenTreeIter*: _GenTreeIterSeek, \
+  GenTreeIterDepth*: _GenTreeIterSeek, \
+  GenTreeIterBreadth*: _GenTreeIterSeek, \
+  GenTreeIterValue*: _GenTreeIterSeek, \
+  default: PBErrInvalidPolymorphism) ((GenTreeIter*)(Iter), IPos)
+
+#define GenTreeIterIsStale(Iter) _Generic(Iter, \
+  GenTreeIter*: _GenTreeIterIsStale, \
+  const GenTreeIter*: _GenTreeIterIsStale, \
+  GenTreeIterDepth*: _GenTreeIterIsStale, \
+  const GenTreeIterDepth*: _GenTreeIterIsStale, \
+  GenTreeIterBreadth*: _GenTreeIterIsStale, \
+  const GenTreeIterBreadth*: _GenTreeIterIsStale, \
+  GenTreeIterValue*: _GenTreeIterIsStale, \
+  const GenTreeIterValue*: _GenTreeIterIsStale, \
+  default: PBErrInvalidPolymorphism) ((const GenTreeIter*)(Iter))
+
 #define GenTreeIterUpdate(Iter) _Generic(Iter, \
   GenTreeIterDepth*: GenTreeIterDepthUpdate, \
   GenTreeIterBreadth*: GenTreeIterBreadthUpdate, \
   GenTreeIterValue*: GenTreeIterValueUpdate, \
   default: PBErrInvalidPolymorphism) (Iter)
 
+#define GenTreeIterUpdateParallel(Iter, Pool) _Generic(Iter, \
+  GenTreeIterDepth*: GenTreeIterDepthUpdateParallel, \
+  GenTreeIterBreadth*: GenTreeIterBreadthUpdateParallel, \
+  GenTreeIterValue*: GenTreeIterValueUpdateParallel, \
+  default: PBErrInvalidPolymorphism) (Iter, Pool)
+
 // ================ static inliner ====================
 
 #if BUILDMODE != 0
@@ -121,8 +121,27 @@ void UnitTestGenTreeCutGetSize() {
     sprintf(GenTreeErr->_msg, "GenTreeCut failed");
     PBErrCatch(GenTreeErr);
   }
-  GenTreeFreeStatic(&tree);
+  GenTreeAppendSubtree(GenTreeSubtree(&tree, 0), cuttree);
+  GenTreePushData(cuttree, &data);
+  if (GenTreeGetSize(&tree) != 4 ||
+    GenTreeGetSize(GenTreeSubtree(&tree, 0)) != 3 ||
+    GenTreeGetSize(cuttree) != 2) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeGetSize failed");
+    PBErrCatch(GenTreeErr);
+  }
   GenTreeFree(&cuttree);
+  if (GenTreeGetSize(&tree) != 1) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeFreeStatic(&tree);
+  if (GenTreeGetSize(&tree) != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeFreeStatic failed");
+    PBErrCatch(GenTreeErr);
+  }
   printf("UnitTestGenTreeCutGetSize OK\n");
 }
 
@@ -189,319 +208,1098 @@ void UnitTestGenTreeIsLastBrother() {
   printf("UnitTestGenTreeIsLastBrother OK\n");
 }
   
-void UnitTestGenTree() {
-  UnitTestGenTreeCreateFree();
-  UnitTestGenTreeGetSet();
-  UnitTestGenTreeCutGetSize();
-  UnitTestGenTreeSearchAppendToNode();
-  UnitTestGenTreeIsLastBrother();
-  printf("UnitTestGenTree OK\n");
-}
-
-int dataExampleTree[10] = {0,1,2,3,4,5,6,7,8,9};
-GenTree* GetExampleTree() {
-  GenTree* tree = GenTreeCreate();
-  GenTreeAddSortData(tree, dataExampleTree + 0, 0);
-  GenTreeAddSortData(tree, dataExampleTree + 9, 9);
-  GenTree* subtree = GenTreeSubtree(tree, 0);
-  GenTreeAddSortData(subtree, dataExampleTree + 1, 1);
-  GenTreeAddSortData(subtree, dataExampleTree + 2, 2);
-  subtree = GenTreeSubtree(tree, 1);
-  GenTreeAddSortData(subtree, dataExampleTree + 3, 3);
-  GenTreeAddSortData(subtree, dataExampleTree + 4, 4);
-  subtree = GenTreeSubtree(subtree, 0);
-  GenTreeAddSortData(subtree, dataExampleTree + 8, 8);
-  GenTreeAddSortData(subtree, dataExampleTree + 6, 6);
-  subtree = GenTreeSubtree(subtree, 1);
-  GenTreeAddSortData(subtree, dataExampleTree + 7, 7);
-  GenTreeAddSortData(subtree, dataExampleTree + 5, 5);
-  return tree;
-}
-
-void funApply(void* data, void* param) {
-  printf("%d%c", *(int*)data,*(char*)param);
+void UnitTestGenTreeSiblings() {
+  GenTree tree = GenTreeCreateStatic();
+  int data[4] = {0, 1, 2, 3};
+  for (int i = 0; i < 3; ++i)
+    GenTreeAppendData(&tree, data + i);
+  GenTree* first = GenTreeSubtree(&tree, 0);
+  GenTree* second = GenTreeSubtree(&tree, 1);
+  GenTree* third = GenTreeSubtree(&tree, 2);
+  if (GenTreeNextSibling(first) != second ||
+    GenTreeNextSibling(third) != NULL ||
+    GenTreePrevSibling(third) != second ||
+    GenTreePrevSibling(first) != NULL ||
+    GenTreeNextSibling(&tree) != NULL ||
+    GenTreePrevSibling(&tree) != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeNextSibling failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeSiblingIndex(&tree) != 0 ||
+    GenTreeSiblingIndex(first) != 0 ||
+    GenTreeSiblingIndex(second) != 1 ||
+    GenTreeSiblingIndex(third) != 2) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeSiblingIndex failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreePushData(&tree, data + 3);
+  GenTreeCut(second);
+  if (GenTreeSiblingIndex(first) != 1 ||
+    GenTreeSiblingIndex(third) != 2 ||
+    GenTreeSiblingIndex(GenTreeSubtree(&tree, 0)) != 0 ||
+    GenTreeSiblingIndex(second) != 0 ||
+    GenTreeNextSibling(first) != third ||
+    GenTreePrevSibling(third) != first) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeSiblingIndex failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeAppendSubtree(&tree, second);
+  if (GenTreeSiblingIndex(second) != 3 ||
+    GenTreeNextSibling(third) != second ||
+    GenTreeIsLastBrother(second) == false ||
+    GenTreeIsLastBrother(third) == true) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeSiblingIndex failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeFreeStatic(&tree);
+  printf("UnitTestGenTreeSiblings OK\n");
 }
 
-void UnitTestGenTreeIterDepth() {
-  GenTree* tree = GetExampleTree();
-  GenTreeIterDepth* iter = GenTreeIterDepthCreate(tree);
-  if (iter == NULL ||
-    iter->_iter._tree != tree ||
-    GSetNbElem(&(iter->_iter._seq)) != 10 ||
-    iter->_iter._curPos != iter->_iter._seq._set._head) {
+void UnitTestGenTreeSubtreeArray() {
+  GenTree tree = GenTreeCreateStatic();
+  int data[40];
+  for (int i = 0; i < 40; ++i)
+    data[i] = i;
+  GenTreeAppendData(&tree, data + 1);
+  GenTreeSubtreeArrayCreate(&tree);
+  if (GenTreeHasSubtreeArray(&tree) == false ||
+    GenTreeData(GenTreeSubtree(&tree, 0)) != data + 1) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterDepthCreate failed");
+    sprintf(GenTreeErr->_msg, "GenTreeSubtreeArrayCreate failed");
     PBErrCatch(GenTreeErr);
   }
-  int check[10] = {0,1,2,9,3,6,8,5,7,4};
-  int iCheck = 0;
-  do {
-    int* data = GenTreeIterGetData(iter);
-    if (*data != check[iCheck]) {
+  for (int i = 2; i < 40; ++i)
+    GenTreeAppendData(&tree, data + i);
+  GenTreePushData(&tree, data);
+  GenTreeInsertData(&tree, data + 20, 10);
+  GenTree* removed = GenTreeRemoveSubtree(&tree, 11);
+  GenTreeFree(&removed);
+  GenTree* popped = GenTreePopSubtree(&tree);
+  GenTreeInsertSubtree(&tree, popped, 0);
+  for (int i = 0; i < 40; ++i) {
+    GenTree* subtree = GenTreeSubtree(&tree, i);
+    int expected = (i == 10 ? 20 : i);
+    if (GenTreeData(subtree) != data + expected ||
+      GenTreeSiblingIndex(subtree) != i) {
       GenTreeErr->_type = PBErrTypeUnitTestFailed;
-      sprintf(GenTreeErr->_msg, "GenTreeIterDepth failed");
+      sprintf(GenTreeErr->_msg, "GenTreeSubtree failed");
       PBErrCatch(GenTreeErr);
     }
-    ++iCheck;
-  } while (GenTreeIterStep(iter));
-  GenTreeIterFree(&iter);
-  if (iter != NULL) {
+  }
+  GenTree* cut = GenTreeSubtree(&tree, 5);
+  GenTreeCut(cut);
+  if (GenTreeData(GenTreeSubtree(&tree, 5)) != data + 6 ||
+    GenTreeSiblingIndex(GenTreeLastSubtree(&tree)) != 38 ||
+    GenTreeGetSize(&tree) != 39) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterFree failed");
+    sprintf(GenTreeErr->_msg, "GenTreeCut failed");
     PBErrCatch(GenTreeErr);
   }
-  GenTreeIterDepth iterstatic = GenTreeIterDepthCreateStatic(tree);
-  if (iterstatic._iter._tree != tree ||
-    GSetNbElem(&(iterstatic._iter._seq)) != 10 ||
-    iterstatic._iter._curPos != iterstatic._iter._seq._set._head) {
+  GenTreeFree(&cut);
+  GenTreeSubtreeArrayFree(&tree);
+  if (GenTreeHasSubtreeArray(&tree) == true ||
+    GenTreeData(GenTreeSubtree(&tree, 5)) != data + 6 ||
+    GenTreeSiblingIndex(GenTreeSubtree(&tree, 5)) != 5) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterDepthCreateStatic failed");
+    sprintf(GenTreeErr->_msg, "GenTreeSubtreeArrayFree failed");
     PBErrCatch(GenTreeErr);
   }
-  iCheck = 0;
-  do {
-    int* data = GenTreeIterGetData(&iterstatic);
-    if (*data != check[iCheck]) {
+  GenTreeSubtreeArrayCreate(GenTreeSubtree(&tree, 0));
+  GenTreeAppendData(GenTreeSubtree(&tree, 0), data);
+  GenTreeFreeStatic(&tree);
+  printf("UnitTestGenTreeSubtreeArray OK\n");
+}
+
+void UnitTestGenTreeSubtreeSkipList() {
+  GenTree tree = GenTreeCreateStatic();
+  GenTree treeRef = GenTreeCreateStatic();
+  int data[2000];
+  for (int i = 0; i < 2000; ++i) {
+    data[i] = i;
+    float sortVal = (float)(rand() % 100);
+    GenTreeAddSortData(&tree, data + i, sortVal);
+    GenTreeAddSortData(&treeRef, data + i, sortVal);
+    if (i == 999)
+      GenTreeSubtreeSkipListCreate(&tree);
+  }
+  if (GenTreeHasSubtreeSkipList(&tree) == false ||
+    GenTreeHasSubtreeSkipList(&treeRef) == true) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeSubtreeSkipListCreate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  for (int i = 0; i < 500; ++i) {
+    GenTree* removed = GenTreeRemoveSubtree(&tree, rand() % 1500);
+    GenTree* subtree = GenTreeFirstSubtree(&treeRef);
+    while (GenTreeData(subtree) != GenTreeData(removed))
+      subtree = GenTreeNextSibling(subtree);
+    GenTreeFree(&subtree);
+    GenTreeFree(&removed);
+  }
+  for (int i = 0; i < 100; ++i) {
+    float sortVal = (float)(rand() % 100);
+    GenTreeAddSortSubtree(&tree, GenTreeCreateData(data + i), sortVal);
+    GenTreeAddSortData(&treeRef, data + i, sortVal);
+  }
+  GenTree* subtree = GenTreeFirstSubtree(&tree);
+  GenTree* subtreeRef = GenTreeFirstSubtree(&treeRef);
+  while (subtree != NULL) {
+    if (GenTreeData(subtree) != GenTreeData(subtreeRef)) {
       GenTreeErr->_type = PBErrTypeUnitTestFailed;
-      sprintf(GenTreeErr->_msg, "GenTreeIterDepth failed");
+      sprintf(GenTreeErr->_msg, "GenTreeAddSortSubtree failed");
       PBErrCatch(GenTreeErr);
     }
-    ++iCheck;
-  } while (GenTreeIterStep(&iterstatic));
-  check[3] = 12;
-  dataExampleTree[9] = 12;
-  GenTreeIterDepthUpdate(&iterstatic);
-  iCheck = 0;
-  do {
-    int* data = GenTreeIterGetData(&iterstatic);
-    if (*data != check[iCheck]) {
+    subtree = GenTreeNextSibling(subtree);
+    subtreeRef = GenTreeNextSibling(subtreeRef);
+  }
+  for (int i = 0; i < 100; ++i) {
+    float lo = (float)(rand() % 110) - 5.0;
+    float hi = lo + (float)(rand() % 20);
+    GenTree* first = NULL;
+    GenTree* firstRef = NULL;
+    int nb = GenTreeSubtreesInRange(&tree, lo, hi, &first);
+    int nbRef = GenTreeSubtreesInRange(&treeRef, lo, hi, &firstRef);
+    if (nb != nbRef || 
+      (first != NULL && GenTreeData(first) != GenTreeData(firstRef)) ||
+      (first == NULL && firstRef != NULL) ||
+      (nb == 0 && first != NULL) ||
+      GenTreeSubtreeLowerBound(&tree, lo) != 
+        GenTreeSubtreeLowerBound(&tree, lo - 0.5) ||
+      GenTreeSubtreeUpperBound(&tree, hi) != 
+        GenTreeSubtreeLowerBound(&tree, hi + 0.5)) {
       GenTreeErr->_type = PBErrTypeUnitTestFailed;
-      sprintf(GenTreeErr->_msg, "GenTreeIterUpdate failed");
+      sprintf(GenTreeErr->_msg, "GenTreeSubtreesInRange failed");
       PBErrCatch(GenTreeErr);
     }
-    ++iCheck;
-  } while (GenTreeIterStep(&iterstatic));
-  dataExampleTree[9] = 9;
-  GenTreeIterReset(&iterstatic);
-  if (iterstatic._iter._curPos != iterstatic._iter._seq._set._head) {
-    GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterReset failed");
-    PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterIsFirst(&iterstatic) == false) {
+  if (GenTreeData(GenTreeMinSubtree(&tree)) != 
+      GenTreeData(GenTreeMinSubtree(&treeRef)) ||
+    GenTreeData(GenTreeMaxSubtree(&tree)) != 
+      GenTreeData(GenTreeMaxSubtree(&treeRef)) ||
+    GenTreeMinSubtree(&tree) != GenTreeFirstSubtree(&tree) ||
+    GenTreeMaxSubtree(&tree) != GenTreeLastSubtree(&tree)) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterIsFirst failed");
+    sprintf(GenTreeErr->_msg, "GenTreeMinSubtree failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterIsLast(&iterstatic) == true) {
+  GenTreeSubtreeSkipListFree(&tree);
+  if (GenTreeHasSubtreeSkipList(&tree) == true ||
+    (GenTreeFirstSubtree(&tree)->_extra != NULL &&
+    GenTreeFirstSubtree(&tree)->_extra->_skipNext != NULL)) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterIsLast failed");
+    sprintf(GenTreeErr->_msg, "GenTreeSubtreeSkipListFree failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterGetGenTree(&iterstatic) != GenTreeSubtree(tree, 0)) {
-    GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterGetGenTree failed");
-    PBErrCatch(GenTreeErr);
+  GenTreeSubtreeSkipListCreate(&tree);
+  GenTreeFreeStatic(&tree);
+  GenTreeFreeStatic(&treeRef);
+  printf("UnitTestGenTreeSubtreeSkipList OK\n");
+}
+
+void UnitTestGenTreeSortSubtrees() {
+  GenTree tree = GenTreeCreateStatic();
+  GenTree treeRef = GenTreeCreateStatic();
+  int data[1000];
+  void* dataArr[500];
+  float sortVals[500];
+  for (int i = 0; i < 500; ++i) {
+    data[i] = i;
+    float sortVal = (float)(rand() % 50);
+    GenTreeAppendSortData(&tree, data + i, sortVal);
+    GenTreeAddSortData(&treeRef, data + i, sortVal);
   }
-  GenTreeIterToEnd(&iterstatic);
-  if (iterstatic._iter._curPos != iterstatic._iter._seq._set._tail) {
-    GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterToEnd failed");
-    PBErrCatch(GenTreeErr);
+  GenTreeSubtreeArrayCreate(&tree);
+  GenTreeSortSubtrees(&tree);
+  for (int i = 500; i < 1000; ++i) {
+    data[i] = i;
+    dataArr[i - 500] = data + i;
+    sortVals[i - 500] = (float)(rand() % 50);
+    GenTreeAddSortData(&treeRef, data + i, sortVals[i - 500]);
   }
-  if (GenTreeIterIsFirst(&iterstatic) == true) {
+  GenTreeAddSortDataBatch(&tree, dataArr, sortVals, 500);
+  GenTree* subtree = GenTreeFirstSubtree(&tree);
+  GenTree* subtreeRef = GenTreeFirstSubtree(&treeRef);
+  int iSubtree = 0;
+  while (subtreeRef != NULL) {
+    if (subtree == NULL ||
+      GenTreeData(subtree) != GenTreeData(subtreeRef) ||
+      GenTreeSubtree(&tree, iSubtree) != subtree ||
+      GenTreeSiblingIndex(subtree) != iSubtree) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeSortSubtrees failed");
+      PBErrCatch(GenTreeErr);
+    }
+    subtree = GenTreeNextSibling(subtree);
+    subtreeRef = GenTreeNextSibling(subtreeRef);
+    ++iSubtree;
+  }
+  if (subtree != NULL || GenTreePrevSibling(GenTreeLastSubtree(&tree)) ==
+    NULL) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterIsFirst failed");
+    sprintf(GenTreeErr->_msg, "GenTreeSortSubtrees failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterIsLast(&iterstatic) == false) {
+  GenTree* node = GenTreeSubtree(&tree, 0);
+  GenTreeAppendSortData(node, data, 2.0);
+  GenTreeAppendSortData(node, data + 1, 1.0);
+  GenTreeAppendSortData(GenTreeSubtree(node, 1), data + 2, 1.0);
+  GenTreeAppendSortData(GenTreeSubtree(node, 1), data + 3, 0.0);
+  unsigned long gen = GenTreeGen(&tree);
+  unsigned long genNode = GenTreeGen(node);
+  GenTreeSortSubtreesRec(&tree);
+  if (GenTreeData(GenTreeSubtree(node, 0)) != data + 1 ||
+    GenTreeData(GenTreeSubtree(GenTreeSubtree(node, 0), 0)) != 
+      data + 3 ||
+    GenTreeGen(&tree) == gen || GenTreeGen(node) == genNode) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterIsLast failed");
+    sprintf(GenTreeErr->_msg, "GenTreeSortSubtreesRec failed");
     PBErrCatch(GenTreeErr);
   }
-  GenTreeIterStepBack(&iterstatic);
-  if (iterstatic._iter._curPos->_next != 
-    iterstatic._iter._seq._set._tail) {
+  GenTreeFreeStatic(&tree);
+  GenTreeFreeStatic(&treeRef);
+  printf("UnitTestGenTreeSortSubtrees OK\n");
+}
+
+void UnitTestGenTreeBatch() {
+  int data[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  void* dataPtr[10];
+  for (int i = 0; i < 10; ++i)
+    dataPtr[i] = data + i;
+  GenTree* tree = GenTreeCreate();
+  GenTreeAppendDataBatch(tree, dataPtr + 5, 5);
+  GenTreePushDataBatch(tree, dataPtr, 3);
+  GenTreeInsertDataBatch(tree, dataPtr + 3, 2, 3);
+  if (GenTreeGetSize(tree) != 10 ||
+    GSetNbElem(GenTreeSubtrees(tree)) != 10 ||
+    GenTreeLastSubtree(tree)->_block != 
+      GenTreeSubtree(tree, 5)->_block) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterStepBack failed");
+    sprintf(GenTreeErr->_msg, "GenTreeAppendDataBatch failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterGenTree(&iterstatic) != tree) {
+  for (int i = 0; i < 10; ++i) {
+    GenTree* subtree = GenTreeSubtree(tree, i);
+    if (GenTreeData(subtree) != data + i ||
+      GenTreeParent(subtree) != tree ||
+      GenTreeSiblingIndex(subtree) != i ||
+      (i > 0 && GenTreePrevSibling(subtree) != 
+        GenTreeSubtree(tree, i - 1))) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeInsertDataBatch failed");
+      PBErrCatch(GenTreeErr);
+    }
+  }
+  GenTree* subtree = GenTreeSubtree(tree, 6);
+  GenTreeFree(&subtree);
+  GenTreeSubtreeArrayCreate(GenTreeSubtree(tree, 0));
+  GenTreeAppendDataBatch(GenTreeSubtree(tree, 0), dataPtr, 3);
+  if (GenTreeGetSize(tree) != 12 ||
+    GenTreeData(GenTreeSubtree(GenTreeSubtree(tree, 0), 2)) != data + 2) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterGenTree failed");
+    sprintf(GenTreeErr->_msg, "GenTreeAppendDataBatch failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterSeq(&iterstatic) != &(iterstatic._iter._seq)) {
+  GenTreeFree(&tree);
+  GenTreePool pool = GenTreePoolCreateStatic(4);
+  tree = GenTreeCreatePool(&pool);
+  GenTreeAppendDataBatch(tree, dataPtr, 10);
+  if (GenTreePoolGetNbLive(&pool) != 11 ||
+    GSetNbElem(&(pool._chunks)) != 3 ||
+    GenTreeData(GenTreeLastSubtree(tree)) != data + 9) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterSeq failed");
+    sprintf(GenTreeErr->_msg, "GenTreeAppendDataBatch failed");
     PBErrCatch(GenTreeErr);
   }
-  char c = ',';
-  GenTreeIterApply(&iterstatic, &funApply, &c);
-  printf("\n");
-  GenTree* treeB = GenTreeCreate();
-  GenTreeIterSetGenTree(&iterstatic, treeB);
-  if (GenTreeIterGenTree(&iterstatic) != treeB ||
-    GSetNbElem(&(iterstatic._iter._seq)) != 0) {
+  GenTreeFree(&tree);
+  if (GenTreePoolGetNbLive(&pool) != 0) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterSetGenTree failed");
+    sprintf(GenTreeErr->_msg, "GenTreeFree failed");
     PBErrCatch(GenTreeErr);
   }
-  GenTreeIterFreeStatic(&iterstatic);
-  GenTreeFree(&tree);
-  GenTreeFree(&treeB);
-  printf("UnitTestGenTreeIterDepth OK\n");
+  GenTreePoolFreeStatic(&pool);
+  printf("UnitTestGenTreeBatch OK\n");
 }
 
-void UnitTestGenTreeIterBreadth() {
-  GenTree* tree = GetExampleTree();
-  GenTreeIterBreadth* iter = GenTreeIterBreadthCreate(tree);
-  if (iter == NULL ||
-    iter->_iter._tree != tree ||
-    GSetNbElem(&(iter->_iter._seq)) != 10 ||
-    iter->_iter._curPos != iter->_iter._seq._set._head) {
+void UnitTestGenTreeFromParents() {
+  int data[7] = {0, 1, 2, 3, 4, 5, 6};
+  void* dataPtr[7];
+  for (int i = 0; i < 7; ++i)
+    dataPtr[i] = data + i;
+  // 3 -> {0 -> {1, 2}, 5 -> {4}, 6}
+  int parents[7] = {3, 0, 0, -1, 5, 3, 3};
+  float sortVals[7] = {1.0, 2.0, 1.0, 0.0, 0.0, 1.0, 2.0};
+  GenTree* tree = GenTreeCreateFromParents(dataPtr, parents, NULL, 7);
+  if (GenTreeData(tree) != data + 3 ||
+    GenTreeGetSize(tree) != 6 ||
+    GenTreeData(GenTreeSubtree(tree, 0)) != data + 0 ||
+    GenTreeData(GenTreeSubtree(tree, 1)) != data + 5 ||
+    GenTreeData(GenTreeSubtree(tree, 2)) != data + 6 ||
+    GenTreeGetSize(GenTreeSubtree(tree, 0)) != 2 ||
+    GenTreeSiblingIndex(GenTreeSubtree(tree, 2)) != 2 ||
+    GenTreeData(GenTreeSubtree(GenTreeSubtree(tree, 1), 0)) != data + 4) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterBreadthCreate failed");
+    sprintf(GenTreeErr->_msg, "GenTreeCreateFromParents failed");
     PBErrCatch(GenTreeErr);
   }
-  int check[10] = {0,9,1,2,3,4,6,8,5,7};
-  int iCheck = 0;
-  do {
-    int* data = GenTreeIterGetData(iter);
-    if (*data != check[iCheck]) {
+  void* exportData[7];
+  int exportParents[7];
+  int checkParents[7] = {-1, 0, 1, 1, 0, 4, 0};
+  if (GenTreeExportParents(tree, exportData, exportParents, NULL) != 7) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeExportParents failed");
+    PBErrCatch(GenTreeErr);
+  }
+  for (int i = 0; i < 7; ++i) {
+    if (exportParents[i] != checkParents[i]) {
       GenTreeErr->_type = PBErrTypeUnitTestFailed;
-      sprintf(GenTreeErr->_msg, "GenTreeIterBreadth failed");
+      sprintf(GenTreeErr->_msg, "GenTreeExportParents failed");
       PBErrCatch(GenTreeErr);
     }
-    ++iCheck;
-  } while (GenTreeIterStep(iter));
-  GenTreeIterFree(&iter);
-  if (iter != NULL) {
+  }
+  GenTree* subtree = GenTreeSubtree(tree, 0);
+  GenTreeFree(&subtree);
+  if (GenTreeGetSize(tree) != 3 ||
+    GenTreeExportParents(tree, NULL, NULL, NULL) != 4) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterFree failed");
+    sprintf(GenTreeErr->_msg, "GenTreeExportParents failed");
     PBErrCatch(GenTreeErr);
   }
-  GenTreeIterBreadth iterstatic = GenTreeIterBreadthCreateStatic(tree);
-  if (iterstatic._iter._tree != tree ||
-    GSetNbElem(&(iterstatic._iter._seq)) != 10 ||
-    iterstatic._iter._curPos != iterstatic._iter._seq._set._head) {
+  GenTreeFree(&tree);
+  tree = GenTreeCreateFromParents(dataPtr, parents, sortVals, 7);
+  if (GenTreeData(GenTreeSubtree(tree, 0)) != data + 0 ||
+    GenTreeData(GenTreeSubtree(tree, 1)) != data + 5 ||
+    GenTreeData(GenTreeSubtree(tree, 2)) != data + 6 ||
+    GenTreeData(GenTreeSubtree(GenTreeSubtree(tree, 0), 0)) != data + 2 ||
+    GenTreeSortVal(GenTreeSubtree(tree, 2)) != 2.0) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterBreadthCreateStatic failed");
+    sprintf(GenTreeErr->_msg, "GenTreeCreateFromParents failed");
     PBErrCatch(GenTreeErr);
   }
-  iCheck = 0;
-  do {
-    int* data = GenTreeIterGetData(&iterstatic);
-    if (*data != check[iCheck]) {
-      GenTreeErr->_type = PBErrTypeUnitTestFailed;
-      sprintf(GenTreeErr->_msg, "GenTreeIterBreadth failed");
-      PBErrCatch(GenTreeErr);
-    }
-    ++iCheck;
-  } while (GenTreeIterStep(&iterstatic));
-  check[1] = 12;
-  dataExampleTree[9] = 12;
-  GenTreeIterBreadthUpdate(&iterstatic);
-  iCheck = 0;
-  do {
-    int* data = GenTreeIterGetData(&iterstatic);
-    if (*data != check[iCheck]) {
+  float exportSortVals[7];
+  GenTreeExportParents(tree, exportData, exportParents, exportSortVals);
+  GenTree* copy = GenTreeCreateFromParents(exportData, exportParents,
+    exportSortVals, 7);
+  void* copyData[7];
+  int copyParents[7];
+  float copySortVals[7];
+  GenTreeExportParents(copy, copyData, copyParents, copySortVals);
+  for (int i = 0; i < 7; ++i) {
+    if (copyData[i] != exportData[i] ||
+      copyParents[i] != exportParents[i] ||
+      copySortVals[i] != exportSortVals[i]) {
       GenTreeErr->_type = PBErrTypeUnitTestFailed;
-      sprintf(GenTreeErr->_msg, "GenTreeIterUpdate failed");
+      sprintf(GenTreeErr->_msg, "GenTreeExportParents failed");
       PBErrCatch(GenTreeErr);
     }
-    ++iCheck;
-  } while (GenTreeIterStep(&iterstatic));
-  dataExampleTree[9] = 9;
-  GenTreeIterReset(&iterstatic);
-  if (iterstatic._iter._curPos != iterstatic._iter._seq._set._head) {
+  }
+  GenTreeFree(&copy);
+  GenTreeFree(&tree);
+  // 3 -> {5 -> {4}, 0 -> {2, 1}, 6}
+  int edges[12] = {3, 5, 5, 4, 0, 2, 3, 0, 0, 1, 3, 6};
+  tree = GenTreeCreateFromEdges(dataPtr, edges, NULL, 7);
+  if (GenTreeData(tree) != data + 3 ||
+    GenTreeGetSize(tree) != 6 ||
+    GenTreeData(GenTreeSubtree(tree, 0)) != data + 5 ||
+    GenTreeData(GenTreeSubtree(tree, 1)) != data + 0 ||
+    GenTreeData(GenTreeSubtree(tree, 2)) != data + 6 ||
+    GenTreeData(GenTreeSubtree(GenTreeSubtree(tree, 1), 0)) != data + 2 ||
+    GenTreeGetSize(GenTreeSubtree(tree, 1)) != 2) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterReset failed");
+    sprintf(GenTreeErr->_msg, "GenTreeCreateFromEdges failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterIsFirst(&iterstatic) == false) {
+  GenTreeFree(&tree);
+  tree = GenTreeCreateFromEdges(dataPtr, edges, sortVals, 7);
+  if (GenTreeData(GenTreeSubtree(tree, 0)) != data + 5 ||
+    GenTreeData(GenTreeSubtree(tree, 1)) != data + 0 ||
+    GenTreeData(GenTreeSubtree(GenTreeSubtree(tree, 1), 1)) != data + 1) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterIsFirst failed");
+    sprintf(GenTreeErr->_msg, "GenTreeCreateFromEdges failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterIsLast(&iterstatic) == true) {
+  GenTreeFree(&tree);
+  // Deep tree: each node of the spine has a leaf, added first but with 
+  // a greater sort value, and the next node of the spine
+  int nbDeep = 1000001;
+  int* deepParents = PBErrMalloc(GenTreeErr, sizeof(int) * nbDeep);
+  float* deepSortVals = PBErrMalloc(GenTreeErr, sizeof(float) * nbDeep);
+  deepParents[0] = -1;
+  deepSortVals[0] = 0.0;
+  for (int i = 1; i < nbDeep; ++i) {
+    deepParents[i] = ((i - 1) / 2) * 2;
+    deepSortVals[i] = (i % 2 == 1 ? 1.0 : 0.0);
+  }
+  tree = GenTreeCreateFromParents(NULL, deepParents, deepSortVals, nbDeep);
+  int depth = 0;
+  for (GenTree* node = tree; !GenTreeIsLeaf(node);
+    node = GenTreeSubtree(node, 0))
+    ++depth;
+  if (depth != nbDeep / 2 || GenTreeGetSize(tree) != nbDeep - 1) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterIsLast failed");
+    sprintf(GenTreeErr->_msg, "GenTreeCreateFromParents failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterGetGenTree(&iterstatic) != GenTreeSubtree(tree, 0)) {
+  GenTreeFree(&tree);
+  free(deepParents);
+  free(deepSortVals);
+  printf("UnitTestGenTreeFromParents OK\n");
+}
+
+void* cloneInt(void* const data) {
+  int* clone = PBErrMalloc(GenTreeErr, sizeof(int));
+  *clone = *(int*)data;
+  return clone;
+}
+
+void UnitTestGenTreeClone() {
+  int data[7] = {0, 1, 2, 3, 4, 5, 6};
+  void* dataPtr[7];
+  for (int i = 0; i < 7; ++i)
+    dataPtr[i] = data + i;
+  // 3 -> {0 -> {2, 1}, 5 -> {4}, 6}
+  int parents[7] = {3, 0, 0, -1, 5, 3, 3};
+  float sortVals[7] = {1.0, 2.0, 1.0, 0.0, 0.0, 1.0, 2.0};
+  GenTree* tree = GenTreeCreateFromParents(dataPtr, parents, sortVals, 7);
+  GenTreeSubtreeSkipListCreate(tree);
+  GenTree* clone = GenTreeClone(tree, NULL);
+  void* exportData[7];
+  int exportParents[7];
+  float exportSortVals[7];
+  GenTreeExportParents(tree, exportData, exportParents, exportSortVals);
+  void* cloneData[7];
+  int cloneParents[7];
+  float cloneSortVals[7];
+  if (clone == tree ||
+    GenTreeExportParents(clone, cloneData, cloneParents, 
+      cloneSortVals) != 7 ||
+    GenTreeGetSize(clone) != 6 ||
+    GenTreeGetSize(GenTreeSubtree(clone, 0)) != 2 ||
+    GenTreeSiblingIndex(GenTreeSubtree(clone, 2)) != 2 ||
+    GenTreeGetSkipList(clone) == NULL ||
+    GenTreeGetSkipList(GenTreeSubtree(clone, 0)) != NULL ||
+    GenTreeMaxSubtree(clone) != GenTreeSubtree(clone, 2)) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterGetGenTree failed");
+    sprintf(GenTreeErr->_msg, "GenTreeClone failed");
     PBErrCatch(GenTreeErr);
   }
-  GenTreeIterToEnd(&iterstatic);
-  if (iterstatic._iter._curPos != iterstatic._iter._seq._set._tail) {
+  for (int i = 0; i < 7; ++i) {
+    if (cloneData[i] != exportData[i] ||
+      cloneParents[i] != exportParents[i] ||
+      cloneSortVals[i] != exportSortVals[i]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeClone failed");
+      PBErrCatch(GenTreeErr);
+    }
+  }
+  // The copy is independent from the original
+  GenTreeAppendData(GenTreeSubtree(clone, 1), data + 1);
+  if (GenTreeGetSize(tree) != 6 ||
+    GenTreeGetSize(clone) != 7) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterToEnd failed");
+    sprintf(GenTreeErr->_msg, "GenTreeClone failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterIsFirst(&iterstatic) == true) {
+  GenTreeFree(&clone);
+  // Copy of a subtree, with copies of the data
+  clone = GenTreeClone(GenTreeSubtree(tree, 0), cloneInt);
+  if (!GenTreeIsRoot(clone) ||
+    GenTreeGetSize(clone) != 2 ||
+    GenTreeData(clone) == data + 0 ||
+    *(int*)GenTreeData(clone) != 0 ||
+    *(int*)GenTreeData(GenTreeSubtree(clone, 0)) != 2 ||
+    *(int*)GenTreeData(GenTreeSubtree(clone, 1)) != 1 ||
+    GenTreeSortVal(GenTreeSubtree(clone, 1)) != 2.0) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterIsFirst failed");
+    sprintf(GenTreeErr->_msg, "GenTreeClone failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterIsLast(&iterstatic) == false) {
+  free(GenTreeData(GenTreeSubtree(clone, 0)));
+  free(GenTreeData(GenTreeSubtree(clone, 1)));
+  free(GenTreeData(clone));
+  GenTreeFree(&clone);
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreeClone OK\n");
+}
+
+// Check the GenTree 'tree' has the 'nb' nodes 'data' with parents 
+// 'parents' in depth first order
+bool CheckTreeParents(const GenTree* const tree, const int nb, 
+  int* const data, const int* const checkData, 
+  const int* const checkParents) {
+  void* exportData[16];
+  int exportParents[16];
+  if (GenTreeExportParents(tree, exportData, exportParents, NULL) != nb ||
+    GenTreeGetSize(tree) != nb - 1)
+    return false;
+  for (int i = 0; i < nb; ++i)
+    if (exportData[i] != data + checkData[i] ||
+      exportParents[i] != checkParents[i])
+      return false;
+  return true;
+}
+
+void UnitTestGenTreeMoveGraft() {
+  int data[9] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+  void* dataPtr[7];
+  for (int i = 0; i < 7; ++i)
+    dataPtr[i] = data + i;
+  // 3 -> {0 -> {1, 2}, 5 -> {4}, 6}
+  int parents[7] = {3, 0, 0, -1, 5, 3, 3};
+  GenTree* tree = GenTreeCreateFromParents(dataPtr, parents, NULL, 7);
+  GenTreeIndexCreate(tree, NULL);
+  GenTree* zero = GenTreeSubtree(tree, 0);
+  GenTree* five = GenTreeSubtree(tree, 1);
+  GenTree* six = GenTreeSubtree(tree, 2);
+  // 3 -> {0 -> {1, 4, 2}, 5, 6}
+  GenTreeMoveSubtree(GenTreeSubtree(five, 0), zero, 1);
+  int checkData[7] = {3, 0, 1, 4, 2, 5, 6};
+  int checkParents[7] = {-1, 0, 1, 1, 1, 0, 0};
+  if (!CheckTreeParents(tree, 7, data, checkData, checkParents) ||
+    GenTreeGetSize(zero) != 3 ||
+    GenTreeGetSize(five) != 0 ||
+    GenTreeSiblingIndex(GenTreeSubtree(zero, 2)) != 2 ||
+    GenTreeIndexSearch(tree, data + 4, NULL) != GenTreeSubtree(zero, 1)) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterIsLast failed");
+    sprintf(GenTreeErr->_msg, "GenTreeMoveSubtree failed");
     PBErrCatch(GenTreeErr);
   }
-  GenTreeIterStepBack(&iterstatic);
-  if (iterstatic._iter._curPos->_next != 
-    iterstatic._iter._seq._set._tail) {
+  // 3 -> {6, 0 -> {1, 4, 2}, 5 -> {7}}
+  GenTreeMoveSubtree(six, tree, 0);
+  GenTree* seven = GenTreeCreateData(data + 7);
+  GenTreeMoveSubtree(seven, five, 0);
+  int checkDataB[8] = {3, 6, 0, 1, 4, 2, 5, 7};
+  int checkParentsB[8] = {-1, 0, 0, 2, 2, 2, 0, 6};
+  if (!CheckTreeParents(tree, 8, data, checkDataB, checkParentsB) ||
+    GenTreeSiblingIndex(zero) != 1 ||
+    GenTreeIndexSearch(tree, data + 7, NULL) != seven) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterStepBack failed");
+    sprintf(GenTreeErr->_msg, "GenTreeMoveSubtree failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterGenTree(&iterstatic) != tree) {
+  // 3 -> {6, 0, 5 -> {7, 1, 4, 2}}
+  GenTreeGraftChildren(zero, five);
+  int checkDataC[8] = {3, 6, 0, 5, 7, 1, 4, 2};
+  int checkParentsC[8] = {-1, 0, 0, 0, 3, 3, 3, 3};
+  if (!CheckTreeParents(tree, 8, data, checkDataC, checkParentsC) ||
+    GenTreeGetSize(zero) != 0 ||
+    GenTreeSubtreeElem(zero, 0) != NULL ||
+    GenTreeSiblingIndex(GenTreeSubtree(five, 3)) != 3 ||
+    GenTreeParent(GenTreeSubtree(five, 2)) != five ||
+    GenTreeIndexSearch(tree, data + 2, NULL) != 
+      GenTreeSubtree(five, 3)) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterGenTree failed");
+    sprintf(GenTreeErr->_msg, "GenTreeGraftChildren failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterSeq(&iterstatic) != &(iterstatic._iter._seq)) {
+  // Graft to a node of another tree with a skip list, the subtrees are
+  // sorted: 8 -> {7, 1, 4, 2} with sort values {2, 1, 3, 0} gives
+  // 8 -> {2, 1, 7, 4}
+  GenTree* other = GenTreeCreateData(data + 8);
+  GenTreeSubtreeSkipListCreate(other);
+  float sortVals[4] = {2.0, 1.0, 3.0, 0.0};
+  for (int i = 0; i < 4; ++i)
+    GenTreeSubtree(five, i)->_link._sortVal = sortVals[i];
+  GenTreeGraftChildren(five, other);
+  int checkDataD[5] = {8, 2, 1, 7, 4};
+  int checkParentsD[5] = {-1, 0, 0, 0, 0};
+  int checkDataE[4] = {3, 6, 0, 5};
+  int checkParentsE[4] = {-1, 0, 0, 0};
+  if (!CheckTreeParents(other, 5, data, checkDataD, checkParentsD) ||
+    !CheckTreeParents(tree, 4, data, checkDataE, checkParentsE) ||
+    GenTreeMaxSubtree(other) != GenTreeSubtree(other, 3) ||
+    GenTreeIndexSearch(tree, data + 2, NULL) != NULL) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterSeq failed");
+    sprintf(GenTreeErr->_msg, "GenTreeGraftChildren failed");
     PBErrCatch(GenTreeErr);
   }
-  char c = ',';
-  GenTreeIterApply(&iterstatic, &funApply, &c);
-  printf("\n");
-  GenTree* treeB = GenTreeCreate();
-  GenTreeIterSetGenTree(&iterstatic, treeB);
-  if (GenTreeIterGenTree(&iterstatic) != treeB ||
-    GSetNbElem(&(iterstatic._iter._seq)) != 0) {
+  GenTreeFree(&other);
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreeMoveGraft OK\n");
+}
+
+void UnitTestGenTreeLink() {
+  GenTree tree = GenTreeCreateStatic();
+  int data[3] = {1, 2, 3};
+  GenTreeAddSortData(&tree, data, 2.0);
+  GenTreeAddSortData(&tree, data + 1, 1.0);
+  GenTreeAddSortData(&tree, data + 2, 2.0);
+  GenTree* first = GenTreeSubtree(&tree, 0);
+  GenTree* second = GenTreeSubtree(&tree, 1);
+  GenTree* third = GenTreeSubtree(&tree, 2);
+  if (GenTreeData(first) != data + 1 ||
+    GenTreeData(second) != data ||
+    GenTreeData(third) != data + 2 ||
+    tree._subtrees._set._head != &(first->_link) ||
+    tree._subtrees._set._tail != &(third->_link) ||
+    first->_link._next != &(second->_link) ||
+    third->_link._prev != &(second->_link) ||
+    second->_link._data != second ||
+    fabs(GenTreeSortVal(first) - 1.0) > 1e-6 ||
+    fabs(GenTreeSortVal(third) - 2.0) > 1e-6) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterSetGenTree failed");
+    sprintf(GenTreeErr->_msg, "GenTreeLinkSubtree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeCut(second);
+  if (GenTreeParent(second) != NULL ||
+    second->_link._next != NULL ||
+    second->_link._prev != NULL ||
+    first->_link._next != &(third->_link) ||
+    third->_link._prev != &(first->_link) ||
+    GSetNbElem(GenTreeSubtrees(&tree)) != 2) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeCut failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeFree(&second);
+  GenTreeFreeStatic(&tree);
+  printf("UnitTestGenTreeLink OK\n");
+}
+
+void UnitTestGenTreePool() {
+  GenTreePool* pool = GenTreePoolCreate(2);
+  if (pool == NULL ||
+    pool->_nbNodePerChunk != 2 ||
+    GSetNbElem(&(pool->_chunks)) != 0 ||
+    pool->_freeNodes != NULL ||
+    GenTreePoolGetNbLive(pool) != 0 ||
+    GenTreePoolGetNbRecycled(pool) != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePoolCreate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  int data[3] = {1, 2, 3};
+  GenTree* tree = GenTreeCreatePool(pool);
+  GenTreeAppendData(tree, data);
+  GenTreeAppendData(tree, data + 1);
+  GenTreeAppendData(GenTreeSubtree(tree, 1), data + 2);
+  if (GenTreeGetPool(tree) != pool ||
+    GenTreeGetPool(GenTreeSubtree(tree, 1)) != pool ||
+    GenTreePoolGetNbLive(pool) != 4 ||
+    GSetNbElem(&(pool->_chunks)) != 2 ||
+    GenTreeGetSize(tree) != 3) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeCreatePool failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTree* subtree = GenTreeSubtree(tree, 1);
+  GenTreeFree(&subtree);
+  if (GenTreePoolGetNbLive(pool) != 2 ||
+    GenTreeGetSize(tree) != 1) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeAppendData(tree, data + 2);
+  if (GenTreePoolGetNbLive(pool) != 3 ||
+    GenTreePoolGetNbRecycled(pool) != 1 ||
+    GSetNbElem(&(pool->_chunks)) != 2 ||
+    GenTreeData(GenTreeSubtree(tree, 1)) != data + 2) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePoolAllocNode failed");
     PBErrCatch(GenTreeErr);
   }
-  GenTreeIterFreeStatic(&iterstatic);
   GenTreeFree(&tree);
-  GenTreeFree(&treeB);
-  printf("UnitTestGenTreeIterBreadth OK\n");
+  if (GenTreePoolGetNbLive(pool) != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTree treeStatic = GenTreeCreateStaticPool(pool);
+  GenTreeAppendData(&treeStatic, data);
+  if (GenTreeGetPool(&treeStatic) != pool ||
+    GenTreePoolGetNbLive(pool) != 1) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeCreateStaticPool failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeFreeStatic(&treeStatic);
+  GenTreePoolFree(&pool);
+  if (pool != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePoolFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  printf("UnitTestGenTreePool OK\n");
 }
 
-void UnitTestGenTreeIterValue() {
+void UnitTestGenTreeArena() {
+  GenTreePool arena = GenTreePoolCreateStaticArena(2);
+  if (GenTreePoolIsArena(&arena) == false ||
+    GSetNbElem(&(arena._chunks)) != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePoolCreateStaticArena failed");
+    PBErrCatch(GenTreeErr);
+  }
+  int data[4] = {1, 2, 3, 4};
+  GenTree* tree = GenTreeCreatePool(&arena);
+  GenTreeAppendData(tree, data);
+  GenTreeAddSortData(tree, data + 1, 1.0);
+  GenTreePushData(GenTreeSubtree(tree, 1), data + 2);
+  GenTreeInsertData(tree, data + 3, 1);
+  if (GenTreePoolGetNbLive(&arena) != 5 ||
+    GenTreeGetSize(tree) != 4 ||
+    GenTreeData(GenTreeSubtree(tree, 1)) != data + 3 ||
+    GenTreeData(GenTreeSubtree(GenTreeSubtree(tree, 2), 0)) != 
+      data + 2) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeCreatePool failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTree* subtree = GenTreeSubtree(tree, 2);
+  GenTreeFree(&subtree);
+  GenTree* popped = GenTreePopSubtree(tree);
+  if (GenTreePoolGetNbLive(&arena) != 3 ||
+    GenTreeGetSize(tree) != 1 ||
+    GenTreeParent(popped) != NULL ||
+    GenTreeData(popped) != data ||
+    arena._freeNodes != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreePoolReset(&arena);
+  if (GenTreePoolGetNbLive(&arena) != 0 ||
+    GSetNbElem(&(arena._chunks)) != 1 ||
+    arena._nbUsedByte != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePoolReset failed");
+    PBErrCatch(GenTreeErr);
+  }
+  tree = GenTreeCreateDataPool(&arena, data);
+  GenTreeAppendData(tree, data + 1);
+  if (GenTreePoolGetNbLive(&arena) != 2 ||
+    GSetNbElem(&(arena._chunks)) != 1) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePoolReset failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // The arrays of subtrees, skip lists and indexes of the trees are 
+  // released with the arena
+  GenTreeSubtreeArrayCreate(tree);
+  GenTreeSubtreeSkipListCreate(tree);
+  GenTreeIndexCreate(tree, NULL);
+  for (int iNode = 0; iNode < 64; ++iNode)
+    GenTreeAddSortData(tree, data + iNode % 4, (float)(iNode % 4));
+  if (arena._extras == NULL ||
+    GenTreeIndexSearch(tree, data + 3, NULL) == NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePoolReset failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreePoolReset(&arena);
+  if (arena._extras != NULL ||
+    GenTreePoolGetNbLive(&arena) != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePoolReset failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreePoolFreeStatic(&arena);
+  printf("UnitTestGenTreeArena OK\n");
+}
+
+unsigned long UnitTestGenTreeIndexKey(const void* const data) {
+  return (unsigned long)(*(int*)data);
+}
+
+void UnitTestGenTreeIndex() {
+  int data[30];
+  for (int i = 0; i < 30; ++i)
+    data[i] = i;
+  GenTree* tree = GenTreeCreate();
+  GenTreeAppendData(tree, data);
+  for (int i = 1; i < 20; ++i)
+    GenTreeAppendData(GenTreeSubtree(tree, 0), data + i);
+  GenTreeIndexCreate(tree, NULL);
+  GenTreeAppendData(GenTreeSubtree(GenTreeSubtree(tree, 0), 3), data + 20);
+  if (GenTreeIsIndexed(tree) == false ||
+    GenTreeIndexGetNbNode(tree) != 21 ||
+    GenTreeSubtree(tree, 0)->_extra != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIndexCreate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  for (int i = 0; i < 21; ++i) {
+    GenTree* node = GenTreeIndexSearch(tree, data + i, NULL);
+    if (node == NULL || GenTreeData(node) != data + i ||
+      GenTreeIndexSearch(tree, data + i, node) != NULL) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIndexSearch failed");
+      PBErrCatch(GenTreeErr);
+    }
+  }
+  if (GenTreeIndexSearch(tree, data + 21, NULL) != NULL ||
+    GenTreeIndexAppendToNode(tree, data + 21, data + 22) == true ||
+    GenTreeIndexAppendToNode(tree, data + 21, data + 20) == false ||
+    GenTreeParent(GenTreeIndexSearch(tree, data + 21, NULL)) != 
+      GenTreeIndexSearch(tree, data + 20, NULL)) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIndexAppendToNode failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTree* node = GenTreeIndexSearch(tree, data + 21, NULL);
+  GenTreeSetData(node, data + 1);
+  GenTree* found = GenTreeIndexSearch(tree, data + 1, NULL);
+  GenTree* foundNext = GenTreeIndexSearch(tree, data + 1, found);
+  if (GenTreeIndexSearch(tree, data + 21, NULL) != NULL ||
+    found == NULL || foundNext == NULL || found == foundNext ||
+    (found != node && foundNext != node) ||
+    GenTreeIndexSearch(tree, data + 1, foundNext) != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeSetData failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterDepth iter = GenTreeIterDepthCreateStatic(tree);
+  GenTreeIterDepthLazy iterLazy = GenTreeIterDepthLazyCreateStatic(tree);
+  if (GenTreeSearch(tree, data + 25, &iter) != NULL ||
+    GenTreeIterIsLast(&iter) == false ||
+    GenTreeSearch(tree, data + 25, &iterLazy) != NULL ||
+    GenTreeIterIsLast(&iterLazy) == false) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeSearch failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterReset(&iter);
+  GenTreeIterReset(&iterLazy);
+  if (GenTreeSearch(tree, data + 20, &iter) == NULL ||
+    GenTreeSearch(tree, data + 20, &iterLazy) == NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeSearch failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterFreeStatic(&iter);
+  GenTreeIterFreeStatic(&iterLazy);
+  GenTree* cut = GenTreeSubtree(GenTreeSubtree(tree, 0), 3);
+  GenTreeCut(cut);
+  if (GenTreeIndexGetNbNode(tree) != 19 ||
+    GenTreeIsIndexed(cut) == true ||
+    GenTreeIsIndexed(GenTreeSubtree(cut, 0)) == true ||
+    GenTreeIndexSearch(tree, data + 4, NULL) != NULL ||
+    GenTreeIndexSearch(tree, data + 20, NULL) != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeCut failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIndexCreate(cut, NULL);
+  GenTreeAppendSubtree(tree, cut);
+  if (GenTreeIndexGetNbNode(tree) != 22 ||
+    GenTreeIndexSearch(tree, data + 20, NULL) == NULL ||
+    GenTreeIndexGetNbNode(cut) != 22) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeAppendSubtree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  int dataCopy = 7;
+  GenTreeIndexCreate(tree, UnitTestGenTreeIndexKey);
+  if (GenTreeIndexGetNbNode(tree) != 22 ||
+    GenTreeData(GenTreeIndexSearch(tree, &dataCopy, NULL)) != data + 7) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIndexCreate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIndexFree(tree);
+  if (GenTreeIsIndexed(tree) == true ||
+    GenTreeIsIndexed(GenTreeSubtree(tree, 0)) == true) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIndexFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // Searches with the index, checked against the searches through the
+  // iterators before the tree is indexed
+  GenTreeIndexFree(tree);
+  srand(0);
+  for (int iNode = 0; iNode < 200; ++iNode) {
+    int size = GenTreeGetSize(tree);
+    GenTree* parent = 
+      (size > 0 && rand() % 4 != 0 ? GenTreeSelect(tree, rand() % size) :
+      tree);
+    GenTreeAppendData(parent, data + rand() % 5);
+  }
+  GenTree* sub = GenTreeSubtree(tree, 0);
+  GenTree* searched[3][2][250];
+  int nbFound[3][2] = {{0}};
+  for (int iRun = 0; iRun < 2; ++iRun) {
+    if (iRun == 1)
+      GenTreeIndexCreate(tree, NULL);
+    for (int iTree = 0; iTree < 2; ++iTree) {
+      GenTree* t = (iTree == 0 ? tree : sub);
+      GenTreeIterDepth depth = GenTreeIterDepthCreateStatic(t);
+      GenTreeIterBreadth breadth = GenTreeIterBreadthCreateStatic(t);
+      GenTreeIterDepthLazy lazy = GenTreeIterDepthLazyCreateStatic(t);
+      GenTreeIterSeek(&depth, 3);
+      GenTreeIterSeek(&breadth, 3);
+      for (int iStep = 0; iStep < 3; ++iStep)
+        GenTreeIterStep(&lazy);
+      GenTree* node = NULL;
+      int nb[3] = {0};
+      while ((node = GenTreeSearch(t, data + 2, &depth)) != NULL) {
+        if (iRun == 0)
+          searched[0][iTree][nb[0]] = node;
+        else if (searched[0][iTree][nb[0]] != node)
+          nb[0] = -1000;
+        ++(nb[0]);
+        if (GenTreeIterIsLast(&depth))
+          break;
+      }
+      while ((node = GenTreeSearch(t, data + 2, &breadth)) != NULL) {
+        if (iRun == 0)
+          searched[1][iTree][nb[1]] = node;
+        else if (searched[1][iTree][nb[1]] != node)
+          nb[1] = -1000;
+        ++(nb[1]);
+        if (GenTreeIterIsLast(&breadth))
+          break;
+      }
+      while ((node = GenTreeSearch(t, data + 2, &lazy)) != NULL) {
+        if (iRun == 0)
+          searched[2][iTree][nb[2]] = node;
+        else if (searched[2][iTree][nb[2]] != node)
+          nb[2] = -1000;
+        ++(nb[2]);
+        if (GenTreeIterIsLast(&lazy))
+          break;
+      }
+      for (int iIter = 0; iIter < 3; ++iIter) {
+        if (iRun == 0)
+          nbFound[iIter][iTree] = nb[iIter];
+        else if (nbFound[iIter][iTree] != nb[iIter] || 
+          (nb[iIter] == 0 && iTree == 0)) {
+          GenTreeErr->_type = PBErrTypeUnitTestFailed;
+          sprintf(GenTreeErr->_msg, "GenTreeSearch failed");
+          PBErrCatch(GenTreeErr);
+        }
+      }
+      GenTreeIterFreeStatic(&depth);
+      GenTreeIterFreeStatic(&breadth);
+      GenTreeIterFreeStatic(&lazy);
+    }
+  }
+  // Random edits of the indexed tree, checked against a run through 
+  // the tree
+  GenTreeIndexCreate(tree, NULL);
+  srand(0);
+  for (int iEdit = 0; iEdit < 2000; ++iEdit) {
+    int size = GenTreeGetSize(tree);
+    GenTree* node = (size > 0 ? GenTreeSelect(tree, rand() % size) : tree);
+    int op = rand() % 4;
+    if (op == 0 || size < 10) {
+      GenTreeAppendData(node, data + rand() % 30);
+    } else if (op == 1) {
+      GenTreeSetData(node, data + rand() % 30);
+    } else if (op == 2 && GenTreeGetSize(node) < size / 4) {
+      GenTreeFree(&node);
+    } else if (op == 3) {
+      GenTree* parent = GenTreeSelect(tree, rand() % size);
+      GenTree* ancestor = parent;
+      while (ancestor != NULL && ancestor != node)
+        ancestor = GenTreeParent(ancestor);
+      if (ancestor == NULL)
+        GenTreeMoveSubtree(node, parent, 0);
+    }
+    for (int i = 0; i < 30; ++i) {
+      int nbIndexed = 0;
+      for (GenTree* found = GenTreeIndexSearch(tree, data + i, NULL);
+        found != NULL; found = GenTreeIndexSearch(tree, data + i, found))
+        nbIndexed += (GenTreeData(found) == data + i ? 1 : 0);
+      int nbNode = 0;
+      for (int iNode = GenTreeGetSize(tree); iNode--;)
+        nbNode += (GenTreeData(GenTreeSelect(tree, iNode)) == data + i);
+      if (nbIndexed != nbNode || 
+        GenTreeIndexGetNbNode(tree) != GenTreeGetSize(tree)) {
+        GenTreeErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(GenTreeErr->_msg, "GenTreeIndex failed");
+        PBErrCatch(GenTreeErr);
+      }
+    }
+  }
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreeIndex OK\n");
+}
+
+void UnitTestGenTree() {
+  UnitTestGenTreeCreateFree();
+  UnitTestGenTreeGetSet();
+  UnitTestGenTreeCutGetSize();
+  UnitTestGenTreeSearchAppendToNode();
+  UnitTestGenTreeIsLastBrother();
+  UnitTestGenTreeSiblings();
+  UnitTestGenTreeSubtreeArray();
+  UnitTestGenTreeSubtreeSkipList();
+  UnitTestGenTreeSortSubtrees();
+  UnitTestGenTreeBatch();
+  UnitTestGenTreeFromParents();
+  UnitTestGenTreeClone();
+  UnitTestGenTreeMoveGraft();
+  UnitTestGenTreeLink();
+  UnitTestGenTreePool();
+  UnitTestGenTreeArena();
+  UnitTestGenTreeIndex();
+  printf("UnitTestGenTree OK\n");
+}
+
+int dataExampleTree[10] = {0,1,2,3,4,5,6,7,8,9};
+GenTree* GetExampleTree() {
+  GenTree* tree = GenTreeCreate();
+  GenTreeAddSortData(tree, dataExampleTree + 0, 0);
+  GenTreeAddSortData(tree, dataExampleTree + 9, 9);
+  GenTree* subtree = GenTreeSubtree(tree, 0);
+  GenTreeAddSortData(subtree, dataExampleTree + 1, 1);
+  GenTreeAddSortData(subtree, dataExampleTree + 2, 2);
+  subtree = GenTreeSubtree(tree, 1);
+  GenTreeAddSortData(subtree, dataExampleTree + 3, 3);
+  GenTreeAddSortData(subtree, dataExampleTree + 4, 4);
+  subtree = GenTreeSubtree(subtree, 0);
+  GenTreeAddSortData(subtree, dataExampleTree + 8, 8);
+  GenTreeAddSortData(subtree, dataExampleTree + 6, 6);
+  subtree = GenTreeSubtree(subtree, 1);
+  GenTreeAddSortData(subtree, dataExampleTree + 7, 7);
+  GenTreeAddSortData(subtree, dataExampleTree + 5, 5);
+  return tree;
+}
+
+// Set the 'nb' data 'data' to their index, 'dataPtr' to their address
+// and 'parents' to the parents of a random tree mixing deep and wide 
+// subtrees, for GenTreeCreateFromParents, and 'sortVals' to random 
+// sort values if it's not null
+void GetRandomParents(int* const data, void** const dataPtr, 
+  int* const parents, float* const sortVals, const int nb) {
+  for (int iNode = 0; iNode < nb; ++iNode) {
+    data[iNode] = iNode;
+    dataPtr[iNode] = data + iNode;
+    // Mix of deep and wide subtrees
+    parents[iNode] = (iNode == 0 ? -1 : 
+      (iNode % 3 == 0 ? iNode - 1 : rand() % iNode));
+    if (sortVals != NULL)
+      sortVals[iNode] = (float)(rand() % 10);
+  }
+}
+
+void funApply(void* data, void* param) {
+  printf("%d%c", *(int*)data,*(char*)param);
+}
+
+void UnitTestGenTreeIterDepth() {
   GenTree* tree = GetExampleTree();
-  GenTreeIterValue* iter = GenTreeIterValueCreate(tree);
+  GenTreeIterDepth* iter = GenTreeIterDepthCreate(tree);
   if (iter == NULL ||
     iter->_iter._tree != tree ||
-    GSetNbElem(&(iter->_iter._seq)) != 10 ||
-    iter->_iter._curPos != iter->_iter._seq._set._head) {
+    iter->_iter._nbNode != 10 ||
+    iter->_iter._curPos != 0) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterValueCreate failed");
+    sprintf(GenTreeErr->_msg, "GenTreeIterDepthCreate failed");
     PBErrCatch(GenTreeErr);
   }
-  int check[10] = {0,1,2,3,4,5,6,7,8,9};
+  int check[10] = {0,1,2,9,3,6,8,5,7,4};
   int iCheck = 0;
   do {
     int* data = GenTreeIterGetData(iter);
     if (*data != check[iCheck]) {
       GenTreeErr->_type = PBErrTypeUnitTestFailed;
-      sprintf(GenTreeErr->_msg, "GenTreeIterValue failed");
+      sprintf(GenTreeErr->_msg, "GenTreeIterDepth failed");
       PBErrCatch(GenTreeErr);
     }
     ++iCheck;
@@ -512,12 +1310,12 @@ void UnitTestGenTreeIterValue() {
     sprintf(GenTreeErr->_msg, "GenTreeIterFree failed");
     PBErrCatch(GenTreeErr);
   }
-  GenTreeIterValue iterstatic = GenTreeIterValueCreateStatic(tree);
+  GenTreeIterDepth iterstatic = GenTreeIterDepthCreateStatic(tree);
   if (iterstatic._iter._tree != tree ||
-    GSetNbElem(&(iterstatic._iter._seq)) != 10 ||
-    iterstatic._iter._curPos != iterstatic._iter._seq._set._head) {
+    iterstatic._iter._nbNode != 10 ||
+    iterstatic._iter._curPos != 0) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
-    sprintf(GenTreeErr->_msg, "GenTreeIterValueCreateStatic failed");
+    sprintf(GenTreeErr->_msg, "GenTreeIterDepthCreateStatic failed");
     PBErrCatch(GenTreeErr);
   }
   iCheck = 0;
@@ -525,14 +1323,14 @@ void UnitTestGenTreeIterValue() {
     int* data = GenTreeIterGetData(&iterstatic);
     if (*data != check[iCheck]) {
       GenTreeErr->_type = PBErrTypeUnitTestFailed;
-      sprintf(GenTreeErr->_msg, "GenTreeIterValue failed");
+      sprintf(GenTreeErr->_msg, "GenTreeIterDepth failed");
       PBErrCatch(GenTreeErr);
     }
     ++iCheck;
   } while (GenTreeIterStep(&iterstatic));
-  check[9] = 12;
+  check[3] = 12;
   dataExampleTree[9] = 12;
-  GenTreeIterValueUpdate(&iterstatic);
+  GenTreeIterDepthUpdate(&iterstatic);
   iCheck = 0;
   do {
     int* data = GenTreeIterGetData(&iterstatic);
@@ -545,7 +1343,7 @@ void UnitTestGenTreeIterValue() {
   } while (GenTreeIterStep(&iterstatic));
   dataExampleTree[9] = 9;
   GenTreeIterReset(&iterstatic);
-  if (iterstatic._iter._curPos != iterstatic._iter._seq._set._head) {
+  if (iterstatic._iter._curPos != 0) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
     sprintf(GenTreeErr->_msg, "GenTreeIterReset failed");
     PBErrCatch(GenTreeErr);
@@ -566,7 +1364,7 @@ void UnitTestGenTreeIterValue() {
     PBErrCatch(GenTreeErr);
   }
   GenTreeIterToEnd(&iterstatic);
-  if (iterstatic._iter._curPos != iterstatic._iter._seq._set._tail) {
+  if (iterstatic._iter._curPos != iterstatic._iter._nbNode - 1) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
     sprintf(GenTreeErr->_msg, "GenTreeIterToEnd failed");
     PBErrCatch(GenTreeErr);
@@ -582,8 +1380,7 @@ void UnitTestGenTreeIterValue() {
     PBErrCatch(GenTreeErr);
   }
   GenTreeIterStepBack(&iterstatic);
-  if (iterstatic._iter._curPos->_next != 
-    iterstatic._iter._seq._set._tail) {
+  if (iterstatic._iter._curPos != iterstatic._iter._nbNode - 2) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
     sprintf(GenTreeErr->_msg, "GenTreeIterStepBack failed");
     PBErrCatch(GenTreeErr);
@@ -593,7 +1390,7 @@ void UnitTestGenTreeIterValue() {
     sprintf(GenTreeErr->_msg, "GenTreeIterGenTree failed");
     PBErrCatch(GenTreeErr);
   }
-  if (GenTreeIterSeq(&iterstatic) != &(iterstatic._iter._seq)) {
+  if (GenTreeIterSeq(&iterstatic) != iterstatic._iter._seq) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
     sprintf(GenTreeErr->_msg, "GenTreeIterSeq failed");
     PBErrCatch(GenTreeErr);
@@ -604,7 +1401,7 @@ void UnitTestGenTreeIterValue() {
   GenTree* treeB = GenTreeCreate();
   GenTreeIterSetGenTree(&iterstatic, treeB);
   if (GenTreeIterGenTree(&iterstatic) != treeB ||
-    GSetNbElem(&(iterstatic._iter._seq)) != 0) {
+    iterstatic._iter._nbNode != 0) {
     GenTreeErr->_type = PBErrTypeUnitTestFailed;
     sprintf(GenTreeErr->_msg, "GenTreeIterSetGenTree failed");
     PBErrCatch(GenTreeErr);
@@ -612,19 +1409,1679 @@ void UnitTestGenTreeIterValue() {
   GenTreeIterFreeStatic(&iterstatic);
   GenTreeFree(&tree);
   GenTreeFree(&treeB);
-  printf("UnitTestGenTreeIterValue OK\n");
+  printf("UnitTestGenTreeIterDepth OK\n");
 }
 
-void UnitTestGenTreeIter() {
-  UnitTestGenTreeIterDepth();
-  UnitTestGenTreeIterBreadth();
-  UnitTestGenTreeIterValue();
-  printf("UnitTestGenTreeIter OK\n");
+void UnitTestGenTreeIterBreadth() {
+  GenTree* tree = GetExampleTree();
+  GenTreeIterBreadth* iter = GenTreeIterBreadthCreate(tree);
+  if (iter == NULL ||
+    iter->_iter._tree != tree ||
+    iter->_iter._nbNode != 10 ||
+    iter->_iter._curPos != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterBreadthCreate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  int check[10] = {0,9,1,2,3,4,6,8,5,7};
+  int iCheck = 0;
+  do {
+    int* data = GenTreeIterGetData(iter);
+    if (*data != check[iCheck]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterBreadth failed");
+      PBErrCatch(GenTreeErr);
+    }
+    ++iCheck;
+  } while (GenTreeIterStep(iter));
+  int checkSub[7] = {9,3,4,6,8,5,7};
+  GenTreeIterSetGenTree(iter, GenTreeSubtree(tree, 1));
+  iCheck = 0;
+  do {
+    int* data = GenTreeIterGetData(iter);
+    if (iCheck >= 7 || *data != checkSub[iCheck]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterBreadth failed");
+      PBErrCatch(GenTreeErr);
+    }
+    ++iCheck;
+  } while (GenTreeIterStep(iter));
+  GenTreeIterFree(&iter);
+  if (iter != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterBreadth iterstatic = GenTreeIterBreadthCreateStatic(tree);
+  if (iterstatic._iter._tree != tree ||
+    iterstatic._iter._nbNode != 10 ||
+    iterstatic._iter._curPos != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterBreadthCreateStatic failed");
+    PBErrCatch(GenTreeErr);
+  }
+  iCheck = 0;
+  do {
+    int* data = GenTreeIterGetData(&iterstatic);
+    if (*data != check[iCheck]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterBreadth failed");
+      PBErrCatch(GenTreeErr);
+    }
+    ++iCheck;
+  } while (GenTreeIterStep(&iterstatic));
+  check[1] = 12;
+  dataExampleTree[9] = 12;
+  GenTreeIterBreadthUpdate(&iterstatic);
+  iCheck = 0;
+  do {
+    int* data = GenTreeIterGetData(&iterstatic);
+    if (*data != check[iCheck]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterUpdate failed");
+      PBErrCatch(GenTreeErr);
+    }
+    ++iCheck;
+  } while (GenTreeIterStep(&iterstatic));
+  dataExampleTree[9] = 9;
+  GenTreeIterReset(&iterstatic);
+  if (iterstatic._iter._curPos != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterReset failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterIsFirst(&iterstatic) == false) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsFirst failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterIsLast(&iterstatic) == true) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsLast failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterGetGenTree(&iterstatic) != GenTreeSubtree(tree, 0)) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterGetGenTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterToEnd(&iterstatic);
+  if (iterstatic._iter._curPos != iterstatic._iter._nbNode - 1) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterToEnd failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterIsFirst(&iterstatic) == true) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsFirst failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterIsLast(&iterstatic) == false) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsLast failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterStepBack(&iterstatic);
+  if (iterstatic._iter._curPos != iterstatic._iter._nbNode - 2) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterStepBack failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterGenTree(&iterstatic) != tree) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterGenTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterSeq(&iterstatic) != iterstatic._iter._seq) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterSeq failed");
+    PBErrCatch(GenTreeErr);
+  }
+  char c = ',';
+  GenTreeIterApply(&iterstatic, &funApply, &c);
+  printf("\n");
+  GenTree* treeB = GenTreeCreate();
+  GenTreeIterSetGenTree(&iterstatic, treeB);
+  if (GenTreeIterGenTree(&iterstatic) != treeB ||
+    iterstatic._iter._nbNode != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterSetGenTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterFreeStatic(&iterstatic);
+  GenTreeFree(&tree);
+  GenTreeFree(&treeB);
+  printf("UnitTestGenTreeIterBreadth OK\n");
+}
+
+void UnitTestGenTreeIterValue() {
+  GenTree* tree = GetExampleTree();
+  GenTreeIterValue* iter = GenTreeIterValueCreate(tree);
+  if (iter == NULL ||
+    iter->_iter._tree != tree ||
+    iter->_iter._nbNode != 10 ||
+    iter->_iter._curPos != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterValueCreate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  int check[10] = {0,1,2,3,4,5,6,7,8,9};
+  int iCheck = 0;
+  do {
+    int* data = GenTreeIterGetData(iter);
+    if (*data != check[iCheck]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterValue failed");
+      PBErrCatch(GenTreeErr);
+    }
+    ++iCheck;
+  } while (GenTreeIterStep(iter));
+  GenTreeIterFree(&iter);
+  if (iter != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterValue iterstatic = GenTreeIterValueCreateStatic(tree);
+  if (iterstatic._iter._tree != tree ||
+    iterstatic._iter._nbNode != 10 ||
+    iterstatic._iter._curPos != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterValueCreateStatic failed");
+    PBErrCatch(GenTreeErr);
+  }
+  iCheck = 0;
+  do {
+    int* data = GenTreeIterGetData(&iterstatic);
+    if (*data != check[iCheck]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterValue failed");
+      PBErrCatch(GenTreeErr);
+    }
+    ++iCheck;
+  } while (GenTreeIterStep(&iterstatic));
+  check[9] = 12;
+  dataExampleTree[9] = 12;
+  GenTreeIterValueUpdate(&iterstatic);
+  iCheck = 0;
+  do {
+    int* data = GenTreeIterGetData(&iterstatic);
+    if (*data != check[iCheck]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterUpdate failed");
+      PBErrCatch(GenTreeErr);
+    }
+    ++iCheck;
+  } while (GenTreeIterStep(&iterstatic));
+  dataExampleTree[9] = 9;
+  GenTreeIterReset(&iterstatic);
+  if (iterstatic._iter._curPos != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterReset failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterIsFirst(&iterstatic) == false) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsFirst failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterIsLast(&iterstatic) == true) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsLast failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterGetGenTree(&iterstatic) != GenTreeSubtree(tree, 0)) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterGetGenTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterToEnd(&iterstatic);
+  if (iterstatic._iter._curPos != iterstatic._iter._nbNode - 1) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterToEnd failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterIsFirst(&iterstatic) == true) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsFirst failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterIsLast(&iterstatic) == false) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsLast failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterStepBack(&iterstatic);
+  if (iterstatic._iter._curPos != iterstatic._iter._nbNode - 2) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterStepBack failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterGenTree(&iterstatic) != tree) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterGenTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterSeq(&iterstatic) != iterstatic._iter._seq) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterSeq failed");
+    PBErrCatch(GenTreeErr);
+  }
+  char c = ',';
+  GenTreeIterApply(&iterstatic, &funApply, &c);
+  printf("\n");
+  GenTree* treeB = GenTreeCreate();
+  GenTreeIterSetGenTree(&iterstatic, treeB);
+  if (GenTreeIterGenTree(&iterstatic) != treeB ||
+    iterstatic._iter._nbNode != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterSetGenTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeAddSortData(treeB, dataExampleTree + 5, 5);
+  GenTreeAddSortData(treeB, dataExampleTree + 1, 1);
+  GenTreeAddSortData(GenTreeSubtree(treeB, 1), dataExampleTree + 3, 1);
+  GenTreeIterValueUpdateFirst(&iterstatic, 2);
+  if (iterstatic._iter._nbNode != 2 ||
+    *(int*)GenTreeIterGetData(&iterstatic) != 1 ||
+    GenTreeIterStep(&iterstatic) == false ||
+    *(int*)GenTreeIterGetData(&iterstatic) != 3 ||
+    GenTreeIterStep(&iterstatic) == true) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterValueUpdateFirst failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterValueUpdateFirst(&iterstatic, 10);
+  if (iterstatic._iter._nbNode != 3 ||
+    *(int*)GenTreeData(iterstatic._iter._seq[2]) != 5) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterValueUpdateFirst failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterFreeStatic(&iterstatic);
+  GenTreeFree(&tree);
+  GenTreeFree(&treeB);
+  printf("UnitTestGenTreeIterValue OK\n");
+}
+
+void UnitTestGenTreeIterDepthLazy() {
+  GenTree* tree = GetExampleTree();
+  GenTreeIterDepthLazy* iter = GenTreeIterDepthLazyCreate(tree);
+  int extra = 10;
+  if (iter == NULL ||
+    iter->_tree != tree ||
+    iter->_curNode != GenTreeSubtree(tree, 0)) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterDepthLazyCreate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  int check[10] = {0,1,2,9,3,6,8,5,7,4};
+  int iCheck = 0;
+  do {
+    int* data = GenTreeIterGetData(iter);
+    if (*data != check[iCheck]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterDepthLazy failed");
+      PBErrCatch(GenTreeErr);
+    }
+    ++iCheck;
+  } while (GenTreeIterStep(iter));
+  if (iCheck != 10) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterDepthLazy failed");
+    PBErrCatch(GenTreeErr);
+  }
+  do {
+    --iCheck;
+    int* data = GenTreeIterGetData(iter);
+    if (*data != check[iCheck]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterStepBack failed");
+      PBErrCatch(GenTreeErr);
+    }
+  } while (GenTreeIterStepBack(iter));
+  if (iCheck != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterStepBack failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterFree(&iter);
+  if (iter != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterDepthLazy iterstatic = GenTreeIterDepthLazyCreateStatic(tree);
+  if (iterstatic._tree != tree ||
+    iterstatic._curNode != GenTreeSubtree(tree, 0)) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterDepthLazyCreateStatic failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterIsFirst(&iterstatic) == false) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsFirst failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterIsLast(&iterstatic) == true) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsLast failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // The iterator sees the modifications of the tree without update
+  GenTreeIterStep(&iterstatic);
+  GenTreeAppendData(GenTreeIterGetGenTree(&iterstatic), 
+    &extra);
+  GenTreeIterStep(&iterstatic);
+  if (*(int*)GenTreeIterGetData(&iterstatic) != 10) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterDepthLazy failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTree* node = GenTreeIterGetGenTree(&iterstatic);
+  GenTreeIterStep(&iterstatic);
+  GenTreeFree(&node);
+  if (*(int*)GenTreeIterGetData(&iterstatic) != 2) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterDepthLazy failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterReset(&iterstatic);
+  node = GenTreeSearch(tree, dataExampleTree + 6, &iterstatic);
+  if (node == NULL || *(int*)GenTreeData(node) != 6 ||
+    *(int*)GenTreeIterGetData(&iterstatic) != 8) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeSearch failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeSearch(tree, dataExampleTree + 6, &iterstatic) != NULL ||
+    GenTreeIterIsLast(&iterstatic) == false) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeSearch failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterReset(&iterstatic);
+  if (GenTreeAppendToNode(tree, &extra, 
+    dataExampleTree + 4, &iterstatic) == false ||
+    *(int*)GenTreeIterGetData(&iterstatic) != 4 ||
+    GenTreeIterIsLast(&iterstatic) == true) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeAppendToNode failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterStep(&iterstatic);
+  node = GenTreeIterGetGenTree(&iterstatic);
+  GenTreeFree(&node);
+  GenTreeIterToEnd(&iterstatic);
+  if (*(int*)GenTreeIterGetData(&iterstatic) != 4 ||
+    GenTreeIterIsFirst(&iterstatic) == true ||
+    GenTreeIterIsLast(&iterstatic) == false) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterToEnd failed");
+    PBErrCatch(GenTreeErr);
+  }
+  if (GenTreeIterGenTree(&iterstatic) != tree) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterGenTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  char c = ',';
+  GenTreeIterApply(&iterstatic, &funApply, &c);
+  printf("\n");
+  GenTree* treeB = GenTreeCreate();
+  GenTreeIterSetGenTree(&iterstatic, treeB);
+  if (GenTreeIterGenTree(&iterstatic) != treeB ||
+    iterstatic._curNode != NULL ||
+    GenTreeIterIsFirst(&iterstatic) == false ||
+    GenTreeIterIsLast(&iterstatic) == false ||
+    GenTreeSearch(treeB, dataExampleTree, &iterstatic) != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterSetGenTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // On a subtree, the node sequence includes the subtree itself like 
+  // the one of GenTreeIterDepth
+  for (int iNode = 0; iNode < GenTreeGetSize(tree); ++iNode) {
+    GenTree* subtree = GenTreeSelect(tree, iNode);
+    GenTreeIterDepth iterSeq = GenTreeIterDepthCreateStatic(subtree);
+    GenTreeIterSetGenTree(&iterstatic, subtree);
+    if (GenTreeIterGetGenTree(&iterstatic) != subtree ||
+      GenTreeSearch(subtree, GenTreeData(subtree), &iterstatic) != 
+        subtree) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterDepthLazy failed");
+      PBErrCatch(GenTreeErr);
+    }
+    GenTreeIterReset(&iterstatic);
+    bool stepLazy = true;
+    bool stepSeq = true;
+    do {
+      if (GenTreeIterGetGenTree(&iterstatic) != 
+        GenTreeIterGetGenTree(&iterSeq)) {
+        GenTreeErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(GenTreeErr->_msg, "GenTreeIterStep failed");
+        PBErrCatch(GenTreeErr);
+      }
+      stepLazy = GenTreeIterStep(&iterstatic);
+      stepSeq = GenTreeIterStep(&iterSeq);
+    } while (stepLazy && stepSeq);
+    if (stepLazy != stepSeq ||
+      GenTreeIterIsLast(&iterstatic) == false) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterStep failed");
+      PBErrCatch(GenTreeErr);
+    }
+    GenTreeIterToEnd(&iterstatic);
+    GenTreeIterToEnd(&iterSeq);
+    do {
+      if (GenTreeIterGetGenTree(&iterstatic) != 
+        GenTreeIterGetGenTree(&iterSeq)) {
+        GenTreeErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(GenTreeErr->_msg, "GenTreeIterStepBack failed");
+        PBErrCatch(GenTreeErr);
+      }
+      stepLazy = GenTreeIterStepBack(&iterstatic);
+      stepSeq = GenTreeIterStepBack(&iterSeq);
+    } while (stepLazy && stepSeq);
+    if (stepLazy != stepSeq ||
+      GenTreeIterIsFirst(&iterstatic) == false) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterStepBack failed");
+      PBErrCatch(GenTreeErr);
+    }
+    GenTreeIterFreeStatic(&iterSeq);
+  }
+  GenTreeIterFreeStatic(&iterstatic);
+  GenTreeFree(&tree);
+  GenTreeFree(&treeB);
+  printf("UnitTestGenTreeIterDepthLazy OK\n");
+}
+
+// Return true if the iterators 'iter' and 'ref' have the same sequence
+bool IsSameIterSeq(const GenTreeIter* const iter, 
+  const GenTreeIter* const ref) {
+  bool isSame = (iter->_nbNode == ref->_nbNode);
+  for (int iNode = 0; isSame && iNode < ref->_nbNode; ++iNode)
+    isSame = (iter->_seq[iNode] == ref->_seq[iNode]);
+  return isSame;
+}
+
+// Return true if the sequence of the iterator 'iter' is the one of a
+// new iterator of the same kind on the GenTree 'tree'
+bool IsSameIterDepth(const GenTreeIterDepth* const iter, 
+  GenTree* const tree) {
+  GenTreeIterDepth ref = GenTreeIterDepthCreateStatic(tree);
+  bool isSame = IsSameIterSeq(&(iter->_iter), &(ref._iter));
+  GenTreeIterFreeStatic(&ref);
+  return isSame;
+}
+
+bool IsSameIterBreadth(const GenTreeIterBreadth* const iter, 
+  GenTree* const tree) {
+  GenTreeIterBreadth ref = GenTreeIterBreadthCreateStatic(tree);
+  bool isSame = IsSameIterSeq(&(iter->_iter), &(ref._iter));
+  GenTreeIterFreeStatic(&ref);
+  return isSame;
+}
+
+bool IsSameIterValue(const GenTreeIterValue* const iter, 
+  GenTree* const tree) {
+  GenTreeIterValue ref = GenTreeIterValueCreateStatic(tree);
+  bool isSame = IsSameIterSeq(&(iter->_iter), &(ref._iter));
+  GenTreeIterFreeStatic(&ref);
+  return isSame;
+}
+
+void UnitTestGenTreeIterUpdate() {
+  GenTree* tree = GetExampleTree();
+  unsigned long gen = GenTreeGen(tree);
+  GenTreeIterDepth iter = GenTreeIterDepthCreateStatic(tree);
+  GenTreeIterBreadth iterB = GenTreeIterBreadthCreateStatic(tree);
+  if (GenTreeIterIsStale(&iter) == true ||
+    GenTreeIterIsStale(&iterB) == true) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsStale failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTree** seq = iter._iter._seq;
+  GenTree* head = seq[0];
+  GenTreeIterStep(&iter);
+  GenTreeIterUpdate(&iter);
+  if (iter._iter._seq != seq || seq[0] != head ||
+    iter._iter._curPos != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterUpdate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTree* subtree = GenTreeSubtree(GenTreeSubtree(tree, 1), 0);
+  unsigned long genSub = GenTreeGen(subtree);
+  unsigned long genBrother = GenTreeGen(GenTreeSubtree(tree, 0));
+  int data = 10;
+  GenTreeAppendData(subtree, &data);
+  if (GenTreeGen(tree) == gen ||
+    GenTreeGen(subtree) == genSub ||
+    GenTreeGen(GenTreeSubtree(tree, 0)) != genBrother ||
+    GenTreeIterIsStale(&iter) == false ||
+    GenTreeIterIsStale(&iterB) == false) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsStale failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterUpdate(&iter);
+  if (GenTreeIterIsStale(&iter) == true ||
+    GenTreeIterGetNbNode(&iter) != 11 ||
+    GenTreeIterIsStale(&iterB) == false) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterUpdate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTree* leaf = GenTreeLastSubtree(subtree);
+  GenTreeCut(leaf);
+  if (GenTreeIterIsStale(&iter) == false) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterIsStale failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterUpdate(&iter);
+  GenTreeIterUpdate(&iterB);
+  if (GenTreeIterIsStale(&iter) == true ||
+    GenTreeIterGetNbNode(&iter) != 10 ||
+    GenTreeIterIsStale(&iterB) == true ||
+    GenTreeIterGetNbNode(&iterB) != 10) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterUpdate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterSetGenTree(&iter, leaf);
+  if (GenTreeIterIsStale(&iter) == true ||
+    GenTreeIterGetNbNode(&iter) != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterSetGenTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterFreeStatic(&iter);
+  GenTreeIterFreeStatic(&iterB);
+  GenTreeFree(&leaf);
+  GenTreeFree(&tree);
+  // Sequences patched with the edits of the tree, compared to the ones
+  // of new iterators, for iterators attached to the root and to one of
+  // its subtrees, with rounds of edits overflowing the edit log and 
+  // modifications not memorized in the log
+  srand(0);
+  tree = GenTreeCreate();
+  GenTreeAppendData(tree, &data);
+  GenTree* sub = GenTreeSubtree(tree, 0);
+  void* batch[3] = {&data, &data, &data};
+  GenTreeIterDepth iterP = GenTreeIterDepthCreateStatic(tree);
+  GenTreeIterBreadth iterPB = GenTreeIterBreadthCreateStatic(tree);
+  GenTreeIterValue iterPV = GenTreeIterValueCreateStatic(tree);
+  GenTreeIterDepth iterS = GenTreeIterDepthCreateStatic(sub);
+  GenTreeIterBreadth iterSB = GenTreeIterBreadthCreateStatic(sub);
+  GenTreeIterValue iterSV = GenTreeIterValueCreateStatic(sub);
+  for (int iRound = 0; iRound < 200; ++iRound) {
+    int nbEdit = (iRound % 20 == 19 ? GENTREEEDITLOG_NBEDIT + 10 : 
+      1 + rand() % 4);
+    for (int iEdit = 0; iEdit < nbEdit; ++iEdit) {
+      int size = GenTreeGetSize(tree);
+      GenTree* node = (rand() % 4 != 0 ? 
+        GenTreeSelect(tree, rand() % size) : tree);
+      GenTree* ancestor = sub;
+      while (ancestor != NULL && ancestor != node)
+        ancestor = GenTreeParent(ancestor);
+      int op = rand() % 7;
+      if (op == 0 || size < 10) {
+        GenTreeAppendData(node, &data);
+      } else if (op == 1) {
+        GenTreeAppendSortData(node, &data, (float)(rand() % 4));
+      } else if (op == 2) {
+        GenTreePushData(node, &data);
+      } else if (op == 3 && ancestor == NULL) {
+        GenTreeFree(&node);
+      } else if (op == 4) {
+        GenTreeAppendDataBatch(node, batch, 3);
+      } else if (op == 5 && node != tree) {
+        GenTree* parent = GenTreeSelect(tree, rand() % size);
+        ancestor = parent;
+        while (ancestor != NULL && ancestor != node)
+          ancestor = GenTreeParent(ancestor);
+        if (ancestor == NULL)
+          GenTreeMoveSubtree(node, parent, 0);
+      }
+    }
+    if (iRound % 50 == 49)
+      GenTreeGraftChildren(GenTreeSelect(tree, 0), tree);
+    GenTreeIterUpdate(&iterP);
+    GenTreeIterUpdate(&iterPB);
+    GenTreeIterUpdate(&iterPV);
+    GenTreeIterUpdate(&iterS);
+    GenTreeIterUpdate(&iterSB);
+    GenTreeIterUpdate(&iterSV);
+    if (!IsSameIterDepth(&iterP, tree) || 
+      !IsSameIterBreadth(&iterPB, tree) ||
+      !IsSameIterValue(&iterPV, tree) || 
+      !IsSameIterDepth(&iterS, sub) ||
+      !IsSameIterBreadth(&iterSB, sub) || 
+      !IsSameIterValue(&iterSV, sub)) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterUpdate failed");
+      PBErrCatch(GenTreeErr);
+    }
+  }
+  if (tree->_extra == NULL || tree->_extra->_editLog == NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterUpdate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // The log is released when the iterators can't be patched anymore
+  for (int iEdit = 0; iEdit <= GENTREEEDITLOG_NBEDIT; ++iEdit)
+    GenTreeAppendData(sub, &data);
+  if (tree->_extra->_editLog != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterUpdate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterUpdate(&iterSV);
+  if (!IsSameIterValue(&iterSV, sub) || 
+    tree->_extra->_editLog == NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterUpdate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterFreeStatic(&iterP);
+  GenTreeIterFreeStatic(&iterPB);
+  GenTreeIterFreeStatic(&iterPV);
+  GenTreeIterFreeStatic(&iterS);
+  GenTreeIterFreeStatic(&iterSB);
+  GenTreeIterFreeStatic(&iterSV);
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreeIterUpdate OK\n");
+}
+
+void UnitTestGenTreeIterSeekBuffer() {
+  GenTree* tree = GetExampleTree();
+  GenTree* buffer[16];
+  GenTreeIterDepth iter = 
+    GenTreeIterDepthCreateStaticBuffer(tree, buffer, 16);
+  if (iter._iter._seq != buffer ||
+    iter._iter._isUserBuffer == false ||
+    GenTreeIterGetNbNode(&iter) != 10 ||
+    buffer[3] != GenTreeSubtree(tree, 1)) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterDepthCreateStaticBuffer failed");
+    PBErrCatch(GenTreeErr);
+  }
+  int check[10] = {0,1,2,9,3,6,8,5,7,4};
+  for (int iPos = 10; iPos--;) {
+    GenTreeIterSeek(&iter, iPos);
+    if (GenTreeIterGetPos(&iter) != iPos ||
+      *(int*)GenTreeIterGetData(&iter) != check[iPos]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeIterSeek failed");
+      PBErrCatch(GenTreeErr);
+    }
+  }
+  GenTreeIterFreeStatic(&iter);
+  GenTreeIterBreadth iterB = 
+    GenTreeIterBreadthCreateStaticBuffer(tree, buffer, 4);
+  if (iterB._iter._seq == buffer ||
+    iterB._iter._isUserBuffer == true ||
+    GenTreeIterGetNbNode(&iterB) != 10 ||
+    buffer[1] != GenTreeSubtree(tree, 1) ||
+    *(int*)GenTreeData(GenTreeIterSeq(&iterB)[9]) != 7) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, 
+      "GenTreeIterBreadthCreateStaticBuffer failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterFreeStatic(&iterB);
+  GenTreeIterValue iterV = GenTreeIterValueCreateStaticBuffer(tree, 
+    buffer, 16);
+  GenTreeIterSeek(&iterV, 4);
+  if (*(int*)GenTreeIterGetData(&iterV) != 4 ||
+    GenTreeIterStepBack(&iterV) == false ||
+    *(int*)GenTreeIterGetData(&iterV) != 3) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeIterSeek failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterFreeStatic(&iterV);
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreeIterSeekBuffer OK\n");
+}
+
+void UnitTestGenTreeSelectRank() {
+  GenTree* tree = GetExampleTree();
+  GenTreeIterDepth iter = GenTreeIterDepthCreateStatic(tree);
+  int iNode = 0;
+  do {
+    GenTree* node = GenTreeIterGetGenTree(&iter);
+    if (GenTreeSelect(tree, iNode) != node ||
+      GenTreeRank(tree, node) != iNode) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeSelect failed");
+      PBErrCatch(GenTreeErr);
+    }
+    ++iNode;
+  } while (GenTreeIterStep(&iter));
+  GenTree* subtree = GenTreeSubtree(tree, 1);
+  if (iNode != GenTreeGetSize(tree) ||
+    GenTreeSelect(tree, -1) != NULL ||
+    GenTreeSelect(tree, iNode) != NULL ||
+    GenTreeSelect(subtree, 0) != GenTreeSubtree(subtree, 0) ||
+    GenTreeData(GenTreeSelect(subtree, 2)) != dataExampleTree + 8 ||
+    GenTreeRank(subtree, GenTreeSelect(subtree, 5)) != 5) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeSelect failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterFreeStatic(&iter);
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreeSelectRank OK\n");
+}
+
+void UnitTestGenTreeIter() {
+  UnitTestGenTreeIterDepth();
+  UnitTestGenTreeIterBreadth();
+  UnitTestGenTreeIterValue();
+  UnitTestGenTreeIterDepthLazy();
+  UnitTestGenTreeIterUpdate();
+  UnitTestGenTreeIterSeekBuffer();
+  UnitTestGenTreeSelectRank();
+  printf("UnitTestGenTreeIter OK\n");
+}
+
+void UnitTestGenTreeFrozenFreezeThaw() {
+  GenTree* tree = GetExampleTree();
+  GenTreeFrozen* frozen = GenTreeFreeze(tree);
+  if (frozen == NULL ||
+    GenTreeFrozenGetNbNode(frozen) != 11 ||
+    GenTreeFrozenData(frozen, 0) != NULL ||
+    GenTreeFrozenParent(frozen, 0) != -1 ||
+    GenTreeFrozenGetSize(frozen, 0) != 10) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeFreeze failed");
+    PBErrCatch(GenTreeErr);
+  }
+  int checkDepth[10] = {0,1,2,9,3,6,8,5,7,4};
+  int checkBreadth[10] = {0,9,1,2,3,4,6,8,5,7};
+  int checkValue[10] = {0,1,2,3,4,5,6,7,8,9};
+  for (int iStep = 0; iStep < 10; ++iStep) {
+    if (*(int*)GenTreeFrozenData(frozen, 
+      GenTreeFrozenDepth(frozen, iStep)) != checkDepth[iStep] ||
+      *(int*)GenTreeFrozenData(frozen, 
+      GenTreeFrozenBreadth(frozen, iStep)) != checkBreadth[iStep] ||
+      *(int*)GenTreeFrozenData(frozen, 
+      GenTreeFrozenValue(frozen, iStep)) != checkValue[iStep]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeFreeze failed");
+      PBErrCatch(GenTreeErr);
+    }
+  }
+  // Node 4 contains 9, its subtrees are 3 and 4, and 3 has 6 and 8
+  int iNine = GenTreeFrozenSearch(frozen, dataExampleTree + 9, 0);
+  int iThree = GenTreeFrozenSearch(frozen, dataExampleTree + 3, 0);
+  if (iNine != 4 ||
+    GenTreeFrozenSearch(frozen, dataExampleTree + 9, iNine + 1) != -1 ||
+    GenTreeFrozenParent(frozen, iNine) != 0 ||
+    GenTreeFrozenGetSize(frozen, iNine) != 6 ||
+    GenTreeFrozenNbSubtree(frozen, iNine) != 2 ||
+    GenTreeFrozenSubtree(frozen, iNine, 0) != iThree ||
+    *(int*)GenTreeFrozenData(frozen, 
+      GenTreeFrozenSubtree(frozen, iNine, 1)) != 4 ||
+    GenTreeFrozenNbSubtree(frozen, iThree) != 2 ||
+    GenTreeFrozenParent(frozen, iThree) != iNine ||
+    fabs(GenTreeFrozenSortVal(frozen, iThree) - 3.0) > 1e-6) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeFrozen failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTree* thawed = GenTreeFrozenThaw(frozen, NULL);
+  GenTreeIterValue iter = GenTreeIterValueCreateStatic(thawed);
+  int iCheck = 0;
+  do {
+    int* data = GenTreeIterGetData(&iter);
+    if (*data != checkValue[iCheck]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeFrozenThaw failed");
+      PBErrCatch(GenTreeErr);
+    }
+    ++iCheck;
+  } while (GenTreeIterStep(&iter));
+  if (iCheck != 10 ||
+    GenTreeGetSize(thawed) != 10) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeFrozenThaw failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeIterFreeStatic(&iter);
+  GenTreeFree(&thawed);
+  GenTreeFrozenFree(&frozen);
+  if (frozen != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeFrozenFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreeFrozenFreezeThaw OK\n");
+}
+
+void UnitTestGenTreeFrozen() {
+  UnitTestGenTreeFrozenFreezeThaw();
+  printf("UnitTestGenTreeFrozen OK\n");
+}
+
+void UnitTestGenTreeThreadPoolCreateFree() {
+  GenTreeThreadPool* pool = GenTreeThreadPoolCreate(3);
+  if (pool == NULL || GenTreeThreadPoolGetNbThread(pool) != 3) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeThreadPoolCreate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeThreadPoolFree(&pool);
+  if (pool != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeThreadPoolFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  pool = GenTreeThreadPoolCreate(0);
+  if (GenTreeThreadPoolGetNbThread(pool) < 1) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeThreadPoolCreate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeThreadPoolFree(&pool);
+  printf("UnitTestGenTreeThreadPoolCreateFree OK\n");
+}
+
+// Parameters of funParallelApply
+typedef struct ParallelApplyParam {
+  // Number of nodes processed so far
+  atomic_int nbNode;
+  // Rank of processing of the nodes
+  int* rank;
+} ParallelApplyParam;
+
+void funParallelApply(void* data, void* param) {
+  ParallelApplyParam* p = param;
+  p->rank[*(int*)data] = atomic_fetch_add(&(p->nbNode), 1);
+}
+
+// Apply funParallelApply to the tree 'param' with the shared pool 
+// from the tasks of a call using it
+void funParallelApplyNested(void* data, void* param) {
+  (void)data;
+  int rank[2] = {-1, -1};
+  ParallelApplyParam p;
+  atomic_init(&(p.nbNode), 0);
+  p.rank = rank;
+  GenTreeParallelApply((GenTree*)param, funParallelApply, &p, NULL, 
+    GenTreeApplyOrderTopDown);
+  if (atomic_load(&(p.nbNode)) != 1 || rank[1] != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeParallelApply failed");
+    PBErrCatch(GenTreeErr);
+  }
+}
+
+#define PARALLELAPPLY_NBNODE 5000
+void UnitTestGenTreeParallelApply() {
+  srand(0);
+  int data[PARALLELAPPLY_NBNODE];
+  void* dataPtr[PARALLELAPPLY_NBNODE];
+  int parents[PARALLELAPPLY_NBNODE];
+  int rank[PARALLELAPPLY_NBNODE];
+  GetRandomParents(data, dataPtr, parents, NULL, PARALLELAPPLY_NBNODE);
+  GenTree* tree = GenTreeCreateFromParents(dataPtr, parents, NULL, 
+    PARALLELAPPLY_NBNODE);
+  GenTreeThreadPool* pool = GenTreeThreadPoolCreate(4);
+  GenTreeApplyOrder orders[2] = 
+    {GenTreeApplyOrderTopDown, GenTreeApplyOrderBottomUp};
+  for (int iRun = 0; iRun < 4; ++iRun) {
+    GenTreeApplyOrder order = orders[iRun % 2];
+    ParallelApplyParam param;
+    atomic_init(&(param.nbNode), 0);
+    param.rank = rank;
+    for (int iNode = 0; iNode < PARALLELAPPLY_NBNODE; ++iNode)
+      rank[iNode] = -1;
+    GenTreeParallelApply(tree, funParallelApply, &param, 
+      (iRun < 2 ? pool : NULL), order);
+    if (atomic_load(&(param.nbNode)) != PARALLELAPPLY_NBNODE - 1 ||
+      rank[0] != -1) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeParallelApply failed");
+      PBErrCatch(GenTreeErr);
+    }
+    for (int iNode = 1; iNode < PARALLELAPPLY_NBNODE; ++iNode) {
+      int iParent = parents[iNode];
+      if (rank[iNode] < 0 || (iParent != 0 && 
+        (order == GenTreeApplyOrderTopDown ? 
+          rank[iParent] > rank[iNode] : rank[iParent] < rank[iNode]))) {
+        GenTreeErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(GenTreeErr->_msg, "GenTreeParallelApply failed");
+        PBErrCatch(GenTreeErr);
+      }
+    }
+  }
+  GenTreeThreadPoolFree(&pool);
+  GenTreeFree(&tree);
+  // Parallel functions called with a null pool while the shared pool
+  // is in use
+  tree = GenTreeCreate();
+  GenTree* inner = GenTreeCreate();
+  GenTreeAppendData(inner, data + 1);
+  for (int iNode = 0; iNode < 4; ++iNode)
+    GenTreeAppendData(tree, data + iNode);
+  GenTreeParallelApply(tree, funParallelApplyNested, inner, NULL, 
+    GenTreeApplyOrderTopDown);
+  GenTreeFree(&inner);
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreeParallelApply OK\n");
+}
+
+void funReduceMapSum(void* data, void* value, void* param) {
+  (void)param;
+  *(long*)value = *(int*)data;
+}
+
+void funReduceCombineSum(void* acc, const void* value, void* param) {
+  (void)param;
+  *(long*)acc += *(const long*)value;
+}
+
+void funReduceMapHisto(void* data, void* value, void* param) {
+  (void)param;
+  memset(value, 0, sizeof(int) * 8);
+  ((int*)value)[*(int*)data % 8] = 1;
+}
+
+void funReduceCombineHisto(void* acc, const void* value, void* param) {
+  (void)param;
+  for (int i = 0; i < 8; ++i)
+    ((int*)acc)[i] += ((const int*)value)[i];
+}
+
+void funReduceMapOne(void* data, void* value, void* param) {
+  (void)data;
+  (void)param;
+  *(long*)value = 1;
+}
+
+void funReduceStore(void* data, const void* value, void* param) {
+  ((long*)param)[*(int*)data] = *(const long*)value;
+}
+
+#define REDUCE_NBNODE 5000
+void UnitTestGenTreeReduce() {
+  srand(0);
+  int data[REDUCE_NBNODE];
+  void* dataPtr[REDUCE_NBNODE];
+  int parents[REDUCE_NBNODE];
+  long sizes[REDUCE_NBNODE];
+  long stored[REDUCE_NBNODE];
+  GetRandomParents(data, dataPtr, parents, NULL, REDUCE_NBNODE);
+  for (int iNode = 0; iNode < REDUCE_NBNODE; ++iNode)
+    sizes[iNode] = 1;
+  for (int iNode = REDUCE_NBNODE; iNode-- > 1;)
+    sizes[parents[iNode]] += sizes[iNode];
+  GenTree* tree = 
+    GenTreeCreateFromParents(dataPtr, parents, NULL, REDUCE_NBNODE);
+  GenTreeThreadPool* pool = GenTreeThreadPoolCreate(4);
+  for (int iRun = 0; iRun < 2; ++iRun) {
+    GenTreeThreadPool* p = (iRun == 0 ? pool : NULL);
+    long zero = 0;
+    long sum = -1;
+    GenTreeReduce(tree, &sum, &zero, sizeof(long), funReduceMapSum, 
+      funReduceCombineSum, NULL, p);
+    int histoZero[8] = {0};
+    int histo[8];
+    GenTreeReduce(tree, histo, histoZero, sizeof(histo), 
+      funReduceMapHisto, funReduceCombineHisto, NULL, p);
+    if (sum != (long)REDUCE_NBNODE * (REDUCE_NBNODE - 1) / 2) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeReduce failed");
+      PBErrCatch(GenTreeErr);
+    }
+    for (int i = 0; i < 8; ++i) {
+      if (histo[i] != REDUCE_NBNODE / 8 - (i == 0 ? 1 : 0)) {
+        GenTreeErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(GenTreeErr->_msg, "GenTreeReduce failed");
+        PBErrCatch(GenTreeErr);
+      }
+    }
+    long nb = -1;
+    for (int iNode = 0; iNode < REDUCE_NBNODE; ++iNode)
+      stored[iNode] = -1;
+    GenTreeReduceBottomUp(tree, &nb, &zero, sizeof(long), 
+      funReduceMapOne, funReduceCombineSum, funReduceStore, stored, p);
+    if (nb != REDUCE_NBNODE - 1 || stored[0] != -1) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeReduceBottomUp failed");
+      PBErrCatch(GenTreeErr);
+    }
+    for (int iNode = 1; iNode < REDUCE_NBNODE; ++iNode) {
+      if (stored[iNode] != sizes[iNode]) {
+        GenTreeErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(GenTreeErr->_msg, "GenTreeReduceBottomUp failed");
+        PBErrCatch(GenTreeErr);
+      }
+    }
+  }
+  GenTreeFree(&tree);
+  tree = GenTreeCreate();
+  long zero = 0;
+  long sum = -1;
+  GenTreeReduceBottomUp(tree, &sum, &zero, sizeof(long), 
+    funReduceMapOne, funReduceCombineSum, NULL, NULL, pool);
+  if (sum != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeReduceBottomUp failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeFree(&tree);
+  GenTreeThreadPoolFree(&pool);
+  printf("UnitTestGenTreeReduce OK\n");
+}
+
+#define ITERUPDATEPARALLEL_NBNODE 12000
+void UnitTestGenTreeIterUpdateParallel() {
+  srand(0);
+  int* data = PBErrMalloc(GenTreeErr, sizeof(int) * 
+    ITERUPDATEPARALLEL_NBNODE);
+  void** dataPtr = PBErrMalloc(GenTreeErr, sizeof(void*) * 
+    ITERUPDATEPARALLEL_NBNODE);
+  int* parents = PBErrMalloc(GenTreeErr, sizeof(int) * 
+    ITERUPDATEPARALLEL_NBNODE);
+  float* sortVals = PBErrMalloc(GenTreeErr, sizeof(float) * 
+    ITERUPDATEPARALLEL_NBNODE);
+  for (int iNode = 0; iNode < ITERUPDATEPARALLEL_NBNODE; ++iNode) {
+    data[iNode] = iNode;
+    dataPtr[iNode] = data + iNode;
+    // A level wide enough to be processed in parallel, then random 
+    // nodes
+    parents[iNode] = (iNode == 0 ? -1 : 
+      (iNode <= 5000 ? 0 : rand() % iNode));
+    sortVals[iNode] = (float)(rand() % 10);
+  }
+  GenTree* tree = GenTreeCreateFromParents(dataPtr, parents, sortVals, 
+    ITERUPDATEPARALLEL_NBNODE);
+  GenTreeThreadPool* pool = GenTreeThreadPoolCreate(4);
+  GenTree* trees[2] = {tree, GenTreeSubtree(tree, 3)};
+  for (int iRun = 0; iRun < 4; ++iRun) {
+    GenTree* t = trees[iRun % 2];
+    GenTreeThreadPool* p = (iRun < 2 ? pool : NULL);
+    GenTreeIterDepth depth = GenTreeIterDepthCreateStatic(t);
+    GenTreeIterDepth depthParallel = GenTreeIterDepthCreateStatic(t);
+    GenTreeIterBreadth breadth = GenTreeIterBreadthCreateStatic(t);
+    GenTreeIterBreadth breadthParallel = 
+      GenTreeIterBreadthCreateStatic(t);
+    GenTreeIterValue value = GenTreeIterValueCreateStatic(t);
+    GenTreeIterValue valueParallel = GenTreeIterValueCreateStatic(t);
+    // Make the iterators stale
+    GenTreeAppendData(t, NULL);
+    GenTree* last = GenTreeLastSubtree(t);
+    GenTreeFree(&last);
+    GenTreeIterUpdateParallel(&depthParallel, p);
+    GenTreeIterUpdateParallel(&breadthParallel, p);
+    GenTreeIterUpdateParallel(&valueParallel, p);
+    GenTreeIterUpdate(&depth);
+    GenTreeIterUpdate(&breadth);
+    GenTreeIterUpdate(&value);
+    GenTreeIter* iters[3] = {(GenTreeIter*)&depth, 
+      (GenTreeIter*)&breadth, (GenTreeIter*)&value};
+    GenTreeIter* itersParallel[3] = {(GenTreeIter*)&depthParallel, 
+      (GenTreeIter*)&breadthParallel, (GenTreeIter*)&valueParallel};
+    for (int iIter = 0; iIter < 3; ++iIter) {
+      GenTreeIter* iter = iters[iIter];
+      GenTreeIter* iterParallel = itersParallel[iIter];
+      if (iter->_nbNode != iterParallel->_nbNode ||
+        GenTreeIterIsStale(iterParallel)) {
+        GenTreeErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(GenTreeErr->_msg, "GenTreeIterUpdateParallel failed");
+        PBErrCatch(GenTreeErr);
+      }
+      for (int iNode = 0; iNode < iter->_nbNode; ++iNode) {
+        if (iter->_seq[iNode] != iterParallel->_seq[iNode]) {
+          GenTreeErr->_type = PBErrTypeUnitTestFailed;
+          sprintf(GenTreeErr->_msg, "GenTreeIterUpdateParallel failed");
+          PBErrCatch(GenTreeErr);
+        }
+      }
+      GenTreeIterFreeStatic(iter);
+      GenTreeIterFreeStatic(iterParallel);
+    }
+  }
+  GenTreeThreadPoolFree(&pool);
+  GenTreeFree(&tree);
+  free(data);
+  free(dataPtr);
+  free(parents);
+  free(sortVals);
+  printf("UnitTestGenTreeIterUpdateParallel OK\n");
+}
+
+#define CLONEPARALLEL_NBNODE 5000
+void UnitTestGenTreeCloneParallel() {
+  srand(0);
+  int data[CLONEPARALLEL_NBNODE];
+  void* dataPtr[CLONEPARALLEL_NBNODE];
+  int parents[CLONEPARALLEL_NBNODE];
+  float sortVals[CLONEPARALLEL_NBNODE];
+  GetRandomParents(data, dataPtr, parents, sortVals, 
+    CLONEPARALLEL_NBNODE);
+  GenTree* tree = GenTreeCreateFromParents(dataPtr, parents, sortVals,
+    CLONEPARALLEL_NBNODE);
+  GenTreeSubtreeArrayCreate(tree);
+  void* exportData[CLONEPARALLEL_NBNODE];
+  int exportParents[CLONEPARALLEL_NBNODE];
+  float exportSortVals[CLONEPARALLEL_NBNODE];
+  GenTreeExportParents(tree, exportData, exportParents, exportSortVals);
+  GenTreeThreadPool* pool = GenTreeThreadPoolCreate(4);
+  for (int iRun = 0; iRun < 2; ++iRun) {
+    GenTree* clone = GenTreeCloneParallel(tree, NULL, 
+      (iRun == 0 ? pool : NULL));
+    if (GenTreeExportParents(clone, dataPtr, parents, sortVals) != 
+      CLONEPARALLEL_NBNODE ||
+      GenTreeGetSubtreeArr(clone) == NULL ||
+      GenTreeSiblingIndex(GenTreeLastSubtree(GenTreeSubtree(clone, 0)))
+        != GSetNbElem(GenTreeSubtrees(GenTreeSubtree(clone, 0))) - 1) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeCloneParallel failed");
+      PBErrCatch(GenTreeErr);
+    }
+    for (int iNode = 0; iNode < CLONEPARALLEL_NBNODE; ++iNode) {
+      if (dataPtr[iNode] != exportData[iNode] ||
+        parents[iNode] != exportParents[iNode] ||
+        sortVals[iNode] != exportSortVals[iNode]) {
+        GenTreeErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(GenTreeErr->_msg, "GenTreeCloneParallel failed");
+        PBErrCatch(GenTreeErr);
+      }
+    }
+    GenTreeFree(&clone);
+  }
+  GenTreeThreadPoolFree(&pool);
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreeCloneParallel OK\n");
+}
+
+void UnitTestGenTreeThreadPool() {
+  UnitTestGenTreeThreadPoolCreateFree();
+  UnitTestGenTreeParallelApply();
+  UnitTestGenTreeReduce();
+  UnitTestGenTreeIterUpdateParallel();
+  UnitTestGenTreeCloneParallel();
+  printf("UnitTestGenTreeThreadPool OK\n");
+}
+
+void UnitTestGenTreeRcuPublish() {
+  GenTree* tree = GetExampleTree();
+  GenTreeRcu* rcu = GenTreeRcuCreate(tree);
+  GenTreeRcuReader* reader = GenTreeRcuReaderCreate(rcu);
+  if (GenTreeRcuGetVersion(rcu) != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeRcuCreate failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // The reader keeps reading the snapshot it got while the writer 
+  // modifies and publishes the tree
+  const GenTreePersist* root = GenTreeRcuReadLock(reader);
+  GenTreeAppendData(tree, dataExampleTree);
+  GenTreeRcuPublish(rcu);
+  if (GenTreeRcuGetVersion(rcu) != 1 ||
+    GenTreeRcuReaderGetVersion(reader) != 0 ||
+    GenTreePersistGetSize(root) != 10 ||
+    *(int*)GenTreePersistData(GenTreePersistSelect(root, 10)) != 4 ||
+    GenTreeRcuReclaim(rcu) != 1) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeRcuPublish failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // The new snapshot shares the unmodified subtrees with the previous
+  // one
+  GenTreeRcuReader* latest = GenTreeRcuReaderCreate(rcu);
+  const GenTreePersist* next = GenTreeRcuReadLock(latest);
+  if (next == root ||
+    GenTreePersistGetSize(next) != 11 ||
+    GenTreePersistNbSubtree(next) != 3 ||
+    GenTreePersistSubtree(next, 0) != GenTreePersistSubtree(root, 0) ||
+    GenTreePersistSubtree(next, 1) != GenTreePersistSubtree(root, 1) ||
+    GenTreePersistData(GenTreePersistSubtree(next, 2)) != 
+      dataExampleTree) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeRcuPublish failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeRcuReadUnlock(latest);
+  GenTreeRcuReadUnlock(reader);
+  if (GenTreeRcuReclaim(rcu) != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeRcuReclaim failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // The user data modified without modifying the tree are published
+  // too, only the path to the modified node is copied
+  root = GenTreeRcuReadLock(reader);
+  GenTreeSetData(GenTreeSubtree(GenTreeSubtree(tree, 1), 1), 
+    dataExampleTree + 1);
+  GenTreeRcuPublish(rcu);
+  next = GenTreeRcuReadLock(latest);
+  if (GenTreeRcuReaderGetVersion(reader) != 1 ||
+    GenTreeRcuReaderGetVersion(latest) != 2 ||
+    GenTreePersistSubtree(next, 0) != GenTreePersistSubtree(root, 0) ||
+    GenTreePersistSubtree(next, 1) == GenTreePersistSubtree(root, 1) ||
+    GenTreePersistSubtree(GenTreePersistSubtree(next, 1), 0) != 
+      GenTreePersistSubtree(GenTreePersistSubtree(root, 1), 0) ||
+    GenTreePersistSubtree(next, 2) != GenTreePersistSubtree(root, 2) ||
+    *(int*)GenTreePersistData(GenTreePersistSelect(next, 10)) != 1 ||
+    *(int*)GenTreePersistData(GenTreePersistSelect(root, 10)) != 4) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeRcuPublish failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeRcuReadUnlock(latest);
+  GenTreeRcuReaderFree(&latest);
+  GenTreeRcuReadUnlock(reader);
+  // Snapshots replaced while no reader is reading are freed at once
+  GenTreeRcuPublish(rcu);
+  if (GenTreeRcuGetVersion(rcu) != 3 ||
+    GenTreeRcuReclaim(rcu) != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeRcuPublish failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeRcuReaderFree(&reader);
+  GenTreeRcuFree(&rcu);
+  if (reader != NULL || rcu != NULL) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeRcuFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreeRcuPublish OK\n");
+}
+
+#define RCUCONCURRENT_NBREADER 4
+#define RCUCONCURRENT_NBPUBLISH 200
+
+typedef struct RcuConcurrentParam {
+  GenTreeRcuReader* _reader;
+  atomic_bool* _isDone;
+  bool _isOk;
+} RcuConcurrentParam;
+
+void* RcuConcurrentRead(void* arg) {
+  RcuConcurrentParam* param = arg;
+  unsigned long lastVersion = 0;
+  do {
+    const GenTreePersist* root = GenTreeRcuReadLock(param->_reader);
+    unsigned long version = GenTreeRcuReaderGetVersion(param->_reader);
+    // The writer appends one node to the root per publication, and 
+    // the snapshots are published in order
+    int nbSubtree = GenTreePersistNbSubtree(root);
+    if (version < lastVersion ||
+      nbSubtree != (int)version ||
+      GenTreePersistGetSize(root) != nbSubtree ||
+      (version > 0 && *(int*)GenTreePersistData(
+        GenTreePersistSubtree(root, nbSubtree - 1)) != (int)version - 1))
+      param->_isOk = false;
+    lastVersion = version;
+    GenTreeRcuReadUnlock(param->_reader);
+  } while (!atomic_load(param->_isDone));
+  return NULL;
+}
+
+void UnitTestGenTreeRcuConcurrent() {
+  int data[RCUCONCURRENT_NBPUBLISH];
+  GenTree* tree = GenTreeCreate();
+  GenTreeRcu* rcu = GenTreeRcuCreate(tree);
+  atomic_bool isDone;
+  atomic_init(&isDone, false);
+  pthread_t threads[RCUCONCURRENT_NBREADER];
+  RcuConcurrentParam params[RCUCONCURRENT_NBREADER];
+  for (int iThread = 0; iThread < RCUCONCURRENT_NBREADER; ++iThread) {
+    params[iThread]._reader = GenTreeRcuReaderCreate(rcu);
+    params[iThread]._isDone = &isDone;
+    params[iThread]._isOk = true;
+    pthread_create(threads + iThread, NULL, RcuConcurrentRead, 
+      params + iThread);
+  }
+  for (int iPublish = 0; iPublish < RCUCONCURRENT_NBPUBLISH; 
+    ++iPublish) {
+    data[iPublish] = iPublish;
+    GenTreeAppendData(tree, data + iPublish);
+    GenTreeRcuPublish(rcu);
+  }
+  atomic_store(&isDone, true);
+  for (int iThread = 0; iThread < RCUCONCURRENT_NBREADER; ++iThread) {
+    pthread_join(threads[iThread], NULL);
+    if (!params[iThread]._isOk) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeRcuReadLock failed");
+      PBErrCatch(GenTreeErr);
+    }
+    GenTreeRcuReaderFree(&(params[iThread]._reader));
+  }
+  if (GenTreeRcuGetVersion(rcu) != RCUCONCURRENT_NBPUBLISH ||
+    GenTreeRcuReclaim(rcu) != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeRcuPublish failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreeRcuFree(&rcu);
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreeRcuConcurrent OK\n");
+}
+
+void UnitTestGenTreeRcu() {
+  UnitTestGenTreeRcuPublish();
+  UnitTestGenTreeRcuConcurrent();
+  printf("UnitTestGenTreeRcu OK\n");
+}
+
+#define CONCURRENT_NBTHREAD 4
+#define CONCURRENT_NBNODE 500
+
+typedef struct ConcurrentParam {
+  GenTreeConcurrent* _conc;
+  GenTree* _tree;
+  int* _data;
+} ConcurrentParam;
+
+void* ConcurrentAdd(void* arg) {
+  ConcurrentParam* param = arg;
+  for (int iNode = 0; iNode < CONCURRENT_NBNODE; ++iNode) {
+    // All the threads add to the same node, then to their own nodes
+    int* data = param->_data + 3 * iNode;
+    GenTree* node = GenTreeConcurrentAddSortData(param->_conc, 
+      param->_tree, data, (float)(*data % 7));
+    GenTreeConcurrentAppendData(param->_conc, node, data + 1);
+    GenTreeConcurrentAppendData(param->_conc, node, data + 2);
+  }
+  return NULL;
+}
+
+void UnitTestGenTreeConcurrentAdd() {
+  int nbData = 3 * CONCURRENT_NBTHREAD * CONCURRENT_NBNODE;
+  int* data = PBErrMalloc(GenTreeErr, sizeof(int) * nbData);
+  for (int iData = 0; iData < nbData; ++iData)
+    data[iData] = iData;
+  GenTreePool* pool = GenTreePoolCreate(64);
+  GenTree* tree = GenTreeCreatePool(pool);
+  GenTreeSubtreeSkipListCreate(tree);
+  GenTreeIndexCreate(tree, NULL);
+  GenTreeConcurrent* conc = GenTreeConcurrentCreate(tree);
+  pthread_t threads[CONCURRENT_NBTHREAD];
+  ConcurrentParam params[CONCURRENT_NBTHREAD];
+  for (int iThread = 0; iThread < CONCURRENT_NBTHREAD; ++iThread) {
+    params[iThread]._conc = conc;
+    params[iThread]._tree = tree;
+    params[iThread]._data = data + 3 * CONCURRENT_NBNODE * iThread;
+    pthread_create(threads + iThread, NULL, ConcurrentAdd, 
+      params + iThread);
+  }
+  for (int iThread = 0; iThread < CONCURRENT_NBTHREAD; ++iThread)
+    pthread_join(threads[iThread], NULL);
+  GenTreeConcurrentFree(&conc);
+  if (conc != NULL ||
+    GenTreeGetSize(tree) != nbData ||
+    GSetNbElem(GenTreeSubtrees(tree)) != nbData / 3 ||
+    GenTreePoolGetNbLive(pool) != nbData + 1) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreeConcurrentAddSortData failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // The subtrees are sorted, and each has its two subtrees
+  float sortVal = 0.0;
+  GSetIterForward iter = GSetIterForwardCreateStatic(
+    (GSet*)GenTreeSubtrees(tree));
+  do {
+    GenTree* node = GSetIterGet(&iter);
+    int* nodeData = GenTreeData(node);
+    if (GSetIterGetElem(&iter)->_sortVal < sortVal ||
+      GenTreeGetSize(node) != 2 ||
+      GenTreeData(GenTreeSubtree(node, 0)) != nodeData + 1 ||
+      GenTreeData(GenTreeSubtree(node, 1)) != nodeData + 2) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeConcurrentAppendData failed");
+      PBErrCatch(GenTreeErr);
+    }
+    sortVal = GSetIterGetElem(&iter)->_sortVal;
+  } while (GSetIterStep(&iter));
+  // The index is up to date
+  for (int iData = 0; iData < nbData; ++iData) {
+    GenTree* node = GenTreeIndexSearch(tree, data + iData, NULL);
+    if (node == NULL || GenTreeData(node) != data + iData) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreeConcurrentAppendData failed");
+      PBErrCatch(GenTreeErr);
+    }
+  }
+  GenTreeFree(&tree);
+  GenTreePoolFree(&pool);
+  free(data);
+  printf("UnitTestGenTreeConcurrentAdd OK\n");
+}
+
+void UnitTestGenTreeConcurrent() {
+  UnitTestGenTreeConcurrentAdd();
+  printf("UnitTestGenTreeConcurrent OK\n");
+}
+
+void UnitTestGenTreePersistEdit() {
+  int data[6] = {0, 1, 2, 3, 4, 5};
+  // v0: 0
+  GenTreePersist* v0 = GenTreePersistCreate(data);
+  // v1: 0(1 2)
+  GenTreePersist* v1 = GenTreePersistAppendData(v0, 0, data + 1);
+  GenTreePersist* v2 = GenTreePersistAppendData(v1, 0, data + 2);
+  // v3: 0(1(3) 2), v4: 0(1(4 3) 2), v5: 0(1(4 3 5) 2)
+  GenTreePersist* v3 = GenTreePersistAddSortData(v2, 1, data + 3, 2.0);
+  GenTreePersist* v4 = GenTreePersistAddSortData(v3, 1, data + 4, 1.0);
+  GenTreePersist* v5 = GenTreePersistAddSortData(v4, 1, data + 5, 2.0);
+  if (GenTreePersistGetSize(v0) != 0 ||
+    GenTreePersistGetSize(v2) != 2 ||
+    GenTreePersistGetSize(v5) != 5 ||
+    GenTreePersistNbSubtree(v5) != 2 ||
+    GenTreePersistNbSubtree(GenTreePersistSubtree(v5, 0)) != 3 ||
+    GenTreePersistGetSize(GenTreePersistSubtree(v5, 0)) != 3 ||
+    GenTreePersistNbSubtree(GenTreePersistSubtree(v4, 0)) != 2 ||
+    GenTreePersistNbSubtree(v0) != 0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePersistAddSortData failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // Depth first order of v5 is 0 1 4 3 5 2
+  int order[6] = {0, 1, 4, 3, 5, 2};
+  for (int iNode = 0; iNode < 6; ++iNode) {
+    const GenTreePersist* node = GenTreePersistSelect(v5, iNode);
+    if (node == NULL || GenTreePersistData(node) != data + order[iNode]) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreePersistSelect failed");
+      PBErrCatch(GenTreeErr);
+    }
+  }
+  if (GenTreePersistSelect(v5, 6) != NULL ||
+    GenTreePersistSelect(v5, -1) != NULL ||
+    GenTreePersistSortVal(GenTreePersistSelect(v5, 2)) != 1.0) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePersistSelect failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // v6: 0(1(4 0 5) 2), v7: 0(2)
+  GenTreePersist* v6 = GenTreePersistSetData(v5, 3, data);
+  GenTreePersist* v7 = GenTreePersistCut(v6, 1);
+  if (GenTreePersistData(GenTreePersistSelect(v6, 3)) != data ||
+    GenTreePersistData(GenTreePersistSelect(v5, 3)) != data + 3 ||
+    GenTreePersistGetSize(v7) != 1 ||
+    GenTreePersistData(GenTreePersistSelect(v7, 1)) != data + 2 ||
+    GenTreePersistGetSize(v6) != 5) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePersistCut failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreePersist* versions[8] = {v0, v1, v2, v3, v4, v5, v6, v7};
+  for (int iVersion = 0; iVersion < 8; ++iVersion) {
+    GenTreePersistFree(versions + iVersion);
+    if (versions[iVersion] != NULL) {
+      GenTreeErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(GenTreeErr->_msg, "GenTreePersistFree failed");
+      PBErrCatch(GenTreeErr);
+    }
+  }
+  printf("UnitTestGenTreePersistEdit OK\n");
+}
+
+void UnitTestGenTreePersistShare() {
+  int data[101];
+  // Tree of 10 subtrees of 9 subtrees each, the data of the 'iNode'-th
+  // node being data + iNode
+  GenTreePersist* tree = GenTreePersistCreate(data);
+  for (int iSubtree = 0; iSubtree < 10; ++iSubtree) {
+    GenTreePersist* next = 
+      GenTreePersistAppendData(tree, 0, data + 1 + 10 * iSubtree);
+    GenTreePersistFree(&tree);
+    tree = next;
+    for (int iNode = 2; iNode < 11; ++iNode) {
+      next = GenTreePersistAppendData(tree, 1 + 10 * iSubtree, 
+        data + iNode + 10 * iSubtree);
+      GenTreePersistFree(&tree);
+      tree = next;
+    }
+  }
+  // Snapshot and edit a node of the 5th subtree
+  GenTreePersist* snapshot = GenTreePersistRetain(tree);
+  GenTreePersist* edited = GenTreePersistSetData(tree, 53, data);
+  // Only the path to the edited node is copied
+  bool shared = true;
+  for (int iSubtree = 0; iSubtree < 10; ++iSubtree)
+    shared &= ((GenTreePersistSubtree(edited, iSubtree) == 
+      GenTreePersistSubtree(snapshot, iSubtree)) == (iSubtree != 5));
+  const GenTreePersist* sub = GenTreePersistSubtree(edited, 5);
+  for (int iSubtree = 0; iSubtree < 9; ++iSubtree)
+    shared &= ((GenTreePersistSubtree(sub, iSubtree) == 
+      GenTreePersistSubtree(GenTreePersistSubtree(snapshot, 5), 
+      iSubtree)) == (iSubtree != 1));
+  if (snapshot != tree || !shared ||
+    GenTreePersistGetSize(edited) != 100 ||
+    GenTreePersistData(GenTreePersistSelect(edited, 53)) != data ||
+    GenTreePersistData(GenTreePersistSelect(snapshot, 53)) != 
+      data + 53) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePersistSetData failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // The snapshot stays valid after the other references are released
+  GenTreePersistFree(&tree);
+  GenTreePersistFree(&edited);
+  if (GenTreePersistGetSize(snapshot) != 100 ||
+    GenTreePersistData(GenTreePersistSelect(snapshot, 99)) != 
+      data + 99) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePersistFree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreePersistFree(&snapshot);
+  printf("UnitTestGenTreePersistShare OK\n");
+}
+
+void UnitTestGenTreePersistDeep() {
+  int data[2];
+  // Chain of 'depth' nodes, each one appended to the last node, keeping
+  // every other version alive so the chain is shared between versions
+  int depth = 4000;
+  GenTreePersist* tree = GenTreePersistCreate(data);
+  GenTreePersist* old = NULL;
+  for (int iNode = 0; iNode < depth; ++iNode) {
+    GenTreePersist* next = GenTreePersistAppendData(tree, iNode, 
+      data + iNode % 2);
+    if (iNode % 2 == 0) {
+      GenTreePersistFree(&old);
+      old = tree;
+    } else {
+      GenTreePersistFree(&tree);
+    }
+    tree = next;
+  }
+  GenTreePersist* cut = GenTreePersistCut(tree, depth / 2);
+  if (GenTreePersistGetSize(tree) != depth ||
+    GenTreePersistGetSize(old) != depth - 2 ||
+    GenTreePersistGetSize(cut) != depth / 2 - 1 ||
+    GenTreePersistNbSubtree(GenTreePersistSelect(tree, depth - 1)) != 1 ||
+    GenTreePersistNbSubtree(GenTreePersistSelect(cut, depth / 2 - 1)) 
+      != 0 ||
+    GenTreePersistData(GenTreePersistSelect(tree, depth)) != data + 1) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePersistAppendData failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreePersistFree(&tree);
+  GenTreePersistFree(&old);
+  GenTreePersistFree(&cut);
+  printf("UnitTestGenTreePersistDeep OK\n");
+}
+
+void UnitTestGenTreePersistFromTree() {
+  GenTree* tree = GetExampleTree();
+  GenTreePersist* first = GenTreePersistCreateFromTree(tree, NULL);
+  // Nothing is copied from an unmodified tree
+  GenTreePersist* same = GenTreePersistCreateFromTree(tree, first);
+  if (same != first ||
+    GenTreePersistGetSize(first) != 10 ||
+    *(int*)GenTreePersistData(GenTreePersistSelect(first, 10)) != 4) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePersistCreateFromTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreePersistFree(&same);
+  // Only the path to an added node is copied
+  GenTreeAddSortData(GenTreeSubtree(tree, 1), dataExampleTree + 5, 0.0);
+  GenTreePersist* added = GenTreePersistCreateFromTree(tree, first);
+  const GenTreePersist* node = GenTreePersistSubtree(first, 1);
+  const GenTreePersist* addedNode = GenTreePersistSubtree(added, 1);
+  if (GenTreePersistGetSize(added) != 11 ||
+    GenTreePersistSubtree(added, 0) != GenTreePersistSubtree(first, 0) ||
+    GenTreePersistNbSubtree(addedNode) != 3 ||
+    *(int*)GenTreePersistData(GenTreePersistSubtree(addedNode, 0)) != 5 ||
+    GenTreePersistSubtree(addedNode, 1) != GenTreePersistSubtree(node, 0) ||
+    GenTreePersistSubtree(addedNode, 2) != GenTreePersistSubtree(node, 1)) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePersistCreateFromTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  // The brothers of a removed node are shared
+  GenTree* removed = GenTreeRemoveSubtree(tree, 0);
+  GenTreeFree(&removed);
+  GenTreePersist* cut = GenTreePersistCreateFromTree(tree, added);
+  if (GenTreePersistGetSize(cut) != 8 ||
+    GenTreePersistNbSubtree(cut) != 1 ||
+    GenTreePersistSubtree(cut, 0) != addedNode) {
+    GenTreeErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(GenTreeErr->_msg, "GenTreePersistCreateFromTree failed");
+    PBErrCatch(GenTreeErr);
+  }
+  GenTreePersistFree(&first);
+  GenTreePersistFree(&added);
+  GenTreePersistFree(&cut);
+  GenTreeFree(&tree);
+  printf("UnitTestGenTreePersistFromTree OK\n");
+}
+
+void UnitTestGenTreePersist() {
+  UnitTestGenTreePersistEdit();
+  UnitTestGenTreePersistShare();
+  UnitTestGenTreePersistDeep();
+  UnitTestGenTreePersistFromTree();
+  printf("UnitTestGenTreePersist OK\n");
 }
 
 void UnitTestAll() {
   UnitTestGenTree();
   UnitTestGenTreeIter();
+  UnitTestGenTreeFrozen();
+  UnitTestGenTreeThreadPool();
+  UnitTestGenTreeRcu();
+  UnitTestGenTreeConcurrent();
+  UnitTestGenTreePersist();
   printf("UnitTestAll OK\n");
 }
 